@@ -739,11 +739,16 @@ bool AP_Arming_Copter::arm(const AP_Arming::Method method, const bool do_arming_
     copter.sprayer.test_pump(false);
 #endif
 
-    // output lowest possible value to motors
-    copter.motors->output_min();
+    {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        WITH_SEMAPHORE(copter.rate_thread.sem);
+#endif
+        // output lowest possible value to motors
+        copter.motors->output_min();
 
-    // finally actually arm the motors
-    copter.motors->armed(true);
+        // finally actually arm the motors
+        copter.motors->armed(true);
+    }
 
 #if HAL_LOGGING_ENABLED
     // log flight mode in case it was changed while vehicle was disarmed
@@ -813,7 +818,12 @@ bool AP_Arming_Copter::disarm(const AP_Arming::Method method, bool do_disarm_che
     copter.set_land_complete_maybe(true);
 
     // send disarm command to motors
-    copter.motors->armed(false);
+    {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        WITH_SEMAPHORE(copter.rate_thread.sem);
+#endif
+        copter.motors->armed(false);
+    }
 
 #if MODE_AUTO_ENABLED
     // reset the mission
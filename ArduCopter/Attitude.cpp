@@ -10,12 +10,27 @@ void Copter::run_rate_controller()
 {
     // set attitude and position controller loop time
     const float last_loop_time_s = AP::scheduler().get_last_loop_time_s();
-    motors->set_dt(last_loop_time_s);
     attitude_control->set_dt(last_loop_time_s);
     pos_control->set_dt(last_loop_time_s);
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    if (using_rate_thread) {
+        // the rate thread runs the rate controller on each gyro sample
+        return;
+    }
+#endif
+
+    motors->set_dt(last_loop_time_s);
+
+    // trace the latency from the gyro sample used to the motor outputs
+    const AP_InertialSensor::GyroSampleTime &gyro_time = ins.get_gyro_sample_time(ahrs.get_primary_gyro_index());
+    AP_SCHEDULER_GYRO_LATENCY_START(gyro_time.sample_us, gyro_time.filtered_us);
+
     // run low level rate controllers that only require IMU data
-    attitude_control->rate_controller_run();
+    {
+        AP_SCHEDULER_PROFILE_SECTION("rate_controller");
+        attitude_control->rate_controller_run();
+    }
     // reset sysid and other temporary inputs
     attitude_control->rate_controller_target_reset();
 }
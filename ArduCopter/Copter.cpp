@@ -121,7 +121,7 @@ const AP_Scheduler::Task Copter::scheduler_tasks[] = {
     FAST_TASK(heli_update_autorotation),
 #endif //HELI_FRAME
     // send outputs to the motors library immediately
-    FAST_TASK(motors_output),
+    FAST_TASK(motors_output_main),
      // run EKF state estimator (expensive)
     FAST_TASK(read_AHRS),
 #if FRAME_CONFIG == HELI_FRAME
@@ -760,9 +760,15 @@ void Copter::one_hz_loop()
     if (should_log(MASK_LOG_ANY)) {
         Log_Write_Data(LogDataID::AP_STATE, ap_value());
     }
+#if AP_COPTER_RATE_THREAD_ENABLED
+    Log_Write_Rate_Thread();
+#endif
 #endif
 
     if (!motors->armed()) {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        WITH_SEMAPHORE(rate_thread.sem);
+#endif
         update_using_interlock();
 
         // check the user hasn't updated the frame class or type
@@ -789,7 +795,14 @@ void Copter::one_hz_loop()
     AP_Notify::flags.flying = !ap.land_complete;
 
     // slowly update the PID notches with the average loop rate
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // the rate thread updates the rate PID notches itself
+    if (!using_rate_thread) {
+        attitude_control->set_notch_sample_rate(AP::scheduler().get_filtered_loop_rate_hz());
+    }
+#else
     attitude_control->set_notch_sample_rate(AP::scheduler().get_filtered_loop_rate_hz());
+#endif
     pos_control->get_accel_z_pid().set_notch_sample_rate(AP::scheduler().get_filtered_loop_rate_hz());
 #if AC_CUSTOMCONTROL_MULTI_ENABLED
     custom_control.set_notch_sample_rate(AP::scheduler().get_filtered_loop_rate_hz());
@@ -871,6 +884,7 @@ void Copter::update_super_simple_bearing(bool force_update)
 
 void Copter::read_AHRS(void)
 {
+    AP_SCHEDULER_PROFILE_SECTION("ahrs_update");
     // we tell AHRS to skip INS update as we have already done it in FAST_TASK.
     ahrs.update(true);
 }
@@ -591,6 +591,33 @@ private:
 
     bool standby_active;
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // true when the rate controller and motor output run in the rate
+    // thread rather than the main loop
+    bool using_rate_thread;
+
+    // state handed between the main loop and the rate thread. The
+    // main loop also holds the semaphore to arm, disarm, change the
+    // frame or take the motors back from the thread
+    struct {
+        HAL_Semaphore sem;
+
+        // published by the main loop each loop
+        AC_AttitudeControl::RateControllerInputs inputs;
+        Vector3f gyro_drift;
+        bool drive_motors;      // the rate thread sends the motor outputs
+
+        // timing, accumulated by the rate thread and logged and
+        // cleared by the main loop once a second
+        uint32_t count;
+        float dt_sum;
+        float dt_max;
+        uint64_t latency_sum_us;
+        uint32_t latency_max_us;
+        uint32_t timeouts;
+    } rate_thread;
+#endif
+
     static const AP_Scheduler::Task scheduler_tasks[];
     static const AP_Param::Info var_info[];
     static const struct LogStructure log_structure[];
@@ -729,6 +756,14 @@ private:
     void rotate_body_frame_to_NE(float &x, float &y);
     uint16_t get_pilot_speed_dn() const;
     void run_rate_controller();
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // rate_thread.cpp
+    void rate_controller_thread_start();
+    void rate_controller_thread();
+#if HAL_LOGGING_ENABLED
+    void Log_Write_Rate_Thread();
+#endif
+#endif
 
 #if AC_CUSTOMCONTROL_MULTI_ENABLED
     void run_custom_controller() { custom_control.update(); }
@@ -921,7 +956,8 @@ private:
     // motors.cpp
     void arm_motors_check();
     void auto_disarm_check();
-    void motors_output();
+    bool motors_output(bool rate_thread_output = false);
+    void motors_output_main();
     void lost_vehicle_check();
 
     // navigation.cpp
@@ -76,6 +76,10 @@ void Copter::Log_Write_Control_Tuning()
 void Copter::Log_Write_Attitude()
 {
     attitude_control->Write_ANG();
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // the rate thread updates the rates and motor outputs
+    WITH_SEMAPHORE(rate_thread.sem);
+#endif
     attitude_control->Write_Rate(*pos_control);
 }
 
@@ -83,6 +87,10 @@ void Copter::Log_Write_Attitude()
 void Copter::Log_Write_PIDS()
 {
    if (should_log(MASK_LOG_PID)) {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        // the rate thread updates the rate PIDs
+        WITH_SEMAPHORE(rate_thread.sem);
+#endif
         logger.Write_PID(LOG_PIDR_MSG, attitude_control->get_rate_roll_pid().get_pid_info());
         logger.Write_PID(LOG_PIDP_MSG, attitude_control->get_rate_pitch_pid().get_pid_info());
         logger.Write_PID(LOG_PIDY_MSG, attitude_control->get_rate_yaw_pid().get_pid_info());
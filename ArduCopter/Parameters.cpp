@@ -1232,6 +1232,23 @@ const AP_Param::GroupInfo ParametersG2::var_info2[] = {
     // @User: Advanced
     AP_GROUPINFO("FS_EKF_FILT", 8, ParametersG2, fs_ekf_filt_hz, FS_EKF_FILT_DEFAULT),
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // @Param: FSTRATE_ENABLE
+    // @DisplayName: Fast rate thread enable
+    // @Description: Runs the rate controller and motor output in a thread woken by each gyro sample, rather than in the main loop. The main loop, including the EKF and position controller, can then run at a lower SCHED_LOOP_RATE without adding latency to the rate loop. Requires a reboot to take effect
+    // @Values: 0:Disabled,1:Enabled
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("FSTRATE_ENABLE", 9, ParametersG2, fast_rate_enable, 0),
+
+    // @Param: FSTRATE_DIV
+    // @DisplayName: Fast rate thread gyro divisor
+    // @Description: The fast rate thread runs once for every FSTRATE_DIV filtered gyro samples, so its rate is the gyro rate divided by this value
+    // @Range: 1 10
+    // @User: Advanced
+    AP_GROUPINFO("FSTRATE_DIV", 10, ParametersG2, fast_rate_div, 1),
+#endif
+
     // ID 62 is reserved for the AP_SUBGROUPEXTENSION
 
     AP_GROUPEND
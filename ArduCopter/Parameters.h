@@ -681,6 +681,11 @@ public:
     // EKF variance filter cutoff
     AP_Float fs_ekf_filt_hz;
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    AP_Int8 fast_rate_enable;
+    AP_Int8 fast_rate_div;
+#endif
+
 #if WEATHERVANE_ENABLED
     AC_WeatherVane weathervane;
 #endif
@@ -33,6 +33,15 @@ MAV_RESULT Copter::mavlink_compassmot(const GCS_MAVLINK &gcs_chan)
         ap.compass_mot = true;
     }
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // compassmot drives the motors itself from here on, the main loop
+    // hands them back to the rate thread once it is done
+    {
+        WITH_SEMAPHORE(rate_thread.sem);
+        rate_thread.drive_motors = false;
+    }
+#endif
+
     // check compass is enabled
     if (!AP::compass().available()) {
         gcs_chan.send_text(MAV_SEVERITY_CRITICAL, "Compass disabled");
@@ -30,6 +30,7 @@
 #include <AP_ADSB/AP_ADSB_config.h>
 #include <AP_Follow/AP_Follow_config.h>
 #include <AC_Avoidance/AC_Avoidance_config.h>
+#include <AP_InertialSensor/AP_InertialSensor_config.h>
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -598,6 +599,26 @@
 #define AC_CUSTOMCONTROL_MULTI_ENABLED FRAME_CONFIG == MULTICOPTER_FRAME && AP_CUSTOMCONTROL_ENABLED
 #endif
 
+// run the rate controller and motor output in a thread driven by the
+// gyro samples. Custom controllers are not supported as they run
+// after the rate controller in the main loop
+#ifndef AP_COPTER_RATE_THREAD_ENABLED
+#define AP_COPTER_RATE_THREAD_ENABLED (FRAME_CONFIG == MULTICOPTER_FRAME && AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED && !AC_CUSTOMCONTROL_MULTI_ENABLED)
+#endif
+
+// rate thread stack. The thread only runs the rate PIDs, the motor
+// mixer and the RC output push. The deepest call chains measured with
+// -fstack-usage on a 64 bit SITL build are about 430 bytes through
+// rate_controller_run_dt() and 470 bytes through motors->output(), ARM
+// frames are smaller. The RC output push is board specific and is not
+// included, so this leaves about 1k for it and for context switches.
+// The ChibiOS monitor thread raises INTERNAL_ERROR stack_overflow if
+// the free stack drops below 64 bytes, check the free stack in
+// @SYS/threads.txt when changing what the thread runs
+#ifndef AP_COPTER_RATE_THREAD_STACK_SIZE
+#define AP_COPTER_RATE_THREAD_STACK_SIZE 1536
+#endif
+
 #ifndef AC_PAYLOAD_PLACE_ENABLED
 #define AC_PAYLOAD_PLACE_ENABLED 1
 #endif
@@ -3,6 +3,7 @@
 // read_inertia - read inertia in from accelerometers
 void Copter::read_inertia()
 {
+    AP_SCHEDULER_PROFILE_SECTION("read_inertia");
     // inertial altitude estimates. Use barometer climb rate during high vibrations
     inertial_nav.update(vibration_check.high_vibes);
 
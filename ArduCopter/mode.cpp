@@ -410,6 +410,7 @@ void Copter::update_flight_mode()
 #endif
     attitude_control->landed_gain_reduction(copter.ap.land_complete); // Adjust gains when landed to attenuate ground oscillation
 
+    AP_SCHEDULER_PROFILE_SECTION("mode_run");
     flightmode->run();
 }
 
@@ -185,6 +185,10 @@ public:
     // send output to the motors, can be overridden by subclasses
     virtual void output_to_motors();
 
+    // true if output_to_motors() is not overridden, so the rate
+    // thread may send the motor outputs for this mode
+    virtual bool uses_default_motor_output() const { return true; }
+
     // returns true if pilot's yaw input should be used to adjust vehicle's heading
     virtual bool use_pilot_yaw() const {return true; }
 
@@ -1833,6 +1837,7 @@ public:
     bool is_autopilot() const override { return false; }
     void change_motor_direction(bool reverse);
     void output_to_motors() override;
+    bool uses_default_motor_output() const override { return false; }
 
 protected:
     const char *name() const override { return "TURTLE"; }
@@ -159,10 +159,17 @@ MAV_RESULT Copter::mavlink_motor_test_start(const GCS_MAVLINK &gcs_chan, uint8_t
 
             EXPECT_DELAY_MS(3000);
             // enable and arm motors
-            if (!motors->armed()) {
-                motors->output_min();  // output lowest possible value to motors
-                motors->armed(true);
-                hal.util->set_soft_armed(true);
+            {
+#if AP_COPTER_RATE_THREAD_ENABLED
+                // the main loop drives the motors for the test
+                WITH_SEMAPHORE(rate_thread.sem);
+                rate_thread.drive_motors = false;
+#endif
+                if (!motors->armed()) {
+                    motors->output_min();  // output lowest possible value to motors
+                    motors->armed(true);
+                    hal.util->set_soft_armed(true);
+                }
             }
 
             // disable throttle and gps failsafe
@@ -207,7 +214,12 @@ void Copter::motor_test_stop()
     ap.motor_test = false;
 
     // disarm motors
-    motors->armed(false);
+    {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        WITH_SEMAPHORE(rate_thread.sem);
+#endif
+        motors->armed(false);
+    }
     hal.util->set_soft_armed(false);
 
     // reset timeout
@@ -132,8 +132,33 @@ void Copter::auto_disarm_check()
     }
 }
 
+// motors_output_main - called from the main loop. When the rate thread
+// is running this hands it the latest rate targets and tells it whether
+// it should drive the motors
+void Copter::motors_output_main()
+{
+#if AP_COPTER_RATE_THREAD_ENABLED
+    if (using_rate_thread) {
+        // the thread runs several times per handoff, so the gain boost
+        // and throttle mix are updated here rather than in the thread
+        attitude_control->update_rate_controller_inputs(attitude_control->get_dt());
+        WITH_SEMAPHORE(rate_thread.sem);
+        attitude_control->get_rate_controller_inputs(rate_thread.inputs);
+        rate_thread.gyro_drift = ahrs.get_gyro_drift();
+        // reset sysid and other temporary inputs now the rate thread has them
+        attitude_control->rate_controller_target_reset();
+        rate_thread.drive_motors = motors_output(true);
+        return;
+    }
+#endif
+    motors_output();
+}
+
 // motors_output - send output to motors library which will adjust and send to ESCs and servos
-void Copter::motors_output()
+// when rate_thread_output is true the motors are left for the rate
+// thread to output if the flight mode uses the default output, returns
+// true if it should
+bool Copter::motors_output(bool rate_thread_output)
 {
 #if AP_COPTER_ADVANCED_FAILSAFE_ENABLED
     // this is to allow the failsafe module to deliberately crash
@@ -142,7 +167,7 @@ void Copter::motors_output()
     if (g2.afs.should_crash_vehicle()) {
         g2.afs.terminate_vehicle();
         if (!g2.afs.terminating_vehicle_via_landing()) {
-            return;
+            return false;
         }
         // landing must continue to run the motors output
     }
@@ -174,16 +199,23 @@ void Copter::motors_output()
         LOGGER_WRITE_EVENT(LogEvent::MOTORS_INTERLOCK_DISABLED);
     }
 
+    bool thread_output = false;
     if (ap.motor_test) {
         // check if we are performing the motor test
         motor_test_output();
+    } else if (rate_thread_output && flightmode->uses_default_motor_output()) {
+        // the rate thread sends the motor outputs
+        thread_output = true;
     } else {
         // send output signals to motors
+        AP_SCHEDULER_PROFILE_SECTION("motors_output");
         flightmode->output_to_motors();
     }
 
     // push all channels
     srv.push();
+
+    return thread_output;
 }
 
 // check for pilot stick input to trigger lost vehicle alarm
@@ -0,0 +1,167 @@
+#include "Copter.h"
+
+#if AP_COPTER_RATE_THREAD_ENABLED
+
+/*************************************************************
+ *  rate controller thread
+ *
+ *  When FSTRATE_ENABLE is set the rate controller and motor output
+ *  run in their own thread, woken by each filtered gyro sample, rather
+ *  than in the main loop. The main loop still runs the attitude and
+ *  position controllers and the EKF, at SCHED_LOOP_RATE, and hands the
+ *  rate targets to the thread in motors_output_main(). Everything else
+ *  sent to the outputs, the aux servos, motor test and the advanced
+ *  failsafe, stays in the main loop.
+ *
+ *  Flight modes run without the lock and only write main loop state:
+ *  the attitude controller targets and rate PID resets, which are
+ *  copied for the thread at the handoff, and the motor throttle, spool
+ *  and lateral inputs, which are single values the thread only reads.
+ ****************************************************************/
+
+// longest wait for a gyro sample before running on the latest gyro
+#define RATE_THREAD_SAMPLE_TIMEOUT_US 5000U
+
+// start the rate thread, called at the end of init_ardupilot() before
+// the scheduler runs so the main loop never runs the rate controller
+// at the same time
+void Copter::rate_controller_thread_start()
+{
+    if (g2.fast_rate_enable == 0) {
+        return;
+    }
+    if (!ins.enable_rate_loop_buffer(MAX(g2.fast_rate_div.get(), 1))) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Rate thread: no memory");
+        return;
+    }
+    using_rate_thread = true;
+    // the thread owns the rate PIDs, so resets from the main loop are
+    // handed to it with the rate targets
+    attitude_control->set_rate_reset_deferred(true);
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&Copter::rate_controller_thread, void),
+                                      "rate",
+                                      AP_COPTER_RATE_THREAD_STACK_SIZE, AP_HAL::Scheduler::PRIORITY_RCOUT, 1)) {
+        using_rate_thread = false;
+        attitude_control->set_rate_reset_deferred(false);
+        ins.disable_rate_loop_buffer();
+        gcs().send_text(MAV_SEVERITY_WARNING, "Rate thread: failed to start");
+    }
+}
+
+void Copter::rate_controller_thread()
+{
+    uint32_t last_filtered_us = 0;
+    uint32_t last_notch_update_ms = 0;
+
+    while (true) {
+        Vector3f gyro;
+        AP_InertialSensor::GyroSampleTime gyro_time;
+        const bool have_sample = ins.get_next_gyro_sample(gyro, gyro_time, RATE_THREAD_SAMPLE_TIMEOUT_US);
+        if (!have_sample) {
+            // no sample from the primary gyro, it may have changed or
+            // failed. Keep flying on the latest gyro from any IMU
+            gyro = ins.get_gyro();
+            gyro_time.sample_us = gyro_time.filtered_us = AP_HAL::micros();
+        }
+
+        // the loop time is taken from the gyro samples so the rate
+        // controller's derivative and filters see the sensor timing
+        const float nominal_dt = float(ins.rate_loop_buffer_decimation()) / MAX(ins.get_raw_gyro_rate_hz(), 1U);
+        float dt = nominal_dt;
+        if (last_filtered_us != 0) {
+            dt = constrain_float((gyro_time.filtered_us - last_filtered_us) * 1.0e-6f, 0.5f * nominal_dt, 4.0f * nominal_dt);
+        }
+
+        WITH_SEMAPHORE(rate_thread.sem);
+
+        if (!have_sample) {
+            rate_thread.timeouts++;
+        }
+
+        // the main loop drives the motors in motor test, compassmot,
+        // modes with their own output and before the first handoff
+        if (!rate_thread.drive_motors) {
+            last_filtered_us = 0;
+            continue;
+        }
+        last_filtered_us = gyro_time.filtered_us;
+
+        motors->set_dt(dt);
+        if (have_sample) {
+            AP_SCHEDULER_GYRO_LATENCY_START(gyro_time.sample_us, gyro_time.filtered_us);
+        }
+        attitude_control->rate_controller_run_dt(gyro + rate_thread.gyro_drift, dt, rate_thread.inputs);
+
+        // only the motor channels change here, the main loop pushes
+        // the rest of the outputs
+        hal.rcout->cork();
+        motors->output();
+        hal.rcout->push();
+        AP_SCHEDULER_GYRO_LATENCY_MARK(PUSH);
+
+        const uint32_t latency_us = AP_HAL::micros() - gyro_time.sample_us;
+        rate_thread.count++;
+        rate_thread.dt_sum += dt;
+        rate_thread.dt_max = MAX(rate_thread.dt_max, dt);
+        rate_thread.latency_sum_us += latency_us;
+        rate_thread.latency_max_us = MAX(rate_thread.latency_max_us, latency_us);
+
+        // slowly update the rate PID notches with the rate they run at
+        const uint32_t now_ms = AP_HAL::millis();
+        if (now_ms - last_notch_update_ms >= 1000) {
+            last_notch_update_ms = now_ms;
+            attitude_control->set_notch_sample_rate(1.0f / nominal_dt);
+        }
+    }
+}
+
+#if HAL_LOGGING_ENABLED
+// log the rate thread loop time and the latency from the gyro sample
+// to the motor output, called at 1Hz from the main loop
+void Copter::Log_Write_Rate_Thread()
+{
+    if (!using_rate_thread) {
+        return;
+    }
+
+    WITH_SEMAPHORE(rate_thread.sem);
+
+    auto &s = rate_thread;
+    if (s.count > 0 && should_log(MASK_LOG_PM)) {
+// @LoggerMessage: RTDT
+// @Description: Rate thread timing
+// @Field: TimeUS: Time since system startup
+// @Field: Rate: rate controller loops per second
+// @Field: DtAvg: average loop time
+// @Field: DtMax: longest loop time
+// @Field: LatAvg: average time from the gyro sample arriving from the sensor to the motor output
+// @Field: LatMax: longest time from the gyro sample arriving from the sensor to the motor output
+// @Field: Drop: gyro samples not used by the rate controller
+// @Field: TOut: waits for a gyro sample that timed out
+        AP::logger().WriteStreaming(
+            "RTDT",
+            "TimeUS," "Rate," "DtAvg," "DtMax," "LatAvg," "LatMax," "Drop," "TOut",
+            "s"       "z"     "s"      "s"      "s"       "s"       "-"     "-",
+            "F"       "-"     "0"      "0"      "F"       "F"       "-"     "-",
+            "Q"       "H"     "f"      "f"      "I"       "I"       "I"     "H",
+            AP_HAL::micros64(),
+            uint16_t(s.count),
+            s.dt_sum / s.count,
+            s.dt_max,
+            uint32_t(s.latency_sum_us / s.count),
+            s.latency_max_us,
+            ins.get_rate_loop_dropped_samples(),
+            uint16_t(s.timeouts)
+        );
+    }
+
+    s.count = 0;
+    s.dt_sum = 0;
+    s.dt_max = 0;
+    s.latency_sum_us = 0;
+    s.latency_max_us = 0;
+    s.timeouts = 0;
+}
+#endif
+
+#endif // AP_COPTER_RATE_THREAD_ENABLED
@@ -202,6 +202,11 @@ void Copter::init_ardupilot()
     vel_variance_filt.set_cutoff_frequency(g2.fs_ekf_filt_hz);
     hgt_variance_filt.set_cutoff_frequency(g2.fs_ekf_filt_hz);
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // run the rate controller from the gyro samples if enabled
+    rate_controller_thread_start();
+#endif
+
     // flag that initialisation has completed
     ap.initialised = true;
 }
@@ -1,5 +1,5 @@
 #include "DataFlashFileReader.h"
-#include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Math/AP_Math.h>
 
 #include <fcntl.h>
 #include <string.h>
@@ -19,21 +19,151 @@ AP_LoggerFileReader::AP_LoggerFileReader()
 AP_LoggerFileReader::~AP_LoggerFileReader()
 {
     ::printf("Replay counts: %" PRIu64 " bytes  %u entries\n", bytes_read, message_count);
+    delete[] compressed.chunk;
+    delete[] compressed.raw;
+    delete[] compressed.index;
 }
 
+/*
+  logs are read with the host's POSIX calls rather than AP_Filesystem,
+  as compressed logs are seeked by 64 bit offsets and AP_Filesystem
+  lseek() is limited to 2GB
+ */
 bool AP_LoggerFileReader::open_log(const char *logfile)
 {
-    fd = AP::FS().open(logfile, O_RDONLY);
+    fd = ::open(logfile, O_RDONLY|O_CLOEXEC);
     if (fd == -1) {
         return false;
     }
+
+    // check for a compressed log
+    AP_Logger_Compress::FileHeader hdr;
+    if (::read(fd, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+        hdr.magic == AP_Logger_Compress::FILE_MAGIC) {
+        if (hdr.version != AP_Logger_Compress::VERSION ||
+            hdr.chunk_size == 0 ||
+            hdr.chunk_size > AP_Logger_Compress::MAX_CHUNK_SIZE) {
+            ::printf("Unsupported compressed log version %u\n", unsigned(hdr.version));
+            return false;
+        }
+        compressed.active = true;
+        compressed.chunk_size = hdr.chunk_size;
+        compressed.chunk = new uint8_t[hdr.chunk_size];
+        compressed.raw = new uint8_t[hdr.chunk_size];
+        if (!read_index()) {
+            ::printf("Compressed log has no chunk index, reading sequentially\n");
+        }
+        return ::lseek(fd, sizeof(hdr), SEEK_SET) == off_t(sizeof(hdr));
+    }
+    return ::lseek(fd, 0, SEEK_SET) == 0;
+}
+
+/*
+  load the chunk index written when a compressed log is closed. A log
+  that wasn't closed cleanly has no index and is read sequentially
+ */
+bool AP_LoggerFileReader::read_index()
+{
+    AP_Logger_Compress::IndexFooter footer;
+    const off_t file_size = ::lseek(fd, 0, SEEK_END);
+    if (file_size < off_t(sizeof(AP_Logger_Compress::FileHeader) + sizeof(footer)) ||
+        ::lseek(fd, file_size - sizeof(footer), SEEK_SET) != off_t(file_size - sizeof(footer)) ||
+        ::read(fd, &footer, sizeof(footer)) != sizeof(footer) ||
+        footer.magic != AP_Logger_Compress::INDEX_MAGIC ||
+        footer.num_entries == 0 ||
+        footer.index_offset + uint64_t(footer.num_entries) * sizeof(AP_Logger_Compress::IndexEntry) + sizeof(footer) != uint64_t(file_size)) {
+        return false;
+    }
+    const ssize_t index_bytes = footer.num_entries * sizeof(AP_Logger_Compress::IndexEntry);
+    compressed.index = new AP_Logger_Compress::IndexEntry[footer.num_entries];
+    if (::lseek(fd, footer.index_offset, SEEK_SET) != off_t(footer.index_offset) ||
+        ::read(fd, compressed.index, index_bytes) != index_bytes) {
+        delete[] compressed.index;
+        compressed.index = nullptr;
+        return false;
+    }
+    compressed.index_len = footer.num_entries;
+    return true;
+}
+
+/*
+  read the next chunk of a compressed log. With a chunk index each
+  chunk is read from its indexed position, so a corrupt chunk is
+  skipped rather than ending the log
+ */
+bool AP_LoggerFileReader::read_chunk()
+{
+    if (compressed.index == nullptr) {
+        return load_chunk();
+    }
+    while (compressed.next_chunk < compressed.index_len) {
+        const uint64_t file_offset = compressed.index[compressed.next_chunk++].file_offset;
+        if (::lseek(fd, file_offset, SEEK_SET) == off_t(file_offset) &&
+            load_chunk()) {
+            return true;
+        }
+        ::printf("skipping compressed chunk at %" PRIu64 "\n", file_offset);
+        compressed.skipped_chunk = true;
+    }
+    return false;
+}
+
+/*
+  read and decompress the chunk at the current file position
+ */
+bool AP_LoggerFileReader::load_chunk()
+{
+    AP_Logger_Compress::ChunkHeader hdr;
+    if (::read(fd, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+        hdr.magic != AP_Logger_Compress::CHUNK_MAGIC) {
+        // end of the log, or the start of the chunk index
+        return false;
+    }
+    if (hdr.raw_len > compressed.chunk_size ||
+        hdr.compressed_len > hdr.raw_len) {
+        ::printf("bad compressed chunk at %" PRIu64 "\n", hdr.raw_offset);
+        return false;
+    }
+    if (::read(fd, compressed.chunk, hdr.compressed_len) != ssize_t(hdr.compressed_len)) {
+        return false;
+    }
+    if (crc_crc32(0, compressed.chunk, hdr.compressed_len) != hdr.crc) {
+        ::printf("compressed chunk crc error at %" PRIu64 "\n", hdr.raw_offset);
+        return false;
+    }
+    if (hdr.compressed_len == hdr.raw_len) {
+        // chunk stored uncompressed
+        memcpy(compressed.raw, compressed.chunk, hdr.raw_len);
+    } else if (AP_Logger_Compress::decompress(compressed.chunk, hdr.compressed_len,
+                                              compressed.raw, hdr.raw_len) != int32_t(hdr.raw_len)) {
+        ::printf("corrupt compressed chunk at %" PRIu64 "\n", hdr.raw_offset);
+        return false;
+    }
+    compressed.raw_len = hdr.raw_len;
+    compressed.raw_pos = 0;
     return true;
 }
 
 ssize_t AP_LoggerFileReader::read_input(void *buffer, const size_t count)
 {
-    uint64_t ret = AP::FS().read(fd, buffer, count);
-    bytes_read += ret;
+    if (compressed.active) {
+        size_t ret = 0;
+        while (ret < count) {
+            if (compressed.raw_pos == compressed.raw_len && !read_chunk()) {
+                break;
+            }
+            const uint32_t n = MIN(count - ret, size_t(compressed.raw_len - compressed.raw_pos));
+            memcpy((uint8_t *)buffer + ret, &compressed.raw[compressed.raw_pos], n);
+            compressed.raw_pos += n;
+            ret += n;
+        }
+        bytes_read += ret;
+        return ret;
+    }
+    const ssize_t ret = ::read(fd, buffer, count);
+    if (ret > 0) {
+        bytes_read += ret;
+    }
     return ret;
 }
 
@@ -57,6 +187,18 @@ bool AP_LoggerFileReader::update()
     if (read_input(hdr, 3) != 3) {
         return false;
     }
+    if (compressed.skipped_chunk) {
+        // the message at the chunk boundary was lost with the corrupt
+        // chunk, look for the start of the next one
+        while (hdr[0] != HEAD_BYTE1 || hdr[1] != HEAD_BYTE2 || formats[hdr[2]].length == 0) {
+            hdr[0] = hdr[1];
+            hdr[1] = hdr[2];
+            if (read_input(&hdr[2], 1) != 1) {
+                return false;
+            }
+        }
+        compressed.skipped_chunk = false;
+    }
     if (hdr[0] != HEAD_BYTE1 || hdr[1] != HEAD_BYTE2) {
         printf("bad log header\n");
         return false;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Logger/AP_Logger_Compress.h>
 
 #define LOGREADER_MAX_FORMATS 255 // must be >= highest MESSAGE
 
@@ -28,6 +29,24 @@ protected:
 private:
     ssize_t read_input(void *buf, size_t count);
 
+    // state for logs written with LOG_FILE_COMPRESS
+    struct {
+        bool active;
+        uint32_t chunk_size;
+        uint8_t *chunk;         // compressed chunk data
+        uint8_t *raw;           // decompressed chunk data
+        uint32_t raw_len;
+        uint32_t raw_pos;
+        // chunk index from the end of the file, if it has one
+        AP_Logger_Compress::IndexEntry *index;
+        uint32_t index_len;
+        uint32_t next_chunk;    // index of the chunk read_chunk() reads next
+        bool skipped_chunk;     // a corrupt chunk was skipped, find the next message
+    } compressed {};
+    bool read_index();
+    bool read_chunk();
+    bool load_chunk();
+
     uint64_t bytes_read = 0;
     uint32_t message_count = 0;
     uint64_t start_micros;
@@ -3,6 +3,8 @@
 #include "MsgHandler.h"
 #include "Replay.h"
 
+#include <AP_InertialSensor/AP_InertialSensor_DeltaLog.h>
+
 #include <stdio.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -133,7 +135,66 @@ bool LogReader::handle_log_format_msg(const struct log_Format &f)
     return true;
 }
 
+/*
+  find the message type for a format name in the log, returning -1
+  if the log doesn't define it
+ */
+int16_t LogReader::find_format(const char *name) const
+{
+    for (uint16_t i=0; i<LOGREADER_MAX_FORMATS; i++) {
+        if (formats[i].length != 0 && strncmp(formats[i].name, name, sizeof(formats[i].name)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+  write a delta encoded ACCD or GYRD message out as the equivalent
+  ACC or GYR messages, returning false if it is not one we can expand
+ */
+bool LogReader::expand_delta(const struct log_Format &f, const uint8_t *msg)
+{
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+    const bool is_gyro = strncmp(f.name, "GYRD", sizeof(f.name)) == 0;
+    if (!is_gyro && strncmp(f.name, "ACCD", sizeof(f.name)) != 0) {
+        return false;
+    }
+    // ACC and GYR share a layout, so both are written as log_GYR
+    static_assert(sizeof(log_ACC) == sizeof(log_GYR), "ACC and GYR must match");
+    const int16_t type = find_format(is_gyro ? "GYR" : "ACC");
+    if (type < 0 || formats[type].length != sizeof(log_GYR) || f.length != sizeof(log_IMUDelta)) {
+        return false;
+    }
+
+    log_IMUDelta pkt;
+    memcpy(&pkt, msg, sizeof(pkt));
+    uint64_t sample_us[AP_InertialSensor_DeltaLog::MAX_SAMPLES];
+    Vector3f samples[AP_InertialSensor_DeltaLog::MAX_SAMPLES];
+    const uint8_t n = AP_InertialSensor_DeltaLog::decode(pkt, is_gyro ? LOG_GYRD_RESOLUTION : LOG_ACCD_RESOLUTION, sample_us, samples);
+    for (uint8_t i=0; i<n; i++) {
+        const struct log_GYR out {
+            LOG_PACKET_HEADER_INIT(uint8_t(type)),
+            time_us   : sample_us[i],
+            instance  : pkt.instance,
+            sample_us : sample_us[i],
+            GyrX      : samples[i].x,
+            GyrY      : samples[i].y,
+            GyrZ      : samples[i].z
+        };
+        AP::logger().WriteBlock(&out, sizeof(out));
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
 bool LogReader::handle_msg(const struct log_Format &f, uint8_t *msg) {
+    if (replay_expand_delta && expand_delta(f, msg)) {
+        return true;
+    }
+
     // emit the output as we receive it:
     AP::logger().WriteBlock(msg, f.length);
 
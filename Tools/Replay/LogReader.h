@@ -30,6 +30,9 @@ private:
     struct LogStructure *_log_structure;
     uint8_t _log_structure_count;
 
+    int16_t find_format(const char *name) const;
+    bool expand_delta(const struct log_Format &f, const uint8_t *msg);
+
     class LR_MsgHandler *msgparser[LOGREADER_MAX_FORMATS] {};
 };
 
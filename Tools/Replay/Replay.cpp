@@ -39,6 +39,7 @@ static ReplayVehicle replayvehicle;
 user_parameter *user_parameters;
 bool replay_force_ekf2;
 bool replay_force_ekf3;
+bool replay_expand_delta;
 
 const AP_Param::Info ReplayVehicle::var_info[] = {
     GSCALAR(dummy,         "_DUMMY", 0),
@@ -130,11 +131,13 @@ void Replay::usage(void)
     ::printf("\t--param-file FILENAME  load parameters from a file\n");
     ::printf("\t--force-ekf2 force enable EKF2\n");
     ::printf("\t--force-ekf3 force enable EKF3\n");
+    ::printf("\t--expand-delta write ACCD/GYRD messages out as ACC/GYR messages\n");
 }
 
 enum param_key : uint8_t {
     FORCE_EKF2 = 1,
     FORCE_EKF3,
+    EXPAND_DELTA,
 };
 
 void Replay::_parse_command_line(uint8_t argc, char * const argv[])
@@ -146,6 +149,7 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"param-file",      true,   0, 'F'},
         {"force-ekf2",      false,  0, param_key::FORCE_EKF2},
         {"force-ekf3",      false,  0, param_key::FORCE_EKF3},
+        {"expand-delta",    false,  0, param_key::EXPAND_DELTA},
         {"help",            false,  0, 'h'},
         {0, false, 0, 0}
     };
@@ -181,6 +185,10 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             replay_force_ekf3 = true;
             break;
 
+        case param_key::EXPAND_DELTA:
+            replay_expand_delta = true;
+            break;
+
         case 'h':
         default:
             usage();
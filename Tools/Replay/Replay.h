@@ -30,6 +30,7 @@ struct user_parameter {
 extern user_parameter *user_parameters;
 extern bool replay_force_ekf2;
 extern bool replay_force_ekf3;
+extern bool replay_expand_delta;
 
 class ReplayVehicle : public AP_Vehicle {
 public:
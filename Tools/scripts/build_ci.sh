@@ -531,6 +531,13 @@ for t in $CI_BUILD_TARGET; do
         continue
     fi
 
+    if [ "$t" == "ekf3_generated_kernels" ]; then
+        echo "Checking EKF3 generated kernels"
+        python3 -m pip install sympy==1.14.0 --progress-bar off --cache-dir /tmp/pip-cache --user
+        (cd libraries/AP_NavEKF3/derivation && ./generate_kernels.py --check)
+        continue
+    fi
+
     if [ "$t" == "logger_metadata" ]; then
         for v in Rover Tracker Copter Plane Sub Blimp; do
             python3 Tools/autotest/logger_metadata/parse.py --vehicle $v
@@ -230,30 +230,67 @@ void AC_AttitudeControl::relax_attitude_controllers()
     // Initialize remaining variables
     _thrust_error_angle = 0.0f;
 
-    // Reset the PID filters
-    get_rate_roll_pid().reset_filter();
-    get_rate_pitch_pid().reset_filter();
-    get_rate_yaw_pid().reset_filter();
-
-    // Reset the I terms
-    reset_rate_controller_I_terms();
+    // Reset the PID filters and I terms
+    request_rate_reset(RateReset::FILTERS_AND_I);
     // finally update the attitude target
     _ang_vel_body = gyro;
 }
 
+// take a copy of the rate controller targets
+void AC_AttitudeControl::get_rate_controller_inputs(RateControllerInputs &inputs) const
+{
+    inputs.ang_vel_body = _ang_vel_body;
+    inputs.sysid_ang_vel_body = _sysid_ang_vel_body;
+    inputs.actuator_sysid = _actuator_sysid;
+    inputs.pd_scale = _pd_scale;
+    inputs.reset = _rate_reset;
+}
+
+// apply a rate PID reset now, or keep the largest reset requested for
+// the next rate controller inputs if resets are deferred
+void AC_AttitudeControl::request_rate_reset(RateReset reset)
+{
+    if (!_rate_reset_deferred) {
+        apply_rate_reset(reset, _dt);
+        return;
+    }
+    if (reset > _rate_reset) {
+        _rate_reset = reset;
+    }
+}
+
+void AC_AttitudeControl::apply_rate_reset(RateReset reset, float dt)
+{
+    switch (reset) {
+    case RateReset::NONE:
+        break;
+    case RateReset::RELAX_I:
+        get_rate_roll_pid().relax_integrator(0.0, dt, AC_ATTITUDE_RATE_RELAX_TC);
+        get_rate_pitch_pid().relax_integrator(0.0, dt, AC_ATTITUDE_RATE_RELAX_TC);
+        get_rate_yaw_pid().relax_integrator(0.0, dt, AC_ATTITUDE_RATE_RELAX_TC);
+        break;
+    case RateReset::FILTERS_AND_I:
+        get_rate_roll_pid().reset_filter();
+        get_rate_pitch_pid().reset_filter();
+        get_rate_yaw_pid().reset_filter();
+        FALLTHROUGH;
+    case RateReset::I:
+        get_rate_roll_pid().reset_I();
+        get_rate_pitch_pid().reset_I();
+        get_rate_yaw_pid().reset_I();
+        break;
+    }
+}
+
 void AC_AttitudeControl::reset_rate_controller_I_terms()
 {
-    get_rate_roll_pid().reset_I();
-    get_rate_pitch_pid().reset_I();
-    get_rate_yaw_pid().reset_I();
+    request_rate_reset(RateReset::I);
 }
 
 // reset rate controller I terms smoothly to zero in 0.5 seconds
 void AC_AttitudeControl::reset_rate_controller_I_terms_smoothly()
 {
-    get_rate_roll_pid().relax_integrator(0.0, _dt, AC_ATTITUDE_RATE_RELAX_TC);
-    get_rate_pitch_pid().relax_integrator(0.0, _dt, AC_ATTITUDE_RATE_RELAX_TC);
-    get_rate_yaw_pid().relax_integrator(0.0, _dt, AC_ATTITUDE_RATE_RELAX_TC);
+    request_rate_reset(RateReset::RELAX_I);
 }
 
 // Reduce attitude control gains while landed to stop ground resonance
@@ -247,6 +247,37 @@ public:
     // optional variant to allow running with different dt
     virtual void rate_controller_run_dt(const Vector3f& gyro, float dt) { AP_BoardConfig::config_error("rate_controller_run_dt() must be defined"); };
 
+    // resets of the rate PIDs, in increasing order of effect
+    enum class RateReset : uint8_t {
+        NONE = 0,
+        RELAX_I,                        // relax the integrators towards zero
+        I,                              // zero the integrators
+        FILTERS_AND_I,                  // reset the filters and zero the integrators
+    };
+
+    // the targets the rate controller runs on, for handing from the
+    // attitude controllers to a rate controller run on another thread
+    struct RateControllerInputs {
+        Vector3f ang_vel_body;          // rate target in rad/s
+        Vector3f sysid_ang_vel_body;    // system identification rate input in rad/s
+        Vector3f actuator_sysid;        // system identification actuator input
+        Vector3f pd_scale;              // PD gain scaling for this loop
+        RateReset reset;                // rate PID reset requested since the last handoff
+    };
+    void get_rate_controller_inputs(RateControllerInputs &inputs) const;
+
+    // run the rate controller on targets taken with get_rate_controller_inputs()
+    virtual void rate_controller_run_dt(const Vector3f& gyro, float dt, const RateControllerInputs &inputs) { AP_BoardConfig::config_error("rate_controller_run_dt() must be defined"); };
+
+    // update the gain scaling and throttle mix the rate controller uses,
+    // called once per attitude controller update before the rate
+    // controller inputs are taken
+    virtual void update_rate_controller_inputs(float dt) {}
+
+    // pass rate PID resets to the rate controller in its inputs rather
+    // than applying them immediately, for when it runs on another thread
+    void set_rate_reset_deferred(bool deferred) { _rate_reset_deferred = deferred; }
+
     // Convert a 321-intrinsic euler angle derivative to an angular velocity vector
     void euler_rate_to_ang_vel(const Quaternion& att, const Vector3f& euler_rate_rads, Vector3f& ang_vel_rads);
 
@@ -604,6 +635,17 @@ protected:
     // PD scale used for last loop, used for logging
     Vector3f            _pd_scale_used;
 
+    // rate PID reset requested since the rate controller inputs were
+    // last taken, when resets are deferred
+    RateReset           _rate_reset;
+    bool                _rate_reset_deferred;
+
+    // apply or defer a rate PID reset
+    void request_rate_reset(RateReset reset);
+
+    // reset the rate PIDs, dt is the time since the last reset for RELAX_I
+    void apply_rate_reset(RateReset reset, float dt);
+
     // ratio of normal gain to landed gain
     float               _landed_gain_ratio;
 
@@ -412,15 +412,15 @@ void AC_AttitudeControl_Multi::update_throttle_gain_boost()
 }
 
 // update_throttle_rpy_mix - slew set_throttle_rpy_mix to requested value
-void AC_AttitudeControl_Multi::update_throttle_rpy_mix()
+void AC_AttitudeControl_Multi::update_throttle_rpy_mix(float dt)
 {
     // slew _throttle_rpy_mix to _throttle_rpy_mix_desired
     if (_throttle_rpy_mix < _throttle_rpy_mix_desired) {
         // increase quickly (i.e. from 0.1 to 0.9 in 0.4 seconds)
-        _throttle_rpy_mix += MIN(2.0f * _dt, _throttle_rpy_mix_desired - _throttle_rpy_mix);
+        _throttle_rpy_mix += MIN(2.0f * dt, _throttle_rpy_mix_desired - _throttle_rpy_mix);
     } else if (_throttle_rpy_mix > _throttle_rpy_mix_desired) {
         // reduce more slowly (from 0.9 to 0.1 in 1.6 seconds)
-        _throttle_rpy_mix -= MIN(0.5f * _dt, _throttle_rpy_mix - _throttle_rpy_mix_desired);
+        _throttle_rpy_mix -= MIN(0.5f * dt, _throttle_rpy_mix - _throttle_rpy_mix_desired);
 
         // if the mix is still higher than that being used, reset immediately
         const float throttle_hover = _motors.get_throttle_hover();
@@ -439,34 +439,54 @@ void AC_AttitudeControl_Multi::update_throttle_rpy_mix()
     _throttle_rpy_mix = constrain_float(_throttle_rpy_mix, 0.1f, AC_ATTITUDE_CONTROL_MAX);
 }
 
-void AC_AttitudeControl_Multi::rate_controller_run_dt(const Vector3f& gyro, float dt)
+// update the state the rate controller inputs are taken from. When
+// the rate controller runs on another thread this is called by the
+// main loop before each handoff, so the thread writes none of it
+void AC_AttitudeControl_Multi::update_rate_controller_inputs(float dt)
 {
-    // take a copy of the target so that it can't be changed from under us.
-    Vector3f ang_vel_body = _ang_vel_body;
-
     // boost angle_p/pd each cycle on high throttle slew
     update_throttle_gain_boost();
 
-    // move throttle vs attitude mixing towards desired (called from here because this is conveniently called on every iteration)
-    update_throttle_rpy_mix();
+    // move throttle vs attitude mixing towards desired
+    update_throttle_rpy_mix(dt);
+}
 
-    ang_vel_body += _sysid_ang_vel_body;
+void AC_AttitudeControl_Multi::rate_controller_run_dt(const Vector3f& gyro, float dt)
+{
+    update_rate_controller_inputs(dt);
+
+    RateControllerInputs inputs;
+    get_rate_controller_inputs(inputs);
+    rate_controller_run_dt(gyro, dt, inputs);
+}
+
+// the inputs may be used for several runs, so a requested relax is
+// applied on each run using its dt and a reset holds the integrators
+// at zero until the next handoff
+void AC_AttitudeControl_Multi::rate_controller_run_dt(const Vector3f& gyro, float dt, const RateControllerInputs &inputs)
+{
+    apply_rate_reset(inputs.reset, dt);
+
+    const Vector3f ang_vel_body = inputs.ang_vel_body + inputs.sysid_ang_vel_body;
+    const Vector3f &pd_scale = inputs.pd_scale;
 
     _rate_gyro = gyro;
     _rate_gyro_time_us = AP_HAL::micros64();
 
-    _motors.set_roll(get_rate_roll_pid().update_all(ang_vel_body.x, gyro.x,  dt, _motors.limit.roll, _pd_scale.x) + _actuator_sysid.x);
+    _motors.set_roll(get_rate_roll_pid().update_all(ang_vel_body.x, gyro.x,  dt, _motors.limit.roll, pd_scale.x) + inputs.actuator_sysid.x);
     _motors.set_roll_ff(get_rate_roll_pid().get_ff());
 
-    _motors.set_pitch(get_rate_pitch_pid().update_all(ang_vel_body.y, gyro.y,  dt, _motors.limit.pitch, _pd_scale.y) + _actuator_sysid.y);
+    _motors.set_pitch(get_rate_pitch_pid().update_all(ang_vel_body.y, gyro.y,  dt, _motors.limit.pitch, pd_scale.y) + inputs.actuator_sysid.y);
     _motors.set_pitch_ff(get_rate_pitch_pid().get_ff());
 
-    _motors.set_yaw(get_rate_yaw_pid().update_all(ang_vel_body.z, gyro.z,  dt, _motors.limit.yaw, _pd_scale.z) + _actuator_sysid.z);
+    _motors.set_yaw(get_rate_yaw_pid().update_all(ang_vel_body.z, gyro.z,  dt, _motors.limit.yaw, pd_scale.z) + inputs.actuator_sysid.z);
     _motors.set_yaw_ff(get_rate_yaw_pid().get_ff()*_feedforward_scalar);
 
-    _pd_scale_used = _pd_scale;
+    _pd_scale_used = pd_scale;
 
     control_monitor_update();
+
+    AP_SCHEDULER_GYRO_LATENCY_MARK(RATE);
 }
 
 // reset the rate controller target loop updates
@@ -475,6 +495,7 @@ void AC_AttitudeControl_Multi::rate_controller_target_reset()
     _sysid_ang_vel_body.zero();
     _actuator_sysid.zero();
     _pd_scale = VECTORF_111;
+    _rate_reset = RateReset::NONE;
 }
 
 // run the rate controller using the configured _dt and latest gyro
@@ -77,6 +77,8 @@ public:
 
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run_dt(const Vector3f& gyro, float dt) override;
+    // run on targets taken with get_rate_controller_inputs()
+    void rate_controller_run_dt(const Vector3f& gyro, float dt, const RateControllerInputs &inputs) override;
     void rate_controller_target_reset() override;
     void rate_controller_run() override;
 
@@ -86,6 +88,9 @@ public:
     // set the PID notch sample rates
     void set_notch_sample_rate(float sample_rate) override;
 
+    // apply the throttle gain boost and slew the throttle mix
+    void update_rate_controller_inputs(float dt) override;
+
     // user settable parameters
     static const struct AP_Param::GroupInfo var_info[];
 
@@ -95,7 +100,7 @@ protected:
     void update_throttle_gain_boost();
 
     // update_throttle_rpy_mix - updates thr_low_comp value towards the target
-    void update_throttle_rpy_mix();
+    void update_throttle_rpy_mix(float dt);
 
     // get maximum value throttle can be raised to based on throttle vs attitude prioritisation
     float get_throttle_avg_max(float throttle_in);
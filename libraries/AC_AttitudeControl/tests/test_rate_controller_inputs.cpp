@@ -0,0 +1,152 @@
+#include <AP_gtest.h>
+
+#include <AC_AttitudeControl/AC_AttitudeControl_Multi.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_BattMonitor/AP_BattMonitor.h>
+#include <AP_Motors/AP_MotorsMatrix.h>
+#include <AP_Scheduler/AP_Scheduler.h>
+#include <SRV_Channel/SRV_Channel.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// singletons needed by the motors and attitude controller
+static SRV_Channels srvs;
+static AP_BattMonitor battmonitor{0, nullptr, nullptr};
+static AP_Scheduler scheduler;
+static AP_AHRS ahrs;
+static AP_AHRS_View ahrs_view{ahrs, ROTATION_NONE};
+static AP_MultiCopter aparm;
+
+// motors with a throttle slew rate that can be set directly
+class TestMotors : public AP_MotorsMatrix {
+public:
+    TestMotors() : AP_MotorsMatrix(400) {}
+    void set_throttle_slew_rate(float rate) { _throttle_slew_rate = rate; }
+};
+
+// attitude controller with access to the boost parameter and the
+// scales for the next loop
+class TestAttitudeControl : public AC_AttitudeControl_Multi {
+public:
+    using AC_AttitudeControl_Multi::AC_AttitudeControl_Multi;
+    void set_throttle_gain_boost(float boost) { _throttle_gain_boost.set(boost); }
+    const Vector3f &get_angle_P_scale() const { return _angle_P_scale; }
+    const Vector3f &get_last_pd_scale() const { return _pd_scale_used; }
+};
+
+static TestMotors motors;
+static TestAttitudeControl attitude_control{ahrs_view, aparm, motors};
+
+static const float dt = 0.0025f;
+static const Vector3f unscaled{1.0f, 1.0f, 1.0f};
+
+#define EXPECT_VECTOR3F_EQ(v1, v2)              \
+do {                                            \
+    EXPECT_FLOAT_EQ(v1[0], v2[0]);              \
+    EXPECT_FLOAT_EQ(v1[1], v2[1]);              \
+    EXPECT_FLOAT_EQ(v1[2], v2[2]);              \
+} while (false)
+
+// start each test from a loop with no scaling applied
+static void reset_scales()
+{
+    attitude_control.rate_controller_target_reset();
+    attitude_control.set_angle_P_scale(unscaled);
+}
+
+// the main loop rate controller runs with the boost of its own loop
+TEST(ThrottleGainBoost, MainLoop)
+{
+    reset_scales();
+    attitude_control.set_throttle_gain_boost(0.5f);
+    motors.set_throttle_slew_rate(2 * AC_ATTITUDE_CONTROL_THR_G_BOOST_THRESH);
+
+    attitude_control.rate_controller_run_dt(Vector3f(), dt);
+    EXPECT_VECTOR3F_EQ(Vector3f(1.5f, 1.5f, 1.0f), attitude_control.get_last_pd_scale());
+    EXPECT_VECTOR3F_EQ(Vector3f(2.25f, 2.25f, 1.0f), attitude_control.get_angle_P_scale());
+}
+
+// the boost is limited to doubling PD and quadrupling angle P
+TEST(ThrottleGainBoost, Limits)
+{
+    reset_scales();
+    attitude_control.set_throttle_gain_boost(3.0f);
+    motors.set_throttle_slew_rate(2 * AC_ATTITUDE_CONTROL_THR_G_BOOST_THRESH);
+
+    attitude_control.rate_controller_run_dt(Vector3f(), dt);
+    EXPECT_VECTOR3F_EQ(Vector3f(2.0f, 2.0f, 1.0f), attitude_control.get_last_pd_scale());
+    EXPECT_VECTOR3F_EQ(Vector3f(4.0f, 4.0f, 1.0f), attitude_control.get_angle_P_scale());
+}
+
+// no boost without a rapid throttle change
+TEST(ThrottleGainBoost, SlowThrottle)
+{
+    reset_scales();
+    attitude_control.set_throttle_gain_boost(1.0f);
+    motors.set_throttle_slew_rate(0.5f * AC_ATTITUDE_CONTROL_THR_G_BOOST_THRESH);
+
+    attitude_control.rate_controller_run_dt(Vector3f(), dt);
+    EXPECT_VECTOR3F_EQ(unscaled, attitude_control.get_last_pd_scale());
+    EXPECT_VECTOR3F_EQ(unscaled, attitude_control.get_angle_P_scale());
+}
+
+// a rate controller run several times on one set of inputs, as the
+// rate thread does, applies the boost once
+TEST(ThrottleGainBoost, RateThread)
+{
+    reset_scales();
+    attitude_control.set_throttle_gain_boost(1.0f);
+    motors.set_throttle_slew_rate(2 * AC_ATTITUDE_CONTROL_THR_G_BOOST_THRESH);
+
+    attitude_control.update_rate_controller_inputs(dt);
+    AC_AttitudeControl::RateControllerInputs inputs;
+    attitude_control.get_rate_controller_inputs(inputs);
+    attitude_control.rate_controller_target_reset();
+
+    for (uint8_t i=0; i<4; i++) {
+        attitude_control.rate_controller_run_dt(Vector3f(), dt, inputs);
+        EXPECT_VECTOR3F_EQ(Vector3f(2.0f, 2.0f, 1.0f), attitude_control.get_last_pd_scale());
+        EXPECT_VECTOR3F_EQ(Vector3f(4.0f, 4.0f, 1.0f), attitude_control.get_angle_P_scale());
+    }
+}
+
+// with resets deferred the rate controller applies the resets the
+// main loop requested when it runs on the inputs
+TEST(RateReset, Deferred)
+{
+    reset_scales();
+    AC_PID &pid = attitude_control.get_rate_roll_pid();
+    pid.kI().set(0.1f);
+    pid.kIMAX().set(1.0f);
+    attitude_control.set_rate_reset_deferred(true);
+
+    pid.set_integrator(0.5f);
+    attitude_control.reset_rate_controller_I_terms();
+    EXPECT_FLOAT_EQ(0.5f, pid.get_i());
+    AC_AttitudeControl::RateControllerInputs inputs;
+    attitude_control.get_rate_controller_inputs(inputs);
+    attitude_control.rate_controller_target_reset();
+    attitude_control.rate_controller_run_dt(Vector3f(), dt, inputs);
+    EXPECT_FLOAT_EQ(0.0f, pid.get_i());
+
+    // a relax is applied on each run using the dt of the run
+    pid.set_integrator(0.5f);
+    attitude_control.reset_rate_controller_I_terms_smoothly();
+    attitude_control.get_rate_controller_inputs(inputs);
+    attitude_control.rate_controller_target_reset();
+    float expected = 0.5f;
+    for (uint8_t i=0; i<4; i++) {
+        attitude_control.rate_controller_run_dt(Vector3f(), dt, inputs);
+        expected *= 1.0f - dt / (dt + AC_ATTITUDE_RATE_RELAX_TC);
+        EXPECT_NEAR(expected, pid.get_i(), 1.0e-6f);
+    }
+
+    // the next handoff carries no reset
+    attitude_control.get_rate_controller_inputs(inputs);
+    attitude_control.rate_controller_run_dt(Vector3f(), dt, inputs);
+    EXPECT_NEAR(expected, pid.get_i(), 1.0e-6f);
+
+    attitude_control.set_rate_reset_deferred(false);
+}
+
+AP_GTEST_MAIN()
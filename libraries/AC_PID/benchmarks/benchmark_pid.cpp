@@ -0,0 +1,100 @@
+#include <AP_gbenchmark.h>
+
+#include <AC_PID/AC_PID.h>
+#include <AC_AttitudeControl/AC_AttitudeControl_Multi.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  cost of a multicopter rate controller step, running the three rate
+  PIDs with their default gains and filters at a range of loop rates
+ */
+static AC_PID rate_roll {
+    AC_PID::Defaults{
+        .p         = AC_ATC_MULTI_RATE_RP_P,
+        .i         = AC_ATC_MULTI_RATE_RP_I,
+        .d         = AC_ATC_MULTI_RATE_RP_D,
+        .ff        = 0.0f,
+        .imax      = AC_ATC_MULTI_RATE_RP_IMAX,
+        .filt_T_hz = AC_ATC_MULTI_RATE_RPY_FILT_HZ,
+        .filt_E_hz = 0.0f,
+        .filt_D_hz = AC_ATC_MULTI_RATE_RPY_FILT_HZ,
+        .srmax     = 0,
+        .srtau     = 1.0
+    }
+};
+static AC_PID rate_pitch {
+    AC_PID::Defaults{
+        .p         = AC_ATC_MULTI_RATE_RP_P,
+        .i         = AC_ATC_MULTI_RATE_RP_I,
+        .d         = AC_ATC_MULTI_RATE_RP_D,
+        .ff        = 0.0f,
+        .imax      = AC_ATC_MULTI_RATE_RP_IMAX,
+        .filt_T_hz = AC_ATC_MULTI_RATE_RPY_FILT_HZ,
+        .filt_E_hz = 0.0f,
+        .filt_D_hz = AC_ATC_MULTI_RATE_RPY_FILT_HZ,
+        .srmax     = 0,
+        .srtau     = 1.0
+    }
+};
+static AC_PID rate_yaw {
+    AC_PID::Defaults{
+        .p         = AC_ATC_MULTI_RATE_YAW_P,
+        .i         = AC_ATC_MULTI_RATE_YAW_I,
+        .d         = AC_ATC_MULTI_RATE_YAW_D,
+        .ff        = 0.0f,
+        .imax      = AC_ATC_MULTI_RATE_YAW_IMAX,
+        .filt_T_hz = AC_ATC_MULTI_RATE_RPY_FILT_HZ,
+        .filt_E_hz = AC_ATC_MULTI_RATE_YAW_FILT_HZ,
+        .filt_D_hz = AC_ATC_MULTI_RATE_RPY_FILT_HZ,
+        .srmax     = 0,
+        .srtau     = 1.0
+    }
+};
+
+// 400 loops of targets and gyro samples at the given loop rate,
+// oscillating about a turn
+struct RateInputs {
+    RateInputs(float loop_rate_hz) :
+        dt(1.0f / loop_rate_hz)
+    {
+        for (uint16_t i=0; i<ARRAY_SIZE(target); i++) {
+            const float t = i * dt;
+            target[i] = Vector3f{0.5f, -0.2f, 0.3f} * sinf(M_2PI * 2 * t);
+            gyro[i] = target[i] * 0.9f + Vector3f{0.02f, -0.01f, 0.015f} * sinf(M_2PI * 80 * t);
+        }
+    }
+    const float dt;
+    Vector3f target[400];
+    Vector3f gyro[400];
+};
+
+static void BM_RateControllerStep(benchmark::State& state)
+{
+    const RateInputs in(state.range(0));
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float out[3];
+        out[0] = rate_roll.update_all(in.target[i].x, in.gyro[i].x, in.dt);
+        out[1] = rate_pitch.update_all(in.target[i].y, in.gyro[i].y, in.dt);
+        out[2] = rate_yaw.update_all(in.target[i].z, in.gyro[i].z, in.dt);
+        gbenchmark_escape(out);
+        i = (i + 1) % ARRAY_SIZE(in.target);
+    }
+}
+
+static void BM_PIDUpdateAll(benchmark::State& state)
+{
+    const RateInputs in(400);
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float out = rate_roll.update_all(in.target[i].x, in.gyro[i].x, in.dt);
+        gbenchmark_escape(&out);
+        i = (i + 1) % ARRAY_SIZE(in.target);
+    }
+}
+
+BENCHMARK(BM_RateControllerStep)->Arg(400)->Arg(2000)->Arg(8000);
+BENCHMARK(BM_PIDUpdateAll);
+
+BENCHMARK_MAIN();
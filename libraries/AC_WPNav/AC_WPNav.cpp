@@ -335,21 +335,8 @@ bool AC_WPNav::set_wp_destination(const Vector3f& destination, bool terrain_alt)
     _destination = destination;
     _terrain_alt = terrain_alt;
 
-    if (_flags.fast_waypoint && !_this_leg_is_spline && !_next_leg_is_spline && !_scurve_next_leg.finished()) {
-        _scurve_this_leg = _scurve_next_leg;
-    } else {
-        _scurve_this_leg.calculate_track(_origin, _destination,
-                                         _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                         get_wp_acceleration(), _wp_accel_z_cmss,
-                                         _scurve_snap * 100.0f, _scurve_jerk * 100.0f);
-        if (!is_zero(origin_speed)) {
-            // rebuild start of scurve if we have a non-zero origin speed
-            _scurve_this_leg.set_origin_speed_max(origin_speed);
-        }
-    }
+    calc_scurve_this_leg(get_leg_limits(), _scurve_snap * 100.0f, _scurve_jerk * 100.0f, origin_speed, _flags.fast_waypoint);
 
-    _this_leg_is_spline = false;
-    _scurve_next_leg.init();
     _next_destination.zero();       // clear next destination
     _flags.fast_waypoint = false;   // default waypoint back to slow
     _flags.reached_destination = false;
@@ -367,16 +354,7 @@ bool AC_WPNav::set_wp_destination_next(const Vector3f& destination, bool terrain
         return true;
     }
 
-    _scurve_next_leg.calculate_track(_destination, destination,
-                                     _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                     get_wp_acceleration(), _wp_accel_z_cmss,
-                                     _scurve_snap * 100.0f, _scurve_jerk * 100.0);
-    if (_this_leg_is_spline) {
-        const float this_leg_dest_speed_max = _spline_this_leg.get_destination_speed_max();
-        const float next_leg_origin_speed_max = _scurve_next_leg.set_origin_speed_max(this_leg_dest_speed_max);
-        _spline_this_leg.set_destination_speed_max(next_leg_origin_speed_max);
-    }
-    _next_leg_is_spline = false;
+    calc_scurve_next_leg(destination, get_leg_limits(), _scurve_snap * 100.0f, _scurve_jerk * 100.0f);
 
     // next destination provided so fast waypoint
     _flags.fast_waypoint = true;
@@ -558,21 +536,7 @@ bool AC_WPNav::advance_wp_target_along_track(float dt)
 /// recalculate path with update speed and/or acceleration limits
 void AC_WPNav::update_track_with_speed_accel_limits()
 {
-    // update this leg
-    if (_this_leg_is_spline) {
-        _spline_this_leg.set_speed_accel(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                         get_wp_acceleration(), _wp_accel_z_cmss);
-    } else {
-        _scurve_this_leg.set_speed_max(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms());
-    }
-
-    // update next leg
-    if (_next_leg_is_spline) {
-        _spline_next_leg.set_speed_accel(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                         get_wp_acceleration(), _wp_accel_z_cmss);
-    } else {
-        _scurve_next_leg.set_speed_max(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms());
-    }
+    update_legs_speed_accel(get_leg_limits());
 }
 
 /// get_wp_distance_to_destination - get horizontal distance to destination in cm
@@ -742,22 +706,12 @@ bool AC_WPNav::set_spline_destination(const Vector3f& destination, bool terrain_
         wp_and_spline_init(_wp_desired_speed_xy_cms);
     }
 
-    // update spline calculators speeds and accelerations
-    _spline_this_leg.set_speed_accel(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                     _pos_control.get_max_accel_xy_cmss(), _pos_control.get_max_accel_z_cmss());
-
     // calculate origin and origin velocity vector
     Vector3f origin_vector;
     if (terrain_alt == _terrain_alt) {
         if (_flags.fast_waypoint) {
-            // calculate origin vector
-            if (_this_leg_is_spline) {
-                // if previous leg was a spline we can use destination velocity vector for origin velocity vector
-                origin_vector = _spline_this_leg.get_destination_vel();
-            } else {
-                // use direction of the previous straight line segment
-                origin_vector = _destination - _origin;
-            }
+            // leave the previous leg in the same direction
+            origin_vector = this_leg_destination_vector();
         }
 
         // use previous destination as origin
@@ -803,8 +757,7 @@ bool AC_WPNav::set_spline_destination(const Vector3f& destination, bool terrain_
     _flags.fast_waypoint = !destination_vector.is_zero();
 
     // setup spline leg
-    _spline_this_leg.set_origin_and_destination(_origin, _destination, origin_vector, destination_vector);
-    _this_leg_is_spline = true;
+    calc_spline_this_leg(origin_vector, destination_vector, get_spline_leg_limits());
     _flags.reached_destination = false;
 
     return true;
@@ -822,15 +775,8 @@ bool AC_WPNav::set_spline_destination_next(const Vector3f& next_destination, boo
         return true;
     }
 
-    // calculate origin and origin velocity vector
-    Vector3f origin_vector;
-    if (_this_leg_is_spline) {
-        // if previous leg was a spline we can use destination velocity vector for origin velocity vector
-        origin_vector = _spline_this_leg.get_destination_vel();
-    } else {
-        // use the direction of the previous straight line segment
-        origin_vector = _destination - _origin;
-    }
+    // calculate origin velocity vector
+    const Vector3f origin_vector = this_leg_destination_vector();
 
     // calculate destination velocity vector
     Vector3f destination_vector;
@@ -844,24 +790,12 @@ bool AC_WPNav::set_spline_destination_next(const Vector3f& next_destination, boo
         }
     }
 
-    // update spline calculators speeds and accelerations
-    _spline_next_leg.set_speed_accel(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                     _pos_control.get_max_accel_xy_cmss(), _pos_control.get_max_accel_z_cmss());
-
-    // setup next spline leg.  Note this could be made local
-    _spline_next_leg.set_origin_and_destination(_destination, next_destination, origin_vector, destination_vector);
-    _next_leg_is_spline = true;
+    // setup next spline leg
+    calc_spline_next_leg(next_destination, origin_vector, destination_vector, get_spline_leg_limits());
 
     // next destination provided so fast waypoint
     _flags.fast_waypoint = true;
 
-    // update this_leg's final velocity to match next spline leg
-    if (!_this_leg_is_spline) {
-        _scurve_this_leg.set_destination_speed_max(_spline_next_leg.get_origin_speed_max());
-    } else {
-        _spline_this_leg.set_destination_speed_max(_spline_next_leg.get_origin_speed_max());
-    }
-
     return true;
 }
 
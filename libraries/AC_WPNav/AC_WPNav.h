@@ -11,11 +11,12 @@
 #include <AC_AttitudeControl/AC_AttitudeControl.h> // Attitude control library
 #include <AP_Terrain/AP_Terrain.h>
 #include <AC_Avoidance/AC_Avoid.h>                 // Stop at fence library
+#include "AC_WPNav_Legs.h"
 
 // maximum velocities and accelerations
 #define WPNAV_ACCELERATION              250.0f      // maximum horizontal acceleration in cm/s/s that wp navigation will request
 
-class AC_WPNav
+class AC_WPNav : public AC_WPNav_Legs
 {
 public:
 
@@ -235,6 +236,18 @@ protected:
     // updates _scurve_jerk and _scurve_snap
     void calc_scurve_jerk_and_snap();
 
+    // limits used to build the straight legs and to update the legs
+    LegLimits get_leg_limits() const {
+        return LegLimits { _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
+                           get_wp_acceleration(), _wp_accel_z_cmss };
+    }
+
+    // limits used to build the spline legs
+    LegLimits get_spline_leg_limits() const {
+        return LegLimits { _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
+                           _pos_control.get_max_accel_xy_cmss(), _pos_control.get_max_accel_z_cmss() };
+    }
+
     // references and pointers to external libraries
     const AP_InertialNav&   _inav;
     const AP_AHRS_View&     _ahrs;
@@ -259,25 +272,12 @@ protected:
     float _last_wp_speed_down_cms;  // last recorded WPNAV_SPEED_DN, used for changing speed in-flight
 
     // scurve
-    SCurve _scurve_prev_leg;            // previous scurve trajectory used to blend with current scurve trajectory
-    SCurve _scurve_this_leg;            // current scurve trajectory
-    SCurve _scurve_next_leg;            // next scurve trajectory used to blend with current scurve trajectory
     float _scurve_jerk;                 // scurve jerk max in m/s/s/s
     float _scurve_snap;                 // scurve snap in m/s/s/s/s
 
-    // spline curves
-    SplineCurve _spline_this_leg;      // spline curve for current segment
-    SplineCurve _spline_next_leg;      // spline curve for next segment
-
-    // the type of this leg
-    bool _this_leg_is_spline;           // true if this leg is a spline
-    bool _next_leg_is_spline;           // true if the next leg is a spline
-
     // waypoint controller internal variables
     uint32_t    _wp_last_update;        // time of last update_wpnav call
     float       _wp_desired_speed_xy_cms;   // desired wp speed in cm/sec
-    Vector3f    _origin;                // starting point of trip to next waypoint in cm from ekf origin
-    Vector3f    _destination;           // target destination in cm from ekf origin
     Vector3f    _next_destination;      // next target destination in cm from ekf origin
     float       _track_scalar_dt;       // time compression multiplier to slow the progress along the track
     float       _offset_vel;            // horizontal velocity reference used to slow the aircraft for pause and to ensure the aircraft can maintain height above terrain
@@ -0,0 +1,86 @@
+#include "AC_WPNav_Legs.h"
+
+void AC_WPNav_Legs::calc_scurve_this_leg(const LegLimits &limits, float snap_cmssss, float jerk_cmsss, float origin_speed, bool fast_waypoint)
+{
+    if (fast_waypoint && !_this_leg_is_spline && !_next_leg_is_spline && !_scurve_next_leg.finished()) {
+        _scurve_this_leg = _scurve_next_leg;
+    } else {
+        _scurve_this_leg.calculate_track(_origin, _destination,
+                                         limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms,
+                                         limits.accel_xy_cmss, limits.accel_z_cmss,
+                                         snap_cmssss, jerk_cmsss);
+        if (!is_zero(origin_speed)) {
+            // rebuild start of scurve if we have a non-zero origin speed
+            _scurve_this_leg.set_origin_speed_max(origin_speed);
+        }
+    }
+
+    _this_leg_is_spline = false;
+    _scurve_next_leg.init();
+}
+
+void AC_WPNav_Legs::calc_scurve_next_leg(const Vector3f &next_destination, const LegLimits &limits, float snap_cmssss, float jerk_cmsss)
+{
+    _scurve_next_leg.calculate_track(_destination, next_destination,
+                                     limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms,
+                                     limits.accel_xy_cmss, limits.accel_z_cmss,
+                                     snap_cmssss, jerk_cmsss);
+    if (_this_leg_is_spline) {
+        const float this_leg_dest_speed_max = _spline_this_leg.get_destination_speed_max();
+        const float next_leg_origin_speed_max = _scurve_next_leg.set_origin_speed_max(this_leg_dest_speed_max);
+        _spline_this_leg.set_destination_speed_max(next_leg_origin_speed_max);
+    }
+    _next_leg_is_spline = false;
+}
+
+Vector3f AC_WPNav_Legs::this_leg_destination_vector()
+{
+    if (_this_leg_is_spline) {
+        // if this leg is a spline we can use its destination velocity vector
+        return _spline_this_leg.get_destination_vel();
+    }
+    // use the direction of the straight line segment
+    return _destination - _origin;
+}
+
+void AC_WPNav_Legs::calc_spline_this_leg(const Vector3f &origin_vector, const Vector3f &destination_vector, const LegLimits &limits)
+{
+    _spline_this_leg.set_speed_accel(limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms,
+                                     limits.accel_xy_cmss, limits.accel_z_cmss);
+    _spline_this_leg.set_origin_and_destination(_origin, _destination, origin_vector, destination_vector);
+    _this_leg_is_spline = true;
+}
+
+void AC_WPNav_Legs::calc_spline_next_leg(const Vector3f &next_destination, const Vector3f &origin_vector, const Vector3f &destination_vector, const LegLimits &limits)
+{
+    _spline_next_leg.set_speed_accel(limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms,
+                                     limits.accel_xy_cmss, limits.accel_z_cmss);
+    _spline_next_leg.set_origin_and_destination(_destination, next_destination, origin_vector, destination_vector);
+    _next_leg_is_spline = true;
+
+    // update this_leg's final velocity to match next spline leg
+    if (!_this_leg_is_spline) {
+        _scurve_this_leg.set_destination_speed_max(_spline_next_leg.get_origin_speed_max());
+    } else {
+        _spline_this_leg.set_destination_speed_max(_spline_next_leg.get_origin_speed_max());
+    }
+}
+
+void AC_WPNav_Legs::update_legs_speed_accel(const LegLimits &limits)
+{
+    // update this leg
+    if (_this_leg_is_spline) {
+        _spline_this_leg.set_speed_accel(limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms,
+                                         limits.accel_xy_cmss, limits.accel_z_cmss);
+    } else {
+        _scurve_this_leg.set_speed_max(limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms);
+    }
+
+    // update next leg
+    if (_next_leg_is_spline) {
+        _spline_next_leg.set_speed_accel(limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms,
+                                         limits.accel_xy_cmss, limits.accel_z_cmss);
+    } else {
+        _scurve_next_leg.set_speed_max(limits.speed_xy_cms, limits.speed_up_cms, limits.speed_down_cms);
+    }
+}
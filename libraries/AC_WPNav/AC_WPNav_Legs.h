@@ -0,0 +1,62 @@
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/SCurve.h>
+#include <AP_Math/SplineCurve.h>
+
+/*
+  the S-Curve and spline legs of a waypoint path and the leg setup
+  shared by AC_WPNav and AC_WPNav_Trajectory, so the offline evaluator
+  builds its legs exactly as the waypoint controller does. Terrain
+  altitude handling and the fast waypoint flag stay with the users
+ */
+class AC_WPNav_Legs {
+protected:
+
+    // speed and acceleration limits used to build the legs
+    struct LegLimits {
+        float speed_xy_cms;
+        float speed_up_cms;
+        float speed_down_cms;
+        float accel_xy_cmss;
+        float accel_z_cmss;
+    };
+
+    // calculate this leg as a straight line from _origin to
+    // _destination, reusing the next leg if it was already calculated
+    // for a fast waypoint. origin_speed is the speed at the origin if
+    // the previous leg was a spline
+    void calc_scurve_this_leg(const LegLimits &limits, float snap_cmssss, float jerk_cmsss, float origin_speed, bool fast_waypoint);
+
+    // calculate the straight leg from _destination to next_destination
+    void calc_scurve_next_leg(const Vector3f &next_destination, const LegLimits &limits, float snap_cmssss, float jerk_cmsss);
+
+    // direction the vehicle leaves this leg in
+    Vector3f this_leg_destination_vector();
+
+    // calculate this leg as a spline from _origin to _destination
+    void calc_spline_this_leg(const Vector3f &origin_vector, const Vector3f &destination_vector, const LegLimits &limits);
+
+    // calculate the spline leg from _destination to next_destination
+    // and match this leg's final speed to it
+    void calc_spline_next_leg(const Vector3f &next_destination, const Vector3f &origin_vector, const Vector3f &destination_vector, const LegLimits &limits);
+
+    // recalculate this and the next leg with new limits
+    void update_legs_speed_accel(const LegLimits &limits);
+
+    // scurve
+    SCurve _scurve_prev_leg;            // previous scurve trajectory used to blend with current scurve trajectory
+    SCurve _scurve_this_leg;            // current scurve trajectory
+    SCurve _scurve_next_leg;            // next scurve trajectory used to blend with current scurve trajectory
+
+    // spline curves
+    SplineCurve _spline_this_leg;      // spline curve for current segment
+    SplineCurve _spline_next_leg;      // spline curve for next segment
+
+    // the type of this leg
+    bool _this_leg_is_spline;           // true if this leg is a spline
+    bool _next_leg_is_spline;           // true if the next leg is a spline
+
+    Vector3f    _origin;                // starting point of trip to next waypoint in cm
+    Vector3f    _destination;           // target destination in cm
+};
@@ -0,0 +1,536 @@
+#include "AC_WPNav_Trajectory.h"
+
+#if AC_WPNAV_TRAJECTORY_ENABLED
+
+extern const AP_HAL::HAL& hal;
+
+// evaluation stops if a mission takes longer than this
+#define TRAJECTORY_TIME_LIMIT_S     (24 * 3600)
+
+// copter lands at LAND_SPEED below this altitude
+#define TRAJECTORY_LAND_ALT_LOW_CM  1000
+
+// minimum horizontal speed, as WPNAV_WP_SPEED_MIN
+#define TRAJECTORY_SPEED_XY_MIN_CMS 10.0f
+
+AC_WPNav_Trajectory::AC_WPNav_Trajectory(const Limits &limits) :
+    _vehicle_limits(limits)
+{
+    // jerk and snap as calculated by AC_WPNav::calc_scurve_jerk_and_snap
+    // without the attitude controller's rate and acceleration limits
+    _jerk_cmsss = limits.jerk_msss * 100.0f;
+    _snap_cmssss = 0.5f * (_jerk_cmsss * M_PI) / (2.0f * MAX(limits.input_tc, 0.1f));
+}
+
+/*
+  evaluate a mission flown from the ground at home
+ */
+void AC_WPNav_Trajectory::evaluate(const Location &home, const AP_Mission::Mission_Command *cmds, uint16_t num_cmds,
+                                   Result &result, sample_fn_t sample_fn)
+{
+    _home = home;
+    _cmds = cmds;
+    _num_cmds = num_cmds;
+    _cmd_index = 0;
+    _sample_fn = sample_fn;
+    _result = {};
+    _result.complete = true;
+    _limits = _vehicle_limits;
+
+    _origin.zero();
+    _destination.zero();
+    _scurve_prev_leg.init();
+    _scurve_this_leg.init();
+    _scurve_next_leg.init();
+    _this_leg_is_spline = false;
+    _next_leg_is_spline = false;
+    _fast_waypoint = false;
+    _target_pos.zero();
+    _target_vel.zero();
+
+    // "do" commands run while the navigation command before them is
+    // flown. Applying them as that command starts gives the same path
+    // as speed changes recalculate the legs from their current time
+    for (uint16_t i = 0; i < next_nav_cmd(0); i++) {
+        do_change_speed(_cmds[i]);
+    }
+
+    for (uint16_t i = next_nav_cmd(0); i < _num_cmds; i = next_nav_cmd(i+1)) {
+        _cmd_index = i;
+        _result.num_nav_cmds++;
+        for (uint16_t j = i+1; j < next_nav_cmd(i+1); j++) {
+            do_change_speed(_cmds[j]);
+        }
+
+        const AP_Mission::Mission_Command &cmd = _cmds[i];
+        switch (cmd.id) {
+        case MAV_CMD_NAV_TAKEOFF:
+            do_takeoff(i);
+            break;
+        case MAV_CMD_NAV_WAYPOINT:
+            do_nav_wp(i);
+            break;
+        case MAV_CMD_NAV_SPLINE_WAYPOINT:
+            do_spline_wp(i);
+            break;
+        case MAV_CMD_NAV_LOITER_TIME:
+        case MAV_CMD_NAV_LOITER_TURNS:
+        case MAV_CMD_NAV_LOITER_UNLIM:
+            set_wp_destination(pos_from_cmd(cmd, _destination));
+            fly_leg();
+            if (cmd.id == MAV_CMD_NAV_LOITER_TIME) {
+                hold(cmd.p1);
+            }
+            break;
+        case MAV_CMD_NAV_LAND:
+            do_land(i);
+            break;
+        case MAV_CMD_NAV_RETURN_TO_LAUNCH:
+            do_RTL();
+            break;
+        default:
+            // not a command that moves the vehicle
+            break;
+        }
+
+        if (cmd.id == MAV_CMD_NAV_LOITER_UNLIM ||
+            _result.time_s >= TRAJECTORY_TIME_LIMIT_S) {
+            _result.complete = false;
+            break;
+        }
+    }
+
+    result = _result;
+}
+
+uint16_t AC_WPNav_Trajectory::next_nav_cmd(uint16_t index) const
+{
+    while (index < _num_cmds && !AP_Mission::is_nav_cmd(_cmds[index])) {
+        index++;
+    }
+    return index;
+}
+
+// position of a command's location as a NEU offset from home in cm
+Vector3f AC_WPNav_Trajectory::pos_from_cmd(const AP_Mission::Mission_Command &cmd, const Vector3f &default_pos) const
+{
+    Vector3f pos = default_pos;
+    const Location &loc = cmd.content.location;
+
+    // use default lat, lon if zero
+    if (loc.lat != 0 || loc.lng != 0) {
+        pos.xy() = _home.get_distance_NE(loc) * 100.0f;
+    }
+
+    // use default altitude if zero. Without a terrain database all
+    // other frames are taken to be above home
+    if (loc.alt != 0) {
+        pos.z = loc.alt;
+        if (loc.get_alt_frame() == Location::AltFrame::ABSOLUTE) {
+            pos.z -= _home.alt;
+        }
+    }
+    return pos;
+}
+
+void AC_WPNav_Trajectory::do_takeoff(uint16_t index)
+{
+    // climb vertically to the takeoff altitude
+    Vector3f dest = _destination;
+    dest.z = pos_from_cmd(_cmds[index], _destination).z;
+    set_wp_destination(dest);
+    fly_leg();
+}
+
+void AC_WPNav_Trajectory::do_nav_wp(uint16_t index)
+{
+    const Vector3f dest = pos_from_cmd(_cmds[index], _destination);
+    set_wp_destination(dest);
+    set_next_wp(index, dest);
+    fly_leg();
+    hold(_cmds[index].p1);
+}
+
+void AC_WPNav_Trajectory::do_spline_wp(uint16_t index)
+{
+    Vector3f dest, next_dest;
+    bool next_dest_is_spline;
+    get_spline_from_cmd(index, _destination, dest, next_dest, next_dest_is_spline);
+    set_spline_destination(dest, next_dest, next_dest_is_spline);
+    set_next_wp(index, dest);
+    fly_leg();
+    hold(_cmds[index].p1);
+}
+
+void AC_WPNav_Trajectory::do_land(uint16_t index)
+{
+    // fly to the location at the current altitude first if one is given
+    const AP_Mission::Mission_Command &cmd = _cmds[index];
+    if (cmd.content.location.lat != 0 || cmd.content.location.lng != 0) {
+        Vector3f dest = pos_from_cmd(cmd, _destination);
+        dest.z = _destination.z;
+        set_wp_destination(dest);
+        fly_leg();
+    }
+
+    land();
+}
+
+void AC_WPNav_Trajectory::do_RTL()
+{
+    // climb to RTL_ALT, return, loiter then land
+    if (_destination.z < _limits.rtl_alt_cm) {
+        Vector3f climb = _destination;
+        climb.z = _limits.rtl_alt_cm;
+        set_wp_destination(climb);
+        fly_leg();
+    }
+    set_wp_destination(Vector3f{0.0f, 0.0f, _destination.z});
+    fly_leg();
+    hold(_limits.rtl_loiter_time_s);
+    land();
+}
+
+// descend to the ground at the normal speed then at LAND_SPEED
+void AC_WPNav_Trajectory::land()
+{
+    Vector3f ground = _destination;
+    ground.z = 0.0f;
+    const float speed_down_cms = _limits.speed_down_cms;
+    if (_destination.z > TRAJECTORY_LAND_ALT_LOW_CM) {
+        Vector3f land_alt_low = _destination;
+        land_alt_low.z = TRAJECTORY_LAND_ALT_LOW_CM;
+        set_wp_destination(land_alt_low);
+        _limits.speed_down_cms = _limits.land_speed_cms;
+        set_wp_destination_next(ground);
+        _limits.speed_down_cms = speed_down_cms;
+        fly_leg();
+    }
+    _limits.speed_down_cms = _limits.land_speed_cms;
+    set_wp_destination(ground);
+    _limits.speed_down_cms = speed_down_cms;
+    fly_leg();
+}
+
+// set the leg after the current one if the vehicle won't stop at the
+// destination, as ModeAuto::set_next_wp
+void AC_WPNav_Trajectory::set_next_wp(uint16_t index, const Vector3f &dest)
+{
+    // do not add next wp if current command has a delay meaning the vehicle will stop at the destination
+    if (_cmds[index].p1 > 0) {
+        return;
+    }
+
+    // do not add next wp if there are no more navigation commands
+    const uint16_t next_index = next_nav_cmd(index+1);
+    if (next_index >= _num_cmds) {
+        return;
+    }
+
+    // whether vehicle should stop at the target position depends upon the next command
+    switch (_cmds[next_index].id) {
+    case MAV_CMD_NAV_WAYPOINT:
+    case MAV_CMD_NAV_LOITER_UNLIM:
+    case MAV_CMD_NAV_LOITER_TIME:
+        set_wp_destination_next(pos_from_cmd(_cmds[next_index], dest));
+        break;
+    case MAV_CMD_NAV_SPLINE_WAYPOINT: {
+        Vector3f next_dest, next_next_dest;
+        bool next_next_dest_is_spline;
+        get_spline_from_cmd(next_index, dest, next_dest, next_next_dest, next_next_dest_is_spline);
+        set_spline_destination_next(next_dest, next_next_dest, next_next_dest_is_spline);
+        break;
+    }
+    default:
+        // stop for everything else
+        break;
+    }
+}
+
+// get a spline command's destination and the position after it, as ModeAuto::get_spline_from_cmd
+void AC_WPNav_Trajectory::get_spline_from_cmd(uint16_t index, const Vector3f &default_pos, Vector3f &dest, Vector3f &next_dest, bool &next_dest_is_spline) const
+{
+    dest = pos_from_cmd(_cmds[index], default_pos);
+
+    // if there is no delay at the end of this segment get next nav command
+    const uint16_t next_index = next_nav_cmd(index+1);
+    if (_cmds[index].p1 == 0 && next_index < _num_cmds) {
+        next_dest = pos_from_cmd(_cmds[next_index], dest);
+        next_dest_is_spline = _cmds[next_index].id == MAV_CMD_NAV_SPLINE_WAYPOINT;
+    } else {
+        next_dest = dest;
+        next_dest_is_spline = false;
+    }
+}
+
+void AC_WPNav_Trajectory::do_change_speed(const AP_Mission::Mission_Command &cmd)
+{
+    if (cmd.id != MAV_CMD_DO_CHANGE_SPEED || !is_positive(cmd.content.speed.target_ms)) {
+        return;
+    }
+    const float speed_cms = cmd.content.speed.target_ms * 100.0f;
+    switch (cmd.content.speed.speed_type) {
+    case SPEED_TYPE_CLIMB_SPEED:
+        _limits.speed_up_cms = speed_cms;
+        break;
+    case SPEED_TYPE_DESCENT_SPEED:
+        _limits.speed_down_cms = speed_cms;
+        break;
+    default:
+        // as AC_WPNav::set_speed_xy, speeds below the minimum are ignored
+        if (speed_cms < TRAJECTORY_SPEED_XY_MIN_CMS) {
+            return;
+        }
+        _limits.speed_xy_cms = speed_cms;
+        break;
+    }
+    update_track_with_speed_accel_limits();
+}
+
+/*
+  the following mirror the AC_WPNav methods of the same names with
+  the terrain handling removed
+ */
+AC_WPNav_Legs::LegLimits AC_WPNav_Trajectory::get_leg_limits() const
+{
+    return LegLimits { _limits.speed_xy_cms, _limits.speed_up_cms, _limits.speed_down_cms,
+                       _limits.accel_xy_cmss, _limits.accel_z_cmss };
+}
+
+void AC_WPNav_Trajectory::set_wp_destination(const Vector3f &destination)
+{
+    _scurve_prev_leg.init();
+    float origin_speed = 0.0f;
+
+    // use previous destination as origin
+    _origin = _destination;
+
+    if (_this_leg_is_spline) {
+        // if previous leg was a spline we can use current target velocity vector for origin velocity vector
+        origin_speed = _target_vel.length();
+    } else {
+        // store previous leg
+        _scurve_prev_leg = _scurve_this_leg;
+    }
+
+    _destination = destination;
+
+    calc_scurve_this_leg(get_leg_limits(), _snap_cmssss, _jerk_cmsss, origin_speed, _fast_waypoint);
+    _fast_waypoint = false;
+}
+
+void AC_WPNav_Trajectory::set_wp_destination_next(const Vector3f &destination)
+{
+    calc_scurve_next_leg(destination, get_leg_limits(), _snap_cmssss, _jerk_cmsss);
+    _fast_waypoint = true;
+}
+
+void AC_WPNav_Trajectory::set_spline_destination(const Vector3f &destination, const Vector3f &next_destination, bool next_is_spline)
+{
+    // calculate origin velocity vector
+    Vector3f origin_vector;
+    if (_fast_waypoint) {
+        origin_vector = this_leg_destination_vector();
+    }
+
+    // use previous destination as origin
+    _origin = _destination;
+    _destination = destination;
+
+    // calculate destination velocity vector
+    Vector3f destination_vector;
+    if (next_is_spline) {
+        // leave this segment moving parallel to vector from origin to next destination
+        destination_vector = next_destination - _origin;
+    } else {
+        // leave this segment moving parallel to next segment
+        destination_vector = next_destination - _destination;
+    }
+    _fast_waypoint = !destination_vector.is_zero();
+
+    calc_spline_this_leg(origin_vector, destination_vector, get_leg_limits());
+}
+
+void AC_WPNav_Trajectory::set_spline_destination_next(const Vector3f &next_destination, const Vector3f &next_next_destination, bool next_next_is_spline)
+{
+    // calculate origin velocity vector
+    const Vector3f origin_vector = this_leg_destination_vector();
+
+    // calculate destination velocity vector
+    Vector3f destination_vector;
+    if (next_next_is_spline) {
+        destination_vector = next_next_destination - _destination;
+    } else {
+        destination_vector = next_next_destination - next_destination;
+    }
+
+    calc_spline_next_leg(next_destination, origin_vector, destination_vector, get_leg_limits());
+    _fast_waypoint = true;
+}
+
+void AC_WPNav_Trajectory::update_track_with_speed_accel_limits()
+{
+    update_legs_speed_accel(get_leg_limits());
+}
+
+/*
+  advance the targets until the current leg is finished, as
+  AC_WPNav::advance_wp_target_along_track with the vehicle following
+  the targets exactly
+ */
+void AC_WPNav_Trajectory::fly_leg()
+{
+    const float dt = _limits.dt;
+    const float accel_corner_cmss = is_positive(_limits.accel_corner_cmss) ? _limits.accel_corner_cmss : 2.0f * _limits.accel_xy_cmss;
+
+    bool finished = false;
+    while (!finished && _result.time_s < TRAJECTORY_TIME_LIMIT_S) {
+        Vector3f target_pos, target_vel, target_accel;
+        if (!_this_leg_is_spline) {
+            target_pos = _origin;
+            finished = _scurve_this_leg.advance_target_along_track(_scurve_prev_leg, _scurve_next_leg, _limits.wp_radius_cm, accel_corner_cmss, _fast_waypoint, dt, target_pos, target_vel, target_accel);
+        } else {
+            target_vel = _target_vel;
+            _spline_this_leg.advance_target_along_track(dt, target_pos, target_vel);
+            finished = _spline_this_leg.reached_destination();
+            // the spline calculator doesn't provide an acceleration
+            target_accel = (target_vel - _target_vel) / dt;
+        }
+        record(target_pos, target_vel, target_accel, dt);
+    }
+}
+
+void AC_WPNav_Trajectory::hold(float time_s)
+{
+    if (!is_positive(time_s)) {
+        return;
+    }
+    record(_target_pos, Vector3f{}, Vector3f{}, time_s);
+}
+
+void AC_WPNav_Trajectory::record(const Vector3f &pos, const Vector3f &vel, const Vector3f &accel, float dt)
+{
+    _result.time_s += dt;
+    _result.distance_m += (pos - _target_pos).length() * 0.01f;
+    _result.max_speed_ms = MAX(_result.max_speed_ms, vel.length() * 0.01f);
+    _result.max_accel_xy_mss = MAX(_result.max_accel_xy_mss, accel.xy().length() * 0.01f);
+    _target_pos = pos;
+    _target_vel = vel;
+
+    if (_sample_fn) {
+        const Sample sample {
+            time_s : _result.time_s,
+            cmd_index : _cmd_index,
+            pos : pos,
+            vel : vel,
+            accel : accel,
+        };
+        _sample_fn(sample);
+    }
+}
+
+uint8_t AC_WPNav_TrajectoryBatch::init(uint8_t num_workers)
+{
+    num_workers = MIN(num_workers, MAX_WORKERS);
+    while (_num_workers < num_workers) {
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AC_WPNav_TrajectoryBatch::worker_thread, void),
+                                          "wpnav-traj",
+                                          16384, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
+            break;
+        }
+        _num_workers++;
+    }
+    return _num_workers;
+}
+
+void AC_WPNav_TrajectoryBatch::worker_thread()
+{
+    uint8_t worker_index;
+    {
+        WITH_SEMAPHORE(_sem);
+        worker_index = _next_worker_index++;
+    }
+    Worker &worker = _workers[worker_index];
+    while (true) {
+        if (!worker.start.wait_blocking()) {
+            continue;
+        }
+        bool shutdown;
+        {
+            WITH_SEMAPHORE(_sem);
+            shutdown = _shutdown;
+        }
+        if (shutdown) {
+            // nothing may touch this object after the signal
+            worker.done.signal();
+            return;
+        }
+        evaluate_missions();
+        worker.done.signal();
+    }
+}
+
+void AC_WPNav_TrajectoryBatch::shutdown()
+{
+    if (_num_workers == 0) {
+        return;
+    }
+    {
+        WITH_SEMAPHORE(_sem);
+        _shutdown = true;
+    }
+    for (uint8_t i=0; i<_num_workers; i++) {
+        _workers[i].start.signal();
+    }
+    for (uint8_t i=0; i<_num_workers; i++) {
+        _workers[i].done.wait_blocking();
+    }
+
+    // every worker has taken its index and exited, so init() may
+    // start new ones
+    WITH_SEMAPHORE(_sem);
+    _num_workers = 0;
+    _next_worker_index = 0;
+    _shutdown = false;
+}
+
+void AC_WPNav_TrajectoryBatch::evaluate(const AC_WPNav_Trajectory::Limits &limits,
+                                        const Mission *missions, uint32_t num_missions,
+                                        AC_WPNav_Trajectory::Result *results)
+{
+    {
+        WITH_SEMAPHORE(_sem);
+        _limits = &limits;
+        _missions = missions;
+        _num_missions = num_missions;
+        _results = results;
+        _next_mission = 0;
+    }
+
+    for (uint8_t i=0; i<_num_workers; i++) {
+        _workers[i].start.signal();
+    }
+    evaluate_missions();
+    for (uint8_t i=0; i<_num_workers; i++) {
+        _workers[i].done.wait_blocking();
+    }
+}
+
+void AC_WPNav_TrajectoryBatch::evaluate_missions()
+{
+    AC_WPNav_Trajectory trajectory(*_limits);
+    while (true) {
+        uint32_t index;
+        {
+            WITH_SEMAPHORE(_sem);
+            if (_next_mission >= _num_missions) {
+                return;
+            }
+            index = _next_mission++;
+        }
+        const Mission &mission = _missions[index];
+        trajectory.evaluate(mission.home, mission.cmds, mission.num_cmds, _results[index]);
+    }
+}
+
+#endif // AC_WPNAV_TRAJECTORY_ENABLED
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "AC_WPNav_config.h"
+
+#if AC_WPNAV_TRAJECTORY_ENABLED
+
+#include <AP_Common/AP_Common.h>
+#include <AP_Common/Location.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/Semaphores.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/SCurve.h>
+#include <AP_Math/SplineCurve.h>
+#include <AP_Mission/AP_Mission.h>
+#include "AC_WPNav_Legs.h"
+
+/*
+  Evaluates how a copter's waypoint controller will fly a mission,
+  without running the vehicle. The legs are built from the mission
+  commands the way ModeAuto builds them, with the leg setup shared
+  with AC_WPNav through AC_WPNav_Legs, and the S-Curve
+  and spline targets are advanced at a fixed time step. The vehicle is
+  assumed to follow the targets exactly, so the trajectory is the
+  position controller's target path.
+
+  Terrain and rangefinder altitudes are treated as above home, circles
+  (LOITER_TURNS) are flown as a stop at their centre and DO_JUMP is not
+  followed. Evaluation stops at LOITER_UNLIM.
+
+  Nothing here uses the vehicle singletons, so separate instances may
+  evaluate missions on separate threads.
+ */
+class AC_WPNav_Trajectory : public AC_WPNav_Legs {
+public:
+
+    // vehicle limits, the defaults match the parameter defaults
+    struct Limits {
+        float speed_xy_cms = 1000;      // WPNAV_SPEED
+        float speed_up_cms = 250;       // WPNAV_SPEED_UP
+        float speed_down_cms = 150;     // WPNAV_SPEED_DN
+        float accel_xy_cmss = 250;      // WPNAV_ACCEL
+        float accel_z_cmss = 100;       // WPNAV_ACCEL_Z
+        float accel_corner_cmss = 0;    // WPNAV_ACCEL_C, zero for twice WPNAV_ACCEL
+        float jerk_msss = 1;            // WPNAV_JERK
+        float input_tc = 0.15;          // ATC_INPUT_TC, sets the snap limit
+        float wp_radius_cm = 200;       // WPNAV_RADIUS
+        float land_speed_cms = 50;      // LAND_SPEED
+        float rtl_alt_cm = 1500;        // RTL_ALT
+        float rtl_loiter_time_s = 5;    // RTL_LOIT_TIME
+        float dt = 0.0025;              // time step, the main loop period by default
+    };
+
+    // a point on the trajectory. Positions are NEU in cm from home
+    struct Sample {
+        float time_s;
+        uint16_t cmd_index;             // navigation command being flown
+        Vector3f pos;
+        Vector3f vel;
+        Vector3f accel;
+    };
+
+    struct Result {
+        float time_s;                   // time to fly the mission, including delays
+        float distance_m;               // length of the path flown
+        float max_speed_ms;             // highest speed along the path
+        float max_accel_xy_mss;         // highest horizontal acceleration, normally in the corners
+        uint16_t num_nav_cmds;          // navigation commands flown
+        bool complete;                  // false if evaluation stopped at LOITER_UNLIM or the time limit
+    };
+
+    FUNCTOR_TYPEDEF(sample_fn_t, void, const Sample &);
+
+    AC_WPNav_Trajectory(const Limits &limits);
+
+    CLASS_NO_COPY(AC_WPNav_Trajectory);
+
+    // evaluate a mission flown from the ground at home. cmds should
+    // not include the home command. sample_fn, if set, is called at
+    // each time step while moving and at the end of each delay
+    void evaluate(const Location &home, const AP_Mission::Mission_Command *cmds, uint16_t num_cmds,
+                  Result &result, sample_fn_t sample_fn = nullptr);
+
+private:
+
+    // flying the navigation commands, as done by ModeAuto
+    void do_nav_wp(uint16_t index);
+    void do_spline_wp(uint16_t index);
+    void do_takeoff(uint16_t index);
+    void do_land(uint16_t index);
+    void do_RTL();
+    void land();
+    void set_next_wp(uint16_t index, const Vector3f &dest);
+    void get_spline_from_cmd(uint16_t index, const Vector3f &default_pos, Vector3f &dest, Vector3f &next_dest, bool &next_dest_is_spline) const;
+    void do_change_speed(const AP_Mission::Mission_Command &cmd);
+
+    // index of the first navigation command at or after index, num_cmds if none
+    uint16_t next_nav_cmd(uint16_t index) const;
+
+    // position of a command's location, using default_pos where the
+    // command leaves the position or altitude as zero
+    Vector3f pos_from_cmd(const AP_Mission::Mission_Command &cmd, const Vector3f &default_pos) const;
+
+    // setting up the legs, as done by AC_WPNav without terrain altitudes
+    void set_wp_destination(const Vector3f &destination);
+    void set_wp_destination_next(const Vector3f &destination);
+    void set_spline_destination(const Vector3f &destination, const Vector3f &next_destination, bool next_is_spline);
+    void set_spline_destination_next(const Vector3f &next_destination, const Vector3f &next_next_destination, bool next_next_is_spline);
+    void update_track_with_speed_accel_limits();
+    LegLimits get_leg_limits() const;
+
+    // fly the current leg to its end, or to the time limit
+    void fly_leg();
+
+    // stay at the destination
+    void hold(float time_s);
+
+    void record(const Vector3f &pos, const Vector3f &vel, const Vector3f &accel, float dt);
+
+    // limits, the speeds may be changed by the mission
+    const Limits _vehicle_limits;
+    Limits _limits;
+    float _jerk_cmsss;
+    float _snap_cmssss;
+
+    // mission being evaluated
+    Location _home;
+    const AP_Mission::Mission_Command *_cmds;
+    uint16_t _num_cmds;
+    uint16_t _cmd_index;
+    sample_fn_t _sample_fn;
+    Result _result;
+
+    // waypoint controller state, the legs are in AC_WPNav_Legs
+    bool _fast_waypoint;
+
+    // latest target
+    Vector3f _target_pos;
+    Vector3f _target_vel;
+};
+
+/*
+  evaluates many missions, sharing them between worker threads and
+  the calling thread
+ */
+class AC_WPNav_TrajectoryBatch {
+public:
+
+    struct Mission {
+        Location home;
+        const AP_Mission::Mission_Command *cmds;
+        uint16_t num_cmds;
+    };
+
+    AC_WPNav_TrajectoryBatch() {}
+
+    // the workers use this object, so they are stopped before it goes
+    ~AC_WPNav_TrajectoryBatch() { shutdown(); }
+
+    CLASS_NO_COPY(AC_WPNav_TrajectoryBatch);
+
+    // start up to num_workers worker threads, returns the number started
+    uint8_t init(uint8_t num_workers);
+
+    // stop the worker threads, returning once they have all exited.
+    // Must not be called during evaluate()
+    void shutdown();
+
+    // evaluate the missions, returning once all have been evaluated
+    void evaluate(const AC_WPNav_Trajectory::Limits &limits,
+                  const Mission *missions, uint32_t num_missions,
+                  AC_WPNav_Trajectory::Result *results);
+
+    static const uint8_t MAX_WORKERS = 16;
+
+private:
+    struct Worker {
+        HAL_BinarySemaphore start;
+        HAL_BinarySemaphore done;
+    };
+
+    void worker_thread();
+
+    // evaluate missions until there are none left
+    void evaluate_missions();
+
+    Worker _workers[MAX_WORKERS];
+    uint8_t _num_workers = 0;
+
+    // the batch being evaluated
+    const AC_WPNav_Trajectory::Limits *_limits;
+    const Mission *_missions;
+    uint32_t _num_missions;
+    AC_WPNav_Trajectory::Result *_results;
+
+    // protects _next_mission, _next_worker_index and _shutdown
+    HAL_Semaphore _sem;
+    uint32_t _next_mission;
+    uint8_t _next_worker_index = 0;
+    bool _shutdown = false;
+};
+
+#endif // AC_WPNAV_TRAJECTORY_ENABLED
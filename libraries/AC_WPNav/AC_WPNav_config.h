@@ -5,3 +5,9 @@
 #ifndef AC_WPNAV_OA_ENABLED
 #define AC_WPNAV_OA_ENABLED AP_OAPATHPLANNER_ENABLED
 #endif
+
+// offline mission trajectory evaluator, for SITL and tools. Other
+// boards can enable it by defining this to 1
+#ifndef AC_WPNAV_TRAJECTORY_ENABLED
+#define AC_WPNAV_TRAJECTORY_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif
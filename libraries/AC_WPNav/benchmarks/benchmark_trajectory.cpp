@@ -0,0 +1,80 @@
+#include <AP_gbenchmark.h>
+
+#include <AC_WPNav/AC_WPNav_Trajectory.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AC_WPNAV_TRAJECTORY_ENABLED
+
+static const Location home{-353632610, 1491652300, 58400, Location::AltFrame::ABSOLUTE};
+
+static AP_Mission::Mission_Command nav_cmd(uint16_t id, float north_m, float east_m, float alt_m)
+{
+    AP_Mission::Mission_Command cmd {};
+    cmd.id = id;
+    cmd.content.location = home;
+    cmd.content.location.offset(north_m, east_m);
+    cmd.content.location.set_alt_cm(alt_m * 100, Location::AltFrame::ABOVE_HOME);
+    return cmd;
+}
+
+// takeoff, a 500m by 400m lawnmower survey with spline turns and return
+static uint16_t survey_mission(AP_Mission::Mission_Command *cmds)
+{
+    uint16_t n = 0;
+    cmds[n++] = nav_cmd(MAV_CMD_NAV_TAKEOFF, 0, 0, 30);
+    for (uint8_t i=0; i<10; i++) {
+        const float east_m = i * 50.0f;
+        const bool north = (i % 2) == 0;
+        cmds[n++] = nav_cmd(MAV_CMD_NAV_WAYPOINT, north ? 0 : 400, east_m, 30);
+        cmds[n++] = nav_cmd(MAV_CMD_NAV_SPLINE_WAYPOINT, north ? 400 : 0, east_m, 30);
+    }
+    cmds[n++] = nav_cmd(MAV_CMD_NAV_RETURN_TO_LAUNCH, 0, 0, 0);
+    return n;
+}
+
+// evaluate one mission at a time on the calling thread
+static void BM_TrajectoryEvaluate(benchmark::State& state)
+{
+    AP_Mission::Mission_Command cmds[32];
+    const uint16_t num_cmds = survey_mission(cmds);
+    const AC_WPNav_Trajectory::Limits limits;
+    AC_WPNav_Trajectory trajectory{limits};
+    AC_WPNav_Trajectory::Result result;
+
+    while (state.KeepRunning()) {
+        trajectory.evaluate(home, cmds, num_cmds, result);
+        gbenchmark_escape(&result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// evaluate a batch of missions on the calling thread and range(0) workers
+static void BM_TrajectoryBatch(benchmark::State& state)
+{
+    static const uint16_t num_missions = 16;
+    AP_Mission::Mission_Command cmds[32];
+    const uint16_t num_cmds = survey_mission(cmds);
+    AC_WPNav_TrajectoryBatch::Mission missions[num_missions];
+    for (uint16_t i=0; i<num_missions; i++) {
+        missions[i] = { home, cmds, num_cmds };
+    }
+    const AC_WPNav_Trajectory::Limits limits;
+    static AC_WPNav_Trajectory::Result results[num_missions];
+
+    AC_WPNav_TrajectoryBatch batch;
+    batch.init(state.range(0));
+
+    while (state.KeepRunning()) {
+        batch.evaluate(limits, missions, num_missions, results);
+        gbenchmark_escape(results);
+    }
+    state.SetItemsProcessed(state.iterations() * num_missions);
+}
+
+BENCHMARK(BM_TrajectoryEvaluate);
+BENCHMARK(BM_TrajectoryBatch)->Arg(0)->Arg(3)->UseRealTime();
+
+#endif // AC_WPNAV_TRAJECTORY_ENABLED
+
+BENCHMARK_MAIN();
@@ -0,0 +1,238 @@
+#include <AP_gtest.h>
+
+#include <AC_WPNav/AC_WPNav_Trajectory.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AC_WPNAV_TRAJECTORY_ENABLED
+
+static const Location home{-353632610, 1491652300, 58400, Location::AltFrame::ABSOLUTE};
+
+static AP_Mission::Mission_Command nav_cmd(uint16_t id, float north_m, float east_m, float alt_m, uint16_t p1 = 0)
+{
+    AP_Mission::Mission_Command cmd {};
+    cmd.id = id;
+    cmd.p1 = p1;
+    cmd.content.location = home;
+    cmd.content.location.offset(north_m, east_m);
+    cmd.content.location.set_alt_cm(alt_m * 100, Location::AltFrame::ABOVE_HOME);
+    return cmd;
+}
+
+static AP_Mission::Mission_Command change_speed_cmd(float speed_ms)
+{
+    AP_Mission::Mission_Command cmd {};
+    cmd.id = MAV_CMD_DO_CHANGE_SPEED;
+    cmd.content.speed.speed_type = SPEED_TYPE_GROUNDSPEED;
+    cmd.content.speed.target_ms = speed_ms;
+    return cmd;
+}
+
+// takeoff to 20m, fly a 200m square and return
+static uint16_t square_mission(AP_Mission::Mission_Command *cmds)
+{
+    uint16_t n = 0;
+    cmds[n++] = nav_cmd(MAV_CMD_NAV_TAKEOFF, 0, 0, 20);
+    cmds[n++] = nav_cmd(MAV_CMD_NAV_WAYPOINT, 200, 0, 20);
+    cmds[n++] = nav_cmd(MAV_CMD_NAV_WAYPOINT, 200, 200, 20);
+    cmds[n++] = nav_cmd(MAV_CMD_NAV_WAYPOINT, 0, 200, 20);
+    cmds[n++] = nav_cmd(MAV_CMD_NAV_RETURN_TO_LAUNCH, 0, 0, 0);
+    return n;
+}
+
+TEST(AC_WPNav_Trajectory, square)
+{
+    AP_Mission::Mission_Command cmds[8];
+    const uint16_t num_cmds = square_mission(cmds);
+
+    const AC_WPNav_Trajectory::Limits limits;
+    AC_WPNav_Trajectory trajectory{limits};
+    AC_WPNav_Trajectory::Result result;
+    trajectory.evaluate(home, cmds, num_cmds, result);
+
+    EXPECT_TRUE(result.complete);
+    EXPECT_EQ(result.num_nav_cmds, num_cmds);
+
+    // 800m around the square, a little less cutting the corners, plus
+    // the climbs and descents
+    EXPECT_GT(result.distance_m, 780);
+    EXPECT_LT(result.distance_m, 900);
+    EXPECT_LE(result.max_speed_ms, limits.speed_xy_cms * 0.01 * 1.01);
+    EXPECT_GT(result.max_speed_ms, limits.speed_xy_cms * 0.01 * 0.9);
+
+    // slower than flying the distance at full speed, faster than
+    // flying it at half speed with the RTL loiter and the landing
+    EXPECT_GT(result.time_s, 800 / (limits.speed_xy_cms * 0.01));
+    EXPECT_LT(result.time_s, 1600 / (limits.speed_xy_cms * 0.01) + limits.rtl_loiter_time_s + 1500 / limits.land_speed_cms);
+}
+
+TEST(AC_WPNav_Trajectory, change_speed)
+{
+    AP_Mission::Mission_Command cmds[8];
+    uint16_t num_cmds = 0;
+    cmds[num_cmds++] = nav_cmd(MAV_CMD_NAV_TAKEOFF, 0, 0, 20);
+    cmds[num_cmds++] = nav_cmd(MAV_CMD_NAV_WAYPOINT, 500, 0, 20);
+    cmds[num_cmds++] = nav_cmd(MAV_CMD_NAV_LAND, 500, 0, 0);
+
+    const AC_WPNav_Trajectory::Limits limits;
+    AC_WPNav_Trajectory trajectory{limits};
+    AC_WPNav_Trajectory::Result result;
+    trajectory.evaluate(home, cmds, num_cmds, result);
+    EXPECT_TRUE(result.complete);
+
+    // halve the speed for the leg
+    cmds[3] = cmds[2];
+    cmds[2] = change_speed_cmd(limits.speed_xy_cms * 0.005);
+    num_cmds++;
+    AC_WPNav_Trajectory::Result slow_result;
+    trajectory.evaluate(home, cmds, num_cmds, slow_result);
+    EXPECT_TRUE(slow_result.complete);
+    EXPECT_EQ(slow_result.num_nav_cmds, 3);
+    EXPECT_LE(slow_result.max_speed_ms, limits.speed_xy_cms * 0.005 * 1.01);
+    EXPECT_GT(slow_result.time_s, result.time_s + 20);
+
+    // the speed change does not carry over to the next evaluation
+    AC_WPNav_Trajectory::Result again;
+    cmds[2] = cmds[3];
+    trajectory.evaluate(home, cmds, num_cmds-1, again);
+    EXPECT_FLOAT_EQ(again.time_s, result.time_s);
+
+    // speeds below the minimum are ignored, as by AC_WPNav
+    cmds[3] = cmds[2];
+    cmds[2] = change_speed_cmd(0.05);
+    AC_WPNav_Trajectory::Result too_slow;
+    trajectory.evaluate(home, cmds, num_cmds, too_slow);
+    EXPECT_TRUE(too_slow.complete);
+    EXPECT_FLOAT_EQ(too_slow.time_s, result.time_s);
+}
+
+TEST(AC_WPNav_Trajectory, loiter)
+{
+    AP_Mission::Mission_Command cmds[8];
+    uint16_t num_cmds = 0;
+    cmds[num_cmds++] = nav_cmd(MAV_CMD_NAV_TAKEOFF, 0, 0, 20);
+    cmds[num_cmds++] = nav_cmd(MAV_CMD_NAV_LOITER_TIME, 100, 0, 20, 30);
+    cmds[num_cmds++] = nav_cmd(MAV_CMD_NAV_LOITER_UNLIM, 100, 100, 20);
+    cmds[num_cmds++] = nav_cmd(MAV_CMD_NAV_LAND, 0, 0, 0);
+
+    const AC_WPNav_Trajectory::Limits limits;
+    AC_WPNav_Trajectory trajectory{limits};
+    AC_WPNav_Trajectory::Result result;
+    trajectory.evaluate(home, cmds, num_cmds, result);
+
+    // stops at the unlimited loiter, having waited at the first
+    EXPECT_FALSE(result.complete);
+    EXPECT_EQ(result.num_nav_cmds, 3);
+    EXPECT_GT(result.time_s, 30 + 200 / (limits.speed_xy_cms * 0.01));
+}
+
+class SampleRecorder {
+public:
+    void sample(const AC_WPNav_Trajectory::Sample &s) {
+        if (count > 0) {
+            EXPECT_GE(s.time_s, last.time_s);
+            EXPECT_GE(s.cmd_index, last.cmd_index);
+        }
+        last = s;
+        count++;
+    }
+    AC_WPNav_Trajectory::Sample last;
+    uint32_t count;
+};
+
+TEST(AC_WPNav_Trajectory, samples)
+{
+    AP_Mission::Mission_Command cmds[8];
+    const uint16_t num_cmds = square_mission(cmds);
+
+    const AC_WPNav_Trajectory::Limits limits;
+    AC_WPNav_Trajectory trajectory{limits};
+    AC_WPNav_Trajectory::Result result;
+    SampleRecorder recorder {};
+    trajectory.evaluate(home, cmds, num_cmds, result,
+                        FUNCTOR_BIND(&recorder, &SampleRecorder::sample, void, const AC_WPNav_Trajectory::Sample &));
+
+    // a sample for each time step, ending on the ground at home
+    EXPECT_GT(recorder.count, uint32_t(result.time_s * 0.5 / limits.dt));
+    EXPECT_FLOAT_EQ(recorder.last.time_s, result.time_s);
+    EXPECT_EQ(recorder.last.cmd_index, num_cmds-1);
+    EXPECT_LT(recorder.last.pos.length(), 1);
+}
+
+TEST(AC_WPNav_Trajectory, batch)
+{
+    AP_Mission::Mission_Command square_cmds[8];
+    AP_Mission::Mission_Command line_cmds[8];
+    const uint16_t num_square_cmds = square_mission(square_cmds);
+    uint16_t num_line_cmds = 0;
+    line_cmds[num_line_cmds++] = nav_cmd(MAV_CMD_NAV_TAKEOFF, 0, 0, 20);
+    line_cmds[num_line_cmds++] = nav_cmd(MAV_CMD_NAV_WAYPOINT, 300, 0, 20);
+    line_cmds[num_line_cmds++] = nav_cmd(MAV_CMD_NAV_LAND, 300, 0, 0);
+
+    const AC_WPNav_TrajectoryBatch::Mission missions[] {
+        { home, square_cmds, num_square_cmds },
+        { home, line_cmds, num_line_cmds },
+        { home, square_cmds, num_square_cmds },
+    };
+    AC_WPNav_Trajectory::Result results[ARRAY_SIZE(missions)];
+
+    // without workers the missions are evaluated on this thread
+    const AC_WPNav_Trajectory::Limits limits;
+    AC_WPNav_TrajectoryBatch batch;
+    batch.evaluate(limits, missions, ARRAY_SIZE(missions), results);
+
+    AC_WPNav_Trajectory trajectory{limits};
+    for (uint8_t i=0; i<ARRAY_SIZE(missions); i++) {
+        AC_WPNav_Trajectory::Result result;
+        trajectory.evaluate(missions[i].home, missions[i].cmds, missions[i].num_cmds, result);
+        EXPECT_FLOAT_EQ(results[i].time_s, result.time_s);
+        EXPECT_FLOAT_EQ(results[i].distance_m, result.distance_m);
+    }
+}
+
+TEST(AC_WPNav_Trajectory, batch_workers)
+{
+    AP_Mission::Mission_Command cmds[8];
+    const uint16_t num_cmds = square_mission(cmds);
+
+    AC_WPNav_TrajectoryBatch::Mission missions[10];
+    for (auto &mission : missions) {
+        mission = { home, cmds, num_cmds };
+    }
+    AC_WPNav_Trajectory::Result results[ARRAY_SIZE(missions)];
+
+    const AC_WPNav_Trajectory::Limits limits;
+    AC_WPNav_Trajectory trajectory{limits};
+    AC_WPNav_Trajectory::Result expected;
+    trajectory.evaluate(home, cmds, num_cmds, expected);
+
+    {
+        AC_WPNav_TrajectoryBatch batch;
+        EXPECT_EQ(batch.init(3), 3);
+
+        // the workers are reused for each batch
+        for (uint8_t n=0; n<2; n++) {
+            memset(results, 0, sizeof(results));
+            batch.evaluate(limits, missions, ARRAY_SIZE(missions), results);
+            for (const auto &result : results) {
+                EXPECT_TRUE(result.complete);
+                EXPECT_FLOAT_EQ(result.time_s, expected.time_s);
+            }
+        }
+
+        // workers can be stopped and started again
+        batch.shutdown();
+        EXPECT_EQ(batch.init(2), 2);
+        memset(results, 0, sizeof(results));
+        batch.evaluate(limits, missions, ARRAY_SIZE(missions), results);
+        for (const auto &result : results) {
+            EXPECT_FLOAT_EQ(result.time_s, expected.time_s);
+        }
+
+        // the destructor stops the workers before the batch goes
+    }
+}
+
+#endif // AC_WPNAV_TRAJECTORY_ENABLED
+
+AP_GTEST_MAIN()
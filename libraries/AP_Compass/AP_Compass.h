@@ -398,6 +398,10 @@ private:
 #if COMPASS_CAL_ENABLED
     // compass cal
     void _update_calibration_trampoline();
+#if AP_COMPASS_CAL_THREAD_PER_COMPASS
+    void _update_calibration_thread();
+    bool _start_calibration_thread(Priority prio);
+#endif
     bool _accept_calibration(uint8_t i);
     bool _accept_calibration_mask(uint8_t mask);
     void _cancel_calibration(uint8_t i);
@@ -665,6 +669,12 @@ private:
     bool _initial_location_set;
 
     bool _cal_thread_started;
+#if AP_COMPASS_CAL_THREAD_PER_COMPASS
+    // compasses which have had a calibration thread created and those whose thread is running
+    uint8_t _cal_thread_mask;
+    uint8_t _cal_thread_claimed_mask;
+    HAL_Semaphore _cal_thread_sem;
+#endif
 
 #if AP_COMPASS_MSP_ENABLED
     uint8_t msp_instance_mask;
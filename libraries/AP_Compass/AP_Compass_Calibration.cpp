@@ -95,6 +95,11 @@ bool Compass::_start_calibration(uint8_t i, bool retry, float delay)
         // lot noisier
         _calibrator[prio]->start(retry, delay, get_offsets_max(), i, _calibration_threshold*2);
     }
+#if AP_COMPASS_CAL_THREAD_PER_COMPASS
+    if (!_start_calibration_thread(prio)) {
+        return false;
+    }
+#else
     if (!_cal_thread_started) {
         _cal_requires_reboot = true;
         if (!hal.scheduler->thread_create(FUNCTOR_BIND(this, &Compass::_update_calibration_trampoline, void), "compasscal", 2048, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
@@ -103,6 +108,7 @@ bool Compass::_start_calibration(uint8_t i, bool retry, float delay)
         }
         _cal_thread_started = true;
     }
+#endif
 
     // disable compass learning both for calibration and after completion
     _learn.set_and_save(0);
@@ -122,6 +128,55 @@ void Compass::_update_calibration_trampoline() {
     }
 }
 
+#if AP_COMPASS_CAL_THREAD_PER_COMPASS
+// create a calibration thread for a compass if it does not already have one
+bool Compass::_start_calibration_thread(Priority prio)
+{
+    const uint8_t bit = 1U << uint8_t(prio);
+    {
+        WITH_SEMAPHORE(_cal_thread_sem);
+        if (_cal_thread_mask & bit) {
+            return true;
+        }
+        _cal_thread_mask |= bit;
+    }
+    _cal_requires_reboot = true;
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND(this, &Compass::_update_calibration_thread, void), "compasscal", 2048, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
+        WITH_SEMAPHORE(_cal_thread_sem);
+        _cal_thread_mask &= ~bit;
+        GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "CompassCalibrator: Cannot start compass thread.");
+        return false;
+    }
+    _cal_thread_started = true;
+    return true;
+}
+
+// calibration thread for a single compass so the fits for each compass run in parallel
+void Compass::_update_calibration_thread()
+{
+    // claim the first compass whose thread has been created but not yet started
+    Priority prio(COMPASS_MAX_INSTANCES);
+    {
+        WITH_SEMAPHORE(_cal_thread_sem);
+        for (Priority i(0); i<COMPASS_MAX_INSTANCES; i++) {
+            const uint8_t bit = 1U << uint8_t(i);
+            if ((_cal_thread_mask & bit) && !(_cal_thread_claimed_mask & bit)) {
+                _cal_thread_claimed_mask |= bit;
+                prio = i;
+                break;
+            }
+        }
+    }
+    if (prio == COMPASS_MAX_INSTANCES) {
+        return;
+    }
+    while (true) {
+        _calibrator[prio]->update();
+        hal.scheduler->delay(1);
+    }
+}
+#endif  // AP_COMPASS_CAL_THREAD_PER_COMPASS
+
 bool Compass::_start_calibration_mask(uint8_t mask, bool retry, bool autosave, float delay, bool autoreboot)
 {
     _cal_autosave = autosave;
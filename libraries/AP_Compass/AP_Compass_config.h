@@ -18,6 +18,11 @@
 #define COMPASS_CAL_ENABLED AP_COMPASS_ENABLED && AP_AHRS_DCM_ENABLED
 #endif
 
+// run each compass's calibration on its own thread on boards with spare cores
+#ifndef AP_COMPASS_CAL_THREAD_PER_COMPASS
+#define AP_COMPASS_CAL_THREAD_PER_COMPASS (COMPASS_CAL_ENABLED && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX))
+#endif
+
 #ifndef AP_COMPASS_CALIBRATION_FIXED_YAW_ENABLED
 #define AP_COMPASS_CALIBRATION_FIXED_YAW_ENABLED AP_COMPASS_ENABLED && AP_GPS_ENABLED && AP_AHRS_ENABLED
 #endif
@@ -606,28 +606,64 @@ void CompassCalibrator::calc_initial_offset()
     _params.offset /= _samples_collected;
 }
 
-void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const
+// build the normal equations (JTJ and JTFI) for the sphere or ellipsoid fit in a single pass over the samples.
+// The residual and both jacobians share the soft-iron corrected sample so it is only calculated once per sample,
+// and only the upper triangle of the symmetric JTJ is accumulated
+void CompassCalibrator::calc_normal_equations(bool ellipsoid, const param_t& params, float* JTJ, float* JTFI) const
 {
+    const uint8_t num_params = ellipsoid ? COMPASS_CAL_NUM_ELLIPSOID_PARAMS : COMPASS_CAL_NUM_SPHERE_PARAMS;
+    memset(JTJ, 0, sizeof(float) * num_params * num_params);
+    memset(JTFI, 0, sizeof(float) * num_params);
+
     const Vector3f &offset = params.offset;
     const Vector3f &diag = params.diag;
     const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
 
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
-
-    // 0: partial derivative (radius wrt fitness fn) fn operated on sample
-    ret[0] = 1.0f;
-    // 1-3: partial derivative (offsets wrt fitness fn) fn operated on sample
-    ret[1] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[2] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
+    for (uint16_t k = 0; k < _samples_collected; k++) {
+        // sample with offsets applied
+        const Vector3f s = _sample_buffer[k].get() + offset;
+
+        // soft-iron corrected sample
+        const float A = (diag.x    * s.x) + (offdiag.x * s.y) + (offdiag.y * s.z);
+        const float B = (offdiag.x * s.x) + (diag.y    * s.y) + (offdiag.z * s.z);
+        const float C = (offdiag.y * s.x) + (offdiag.z * s.y) + (diag.z    * s.z);
+        const float length = sqrtf(A*A + B*B + C*C);
+        const float residual = params.radius - length;
+        const float inv_length = -1.0f / length;
+
+        // partial derivatives of the residual. The sphere fit's parameters are radius and offsets,
+        // the ellipsoid fit's are offsets, diagonals and off-diagonals
+        float jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+        float *jo = ellipsoid ? &jacob[0] : &jacob[1];
+        jacob[0] = 1.0f;
+        jo[0] = ((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C)) * inv_length;
+        jo[1] = ((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C)) * inv_length;
+        jo[2] = ((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C)) * inv_length;
+        if (ellipsoid) {
+            jacob[3] = (s.x * A) * inv_length;
+            jacob[4] = (s.y * B) * inv_length;
+            jacob[5] = (s.z * C) * inv_length;
+            jacob[6] = ((s.y * A) + (s.x * B)) * inv_length;
+            jacob[7] = ((s.z * A) + (s.x * C)) * inv_length;
+            jacob[8] = ((s.z * B) + (s.y * C)) * inv_length;
+        }
+
+        for (uint8_t i = 0; i < num_params; i++) {
+            const float ji = jacob[i];
+            float *row = &JTJ[i*num_params];
+            for (uint8_t j = i; j < num_params; j++) {
+                row[j] += ji * jacob[j];
+            }
+            JTFI[i] += ji * residual;
+        }
+    }
+
+    // fill in the lower triangle
+    for (uint8_t i = 1; i < num_params; i++) {
+        for (uint8_t j = 0; j < i; j++) {
+            JTJ[i*num_params+j] = JTJ[j*num_params+i];
+        }
+    }
 }
 
 // run sphere fit to calculate diagonals and offdiagonals
@@ -645,28 +681,13 @@ void CompassCalibrator::run_sphere_fit()
     param_t fit1_params, fit2_params;
     fit1_params = fit2_params = _params;
 
-    float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
+    float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
+    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];
+    float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS];
 
     // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
-
-        float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
-
-        calc_sphere_jacob(sample, fit1_params, sphere_jacob);
-
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
-                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
-            }
-            // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
-        }
-    }
+    calc_normal_equations(false, fit1_params, JTJ, JTFI);
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));   //a backup JTJ for LM
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
@@ -717,36 +738,6 @@ void CompassCalibrator::run_sphere_fit()
     }
 }
 
-void CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const
-{
-    const Vector3f &offset = params.offset;
-    const Vector3f &diag = params.diag;
-    const Vector3f &offdiag = params.offdiag;
-    Matrix3f softiron(
-        diag.x    , offdiag.x , offdiag.y,
-        offdiag.x , diag.y    , offdiag.z,
-        offdiag.y , offdiag.z , diag.z
-    );
-
-    float A =  (diag.x    * (sample.x + offset.x)) + (offdiag.x * (sample.y + offset.y)) + (offdiag.y * (sample.z + offset.z));
-    float B =  (offdiag.x * (sample.x + offset.x)) + (diag.y    * (sample.y + offset.y)) + (offdiag.z * (sample.z + offset.z));
-    float C =  (offdiag.y * (sample.x + offset.x)) + (offdiag.z * (sample.y + offset.y)) + (diag.z    * (sample.z + offset.z));
-    float length = (softiron*(sample+offset)).length();
-
-    // 0-2: partial derivative (offset wrt fitness fn) fn operated on sample
-    ret[0] = -1.0f * (((diag.x    * A) + (offdiag.x * B) + (offdiag.y * C))/length);
-    ret[1] = -1.0f * (((offdiag.x * A) + (diag.y    * B) + (offdiag.z * C))/length);
-    ret[2] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
-    // 3-5: partial derivative (diag offset wrt fitness fn) fn operated on sample
-    ret[3] = -1.0f * ((sample.x + offset.x) * A)/length;
-    ret[4] = -1.0f * ((sample.y + offset.y) * B)/length;
-    ret[5] = -1.0f * ((sample.z + offset.z) * C)/length;
-    // 6-8: partial derivative (off-diag offset wrt fitness fn) fn operated on sample
-    ret[6] = -1.0f * (((sample.y + offset.y) * A) + ((sample.x + offset.x) * B))/length;
-    ret[7] = -1.0f * (((sample.z + offset.z) * A) + ((sample.x + offset.x) * C))/length;
-    ret[8] = -1.0f * (((sample.z + offset.z) * B) + ((sample.y + offset.y) * C))/length;
-}
-
 void CompassCalibrator::run_ellipsoid_fit()
 {
     if (_sample_buffer == nullptr) {
@@ -761,28 +752,13 @@ void CompassCalibrator::run_ellipsoid_fit()
     param_t fit1_params, fit2_params;
     fit1_params = fit2_params = _params;
 
-    float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
+    float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+    float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
 
     // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
-
-        float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
-
-        calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
-
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-            }
-            // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
-        }
-    }
+    calc_normal_equations(true, fit1_params, JTJ, JTFI);
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));   //a backup JTJ for LM
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
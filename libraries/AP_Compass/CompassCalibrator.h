@@ -181,12 +181,13 @@ private:
     // calculate initial offsets by simply taking the average values of the samples
     void calc_initial_offset();
 
+    // build the normal equations for the sphere or ellipsoid fit from all samples in a single pass
+    void calc_normal_equations(bool ellipsoid, const param_t& params, float* JTJ, float* JTFI) const;
+
     // run sphere fit to calculate diagonals and offdiagonals
-    void calc_sphere_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_sphere_fit();
 
     // run ellipsoid fit to calculate diagonals and offdiagonals
-    void calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_ellipsoid_fit();
 
     // update the completion mask based on a single sample
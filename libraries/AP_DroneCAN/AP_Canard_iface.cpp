@@ -108,6 +108,9 @@ bool CanardInterface::broadcast(const Canard::Transfer &bcast_transfer) {
     } else {
         protocol_stats.tx_frames += ret;
     }
+    if (msg_stats_enabled) {
+        update_tx_msg_stats(tx_transfer.data_type_id, ret > 0);
+    }
     return ret > 0;
 }
 
@@ -140,6 +143,9 @@ bool CanardInterface::request(uint8_t destination_node_id, const Canard::Transfe
     } else {
         protocol_stats.tx_frames += ret;
     }
+    if (msg_stats_enabled) {
+        update_tx_msg_stats(tx_transfer.data_type_id, ret > 0);
+    }
     return ret > 0;
 }
 
@@ -172,11 +178,17 @@ bool CanardInterface::respond(uint8_t destination_node_id, const Canard::Transfe
     } else {
         protocol_stats.tx_frames += ret;
     }
+    if (msg_stats_enabled) {
+        update_tx_msg_stats(tx_transfer.data_type_id, ret > 0);
+    }
     return ret > 0;
 }
 
 void CanardInterface::onTransferReception(CanardInstance* ins, CanardRxTransfer* transfer) {
     CanardInterface* iface = (CanardInterface*) ins->user_reference;
+    if (iface->msg_stats_enabled) {
+        iface->update_rx_msg_stats(*transfer);
+    }
     iface->handle_message(*transfer);
 }
 
@@ -186,7 +198,114 @@ bool CanardInterface::shouldAcceptTransfer(const CanardInstance* ins,
                                            CanardTransferType transfer_type,
                                            uint8_t source_node_id) {
     CanardInterface* iface = (CanardInterface*) ins->user_reference;
-    return iface->accept_message(data_type_id, *out_data_type_signature);
+    return iface->accept_message_cached(data_type_id, *out_data_type_signature);
+}
+
+/*
+  find whether we have a handler for a data type. This is called for
+  every new incoming transfer, so the result is kept in a small hash
+  table to avoid walking the list of registered handlers each time.
+  Handlers can be registered at any time, so rejections are looked up
+  again after a second
+ */
+bool CanardInterface::accept_message_cached(uint16_t data_type_id, uint64_t &signature)
+{
+    const uint8_t max_probes = 8;
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint16_t hash = data_type_id ^ (data_type_id >> 5) ^ (data_type_id >> 11);
+    AcceptCacheEntry *slot = nullptr;
+    for (uint8_t i=0; i<max_probes; i++) {
+        auto &e = accept_cache[(hash + i) & (AP_DRONECAN_ACCEPT_CACHE_SIZE-1)];
+        if (!e.valid) {
+            slot = &e;
+            break;
+        }
+        if (e.data_type_id != data_type_id) {
+            continue;
+        }
+        if (e.accept) {
+            signature = e.signature;
+            return true;
+        }
+        if (now_ms - e.rejected_ms < 1000) {
+            return false;
+        }
+        slot = &e;
+        break;
+    }
+
+    const bool accept = accept_message(data_type_id, signature);
+    if (slot != nullptr) {
+        // if the table is full around this hash we just don't cache
+        slot->data_type_id = data_type_id;
+        slot->signature = signature;
+        slot->rejected_ms = now_ms;
+        slot->accept = accept;
+        slot->valid = true;
+    }
+    return accept;
+}
+
+/*
+  find or allocate the stats entry for a data type, must be called
+  with msg_stats_sem held
+ */
+CanardInterface::MsgStats *CanardInterface::find_msg_stats(uint16_t data_type_id)
+{
+    for (uint8_t i=0; i<num_msg_stats; i++) {
+        if (msg_stats[i].data_type_id == data_type_id) {
+            return &msg_stats[i];
+        }
+    }
+    if (num_msg_stats >= ARRAY_SIZE(msg_stats)) {
+        return nullptr;
+    }
+    MsgStats &s = msg_stats[num_msg_stats++];
+    memset(&s, 0, sizeof(s));
+    s.data_type_id = data_type_id;
+    return &s;
+}
+
+void CanardInterface::update_tx_msg_stats(uint16_t data_type_id, bool success)
+{
+    WITH_SEMAPHORE(msg_stats_sem);
+    MsgStats *s = find_msg_stats(data_type_id);
+    if (s == nullptr) {
+        return;
+    }
+    if (success) {
+        s->tx_transfers++;
+    } else {
+        s->tx_errors++;
+    }
+}
+
+void CanardInterface::update_rx_msg_stats(const CanardRxTransfer &transfer)
+{
+    // latency from reception of the first frame to dispatch of the transfer
+    const uint64_t now_us = AP_HAL::micros64();
+    const uint32_t latency_us = now_us > transfer.timestamp_usec ? uint32_t(MIN(now_us - transfer.timestamp_usec, UINT32_MAX)) : 0;
+
+    WITH_SEMAPHORE(msg_stats_sem);
+    MsgStats *s = find_msg_stats(transfer.data_type_id);
+    if (s == nullptr) {
+        return;
+    }
+    s->rx_transfers++;
+    s->rx_latency_sum_us += latency_us;
+    s->rx_latency_max_us = MAX(s->rx_latency_max_us, latency_us);
+}
+
+/*
+  copy out the per message type stats and reset them
+ */
+uint8_t CanardInterface::get_msg_stats(MsgStats *stats, uint8_t max_stats)
+{
+    WITH_SEMAPHORE(msg_stats_sem);
+    const uint8_t n = MIN(num_msg_stats, max_stats);
+    memcpy(stats, msg_stats, n * sizeof(MsgStats));
+    num_msg_stats = 0;
+    return n;
 }
 
 #if AP_TEST_DRONECAN_DRIVERS
@@ -229,54 +348,64 @@ void CanardInterface::processTx(bool raw_commands_only = false) {
             */
             iface_down = false;
         } 
-        // scan through list of pending transfers
-        while (true) {
-            auto txf = &txq->frame;
-            if (raw_commands_only &&
-                CANARD_MSG_TYPE_FROM_ID(txf->id) != UAVCAN_EQUIPMENT_ESC_RAWCOMMAND_ID &&
-                CANARD_MSG_TYPE_FROM_ID(txf->id) != COM_HOBBYWING_ESC_RAWCOMMAND_ID) {
-                // look at next transfer
-                txq = txq->next;
-                if (txq == nullptr) {
-                    break;
+        const uint64_t now_us = AP_HAL::micros64();
+        const uint8_t iface_bit = 1U<<iface;
+
+        /*
+          scan through list of pending transfers, handing frames to
+          the interface in batches
+         */
+        AP_HAL::CANFrame batch[AP_DRONECAN_TX_BATCH_SIZE];
+        uint64_t batch_deadline[AP_DRONECAN_TX_BATCH_SIZE];
+        CanardCANFrame *batch_txf[AP_DRONECAN_TX_BATCH_SIZE];
+        bool iface_full = false;
+        while (txq != nullptr && !iface_full) {
+            uint8_t n = 0;
+            for (; txq != nullptr && n < AP_DRONECAN_TX_BATCH_SIZE; txq = txq->next) {
+                auto txf = &txq->frame;
+                if (!(txf->iface_mask & iface_bit) || now_us >= txf->deadline_usec) {
+                    // already sent on this interface or expired
+                    continue;
                 }
-                continue;
-            }
-            AP_HAL::CANFrame txmsg {};
-            txmsg.dlc = AP_HAL::CANFrame::dataLengthToDlc(txf->data_len);
-            memcpy(txmsg.data, txf->data, txf->data_len);
-            txmsg.id = (txf->id | AP_HAL::CANFrame::FlagEFF);
+                if (raw_commands_only &&
+                    CANARD_MSG_TYPE_FROM_ID(txf->id) != UAVCAN_EQUIPMENT_ESC_RAWCOMMAND_ID &&
+                    CANARD_MSG_TYPE_FROM_ID(txf->id) != COM_HOBBYWING_ESC_RAWCOMMAND_ID) {
+                    continue;
+                }
+                AP_HAL::CANFrame &txmsg = batch[n];
+                txmsg = {};
+                txmsg.dlc = AP_HAL::CANFrame::dataLengthToDlc(txf->data_len);
+                memcpy(txmsg.data, txf->data, txf->data_len);
+                txmsg.id = (txf->id | AP_HAL::CANFrame::FlagEFF);
 #if HAL_CANFD_SUPPORTED
-            txmsg.canfd = txf->canfd;
+                txmsg.canfd = txf->canfd;
 #endif
-            bool write = true;
-            bool read = false;
-            ifaces[iface]->select(read, write, &txmsg, 0);
-            if (!write) {
-                // if there is no space then we need to start from the
-                // top of the queue, so wait for the next loop
-                if (!iface_down) {
+                batch_deadline[n] = txf->deadline_usec;
+                batch_txf[n] = txf;
+                n++;
+            }
+
+            uint8_t i = 0;
+            while (i < n) {
+                const uint8_t sent = ifaces[iface]->send_frames(&batch[i], &batch_deadline[i], n - i, 0);
+                // clear the mask for the frames that were sent
+                for (uint8_t j = i; j < i + sent; j++) {
+                    batch_txf[j]->iface_mask &= ~iface_bit;
+                }
+                i += sent;
+                if (i >= n) {
                     break;
-                } else {
-                    txf->iface_mask &= ~(1U<<iface);
                 }
-            } else if ((txf->iface_mask & (1U<<iface)) && (AP_HAL::micros64() < txf->deadline_usec)) {
-                // try sending to interfaces, clearing the mask if we succeed
-                if (ifaces[iface]->send(txmsg, txf->deadline_usec, 0) > 0) {
-                    txf->iface_mask &= ~(1U<<iface);
-                } else {
-                    // if we fail to send then we try sending on next interface
-                    if (!iface_down) {
-                        break;
-                    } else {
-                        txf->iface_mask &= ~(1U<<iface);
-                    }
+                if (!iface_down) {
+                    // if there is no space then we need to start from the
+                    // top of the queue, so wait for the next loop
+                    iface_full = true;
+                    break;
                 }
-            }
-            // look at next transfer
-            txq = txq->next;
-            if (txq == nullptr) {
-                break;
+                // the interface is down, give up on this frame for
+                // this interface and try the next
+                batch_txf[i]->iface_mask &= ~iface_bit;
+                i++;
             }
         }
     }
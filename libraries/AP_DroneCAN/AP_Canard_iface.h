@@ -4,6 +4,21 @@
 #include <canard/interface.h>
 #include <dronecan_msgs.h>
 
+// max number of frames handed to the CAN interface in one call
+#ifndef AP_DRONECAN_TX_BATCH_SIZE
+#define AP_DRONECAN_TX_BATCH_SIZE 8
+#endif
+
+// number of slots in the data type ID to accept result table, must be a power of 2
+#ifndef AP_DRONECAN_ACCEPT_CACHE_SIZE
+#define AP_DRONECAN_ACCEPT_CACHE_SIZE 64
+#endif
+
+// number of message types we keep per-type transfer statistics for
+#ifndef AP_DRONECAN_MSG_STATS_SIZE
+#define AP_DRONECAN_MSG_STATS_SIZE 16
+#endif
+
 class AP_DroneCAN;
 class CANSensor;
 
@@ -64,7 +79,32 @@ public:
     void update_rx_protocol_stats(int16_t res);
 
     uint8_t get_node_id() const override { return canard.node_id; }
+
+    // per message type transfer statistics
+    struct MsgStats {
+        uint16_t data_type_id;
+        uint32_t rx_transfers;
+        uint32_t rx_latency_sum_us;
+        uint32_t rx_latency_max_us;
+        uint32_t tx_transfers;
+        uint32_t tx_errors;
+    };
+
+    // enable or disable collection of per message type statistics
+    void set_msg_stats_enabled(bool enabled) { msg_stats_enabled = enabled; }
+
+    // copy out and reset per message type statistics, returns number
+    // of entries filled in
+    uint8_t get_msg_stats(MsgStats *stats, uint8_t max_stats);
+
 private:
+    // cached lookup of whether we have a handler for a data type
+    bool accept_message_cached(uint16_t data_type_id, uint64_t &signature);
+
+    MsgStats *find_msg_stats(uint16_t data_type_id);
+    void update_tx_msg_stats(uint16_t data_type_id, bool success);
+    void update_rx_msg_stats(const CanardRxTransfer &transfer);
+
     CanardInstance canard;
     AP_HAL::CANIface* ifaces[HAL_NUM_CAN_IFACES];
 #if AP_TEST_DRONECAN_DRIVERS
@@ -81,5 +121,19 @@ private:
 
     // auxillary 11 bit CANSensor
     CANSensor *aux_11bit_driver;
+
+    // open addressed table of accept results, protected by _sem_rx
+    struct AcceptCacheEntry {
+        uint64_t signature;
+        uint32_t rejected_ms;
+        uint16_t data_type_id;
+        bool valid;
+        bool accept;
+    } accept_cache[AP_DRONECAN_ACCEPT_CACHE_SIZE];
+
+    bool msg_stats_enabled;
+    HAL_Semaphore msg_stats_sem;
+    MsgStats msg_stats[AP_DRONECAN_MSG_STATS_SIZE];
+    uint8_t num_msg_stats;
 };
 #endif // HAL_ENABLE_DRONECAN_DRIVERS
@@ -1917,6 +1917,42 @@ void AP_DroneCAN::logging(void)
         return;
     }
     last_log_ms = now_ms;
+
+    // per message type rates and receive latency
+    const bool log_msg_stats = option_is_set(Options::ENABLE_STATS);
+    canard_iface.set_msg_stats_enabled(log_msg_stats);
+    if (log_msg_stats) {
+        CanardInterface::MsgStats msg_stats[AP_DRONECAN_MSG_STATS_SIZE];
+        const uint8_t n = canard_iface.get_msg_stats(msg_stats, ARRAY_SIZE(msg_stats));
+        const uint64_t now_us = AP_HAL::micros64();
+        for (uint8_t i=0; i<n; i++) {
+            const auto &ms = msg_stats[i];
+            // @LoggerMessage: CANM
+            // @Description: DroneCAN per message type statistics
+            // @Field: TimeUS: Time since system startup
+            // @Field: I: driver index
+            // @Field: Id: DroneCAN data type ID
+            // @Field: RxN: transfers received
+            // @Field: RxLat: average receive latency
+            // @Field: RxLMx: longest receive latency
+            // @Field: TxN: transfers sent
+            // @Field: TxE: transfers that failed to send
+            AP::logger().WriteStreaming("CANM",
+                                        "TimeUS,I,Id,RxN,RxLat,RxLMx,TxN,TxE",
+                                        "s#--ss--",
+                                        "F---FF--",
+                                        "QBHIIIII",
+                                        now_us,
+                                        _driver_index,
+                                        ms.data_type_id,
+                                        ms.rx_transfers,
+                                        ms.rx_transfers > 0 ? ms.rx_latency_sum_us / ms.rx_transfers : 0U,
+                                        ms.rx_latency_max_us,
+                                        ms.tx_transfers,
+                                        ms.tx_errors);
+        }
+    }
+
     if (HAL_NUM_CAN_IFACES <= _driver_index) {
         // no interface?
         return;
@@ -62,14 +62,14 @@ float AP_ESC_Telem::get_average_motor_rpm(uint32_t servo_channel_mask) const
     float rpm_avg = 0.0f;
     uint8_t valid_escs = 0;
 
+    float rpms[ESC_TELEM_MAX_ESCS];
+    const uint32_t valid_mask = get_all_rpms(rpms) & servo_channel_mask;
+
     // average the rpm of each motor
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
-        if (BIT_IS_SET(servo_channel_mask,i)) {
-            float rpm;
-            if (get_rpm(i, rpm)) {
-                rpm_avg += rpm;
-                valid_escs++;
-            }
+        if (BIT_IS_SET(valid_mask, i)) {
+            rpm_avg += rpms[i];
+            valid_escs++;
         }
     }
 
@@ -85,12 +85,15 @@ uint8_t AP_ESC_Telem::get_motor_frequencies_hz(uint8_t nfreqs, float* freqs) con
 {
     uint8_t valid_escs = 0;
 
+    float rpms[ESC_TELEM_MAX_ESCS];
+    uint32_t reported_mask;
+    const uint32_t valid_mask = get_all_rpms(rpms, &reported_mask);
+
     // average the rpm of each motor as reported by BLHeli and convert to Hz
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS && valid_escs < nfreqs; i++) {
-        float rpm;
-        if (get_rpm(i, rpm)) {
-            freqs[valid_escs++] = rpm * (1.0f / 60.0f);
-        } else if (was_rpm_data_ever_reported(_rpm_data[i])) {
+        if (BIT_IS_SET(valid_mask, i)) {
+            freqs[valid_escs++] = rpms[i] * (1.0f / 60.0f);
+        } else if (BIT_IS_SET(reported_mask, i)) {
             // if we have ever received data on an ESC, mark it as valid but with no data
             // this prevents large frequency shifts when ESCs disappear
             freqs[valid_escs++] = 0.0f;
@@ -100,6 +103,30 @@ uint8_t AP_ESC_Telem::get_motor_frequencies_hz(uint8_t nfreqs, float* freqs) con
     return MIN(valid_escs, nfreqs);
 }
 
+// get the slewed rpm of all ESCs in one pass, returns the mask of ESCs with valid data
+uint32_t AP_ESC_Telem::get_all_rpms(float *rpms, uint32_t *reported_mask) const
+{
+    uint32_t valid_mask = 0;
+    uint32_t reported = 0;
+    const uint32_t now = AP_HAL::micros();
+
+    for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
+        const AP_ESC_Telem_Backend::RpmData rpmdata = _rpm_data[i].read();
+        rpms[i] = 0.0f;
+        if (calc_slewed_rpm(i, rpmdata, now, rpms[i])) {
+            valid_mask |= (1U << i);
+        }
+        if (was_rpm_data_ever_reported(rpmdata)) {
+            reported |= (1U << i);
+        }
+    }
+
+    if (reported_mask != nullptr) {
+        *reported_mask = reported;
+    }
+    return valid_mask;
+}
+
 // get mask of ESCs that sent valid telemetry and/or rpm data in the last
 // ESC_TELEM_DATA_TIMEOUT_MS/ESC_RPM_DATA_TIMEOUT_US
 uint32_t AP_ESC_Telem::get_active_esc_mask() const {
@@ -107,12 +134,14 @@ uint32_t AP_ESC_Telem::get_active_esc_mask() const {
     const uint32_t now = AP_HAL::millis();
     uint32_t now_us = AP_HAL::micros();
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
-        if (_telem_data[i].last_update_ms == 0 && !was_rpm_data_ever_reported(_rpm_data[i])) {
+        const AP_ESC_Telem_Backend::TelemetryData &telemdata = _telem_data[i].published();
+        const AP_ESC_Telem_Backend::RpmData rpmdata = _rpm_data[i].read();
+        if (telemdata.last_update_ms == 0 && !was_rpm_data_ever_reported(rpmdata)) {
             // have never seen telem from this ESC
             continue;
         }
-        if (_telem_data[i].stale(now)
-            && !rpm_data_within_timeout(_rpm_data[i], now_us, ESC_RPM_DATA_TIMEOUT_US)) {
+        if (telemdata.stale(now)
+            && !rpm_data_within_timeout(i, rpmdata, now_us, ESC_RPM_DATA_TIMEOUT_US)) {
             continue;
         }
         ret |= (1U << i);
@@ -128,16 +157,18 @@ uint8_t AP_ESC_Telem::get_max_rpm_esc() const
     const uint32_t now = AP_HAL::millis();
     const uint32_t now_us = AP_HAL::micros();
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
-        if (_telem_data[i].last_update_ms == 0 && !was_rpm_data_ever_reported(_rpm_data[i])) {
+        const AP_ESC_Telem_Backend::TelemetryData &telemdata = _telem_data[i].published();
+        const AP_ESC_Telem_Backend::RpmData rpmdata = _rpm_data[i].read();
+        if (telemdata.last_update_ms == 0 && !was_rpm_data_ever_reported(rpmdata)) {
             // have never seen telem from this ESC
             continue;
         }
-        if (_telem_data[i].stale(now)
-            && !rpm_data_within_timeout(_rpm_data[i], now_us, ESC_RPM_DATA_TIMEOUT_US)) {
+        if (telemdata.stale(now)
+            && !rpm_data_within_timeout(i, rpmdata, now_us, ESC_RPM_DATA_TIMEOUT_US)) {
             continue;
         }
-        if (_rpm_data[i].rpm > max_rpm) {
-            max_rpm = _rpm_data[i].rpm;
+        if (rpmdata.rpm > max_rpm) {
+            max_rpm = rpmdata.rpm;
             ret = i;
         }
     }
@@ -157,9 +188,9 @@ bool AP_ESC_Telem::are_motors_running(uint32_t servo_channel_mask, float min_rpm
 
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
         if (BIT_IS_SET(servo_channel_mask, i)) {
-            const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[i];
+            const AP_ESC_Telem_Backend::RpmData rpmdata = _rpm_data[i].read();
             // we choose a relatively strict measure of health so that failsafe actions can rely on the results
-            if (!rpm_data_within_timeout(rpmdata, now, ESC_RPM_CHECK_TIMEOUT_US)) {
+            if (!rpm_data_within_timeout(i, rpmdata, now, ESC_RPM_CHECK_TIMEOUT_US)) {
                 return false;
             }
             if (rpmdata.rpm < min_rpm) {
@@ -179,7 +210,7 @@ bool AP_ESC_Telem::is_telemetry_active(uint32_t servo_channel_mask) const
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
         if (BIT_IS_SET(servo_channel_mask, i)) {
             // no data received
-            if (get_last_telem_data_ms(i) == 0 && !was_rpm_data_ever_reported(_rpm_data[i])) {
+            if (get_last_telem_data_ms(i) == 0 && !was_rpm_data_ever_reported(_rpm_data[i].published())) {
                 return false;
             }
         }
@@ -194,14 +225,17 @@ bool AP_ESC_Telem::get_rpm(uint8_t esc_index, float& rpm) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
+    return calc_slewed_rpm(esc_index, _rpm_data[esc_index].read(), AP_HAL::micros(), rpm);
+}
 
+// slew the rpm between updates using the update rate, returns true if the data is valid
+bool AP_ESC_Telem::calc_slewed_rpm(uint8_t esc_index, const AP_ESC_Telem_Backend::RpmData &rpmdata, uint32_t now, float &rpm) const
+{
     if (is_zero(rpmdata.update_rate_hz)) {
         return false;
     }
 
-    const uint32_t now = AP_HAL::micros();
-    if (rpm_data_within_timeout(rpmdata, now, ESC_RPM_DATA_TIMEOUT_US)) {
+    if (rpm_data_within_timeout(esc_index, rpmdata, now, ESC_RPM_DATA_TIMEOUT_US)) {
         const float slew = MIN(1.0f, (now - rpmdata.last_update_us) * rpmdata.update_rate_hz * (1.0f / 1e6f));
         rpm = (rpmdata.prev_rpm + (rpmdata.rpm - rpmdata.prev_rpm) * slew);
 
@@ -223,11 +257,11 @@ bool AP_ESC_Telem::get_raw_rpm(uint8_t esc_index, float& rpm) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
+    const AP_ESC_Telem_Backend::RpmData rpmdata = _rpm_data[esc_index].read();
 
     const uint32_t now = AP_HAL::micros();
 
-    if (!rpm_data_within_timeout(rpmdata, now, ESC_RPM_DATA_TIMEOUT_US)) {
+    if (!rpm_data_within_timeout(esc_index, rpmdata, now, ESC_RPM_DATA_TIMEOUT_US)) {
         return false;
     }
 
@@ -242,7 +276,7 @@ bool AP_ESC_Telem::get_temperature(uint8_t esc_index, int16_t& temp) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::TEMPERATURE | AP_ESC_Telem_Backend::TelemetryType::TEMPERATURE_EXTERNAL)) {
         return false;
     }
@@ -257,7 +291,7 @@ bool AP_ESC_Telem::get_motor_temperature(uint8_t esc_index, int16_t& temp) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::MOTOR_TEMPERATURE | AP_ESC_Telem_Backend::TelemetryType::MOTOR_TEMPERATURE_EXTERNAL)) {
         return false;
     }
@@ -288,7 +322,7 @@ bool AP_ESC_Telem::get_current(uint8_t esc_index, float& amps) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::CURRENT)) {
         return false;
     }
@@ -303,7 +337,7 @@ bool AP_ESC_Telem::get_voltage(uint8_t esc_index, float& volts) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::VOLTAGE)) {
         return false;
     }
@@ -318,7 +352,7 @@ bool AP_ESC_Telem::get_consumption_mah(uint8_t esc_index, float& consumption_mah
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::CONSUMPTION)) {
         return false;
     }
@@ -333,7 +367,7 @@ bool AP_ESC_Telem::get_usage_seconds(uint8_t esc_index, uint32_t& usage_s) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::USAGE)) {
         return false;
     }
@@ -349,7 +383,7 @@ bool AP_ESC_Telem::get_input_duty(uint8_t esc_index, uint8_t& input_duty) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::INPUT_DUTY)) {
         return false;
     }
@@ -364,7 +398,7 @@ bool AP_ESC_Telem::get_output_duty(uint8_t esc_index, uint8_t& output_duty) cons
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::OUTPUT_DUTY)) {
         return false;
     }
@@ -379,7 +413,7 @@ bool AP_ESC_Telem::get_flags(uint8_t esc_index, uint32_t& flags) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::FLAGS)) {
         return false;
     }
@@ -394,7 +428,7 @@ bool AP_ESC_Telem::get_power_percentage(uint8_t esc_index, uint8_t& power_percen
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::TelemetryData& telemdata = _telem_data[esc_index];
+    const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_index].read();
     if (!telemdata.valid(AP_ESC_Telem_Backend::TelemetryType::POWER_PERCENTAGE)) {
         return false;
     }
@@ -435,8 +469,8 @@ void AP_ESC_Telem::send_esc_telemetry_mavlink(uint8_t mav_chan)
         for (uint8_t j=0; j<4; j++) {
             const uint8_t esc_id = (i * 4 + j) + esc_offset;
             if (esc_id < ESC_TELEM_MAX_ESCS &&
-                (!_telem_data[esc_id].stale(now) ||
-                 rpm_data_within_timeout(_rpm_data[esc_id], now_us, ESC_RPM_DATA_TIMEOUT_US))) {
+                (!_telem_data[esc_id].published().stale(now) ||
+                 rpm_data_within_timeout(esc_id, _rpm_data[esc_id].read(), now_us, ESC_RPM_DATA_TIMEOUT_US))) {
                 all_stale = false;
                 break;
             }
@@ -456,7 +490,7 @@ void AP_ESC_Telem::send_esc_telemetry_mavlink(uint8_t mav_chan)
             if (esc_id >= ESC_TELEM_MAX_ESCS) {
                 continue;
             }
-            volatile AP_ESC_Telem_Backend::TelemetryData const &telemdata = _telem_data[esc_id];
+            const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[esc_id].read();
 
             s.temperature[j] = telemdata.temperature_cdeg / 100;
             s.voltage[j] = constrain_float(telemdata.voltage * 100.0f, 0, UINT16_MAX);
@@ -523,17 +557,16 @@ void AP_ESC_Telem::send_esc_telemetry_mavlink(uint8_t mav_chan)
 void AP_ESC_Telem::update_telem_data(const uint8_t esc_index, const AP_ESC_Telem_Backend::TelemetryData& new_data, const uint16_t data_mask)
 {
     // rpm and telemetry data are not protected by a semaphore even though updated from different threads
-    // all data is per-ESC and only written from the update thread and read by the user thread
-    // each element is a primitive type and the timestamp is only updated at the end, thus a caller
-    // can only get slightly more up-to-date information that perhaps they were expecting or might
-    // read data that has just gone stale - both of these are safe and avoid the overhead of locking
+    // all data is per-ESC, writers for an ESC serialise in begin_write() and the update is made
+    // in the unpublished buffer, only becoming visible to readers once complete, so readers
+    // always see a consistent record without the overhead of locking
 
     if (esc_index >= ESC_TELEM_MAX_ESCS || data_mask == 0) {
         return;
     }
 
     _have_data = true;
-    volatile AP_ESC_Telem_Backend::TelemetryData &telemdata = _telem_data[esc_index];
+    AP_ESC_Telem_Backend::TelemetryData &telemdata = _telem_data[esc_index].begin_write();
 
 #if AP_TEMPERATURE_SENSOR_ENABLED
     // always allow external data. Block "internal" if external has ever its ever been set externally then ignore normal "internal" updates
@@ -593,6 +626,8 @@ void AP_ESC_Telem::update_telem_data(const uint8_t esc_index, const AP_ESC_Telem
     telemdata.count++;
     telemdata.types |= data_mask;
     telemdata.last_update_ms = AP_HAL::millis();
+
+    _telem_data[esc_index].end_write();
 }
 
 // record an update to the RPM together with timestamp, this allows the notch values to be slewed
@@ -606,7 +641,7 @@ void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const float new_rpm, cons
     _have_data = true;
 
     const uint32_t now = MAX(1U ,AP_HAL::micros()); // don't allow a value of 0 in, as we use this as a flag in places
-    volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
+    AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index].begin_write();
     const auto last_update_us = rpmdata.last_update_us;
 
     rpmdata.prev_rpm = rpmdata.rpm;
@@ -616,6 +651,8 @@ void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const float new_rpm, cons
     rpmdata.error_rate = error_rate;
     rpmdata.data_valid = true;
 
+    _rpm_data[esc_index].end_write();
+
 #ifdef ESC_TELEM_DEBUG
     hal.console->printf("RPM: rate=%.1fhz, rpm=%f)\n", rpmdata.update_rate_hz, new_rpm);
 #endif
@@ -685,8 +722,8 @@ void AP_ESC_Telem::update()
     const uint64_t now_us64 = AP_HAL::micros64();
 
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
-        const volatile AP_ESC_Telem_Backend::RpmData &rpmdata = _rpm_data[i];
-        volatile AP_ESC_Telem_Backend::TelemetryData &telemdata = _telem_data[i];
+        const AP_ESC_Telem_Backend::RpmData rpmdata = _rpm_data[i].read();
+        const AP_ESC_Telem_Backend::TelemetryData telemdata = _telem_data[i].read();
         // Push received telemetry data into the logging system
         if (logger && logger->logging_enabled()) {
             if (telemdata.last_update_ms != _last_telem_log_ms[i]
@@ -798,9 +835,15 @@ void AP_ESC_Telem::update()
                 if (AP::logger().WriteBlock_first_succeed(&pkt_edt2, sizeof(pkt_edt2))) {
                     // Only clean the telem_updated bits if the write succeeded.
                     // This is important because, if rate limiting is enabled,
-                    // the log-on-change behavior may lose a lot of entries
-                    telemdata.edt2_status &= ~EDT2_TELEM_UPDATED;
-                    telemdata.edt2_stress &= ~EDT2_TELEM_UPDATED;
+                    // the log-on-change behavior may lose a lot of entries.
+                    // Leave them if a backend has merged in more data since
+                    // we took our copy, it gets logged next time
+                    AP_ESC_Telem_Backend::TelemetryData &edt2data = _telem_data[i].begin_write();
+                    if (edt2data.count == telemdata.count) {
+                        edt2data.edt2_status &= ~EDT2_TELEM_UPDATED;
+                        edt2data.edt2_stress &= ~EDT2_TELEM_UPDATED;
+                    }
+                    _telem_data[i].end_write();
                 }
             }
 #endif // AP_EXTENDED_DSHOT_TELEM_V2_ENABLED
@@ -810,14 +853,16 @@ void AP_ESC_Telem::update()
 
     const uint32_t now_us = AP_HAL::micros();
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
-        // Invalidate RPM data if not received for too long
-        if ((now_us - _rpm_data[i].last_update_us) > ESC_RPM_DATA_TIMEOUT_US) {
-            _rpm_data[i].data_valid = false;
+        // Remember RPM data that was not received for too long, the
+        // record itself is left to the backends
+        const uint32_t last_update_us = _rpm_data[i].published().last_update_us;
+        if (last_update_us != 0 && (now_us - last_update_us) > ESC_RPM_DATA_TIMEOUT_US) {
+            _rpm_expired_update_us[i] = last_update_us;
         }
     }
 }
 
-bool AP_ESC_Telem::rpm_data_within_timeout(const volatile AP_ESC_Telem_Backend::RpmData &instance, const uint32_t now_us, const uint32_t timeout_us)
+bool AP_ESC_Telem::rpm_data_within_timeout(uint8_t esc_index, const AP_ESC_Telem_Backend::RpmData &instance, const uint32_t now_us, const uint32_t timeout_us) const
 {
     // easy case, has the time window been crossed so it's invalid
     if ((now_us - instance.last_update_us) > timeout_us) {
@@ -828,10 +873,10 @@ bool AP_ESC_Telem::rpm_data_within_timeout(const volatile AP_ESC_Telem_Backend::
         return false;
     }
     // check if things generally expired on us, this is done to handle time wrapping
-    return instance.data_valid;
+    return instance.data_valid && instance.last_update_us != _rpm_expired_update_us[esc_index];
 }
 
-bool AP_ESC_Telem::was_rpm_data_ever_reported(const volatile AP_ESC_Telem_Backend::RpmData &instance)
+bool AP_ESC_Telem::was_rpm_data_ever_reported(const AP_ESC_Telem_Backend::RpmData &instance)
 {
     return instance.last_update_us > 0;
 }
@@ -7,6 +7,8 @@
 
 #if HAL_WITH_ESC_TELEM
 
+#include <atomic>
+
 #ifndef ESC_TELEM_MAX_ESCS
     #define ESC_TELEM_MAX_ESCS NUM_SERVO_CHANNELS
 #endif
@@ -34,9 +36,15 @@ public:
     // get an individual ESC's raw rpm if available
     bool get_raw_rpm(uint8_t esc_index, float& rpm) const;
 
-    // get raw telemetry data, used by IOMCU
-    const volatile AP_ESC_Telem_Backend::TelemetryData& get_telem_data(uint8_t esc_index) const {
-        return _telem_data[esc_index];
+    // get the slewed rpm of all ESCs in one pass. rpms must have space
+    // for ESC_TELEM_MAX_ESCS entries, ESCs without valid data are set
+    // to zero. Returns the mask of ESCs with valid data and optionally
+    // the mask of ESCs that have ever reported rpm
+    uint32_t get_all_rpms(float *rpms, uint32_t *reported_mask=nullptr) const;
+
+    // get a consistent copy of the raw telemetry data, used by IOMCU
+    AP_ESC_Telem_Backend::TelemetryData get_telem_data(uint8_t esc_index) const {
+        return _telem_data[esc_index].read();
     }
 
     // return the average motor RPM
@@ -105,7 +113,7 @@ public:
     // return the last time telemetry data was received in ms for the given ESC or 0 if never
     uint32_t get_last_telem_data_ms(uint8_t esc_index) const {
         if (esc_index >= ESC_TELEM_MAX_ESCS) {return 0;}
-        return _telem_data[esc_index].last_update_ms;
+        return _telem_data[esc_index].published().last_update_ms;
     }
 
     // send telemetry data to mavlink
@@ -133,9 +141,70 @@ public:
 
 private:
 
+    /*
+      per-ESC data is double buffered so that readers get a consistent
+      copy of all fields without taking a lock. A writer fills in the
+      buffer that is not published and then bumps seq to publish it. A
+      reader copies the published buffer and retries if seq moved while
+      it was copying. A writer that is preempted part way through an
+      update never stalls a reader, which keeps reading the previous
+      record. An ESC can be written from several threads, backends,
+      temperature sensors and battery monitors, so writers serialise on
+      a per-ESC semaphore that readers only take if the record keeps
+      changing under them
+     */
+    template <typename T>
+    class DoubleBuffered {
+    public:
+        // get a consistent copy of the published data
+        T read() const {
+            T ret;
+            for (uint8_t i=0; i<3; i++) {
+                const uint32_t s = seq.load(std::memory_order_acquire);
+                ret = buf[s & 1U];
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq.load(std::memory_order_relaxed) == s) {
+                    return ret;
+                }
+            }
+            // writers are updating faster than we can copy, wait for
+            // the current one to finish
+            WITH_SEMAPHORE(write_sem);
+            return buf[seq.load(std::memory_order_relaxed) & 1U];
+        }
+
+        // direct access to the published data, only for single field reads
+        const T &published() const {
+            return buf[seq.load(std::memory_order_acquire) & 1U];
+        }
+
+        // start an update, returning the unpublished buffer initialised
+        // from the published data. Must be followed by end_write()
+        T &begin_write() {
+            write_sem.take_blocking();
+            const uint32_t s = seq.load(std::memory_order_relaxed);
+            buf[(s+1) & 1U] = buf[s & 1U];
+            return buf[(s+1) & 1U];
+        }
+
+        // publish the buffer returned by begin_write()
+        void end_write() {
+            seq.fetch_add(1, std::memory_order_release);
+            write_sem.give();
+        }
+
+    private:
+        T buf[2] {};
+        std::atomic<uint32_t> seq {0};
+        mutable HAL_Semaphore write_sem;
+    };
+
+    // helper that slews the rpm between updates, returns false if the data is not valid
+    bool calc_slewed_rpm(uint8_t esc_index, const AP_ESC_Telem_Backend::RpmData &rpmdata, uint32_t now_us, float &rpm) const;
+
     // helper that validates RPM data
-    static bool rpm_data_within_timeout (const volatile AP_ESC_Telem_Backend::RpmData &instance, const uint32_t now_us, const uint32_t timeout_us);
-    static bool was_rpm_data_ever_reported (const volatile AP_ESC_Telem_Backend::RpmData &instance);
+    bool rpm_data_within_timeout (uint8_t esc_index, const AP_ESC_Telem_Backend::RpmData &instance, const uint32_t now_us, const uint32_t timeout_us) const;
+    static bool was_rpm_data_ever_reported (const AP_ESC_Telem_Backend::RpmData &instance);
 
 #if AP_EXTENDED_DSHOT_TELEM_V2_ENABLED
     // helpers that aggregate data in EDTv2 messages
@@ -144,9 +213,13 @@ private:
 #endif
 
     // rpm data
-    volatile AP_ESC_Telem_Backend::RpmData _rpm_data[ESC_TELEM_MAX_ESCS];
+    DoubleBuffered<AP_ESC_Telem_Backend::RpmData> _rpm_data[ESC_TELEM_MAX_ESCS];
     // telemetry data
-    volatile AP_ESC_Telem_Backend::TelemetryData _telem_data[ESC_TELEM_MAX_ESCS];
+    DoubleBuffered<AP_ESC_Telem_Backend::TelemetryData> _telem_data[ESC_TELEM_MAX_ESCS];
+
+    // last_update_us of rpm data that timed out, so it isn't treated as
+    // fresh once micros() wraps. Only written by update()
+    uint32_t _rpm_expired_update_us[ESC_TELEM_MAX_ESCS];
 
     uint32_t _last_telem_log_ms[ESC_TELEM_MAX_ESCS];
     uint32_t _last_rpm_log_us[ESC_TELEM_MAX_ESCS];
@@ -36,10 +36,14 @@ struct SysFileList {
 static const SysFileList sysfs_file_list[] = {
     {"threads.txt"},
     {"tasks.txt"},
+#if AP_SCHEDULER_ENABLED && AP_SCHEDULER_PROFILER_ENABLED
+    {"profile.txt"},
+#endif
     {"dma.txt"},
     {"memory.txt"},
     {"uarts.txt"},
     {"timers.txt"},
+    {"buses.txt"},
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     {"can_log.txt"},
 #endif
@@ -52,6 +56,7 @@ static const SysFileList sysfs_file_list[] = {
 #endif
     {"crash_dump.bin"},
     {"storage.bin"},
+    {"storage.txt"},
 #if AP_FILESYSTEM_SYS_FLASH_ENABLED
     {"flash.bin"},
 #endif
@@ -105,6 +110,11 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
     if (strcmp(fname, "tasks.txt") == 0) {
         AP::scheduler().task_info(*r.str);
     }
+#if AP_SCHEDULER_PROFILER_ENABLED
+    if (strcmp(fname, "profile.txt") == 0) {
+        AP::scheduler().profile_info(*r.str);
+    }
+#endif
 #endif
     if (strcmp(fname, "dma.txt") == 0) {
         hal.util->dma_info(*r.str);
@@ -120,6 +130,9 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
     if (strcmp(fname, "timers.txt") == 0) {
         hal.util->timer_info(*r.str);
     }
+    if (strcmp(fname, "buses.txt") == 0) {
+        hal.util->bus_info(*r.str);
+    }
 #if HAL_CANMANAGER_ENABLED
     if (strcmp(fname, "can_log.txt") == 0) {
         AP::can().log_retrieve(*r.str);
@@ -155,6 +168,9 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
             r.str->set_buffer((char*)ptr, size, size);
         }
     }
+    if (strcmp(fname, "storage.txt") == 0) {
+        hal.storage->storage_info(*r.str);
+    }
 #if AP_FILESYSTEM_SYS_FLASH_ENABLED
     if (strcmp(fname, "flash.bin") == 0) {
         void *ptr = (void*)0x08000000;
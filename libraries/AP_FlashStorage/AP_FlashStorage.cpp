@@ -148,6 +148,9 @@ bool AP_FlashStorage::switch_full_sector(void)
     in_switch_full_sector = true;
     bool ret = protected_switch_full_sector();
     in_switch_full_sector = false;
+    if (ret) {
+        stats.compactions++;
+    }
     return ret;
 }
 
@@ -180,7 +183,8 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
         return false;
     }
     //debug("write at %u for %u write_offset=%u\n", offset, length, write_offset);
-    
+    stats.write_calls++;
+
     while (length > 0) {
         uint8_t n = max_write;
 #if AP_FLASHSTORAGE_TYPE != AP_FLASHSTORAGE_TYPE_H7 && AP_FLASHSTORAGE_TYPE != AP_FLASHSTORAGE_TYPE_G4
@@ -240,6 +244,8 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 #endif
 
         write_offset += sizeof(blk.header) + block_nbytes;
+        stats.records_written++;
+        stats.bytes_written += block_nbytes;
 
         uint8_t n2 = block_nbytes - (offset % block_size);
         //debug("write_block at %u for %u n2=%u\n", block_ofs, block_nbytes, n2);
@@ -437,6 +443,7 @@ bool AP_FlashStorage::switch_sectors(void)
 
     // switch sectors
     current_sector = new_sector;
+    stats.sector_switches++;
         
     // we need to reserve some space in next sector to ensure we can successfully do a
     // full write out on init()
@@ -91,6 +91,10 @@ private:
 #endif
     static const uint16_t num_blocks = (HAL_STORAGE_SIZE+(block_size-1)) / block_size;
 
+    static constexpr uint16_t gcd(uint16_t a, uint16_t b) {
+        return b == 0 ? a : gcd(b, a % b);
+    }
+
 public:
     // caller provided function to write to a flash sector
     FUNCTOR_TYPEDEF(FlashWrite, bool, uint8_t , uint32_t , const uint8_t *, uint16_t );
@@ -132,7 +136,27 @@ public:
 
     // fixed storage size
     static const uint16_t storage_size = HAL_STORAGE_SIZE;
-    
+
+    // largest number of bytes that fits in a single flash record
+    static const uint8_t max_record_size = max_write;
+
+    // size of a batch of line_size byte lines that is a whole number of
+    // full flash records, the least common multiple of the two. Callers
+    // that coalesce dirty lines should batch writes up to this size
+    static constexpr uint16_t record_batch_size(uint16_t line_size) {
+        return line_size / gcd(line_size, max_write) * max_write;
+    }
+
+    // counters for monitoring flash wear and write batching
+    struct Stats {
+        uint32_t records_written;   // number of block records written
+        uint32_t bytes_written;     // data bytes written in block records
+        uint32_t write_calls;       // number of calls to write()
+        uint32_t sector_switches;   // number of times we moved to the other sector
+        uint32_t compactions;       // number of full sector switches (with erase)
+    };
+    const Stats &get_stats(void) const { return stats; }
+
 private:
     uint8_t *mem_buffer;
     const uint32_t flash_sector_size;
@@ -145,6 +169,7 @@ private:
     uint32_t write_offset;
     uint32_t reserved_space;
     bool write_error;
+    Stats stats;
 
     // 24 bit signature
 #if AP_FLASHSTORAGE_TYPE == AP_FLASHSTORAGE_TYPE_F4
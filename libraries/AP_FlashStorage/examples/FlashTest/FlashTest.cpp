@@ -5,6 +5,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_FlashStorage/AP_FlashStorage.h>
+#include <AP_Common/Bitmask.h>
 #include <stdio.h>
 #include <AP_HAL/utility/sparse-endian.h>
 
@@ -40,6 +41,15 @@ private:
     // write to storage and mem_mirror
     void write(uint16_t offset, const uint8_t *data, uint16_t length);
 
+    // throughput benchmark of committing each write versus
+    // coalescing dirty lines into batched records
+    static const uint8_t bench_line_size = 8;
+    static const uint16_t bench_num_lines = AP_FlashStorage::storage_size / bench_line_size;
+    Bitmask<bench_num_lines> dirty_lines;
+    void bench_write(uint16_t offset, const uint8_t *data, uint16_t length, bool coalesce);
+    void bench_flush(void);
+    void run_benchmark(const char *name, bool coalesce);
+
     bool erase_ok;
 };
 
@@ -127,6 +137,99 @@ void FlashTest::write(uint16_t offset, const uint8_t *data, uint16_t length)
     }
 }
 
+/*
+  write to mem_buffer, either committing to flash immediately or
+  just marking the affected lines as dirty
+ */
+void FlashTest::bench_write(uint16_t offset, const uint8_t *data, uint16_t length, bool coalesce)
+{
+    memcpy(&mem_mirror[offset], data, length);
+    memcpy(&mem_buffer[offset], data, length);
+    if (!coalesce) {
+        if (!storage.write(offset, length)) {
+            AP_HAL::panic("FATAL: bench write failed at %u", unsigned(offset));
+        }
+        return;
+    }
+    for (uint16_t line=offset/bench_line_size; line<=(offset+length-1)/bench_line_size; line++) {
+        dirty_lines.set(line);
+    }
+}
+
+/*
+  commit runs of contiguous dirty lines, each run up to a whole number
+  of flash records, as done by the HAL storage write-back
+ */
+void FlashTest::bench_flush(void)
+{
+    const uint16_t batch_lines = AP_FlashStorage::record_batch_size(bench_line_size) / bench_line_size;
+    int16_t first;
+    while ((first = dirty_lines.first_set()) >= 0) {
+        uint16_t nlines = 1;
+        while (nlines < batch_lines &&
+               first+nlines < bench_num_lines &&
+               dirty_lines.get(first+nlines)) {
+            nlines++;
+        }
+        if (!storage.write(first*bench_line_size, nlines*bench_line_size)) {
+            AP_HAL::panic("FATAL: bench flush failed at %u", unsigned(first));
+        }
+        for (uint16_t n=0; n<nlines; n++) {
+            dirty_lines.clear(first+n);
+        }
+    }
+}
+
+/*
+  emulate repeated mission uploads and parameter bulk sets
+ */
+void FlashTest::run_benchmark(const char *name, bool coalesce)
+{
+    const AP_FlashStorage::Stats before = storage.get_stats();
+    const uint64_t start_us = AP_HAL::micros64();
+    const uint16_t mission_item_size = 15;
+    const uint16_t burst_size = 50;
+
+    erase_ok = true;
+    for (uint16_t pass=0; pass<20; pass++) {
+        // mission upload: sequential packed 15 byte commands
+        for (uint16_t ofs=0; ofs+mission_item_size <= sizeof(mem_buffer)/2; ofs += mission_item_size) {
+            uint8_t cmd[mission_item_size];
+            for (uint8_t j=0; j<mission_item_size; j++) {
+                cmd[j] = get_random16() & 0xFF;
+            }
+            bench_write(ofs, cmd, mission_item_size, coalesce);
+            if (coalesce && (ofs / mission_item_size) % burst_size == 0) {
+                bench_flush();
+            }
+        }
+        bench_flush();
+        // parameter bulk set: small scattered writes in the upper half
+        for (uint16_t i=0; i<1000; i++) {
+            const uint16_t ofs = sizeof(mem_buffer)/2 + (get_random16() % (sizeof(mem_buffer)/2 - 4));
+            const uint32_t v = get_random16();
+            bench_write(ofs, (const uint8_t *)&v, sizeof(v), coalesce);
+            if (coalesce && i % burst_size == 0) {
+                bench_flush();
+            }
+        }
+        bench_flush();
+    }
+
+    const uint64_t dt_us = AP_HAL::micros64() - start_us;
+    const AP_FlashStorage::Stats &after = storage.get_stats();
+    if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
+        AP_HAL::panic("FATAL: data mis-match in benchmark %s", name);
+    }
+    hal.console->printf("%-10s records=%lu bytes=%lu switches=%lu compactions=%lu time=%.3fms\n",
+                        name,
+                        (unsigned long)(after.records_written - before.records_written),
+                        (unsigned long)(after.bytes_written - before.bytes_written),
+                        (unsigned long)(after.sector_switches - before.sector_switches),
+                        (unsigned long)(after.compactions - before.compactions),
+                        dt_us*1.0e-3);
+}
+
 /*
  * test flash storage
  */
@@ -185,6 +288,11 @@ void FlashTest::loop(void)
     if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
         AP_HAL::panic("FATAL: data mis-match");
     }
+
+    // throughput benchmark
+    run_benchmark("immediate", false);
+    run_benchmark("coalesced", true);
+
     while (true) {
         hal.console->printf("TEST PASSED");
         hal.scheduler->delay(20000);
@@ -1629,8 +1629,12 @@ bool AP_GPS::parse_rtcm_injection(mavlink_channel_t chan, const mavlink_gps_rtcm
         }
         GCS_SEND_TEXT(MAV_SEVERITY_INFO, "GPS: RTCM parsing for chan %u", unsigned(chan));
     }
-    for (uint16_t i=0; i<pkt.len; i++) {
-        if (rtcm.parsers[chan]->read(pkt.data[i])) {
+    uint16_t ofs = 0;
+    while (ofs < pkt.len) {
+        uint16_t consumed;
+        const bool found = rtcm.parsers[chan]->read(&pkt.data[ofs], pkt.len - ofs, consumed);
+        ofs += consumed;
+        if (found) {
             // we have a full message, inject it
             const uint8_t *buf = nullptr;
             uint16_t len = rtcm.parsers[chan]->get_len(buf);
@@ -548,8 +548,11 @@ void AP_GPS_DroneCAN::handle_moving_baseline_msg(const ardupilot_gnss_MovingBase
     if (rtcm3_parser == nullptr) {
         return;
     }
-    for (int i=0; i < msg.data.len; i++) {
-        rtcm3_parser->read(msg.data.data[i]);
+    uint16_t ofs = 0;
+    while (ofs < msg.data.len) {
+        uint16_t consumed;
+        rtcm3_parser->read(&msg.data.data[ofs], msg.data.len - ofs, consumed);
+        ofs += consumed;
     }
 }
 
@@ -634,6 +634,21 @@ AP_GPS_UBLOX::_request_port(void)
     _send_message(CLASS_CFG, MSG_CFG_PRT, nullptr, 0);
 }
 
+/*
+  add a block of bytes to the UBX checksum
+ */
+static void ubx_checksum(const uint8_t *data, uint16_t len, uint8_t &ck_a, uint8_t &ck_b)
+{
+    uint8_t a = ck_a;
+    uint8_t b = ck_b;
+    while (len--) {
+        a += *data++;
+        b += a;
+    }
+    ck_a = a;
+    ck_b = b;
+}
+
 // Ensure there is enough space for the largest possible outgoing message
 // Process bytes available from the stream
 //
@@ -676,16 +691,57 @@ AP_GPS_UBLOX::read(void)
     }
 
     const uint16_t numc = MIN(port->available(), 8192U);
+
+    // bytes are read from the port in blocks unless the RTCMv3
+    // parser is active, as it needs to stop reading at the end of
+    // each RTCMv3 packet
+#if GPS_MOVING_BASELINE
+    const bool block_read = rtcm3_parser == nullptr;
+#else
+    const bool block_read = true;
+#endif
+    uint8_t block[UBLOX_READ_BLOCK_SIZE];
+    uint16_t block_len = 0;
+    uint16_t block_ofs = 0;
+
     for (uint16_t i = 0; i < numc; i++) {        // Process bytes received
 
         // read the next byte
         uint8_t data;
-        if (!port->read(data)) {
-            break;
-        }
+        if (block_read) {
+            if (block_ofs == block_len) {
+                const ssize_t nread = port->read(block, MIN(uint16_t(numc - i), uint16_t(sizeof(block))));
+                if (nread <= 0) {
+                    break;
+                }
+                block_len = nread;
+                block_ofs = 0;
+#if AP_GPS_DEBUG_LOGGING_ENABLED
+                log_data(block, block_len);
+#endif
+            }
+            if (_step == 6) {
+                // copy all but the last byte of the payload that is
+                // in the block in one go, the last byte goes through
+                // the state machine below
+                const uint16_t n = MIN(uint16_t(block_len - block_ofs - 1), uint16_t(_payload_length - _payload_counter - 1));
+                if (n > 0) {
+                    ubx_checksum(&block[block_ofs], n, _ck_a, _ck_b);
+                    memcpy(&_buffer[_payload_counter], &block[block_ofs], n);
+                    _payload_counter += n;
+                    block_ofs += n;
+                    i += n;
+                }
+            }
+            data = block[block_ofs++];
+        } else {
+            if (!port->read(data)) {
+                break;
+            }
 #if AP_GPS_DEBUG_LOGGING_ENABLED
-        log_data(&data, 1);
+            log_data(&data, 1);
 #endif
+        }
 
 #if GPS_MOVING_BASELINE
         if (rtcm3_parser) {
@@ -66,6 +66,11 @@
 
 #define UBLOX_MAX_GNSS_CONFIG_BLOCKS 7
 
+// number of bytes read from the port at a time
+#ifndef UBLOX_READ_BLOCK_SIZE
+    #define UBLOX_READ_BLOCK_SIZE 64
+#endif
+
 #define UBX_TIMEGPS_VALID_WEEK_MASK 0x2
 
 #define UBLOX_MAX_PORTS 6
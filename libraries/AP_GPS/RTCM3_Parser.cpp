@@ -135,6 +135,37 @@ bool RTCM3_Parser::read(uint8_t byte)
     return false;
 }
 
+// read in a block of bytes, return true if a full packet is available
+bool RTCM3_Parser::read(const uint8_t *bytes, uint16_t len, uint16_t &consumed)
+{
+    consumed = 0;
+    while (consumed < len) {
+        if (pkt_bytes == 0) {
+            // skip to the next preamble, read() would discard these bytes
+            const uint8_t *p = (const uint8_t *)memchr(&bytes[consumed], RTCMv3_PREAMBLE, len-consumed);
+            if (p == nullptr) {
+                consumed = len;
+                return false;
+            }
+            consumed = p - bytes;
+        }
+        if (found_len == 0 && pkt_len != 0 && pkt[0] == RTCMv3_PREAMBLE &&
+            pkt_len + 6U <= sizeof(pkt) && pkt_bytes + 1U < pkt_len + 6U) {
+            // copy the packet body in one go, leaving the last byte
+            // for read() to complete and check the packet
+            const uint16_t n = MIN(uint16_t(len - consumed), uint16_t(pkt_len + 6U - 1U - pkt_bytes));
+            memcpy(&pkt[pkt_bytes], &bytes[consumed], n);
+            pkt_bytes += n;
+            consumed += n;
+            continue;
+        }
+        if (read(bytes[consumed++])) {
+            return true;
+        }
+    }
+    return false;
+}
+
 #ifdef RTCM_MAIN_TEST
 /*
   parsing test, taking a raw file captured from UART to u-blox F9
@@ -28,6 +28,11 @@ public:
     // process one byte, return true if packet found
     bool read(uint8_t b);
 
+    // process a block of bytes, stopping after the end of the first
+    // packet found. consumed is set to the number of bytes used.
+    // Return true if packet found
+    bool read(const uint8_t *bytes, uint16_t len, uint16_t &consumed);
+
     // reset internal state
     void reset(void);
 
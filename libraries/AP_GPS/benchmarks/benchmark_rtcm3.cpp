@@ -0,0 +1,107 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_GPS/RTCM3_Parser.h>
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  stream of RTCMv3 packets similar to a 1Hz RTK base, with some noise
+  between packets
+ */
+static uint8_t stream[16384];
+static uint16_t stream_len;
+static uint16_t stream_packets;
+
+static void add_packet(uint16_t id, uint16_t payload_len)
+{
+    uint8_t *p = &stream[stream_len];
+    p[0] = 0xD3;
+    p[1] = payload_len >> 8;
+    p[2] = payload_len & 0xFF;
+    p[3] = id >> 4;
+    p[4] = (id & 0xF) << 4;
+    for (uint16_t i = 2; i < payload_len; i++) {
+        p[3+i] = uint8_t(i * 31 + id);
+    }
+    const uint32_t crc = crc_crc24(p, payload_len+3);
+    p[payload_len+3] = crc >> 16;
+    p[payload_len+4] = crc >> 8;
+    p[payload_len+5] = crc;
+    stream_len += payload_len + 6;
+    stream_packets++;
+}
+
+static void setup_stream()
+{
+    if (stream_len != 0) {
+        return;
+    }
+    while (stream_len < sizeof(stream) - 1024) {
+        add_packet(1005, 19);
+        add_packet(1077, 420);
+        add_packet(1087, 330);
+        add_packet(1230, 6);
+        // noise
+        for (uint8_t i = 0; i < 20; i++) {
+            stream[stream_len++] = i;
+        }
+    }
+}
+
+static void BM_RTCM3ParseBytes(benchmark::State& state)
+{
+    setup_stream();
+    RTCM3_Parser parser {};
+    uint32_t packets = 0;
+    while (state.KeepRunning()) {
+        for (uint16_t i = 0; i < stream_len; i++) {
+            if (parser.read(stream[i])) {
+                packets++;
+            }
+        }
+    }
+    gbenchmark_escape(&packets);
+    state.SetBytesProcessed(int64_t(state.iterations()) * stream_len);
+}
+
+static void BM_RTCM3ParseBlocks(benchmark::State& state)
+{
+    setup_stream();
+    RTCM3_Parser parser {};
+    uint32_t packets = 0;
+    // blocks the size of a GPS_RTCM_DATA message
+    const uint16_t block_size = 180;
+    while (state.KeepRunning()) {
+        for (uint16_t ofs = 0; ofs < stream_len; ofs += block_size) {
+            const uint16_t len = MIN(block_size, uint16_t(stream_len - ofs));
+            uint16_t used = 0;
+            while (used < len) {
+                uint16_t consumed;
+                if (parser.read(&stream[ofs+used], len-used, consumed)) {
+                    packets++;
+                }
+                used += consumed;
+            }
+        }
+    }
+    gbenchmark_escape(&packets);
+    state.SetBytesProcessed(int64_t(state.iterations()) * stream_len);
+}
+
+static void BM_CRC24(benchmark::State& state)
+{
+    setup_stream();
+    uint32_t crc = 0;
+    while (state.KeepRunning()) {
+        crc ^= crc_crc24(stream, stream_len);
+        gbenchmark_escape(&crc);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * stream_len);
+}
+
+BENCHMARK(BM_RTCM3ParseBytes);
+BENCHMARK(BM_RTCM3ParseBlocks);
+BENCHMARK(BM_CRC24);
+
+BENCHMARK_MAIN();
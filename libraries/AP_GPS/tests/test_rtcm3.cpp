@@ -0,0 +1,83 @@
+#include <AP_gtest.h>
+
+#include <AP_GPS/RTCM3_Parser.h>
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+static uint16_t add_packet(uint8_t *p, uint16_t id, uint16_t payload_len)
+{
+    p[0] = 0xD3;
+    p[1] = payload_len >> 8;
+    p[2] = payload_len & 0xFF;
+    p[3] = id >> 4;
+    p[4] = (id & 0xF) << 4;
+    for (uint16_t i = 2; i < payload_len; i++) {
+        p[3+i] = uint8_t(i * 7 + id);
+    }
+    const uint32_t crc = crc_crc24(p, payload_len+3);
+    p[payload_len+3] = crc >> 16;
+    p[payload_len+4] = crc >> 8;
+    p[payload_len+5] = crc;
+    return payload_len + 6;
+}
+
+TEST(RTCM3_Parser, crc24)
+{
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    EXPECT_EQ(0xCDE703U, crc_crc24(check, sizeof(check)));
+}
+
+TEST(RTCM3_Parser, block_matches_bytes)
+{
+    uint8_t stream[4096];
+    uint16_t len = 0;
+    len += add_packet(&stream[len], 1005, 19);
+    // noise including a false preamble
+    stream[len++] = 0x12;
+    stream[len++] = 0xD3;
+    stream[len++] = 0x00;
+    len += add_packet(&stream[len], 1077, 500);
+    len += add_packet(&stream[len], 1230, 6);
+    // corrupted packet
+    const uint16_t bad = len;
+    len += add_packet(&stream[len], 1087, 100);
+    stream[bad + 50] ^= 0x55;
+    len += add_packet(&stream[len], 1005, 19);
+
+    // parse a byte at a time
+    RTCM3_Parser byte_parser {};
+    uint16_t byte_ids[10];
+    uint8_t byte_count = 0;
+    for (uint16_t i = 0; i < len; i++) {
+        if (byte_parser.read(stream[i])) {
+            ASSERT_LT(byte_count, ARRAY_SIZE(byte_ids));
+            byte_ids[byte_count++] = byte_parser.get_id();
+        }
+    }
+
+    // parse in blocks of each size
+    for (uint16_t block_size = 1; block_size < 200; block_size += 13) {
+        RTCM3_Parser block_parser {};
+        uint8_t block_count = 0;
+        for (uint16_t ofs = 0; ofs < len; ofs += block_size) {
+            const uint16_t n = MIN(block_size, uint16_t(len - ofs));
+            uint16_t used = 0;
+            while (used < n) {
+                uint16_t consumed;
+                const bool found = block_parser.read(&stream[ofs+used], n-used, consumed);
+                EXPECT_GT(consumed, 0);
+                used += consumed;
+                if (found) {
+                    ASSERT_LT(block_count, byte_count);
+                    EXPECT_EQ(byte_ids[block_count], block_parser.get_id());
+                    block_count++;
+                }
+            }
+        }
+        EXPECT_EQ(byte_count, block_count);
+    }
+    EXPECT_EQ(4, byte_count);
+}
+
+AP_GTEST_MAIN()
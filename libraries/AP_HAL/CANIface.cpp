@@ -99,6 +99,24 @@ int16_t AP_HAL::CANIface::send(const CANFrame& frame, uint64_t tx_deadline, CanI
     return 1;
 }
 
+/*
+  default batch send, checking for space with select() before each frame
+ */
+uint8_t AP_HAL::CANIface::send_frames(const CANFrame* frames, const uint64_t* tx_deadlines, uint8_t count, CanIOFlags flags)
+{
+    uint8_t sent = 0;
+    while (sent < count) {
+        bool read = false;
+        bool write = true;
+        select(read, write, &frames[sent], 0);
+        if (!write || send(frames[sent], tx_deadlines[sent], flags) <= 0) {
+            break;
+        }
+        sent++;
+    }
+    return sent;
+}
+
 /*
   register a callback for for sending CAN_FRAME messages.
   On success the returned callback_id can be used to unregister the callback
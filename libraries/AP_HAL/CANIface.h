@@ -196,6 +196,10 @@ public:
     // must be called on child class
     virtual int16_t send(const CANFrame& frame, uint64_t tx_deadline, CanIOFlags flags);
 
+    // Put a batch of frames in queue to be sent, stopping at the first frame that can't
+    // be queued. Returns the number of frames queued
+    virtual uint8_t send_frames(const CANFrame* frames, const uint64_t* tx_deadlines, uint8_t count, CanIOFlags flags);
+
     // Non blocking receive frame that pops the frames received inside the buffer, return negative if error occurred, 
     // 0 if no frame available, 1 if successful
     // must be called on child class
@@ -126,6 +126,15 @@ public:
         return false;
     }
 
+    /*
+      pin the calling thread to the CPUs set aside for scheduler
+      worker threads, worker_index selects between them. Returns false
+      if the HAL does not support it or there are no spare CPUs
+     */
+    virtual bool set_worker_thread_affinity(uint8_t worker_index) {
+        return false;
+    }
+
 private:
 
     AP_HAL::Proc _delay_cb;
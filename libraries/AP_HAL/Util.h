@@ -196,6 +196,9 @@ public:
     // request information on timer frequencies
     virtual void timer_info(ExpandingString &str) {}
 
+    // request information on I2C and SPI bus utilisation
+    virtual void bus_info(ExpandingString &str) {}
+
     // generate Random values
     virtual bool get_random_vals(uint8_t* data, size_t size) { return false; }
 
@@ -0,0 +1,129 @@
+#if defined(__linux__)
+
+#include "ThreadCPUStats.h"
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+uint64_t ThreadCPUStats::last_ticks(pid_t tid) const
+{
+    for (uint8_t i=0; i<num_last; i++) {
+        if (last[i].tid == tid) {
+            return last[i].ticks;
+        }
+    }
+    return 0;
+}
+
+void ThreadCPUStats::thread_info(ExpandingString &str)
+{
+    DIR *d = opendir("/proc/self/task");
+    if (d == nullptr) {
+        return;
+    }
+
+    const uint64_t now_us = AP_HAL::micros64();
+    const float dt = (now_us - last_us) * 1.0e-6;
+    last_us = now_us;
+    const float ticks_per_sec = sysconf(_SC_CLK_TCK);
+
+    // a header to allow for machine parsers to determine format
+    str.printf("ThreadsV2\n");
+
+    decltype(last) current;
+    uint8_t num_threads = 0;
+    struct dirent *de;
+    while ((de = readdir(d)) != nullptr) {
+        const pid_t tid = atoi(de->d_name);
+        if (tid <= 0) {
+            continue;
+        }
+        char path[48];
+        snprintf(path, sizeof(path), "/proc/self/task/%d/stat", int(tid));
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            continue;
+        }
+        char buf[512];
+        const ssize_t n = read(fd, buf, sizeof(buf)-1);
+        close(fd);
+        if (n <= 0) {
+            continue;
+        }
+        buf[n] = 0;
+
+        // the thread name is in brackets and may itself contain
+        // spaces or brackets, so the fields start after the last ')'
+        char *name = strchr(buf, '(');
+        char *fields = strrchr(buf, ')');
+        if (name == nullptr || fields == nullptr || fields < name) {
+            continue;
+        }
+        name++;
+        *fields++ = 0;
+
+        // fields 14, 15, 18 and 39 of proc_pid_stat(5)
+        unsigned long long utime, stime;
+        long priority;
+        unsigned cpu;
+        if (sscanf(fields, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %ld"
+                   " %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %u",
+                   &utime, &stime, &priority, &cpu) != 4) {
+            continue;
+        }
+        const uint64_t ticks = utime + stime;
+        const float load = dt > 0 ? 100.0 * (ticks - last_ticks(tid)) / (ticks_per_sec * dt) : 0;
+
+        // realtime threads report a priority of -1 - rt_priority
+        str.printf("%-16.16s TID=%6d PRI=%3u CPU=%2u LOAD=%5.1f%%\n",
+                   name, int(tid),
+                   unsigned(priority < 0 ? -1 - priority : 0),
+                   cpu, load);
+
+        if (num_threads < MAX_THREADS) {
+            current[num_threads].tid = tid;
+            current[num_threads].ticks = ticks;
+            num_threads++;
+        }
+    }
+    closedir(d);
+    memcpy(last, current, num_threads * sizeof(last[0]));
+    num_last = num_threads;
+
+    core_info(str);
+}
+
+// load of each CPU core from the "cpuN" lines of /proc/stat
+void ThreadCPUStats::core_info(ExpandingString &str)
+{
+    FILE *f = fopen("/proc/stat", "re");
+    if (f == nullptr) {
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        unsigned core;
+        unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
+        if (sscanf(line, "cpu%u %llu %llu %llu %llu %llu %llu %llu %llu",
+                   &core, &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal) != 9 ||
+            core >= MAX_CORES) {
+            continue;
+        }
+        const uint64_t busy = user + nice + system + irq + softirq + steal;
+        const uint64_t total = busy + idle + iowait;
+        const uint64_t dtotal = total - last_core[core].total;
+        const float load = dtotal > 0 ? 100.0 * (busy - last_core[core].busy) / dtotal : 0;
+        last_core[core].busy = busy;
+        last_core[core].total = total;
+        str.printf("CPU%-13u LOAD=%5.1f%%\n", core, load);
+    }
+    fclose(f);
+}
+
+#endif // __linux__
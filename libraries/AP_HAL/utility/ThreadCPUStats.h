@@ -0,0 +1,57 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#if defined(__linux__)
+
+#include <AP_Common/AP_Common.h>
+#include <sys/types.h>
+
+class ExpandingString;
+
+/*
+  per-thread and per-core CPU load on Linux, read from
+  /proc/self/task/<tid>/stat and /proc/stat. The load is the CPU time
+  used by each thread or core since the previous call
+ */
+class ThreadCPUStats {
+public:
+    // print one line per thread in the @SYS/threads.txt format,
+    // followed by one line per CPU core
+    void thread_info(ExpandingString &str);
+
+private:
+    static constexpr uint8_t MAX_THREADS = 32;
+    static constexpr uint8_t MAX_CORES = 16;
+
+    // CPU ticks for each thread at the previous call
+    struct {
+        pid_t tid;
+        uint64_t ticks;
+    } last[MAX_THREADS];
+    uint8_t num_last;
+    uint64_t last_us;
+
+    // busy and total ticks for each core at the previous call
+    struct {
+        uint64_t busy;
+        uint64_t total;
+    } last_core[MAX_CORES];
+
+    uint64_t last_ticks(pid_t tid) const;
+    void core_info(ExpandingString &str);
+};
+
+#endif // __linux__
@@ -1092,6 +1092,26 @@ void CANIface::checkAvailable(bool& read, bool& write, const AP_HAL::CANFrame* p
     }
 }
 
+/*
+  queue a batch of frames. The timeout and error checks done by
+  select() are only needed once for the batch
+ */
+uint8_t CANIface::send_frames(const AP_HAL::CANFrame* frames, const uint64_t* tx_deadlines,
+                              uint8_t count, CanIOFlags flags)
+{
+    discardTimedOutTxMailboxes(AP_HAL::micros64());
+    pollErrorFlags();
+    clearErrors();
+
+    uint8_t sent = 0;
+    while (sent < count &&
+           canAcceptNewTxFrame() &&
+           send(frames[sent], tx_deadlines[sent], flags) > 0) {
+        sent++;
+    }
+    return sent;
+}
+
 bool CANIface::select(bool &read, bool &write,
                       const AP_HAL::CANFrame* pending_tx,
                       uint64_t blocking_deadline)
@@ -184,6 +184,11 @@ public:
     int16_t send(const AP_HAL::CANFrame& frame, uint64_t tx_deadline,
                  CanIOFlags flags) override;
 
+    // Put a batch of frames into the Tx FIFO, doing the timeout and error
+    // housekeeping once for the batch. Returns number of frames queued
+    uint8_t send_frames(const AP_HAL::CANFrame* frames, const uint64_t* tx_deadlines,
+                        uint8_t count, CanIOFlags flags) override;
+
     // Receive frame from Rx Buffer, returns negative on error, 0 on nothing available, 
     // 1 on successfully poping a frame
     int16_t receive(AP_HAL::CANFrame& out_frame, uint64_t& out_timestamp_us,
@@ -22,6 +22,7 @@
 #include "Scheduler.h"
 #include "hwdef/common/flash.h"
 #include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Common/ExpandingString.h>
 #include <stdio.h>
 
 using namespace ChibiOS;
@@ -241,6 +242,7 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
         WITH_SEMAPHORE(sem);
         memcpy(&_buffer[loc], src, n);
         _mark_dirty(loc, n);
+        _last_write_ms = AP_HAL::millis();
     }
 }
 
@@ -254,30 +256,47 @@ void Storage::_timer_tick(void)
         return;
     }
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
-    uint16_t i;
-    for (i=0; i<CH_STORAGE_NUM_LINES; i++) {
-        if (_dirty_mask.get(i)) {
-            break;
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        // let bulk updates settle so they coalesce into fewer flash
+        // records, but don't hold dirty data indefinitely
+        const uint32_t now_ms = AP_HAL::millis();
+        if (now_ms - _last_write_ms < HAL_STORAGE_FLASH_HOLDOFF_MS &&
+            now_ms - _last_empty_ms < HAL_STORAGE_FLASH_MAX_DELAY_MS) {
+            return;
         }
     }
-    if (i == CH_STORAGE_NUM_LINES) {
+#endif
+
+    // write out the first run of contiguous dirty lines. We don't
+    // write more than one batch to keep the latency of this call to
+    // a minimum
+    const int16_t first = _dirty_mask.first_set();
+    if (first < 0) {
         // this shouldn't be possible
         return;
     }
+    const uint16_t i = first;
+    uint16_t nlines = 1;
+    while (nlines < CH_STORAGE_BATCH_LINES &&
+           i+nlines < CH_STORAGE_NUM_LINES &&
+           _dirty_mask.get(i+nlines)) {
+        nlines++;
+    }
+    const uint32_t offset = CH_STORAGE_LINE_SIZE*i;
+    const uint16_t nbytes = CH_STORAGE_LINE_SIZE*nlines;
 
     {
-        // take a copy of the line we are writing with a semaphore held
+        // take a copy of the lines we are writing with a semaphore held
         WITH_SEMAPHORE(sem);
-        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE);
+        memcpy(tmpline, &_buffer[offset], nbytes);
     }
 
     bool write_ok = false;
 
 #if HAL_WITH_RAMTRON
     if (_initialisedType == StorageBackend::FRAM) {
-        if (fram.write(CH_STORAGE_LINE_SIZE*i, tmpline, CH_STORAGE_LINE_SIZE)) {
+        if (fram.write(offset, tmpline, nbytes)) {
             write_ok = true;
         }
     }
@@ -285,11 +304,10 @@ void Storage::_timer_tick(void)
 
 #ifdef USE_POSIX
     if ((_initialisedType == StorageBackend::SDCard) && log_fd != -1) {
-        uint32_t offset = CH_STORAGE_LINE_SIZE*i;
         if (AP::FS().lseek(log_fd, offset, SEEK_SET) != offset) {
             return;
         }
-        if (AP::FS().write(log_fd, &_buffer[offset], CH_STORAGE_LINE_SIZE) != CH_STORAGE_LINE_SIZE) {
+        if (AP::FS().write(log_fd, tmpline, nbytes) != nbytes) {
             return;
         }
         if (AP::FS().fsync(log_fd) != 0) {
@@ -302,22 +320,26 @@ void Storage::_timer_tick(void)
 #ifdef STORAGE_FLASH_PAGE
     if (_initialisedType == StorageBackend::Flash) {
         // save to storage backend
-        if (_flash_write(i)) {
+        if (_flash_write(i, nlines)) {
             write_ok = true;
         }
     }
 #endif
 
     if (write_ok) {
+        _batches_written++;
+        _lines_written += nlines;
         WITH_SEMAPHORE(sem);
-        // while holding the semaphore we check if the copy of the
+        // while holding the semaphore we check if the copy of each
         // line is different from the original line. If it is
         // different then someone has re-dirtied the line while we
         // were writing it, in which case we should not mark it
         // clean. If it matches then we know we can mark the line as
         // clean
-        if (memcmp(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE) == 0) {
-            _dirty_mask.clear(i);
+        for (uint16_t n=0; n<nlines; n++) {
+            if (memcmp(&tmpline[CH_STORAGE_LINE_SIZE*n], &_buffer[offset+CH_STORAGE_LINE_SIZE*n], CH_STORAGE_LINE_SIZE) == 0) {
+                _dirty_mask.clear(i+n);
+            }
         }
     }
 }
@@ -345,13 +367,13 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask.
+  write a run of storage lines
 */
-bool Storage::_flash_write(uint16_t line)
+bool Storage::_flash_write(uint16_t line, uint16_t nlines)
 {
 #ifdef STORAGE_FLASH_PAGE
     EXPECT_DELAY_MS(1);
-    return _flash.write(line*CH_STORAGE_LINE_SIZE, CH_STORAGE_LINE_SIZE);
+    return _flash.write(line*CH_STORAGE_LINE_SIZE, nlines*CH_STORAGE_LINE_SIZE);
 #else
     return false;
 #endif
@@ -505,5 +527,32 @@ bool Storage::get_storage_ptr(void *&ptr, size_t &size)
     return true;
 }
 
+/*
+  report write-back statistics
+ */
+void Storage::storage_info(ExpandingString &str)
+{
+    str.printf("Backend: %u\n"
+               "Dirty lines: %u\n"
+               "Batches written: %lu\n"
+               "Lines written: %lu\n",
+               unsigned(_initialisedType),
+               unsigned(_dirty_mask.count()),
+               (unsigned long)_batches_written,
+               (unsigned long)_lines_written);
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        const auto &stats = _flash.get_stats();
+        str.printf("Flash records: %lu\n"
+                   "Flash bytes: %lu\n"
+                   "Flash sector switches: %lu\n"
+                   "Flash compactions: %lu\n",
+                   (unsigned long)stats.records_written,
+                   (unsigned long)stats.bytes_written,
+                   (unsigned long)stats.sector_switches,
+                   (unsigned long)stats.compactions);
+    }
+#endif
+}
 
 #endif // HAL_USE_EMPTY_STORAGE
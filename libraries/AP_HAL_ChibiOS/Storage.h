@@ -47,6 +47,39 @@
 static_assert(CH_STORAGE_SIZE % CH_STORAGE_LINE_SIZE == 0,
               "Storage is not multiple of line size");
 
+/*
+  contiguous dirty lines are coalesced into a single backend write of
+  up to this many bytes. For flash this is a whole number of lines and
+  of full AP_FlashStorage records (240 bytes on H7, 24 on G4 and 64
+  otherwise), so a run of dirty lines doesn't end in a part filled
+  record
+ */
+#ifndef CH_STORAGE_BATCH_SIZE
+#ifdef STORAGE_FLASH_PAGE
+#define CH_STORAGE_BATCH_SIZE AP_FlashStorage::record_batch_size(CH_STORAGE_LINE_SIZE)
+#else
+#define CH_STORAGE_BATCH_SIZE (CH_STORAGE_LINE_SIZE > 64 ? CH_STORAGE_LINE_SIZE : 64)
+#endif
+#endif
+#define CH_STORAGE_BATCH_LINES (CH_STORAGE_BATCH_SIZE/CH_STORAGE_LINE_SIZE)
+
+static_assert(CH_STORAGE_BATCH_SIZE % CH_STORAGE_LINE_SIZE == 0,
+              "Storage batch size is not multiple of line size");
+
+/*
+  when writing to flash we hold off committing dirty lines until
+  writes have been quiet for HAL_STORAGE_FLASH_HOLDOFF_MS, so that
+  bulk updates (mission upload, parameter bulk set) are merged into
+  fewer records. Lines are never held for longer than
+  HAL_STORAGE_FLASH_MAX_DELAY_MS
+ */
+#ifndef HAL_STORAGE_FLASH_HOLDOFF_MS
+#define HAL_STORAGE_FLASH_HOLDOFF_MS 20
+#endif
+#ifndef HAL_STORAGE_FLASH_MAX_DELAY_MS
+#define HAL_STORAGE_FLASH_MAX_DELAY_MS 500
+#endif
+
 /*
   on boards with 8k sector sizes we double up to treat pairs of sectors as one
  */
@@ -64,6 +97,7 @@ public:
     void _timer_tick(void) override;
     bool healthy(void) override;
     bool get_storage_ptr(void *&ptr, size_t &size) override;
+    void storage_info(ExpandingString &str) override;
 
 private:
     enum class StorageBackend: uint8_t {
@@ -80,7 +114,10 @@ private:
     uint8_t _buffer[CH_STORAGE_SIZE] __attribute__((aligned(4)));
     Bitmask<CH_STORAGE_NUM_LINES> _dirty_mask;
     HAL_Semaphore sem;
-    uint8_t tmpline[CH_STORAGE_LINE_SIZE];
+    uint8_t tmpline[CH_STORAGE_BATCH_SIZE];
+    uint32_t _last_write_ms;
+    uint32_t _batches_written;
+    uint32_t _lines_written;
 
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -105,7 +142,7 @@ private:
 #endif
 
     void _flash_load(void);
-    bool _flash_write(uint16_t line);
+    bool _flash_write(uint16_t line, uint16_t nlines);
 
 #if HAL_WITH_RAMTRON
     AP_RAMTRON fram;
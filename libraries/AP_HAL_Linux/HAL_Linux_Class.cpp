@@ -340,6 +340,8 @@ void _usage(void)
     printf("\tcpu affinity:\n");
     printf("\t                   --cpu-affinity 1 (single cpu) or 1,3 (multiple cpus) or 1-3 (range of cpus)\n");
     printf("\t                   -c 1 (single cpu) or 1,3 (multiple cpus) or 1-3 (range of cpus)\n");
+    printf("\tscheduler worker cpu affinity (see SCHED_WORKERS):\n");
+    printf("\t                   --worker-cpu-affinity 2,3\n");
 }
 
 void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
@@ -359,6 +361,7 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         CMDLINE_SERIAL7,
         CMDLINE_SERIAL8,
         CMDLINE_SERIAL9,
+        CMDLINE_WORKER_CPU_AFFINITY,
     };
 
     int opt;
@@ -389,6 +392,7 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         {"module-directory",    true,  0, 'M'},
         {"defaults",            true,  0, 'd'},
         {"cpu-affinity",        true,  0, 'c'},
+        {"worker-cpu-affinity", true,  0, CMDLINE_WORKER_CPU_AFFINITY},
         {"help",                false,  0, 'h'},
         {0, false, 0, 0}
     };
@@ -458,6 +462,14 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
             }
             Linux::Scheduler::from(scheduler)->set_cpu_affinity(cpu_affinity);
             break;
+        case CMDLINE_WORKER_CPU_AFFINITY:
+            cpu_set_t worker_cpu_affinity;
+            if (!utilInstance.parse_cpu_set(gopt.optarg, &worker_cpu_affinity)) {
+                fprintf(stderr, "Could not parse worker cpu affinity: %s\n", gopt.optarg);
+                exit(1);
+            }
+            Linux::Scheduler::from(scheduler)->set_worker_cpu_affinity(worker_cpu_affinity);
+            break;
         case 'h':
             _usage();
             exit(0);
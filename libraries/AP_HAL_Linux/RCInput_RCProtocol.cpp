@@ -140,17 +140,13 @@ void RCInput_RCProtocol::_timer_tick(void)
     if (fd_inverted != -1) {
         ssize_t n = ::read(fd_inverted, &b[0], sizeof(b));
         if (n > 0) {
-            for (uint8_t i=0; i<n; i++) {
-                AP::RC().process_byte(b[i], inverted_is_115200?115200:100000);
-            }
+            AP::RC().process_bytes(b, n, inverted_is_115200?115200:100000);
         }
     }
     if (fd_115200 != -1) {
         ssize_t n = ::read(fd_115200, &b[0], sizeof(b));
         if (n > 0 && !inverted_is_115200) {
-            for (uint8_t i=0; i<n; i++) {
-                AP::RC().process_byte(b[i], 115200);
-            }
+            AP::RC().process_bytes(b, n, 115200);
         }
     }
 
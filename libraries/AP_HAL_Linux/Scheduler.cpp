@@ -62,6 +62,7 @@ extern const AP_HAL::HAL& hal;
 Scheduler::Scheduler()
 {
     CPU_ZERO(&_cpu_affinity);
+    CPU_ZERO(&_worker_cpu_affinity);
 }
 
 
@@ -99,6 +100,46 @@ void Scheduler::init_cpu_affinity()
     }
 }
 
+/*
+  pin the calling thread to one of the worker CPUs, spreading workers
+  round robin over them
+ */
+bool Scheduler::set_worker_thread_affinity(uint8_t worker_index)
+{
+    cpu_set_t cpus = _worker_cpu_affinity;
+    if (!CPU_COUNT(&cpus)) {
+        if (!CPU_COUNT(&_cpu_affinity)) {
+            // main process isn't pinned, leave placement to the kernel
+            return false;
+        }
+        const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < num_cpus && cpu < CPU_SETSIZE; cpu++) {
+            if (!CPU_ISSET(cpu, &_cpu_affinity)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (!CPU_COUNT(&cpus)) {
+            return false;
+        }
+    }
+
+    uint8_t n = worker_index % CPU_COUNT(&cpus);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &cpus) || n-- > 0) {
+            continue;
+        }
+        cpu_set_t worker_cpu;
+        CPU_ZERO(&worker_cpu);
+        CPU_SET(cpu, &worker_cpu);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(worker_cpu), &worker_cpu) != 0) {
+            fprintf(stderr, "Failed to set affinity for worker %u: %m\n", unsigned(worker_index));
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
 void Scheduler::init()
 {
     int ret;
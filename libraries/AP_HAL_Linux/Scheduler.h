@@ -60,6 +60,14 @@ public:
      */
     void set_cpu_affinity(const cpu_set_t &cpu_affinity) { _cpu_affinity = cpu_affinity; }
 
+    /*
+      set the CPUs for AP_Scheduler worker threads. If not set the
+      workers use the CPUs not in the main process affinity mask
+     */
+    void set_worker_cpu_affinity(const cpu_set_t &cpu_affinity) { _worker_cpu_affinity = cpu_affinity; }
+
+    bool set_worker_thread_affinity(uint8_t worker_index) override;
+
 private:
     class SchedulerThread : public PeriodicThread {
     public:
@@ -117,6 +125,7 @@ private:
 
     Semaphore _io_semaphore;
     cpu_set_t _cpu_affinity;
+    cpu_set_t _worker_cpu_affinity;
 };
 
 }
@@ -9,6 +9,7 @@
 #endif
 #include "ToneAlarm.h"
 #include "Semaphores.h"
+#include <AP_HAL/utility/ThreadCPUStats.h>
 
 namespace Linux {
 
@@ -95,7 +96,11 @@ public:
     // fills data with random values of requested size
     bool get_random_vals(uint8_t* data, size_t size) override;
 
+    // request information on running threads
+    void thread_info(ExpandingString &str) override { _thread_stats.thread_info(str); }
+
 private:
+    ThreadCPUStats _thread_stats;
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_DISCO
     static ToneAlarm_Disco _toneAlarm;
 #else
@@ -20,4 +20,5 @@ class GPIO;
 class DigitalSource;
 class DSP;
 class CANIface;
+class BusTiming;
 }  // namespace HALSITL
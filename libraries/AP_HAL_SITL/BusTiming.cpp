@@ -0,0 +1,89 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BusTiming.h"
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include <AP_Common/ExpandingString.h>
+#include <AP_Math/AP_Math.h>
+#include <SITL/SITL.h>
+
+using namespace HALSITL;
+
+uint32_t BusTiming::transfer(uint32_t nbits, uint32_t nbytes, uint32_t clock_hz)
+{
+    uint32_t duration_us = 0;
+    if (clock_hz > 0) {
+        duration_us = uint32_t((uint64_t(nbits) * 1000000ULL + clock_hz - 1) / clock_hz);
+    }
+    const SITL::SIM *sitl = AP::sitl();
+    if (sitl != nullptr && sitl->bus_latency_us > 0) {
+        duration_us += sitl->bus_latency_us;
+    }
+
+    // a transfer made while the bus is still busy is queued behind
+    // the transfers already on it
+    const uint64_t now_us = AP_HAL::micros64();
+    uint64_t start_us = now_us;
+    if (busy_until_us > now_us) {
+        stats.wait_us += busy_until_us - now_us;
+        start_us = busy_until_us;
+    }
+    busy_until_us = start_us + duration_us;
+
+    stats.busy_us += duration_us;
+    stats.transfers++;
+    stats.bytes += nbytes;
+    max_transfer_us = MAX(max_transfer_us, duration_us);
+
+    return duration_us;
+}
+
+bool BusTiming::busy(uint64_t now_us) const
+{
+    const SITL::SIM *sitl = AP::sitl();
+    if (sitl == nullptr || sitl->bus_timing == 0) {
+        return false;
+    }
+    return now_us < busy_until_us;
+}
+
+void BusTiming::bus_info(ExpandingString &str, const char *name, uint8_t bus)
+{
+    const uint64_t now_us = AP_HAL::micros64();
+    uint64_t dt_us = now_us - last_info_us;
+    if (dt_us == 0) {
+        dt_us = 1;
+    }
+    last_info_us = now_us;
+
+    const uint64_t busy_us = stats.busy_us - last_stats.busy_us;
+    const uint64_t wait_us = stats.wait_us - last_stats.wait_us;
+    const uint32_t transfers = stats.transfers - last_stats.transfers;
+    const uint32_t bytes = stats.bytes - last_stats.bytes;
+
+    str.printf("%s%u XFER=%8u BYTES=%8u UTIL=%5.1f%% WAITUS=%8u MAXUS=%6u\n",
+               name, unsigned(bus),
+               unsigned(transfers),
+               unsigned(bytes),
+               float(busy_us * 100.0 / dt_us),
+               unsigned(wait_us),
+               unsigned(max_transfer_us));
+
+    last_stats = stats;
+    max_transfer_us = 0;
+}
+
+#endif // CONFIG_HAL_BOARD == HAL_BOARD_SITL
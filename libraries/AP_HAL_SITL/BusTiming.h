@@ -0,0 +1,59 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include "AP_HAL_SITL_Namespace.h"
+
+class ExpandingString;
+
+/*
+  model of the time taken by transfers on a simulated I2C or SPI bus.
+
+  Transfers on the simulated buses complete immediately. This keeps
+  track of how long each transfer would have occupied a real bus at
+  the device clock, queueing transfers that arrive while the bus is
+  still busy, so that bus load can be profiled in SITL
+ */
+class HALSITL::BusTiming {
+public:
+    // account for a transfer of nbits clocked at clock_hz, returns the
+    // modelled duration of the transfer in microseconds
+    uint32_t transfer(uint32_t nbits, uint32_t nbytes, uint32_t clock_hz);
+
+    // true if previous transfers would still be occupying the bus
+    // and bus timing is enabled with SIM_BUS_TIMING
+    bool busy(uint64_t now_us) const;
+
+    // fill in bus utilisation since the last call for @SYS/buses.txt
+    void bus_info(ExpandingString &str, const char *name, uint8_t bus);
+
+private:
+    uint64_t busy_until_us;
+
+    struct Stats {
+        uint64_t busy_us;       // total modelled time on the bus
+        uint64_t wait_us;       // total time transfers were queued behind others
+        uint32_t transfers;
+        uint32_t bytes;
+    } stats, last_stats;
+
+    uint32_t max_transfer_us;
+    uint64_t last_info_us;
+};
+
+#endif // CONFIG_HAL_BOARD == HAL_BOARD_SITL
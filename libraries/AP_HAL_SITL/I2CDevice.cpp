@@ -20,6 +20,7 @@
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 
 #include <SITL/SITL.h>
+#include "BusTiming.h"
 
 extern const AP_HAL::HAL& hal;
 
@@ -36,6 +37,7 @@ public:
 
     uint8_t bus;
     Semaphore sem;
+    BusTiming timing;
     int ioctl(uint8_t ioctl_number, void *data) {
         return _ioctl(ioctl_number, data);
     }
@@ -85,6 +87,10 @@ void I2CBus::_timer_tick()
 {
     const uint64_t now = AP_HAL::micros64();
     for (struct callback_info *ci = callbacks; ci != nullptr; ci = ci->next) {
+        if (timing.busy(now)) {
+            // transfers from earlier callbacks would still be on the bus
+            break;
+        }
         if (ci->next_usec < now) {
             WITH_SEMAPHORE(sem);
             ci->cb();
@@ -116,10 +122,18 @@ I2CDeviceManager::get_device(uint8_t bus,
     if (bus >= ARRAY_SIZE(buses)) {
         return AP_HAL::OwnPtr<AP_HAL::I2CDevice>(nullptr);
     }
-    auto dev = AP_HAL::OwnPtr<AP_HAL::I2CDevice>(NEW_NOTHROW I2CDevice(buses[bus], address));
+    auto dev = AP_HAL::OwnPtr<AP_HAL::I2CDevice>(NEW_NOTHROW I2CDevice(buses[bus], address, bus_clock));
     return dev;
 }
 
+// fill in bus utilisation for @SYS/buses.txt
+void I2CDeviceManager::bus_info(ExpandingString &str)
+{
+    for (auto &bus : buses) {
+        bus.timing.bus_info(str, "I2C", bus.bus);
+    }
+}
+
 void I2CDeviceManager::_timer_tick()
 {
     for (auto &bus : buses) {
@@ -131,9 +145,10 @@ void I2CDeviceManager::_timer_tick()
  * I2CDevice
  */
 
-I2CDevice::I2CDevice(I2CBus &bus, uint8_t address)
+I2CDevice::I2CDevice(I2CBus &bus, uint8_t address, uint32_t bus_clock)
     : _bus(bus)
     , _address(address)
+    , _bus_clock(bus_clock)
 {
     // ::fprintf(stderr, "bus.bus=%u address=0x%02x\n", bus.bus, address);
     set_device_bus(bus.bus);
@@ -187,9 +202,19 @@ bool I2CDevice::_transfer(const uint8_t *send, uint32_t send_len,
     i2c_data.msgs = msgs;
     i2c_data.nmsgs = nmsgs;
 
+    // each message is a start condition, the address byte and the
+    // data bytes, each byte followed by an ack bit, then a stop
+    uint32_t nbits = 1;
+    uint32_t nbytes = 0;
+    for (uint8_t i=0; i<nmsgs; i++) {
+        nbits += 1 + 9 * (1 + msgs[i].len);
+        nbytes += msgs[i].len;
+    }
+
     int r;
     unsigned retries = _retries;
     do {
+        _bus.timing.transfer(nbits, nbytes, _bus_clock);
         r = _bus.ioctl(I2C_RDWR, &i2c_data);
     } while (r == -1 && retries-- > 0);
 
@@ -37,7 +37,7 @@ public:
 
     /* AP_HAL::I2CDevice implementation */
 
-    I2CDevice(I2CBus &bus, uint8_t address);
+    I2CDevice(I2CBus &bus, uint8_t address, uint32_t bus_clock);
 
     ~I2CDevice() {}
 
@@ -97,6 +97,7 @@ protected:
     I2CBus &_bus;
     uint8_t _address;
     uint8_t _retries;
+    uint32_t _bus_clock;
     bool _split_transfers = false;
 
     bool _transfer(const uint8_t *send, uint32_t send_len,
@@ -123,6 +124,9 @@ public:
                                                  bool use_smbus = false,
                                                  uint32_t timeout_ms=4) override;
 
+    // fill in bus utilisation for @SYS/buses.txt
+    static void bus_info(ExpandingString &str);
+
 protected:
 
     #define NUM_SITL_I2C_BUSES 4
@@ -21,6 +21,7 @@
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
 
 #include <SITL/SITL.h>
+#include "BusTiming.h"
 
 extern const AP_HAL::HAL& hal;
 
@@ -39,6 +40,7 @@ public:
 
     uint8_t bus;
     Semaphore sem;
+    BusTiming timing;
     int ioctl(uint8_t cs_pin, uint8_t ioctl_number, void *data) {
         return _ioctl(cs_pin, ioctl_number, data);
     }
@@ -117,10 +119,10 @@ static const struct SPIDriverInfo {
     { 0, },
 };
 
-// name, bus, cs_pin
+// name, bus, cs_pin, lowspeed, highspeed
 SPIDesc SPIDeviceManager::device_table[] = {
-    { "ramtron", 0, 0 },
-    { "dataflash", 1, 0}
+    { "ramtron", 0, 0, 8000000U, 8000000U },
+    { "dataflash", 1, 0, 104000000U, 104000000U }
 };
 
 AP_HAL::OwnPtr<AP_HAL::SPIDevice>
@@ -163,6 +165,14 @@ SPIDeviceManager::get_device(const char *name)
     return AP_HAL::OwnPtr<AP_HAL::SPIDevice>(NEW_NOTHROW SPIDevice(*busp, desc));
 }
 
+// fill in bus utilisation for @SYS/buses.txt
+void SPIDeviceManager::bus_info(ExpandingString &str)
+{
+    for (SPIBus *busp = buses; busp; busp = busp->next) {
+        busp->timing.bus_info(str, "SPI", busp->bus);
+    }
+}
+
 // void SPIDeviceManager::_timer_tick()
 // {
 //     for (auto &bus : buses) {
@@ -177,11 +187,25 @@ SPIDeviceManager::get_device(const char *name)
 SPIDevice::SPIDevice(SPIBus &_bus, SPIDesc &_device_desc)
     : bus(_bus)
     , device_desc(_device_desc)
+    , frequency(_device_desc.lowspeed)
 {
     set_device_bus(spi_devices[_bus.bus].busid);
     set_device_address(_device_desc.cs_pin);
 }
 
+bool SPIDevice::set_speed(AP_HAL::Device::Speed speed)
+{
+    switch (speed) {
+    case AP_HAL::Device::SPEED_HIGH:
+        frequency = device_desc.highspeed;
+        break;
+    case AP_HAL::Device::SPEED_LOW:
+        frequency = device_desc.lowspeed;
+        break;
+    }
+    return true;
+}
+
 AP_HAL::Semaphore *SPIDevice::get_semaphore()
 {
     return &bus.sem;
@@ -243,6 +267,9 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
     default:
         abort();
     }
+    const uint32_t nbytes = send_len + recv_len;
+    bus.timing.transfer(nbytes * 8, nbytes, frequency);
+
     const int r = bus.ioctl(device_desc.cs_pin, ioctl_number, &msgs);
 
     if (r == -1) {
@@ -28,21 +28,25 @@ class SPIBus;
 namespace HALSITL {
 
 struct SPIDesc {
-    SPIDesc(const char *_name, uint8_t _bus, uint8_t _cs_pin)
-        : name(_name), bus(_bus), cs_pin(_cs_pin)
+    SPIDesc(const char *_name, uint8_t _bus, uint8_t _cs_pin,
+            uint32_t _lowspeed, uint32_t _highspeed)
+        : name(_name), bus(_bus), cs_pin(_cs_pin),
+          lowspeed(_lowspeed), highspeed(_highspeed)
     { }
 
     const char *name;
     uint8_t bus;
     uint8_t cs_pin;  // cs
+    uint32_t lowspeed;
+    uint32_t highspeed;
 };
 
 class SPIDevice : public AP_HAL::SPIDevice {
 public:
     SPIDevice(SPIBus &_bus, SPIDesc &_device_desc);
 
-    // no concept of speed in SITL yet
-    bool set_speed(AP_HAL::Device::Speed speed) override { return true; }
+    // speed is only used for modelling bus timing
+    bool set_speed(AP_HAL::Device::Speed speed) override;
 
     bool transfer(const uint8_t *send, uint32_t send_len,
                   uint8_t *recv, uint32_t recv_len) override;
@@ -61,6 +65,7 @@ public:
 private:
     SPIBus &bus;
     SPIDesc &device_desc;
+    uint32_t frequency;
 
     Semaphore _semaphore;
 
@@ -74,6 +79,9 @@ public:
 
     AP_HAL::OwnPtr<AP_HAL::SPIDevice> get_device(const char *name) override;
 
+    // fill in bus utilisation for @SYS/buses.txt
+    static void bus_info(ExpandingString &str);
+
     static SPIDesc device_table[];
     static SPIBus *buses;
 };
@@ -2,6 +2,7 @@
 
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
 #include "AP_HAL_SITL.h"
 
 #include <assert.h>
@@ -157,6 +158,7 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
         _storage_open();
         memcpy(&_buffer[loc], src, n);
         _mark_dirty(loc, n);
+        _last_write_ms = AP_HAL::millis();
     }
 }
 
@@ -170,49 +172,69 @@ void Storage::_timer_tick(void)
         return;
     }
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
-    uint16_t i;
-    for (i=0; i<STORAGE_NUM_LINES; i++) {
-        if (_dirty_mask.get(i)) {
-            break;
+#if STORAGE_USE_FLASH
+    if (_initialisedType == StorageBackend::Flash) {
+        // let bulk updates settle so they coalesce into fewer flash
+        // records, but don't hold dirty data indefinitely
+        const uint32_t now_ms = AP_HAL::millis();
+        if (now_ms - _last_write_ms < STORAGE_FLASH_HOLDOFF_MS &&
+            now_ms - _last_empty_ms < STORAGE_FLASH_MAX_DELAY_MS) {
+            return;
         }
     }
-    if (i == STORAGE_NUM_LINES) {
+#endif
+
+    // write out the first run of contiguous dirty lines. We don't
+    // write more than one batch to keep the latency of this call to
+    // a minimum
+    const int16_t first = _dirty_mask.first_set();
+    if (first < 0) {
         // this shouldn't be possible
         return;
     }
+    const uint16_t i = first;
+    uint16_t nlines = 1;
+    while (nlines < STORAGE_BATCH_LINES &&
+           i+nlines < STORAGE_NUM_LINES &&
+           _dirty_mask.get(i+nlines)) {
+        nlines++;
+    }
+    const uint32_t offset = STORAGE_LINE_SIZE*i;
+    const uint16_t nbytes = STORAGE_LINE_SIZE*nlines;
+    bool write_ok = false;
 
 #if STORAGE_USE_FRAM
-        if (fram.write(STORAGE_LINE_SIZE*i, &_buffer[STORAGE_LINE_SIZE*i], STORAGE_LINE_SIZE)) {
-            _dirty_mask.clear(i);
-            return;
-        }
+    if (_initialisedType == StorageBackend::FRAM) {
+        write_ok = fram.write(offset, &_buffer[offset], nbytes);
+    }
 #endif
 
 #if STORAGE_USE_POSIX
-    if (hal.get_storage_posix_enabled()) {
-        if (log_fd != -1) {
-            const off_t offset = STORAGE_LINE_SIZE*i;
-            if (lseek(log_fd, offset, SEEK_SET) != offset) {
-                return;
-            }
-            if (write(log_fd, &_buffer[offset], STORAGE_LINE_SIZE) != STORAGE_LINE_SIZE) {
-                return;
-            }
-            _dirty_mask.clear(i);
+    if (_initialisedType == StorageBackend::SDCard && log_fd != -1) {
+        if (lseek(log_fd, offset, SEEK_SET) != (off_t)offset) {
             return;
         }
+        if (write(log_fd, &_buffer[offset], nbytes) != nbytes) {
+            return;
+        }
+        write_ok = true;
     }
 #endif
 
 #if STORAGE_USE_FLASH
-    if (hal.get_storage_flash_enabled()) {
+    if (_initialisedType == StorageBackend::Flash) {
         // save to storage backend
-        _flash_write(i);
-        return;
+        write_ok = _flash_write(i, nlines);
     }
 #endif
+
+    if (write_ok) {
+        _batches_written++;
+        _lines_written += nlines;
+        for (uint16_t n=0; n<nlines; n++) {
+            _dirty_mask.clear(i+n);
+        }
+    }
 }
 
 #if STORAGE_USE_FLASH
@@ -228,14 +250,11 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask. 
+  write a run of storage lines
 */
-void Storage::_flash_write(uint16_t line)
+bool Storage::_flash_write(uint16_t line, uint16_t nlines)
 {
-    if (_flash.write(line*STORAGE_LINE_SIZE, STORAGE_LINE_SIZE)) {
-        // mark the line clean
-        _dirty_mask.clear(line);
-    }
+    return _flash.write(line*STORAGE_LINE_SIZE, nlines*STORAGE_LINE_SIZE);
 }
 
 
@@ -400,3 +419,31 @@ bool Storage::get_storage_ptr(void *&ptr, size_t &size)
     size = sizeof(_buffer);
     return true;
 }
+
+/*
+  report write-back statistics
+ */
+void Storage::storage_info(ExpandingString &str)
+{
+    str.printf("Backend: %u\n"
+               "Dirty lines: %u\n"
+               "Batches written: %u\n"
+               "Lines written: %u\n",
+               unsigned(_initialisedType),
+               unsigned(_dirty_mask.count()),
+               unsigned(_batches_written),
+               unsigned(_lines_written));
+#if STORAGE_USE_FLASH
+    if (_initialisedType == StorageBackend::Flash) {
+        const auto &stats = _flash.get_stats();
+        str.printf("Flash records: %u\n"
+                   "Flash bytes: %u\n"
+                   "Flash sector switches: %u\n"
+                   "Flash compactions: %u\n",
+                   unsigned(stats.records_written),
+                   unsigned(stats.bytes_written),
+                   unsigned(stats.sector_switches),
+                   unsigned(stats.compactions));
+    }
+#endif
+}
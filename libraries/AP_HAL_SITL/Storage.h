@@ -23,6 +23,22 @@
 #define STORAGE_LINE_SIZE (1<<STORAGE_LINE_SHIFT)
 #define STORAGE_NUM_LINES (HAL_STORAGE_SIZE/STORAGE_LINE_SIZE)
 
+// contiguous dirty lines are coalesced into one backend write of up
+// to this many bytes, a whole number of lines and flash records
+#ifndef STORAGE_BATCH_SIZE
+#define STORAGE_BATCH_SIZE AP_FlashStorage::record_batch_size(STORAGE_LINE_SIZE)
+#endif
+#define STORAGE_BATCH_LINES (STORAGE_BATCH_SIZE/STORAGE_LINE_SIZE)
+
+// flash write-back holds off until writes have been quiet for this
+// long, bounded by STORAGE_FLASH_MAX_DELAY_MS
+#ifndef STORAGE_FLASH_HOLDOFF_MS
+#define STORAGE_FLASH_HOLDOFF_MS 20
+#endif
+#ifndef STORAGE_FLASH_MAX_DELAY_MS
+#define STORAGE_FLASH_MAX_DELAY_MS 500
+#endif
+
 class HALSITL::Storage : public AP_HAL::Storage {
 public:
     void init() override {}
@@ -32,6 +48,7 @@ public:
 
     void _timer_tick(void) override;
     bool healthy(void) override;
+    void storage_info(ExpandingString &str) override;
 
 private:
     enum class StorageBackend: uint8_t {
@@ -50,6 +67,9 @@ private:
     Bitmask<STORAGE_NUM_LINES> _dirty_mask;
 
     uint32_t _last_empty_ms;
+    uint32_t _last_write_ms;
+    uint32_t _batches_written;
+    uint32_t _lines_written;
 
 #if STORAGE_USE_FLASH
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
@@ -68,7 +88,7 @@ private:
             FUNCTOR_BIND_MEMBER(&Storage::_flash_erase_ok, bool)};
 
     void _flash_load(void);
-    void _flash_write(uint16_t line);
+    bool _flash_write(uint16_t line, uint16_t nlines);
 #endif
 
 #if STORAGE_USE_POSIX
@@ -2,6 +2,8 @@
 #include <sys/time.h>
 #include <AP_Param/AP_Param.h>
 #include "RCOutput.h"
+#include "I2CDevice.h"
+#include "SPIDevice.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -134,6 +136,17 @@ bool HALSITL::Util::get_random_vals(uint8_t* data, size_t size)
     return true;
 }
 
+// request information on I2C and SPI bus utilisation for @SYS/buses.txt
+void HALSITL::Util::bus_info(ExpandingString &str)
+{
+    // a header to allow for machine parsers to determine format
+    str.printf("BUSV1\n");
+    I2CDeviceManager::bus_info(str);
+#if !defined(HAL_BUILD_AP_PERIPH)
+    SPIDeviceManager::bus_info(str);
+#endif
+}
+
 #if HAL_UART_STATS_ENABLED
 // request information on uart I/O
 void HALSITL::Util::uart_info(ExpandingString &str)
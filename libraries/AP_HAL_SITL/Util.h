@@ -5,6 +5,7 @@
 #include "AP_HAL_SITL.h"
 #include "Semaphores.h"
 #include "ToneAlarm_SF.h"
+#include <AP_HAL/utility/ThreadCPUStats.h>
 #include <AP_Logger/AP_Logger_config.h>
 
 #if !defined(__CYGWIN__) && !defined(__CYGWIN64__)
@@ -87,6 +88,15 @@ private:
     int saved_argc;
     char *const *saved_argv;
 
+    // request information on I2C and SPI bus utilisation
+    void bus_info(ExpandingString &str) override;
+
+#if defined(__linux__)
+    // request information on running threads
+    void thread_info(ExpandingString &str) override { _thread_stats.thread_info(str); }
+    ThreadCPUStats _thread_stats;
+#endif
+
 #if HAL_UART_STATS_ENABLED
     // request information on uart I/O
     void uart_info(ExpandingString &str) override;
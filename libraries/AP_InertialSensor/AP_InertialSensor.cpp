@@ -16,7 +16,9 @@
 #include <AP_AHRS/AP_AHRS_View.h>
 #include <AP_ExternalAHRS/AP_ExternalAHRS.h>
 #include <AP_GyroFFT/AP_GyroFFT.h>
+#include <AP_Logger/AP_Logger.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
+#include <AP_Scheduler/PerfInfo.h>
 #if !APM_BUILD_TYPE(APM_BUILD_Rover)
 #include <AP_Motors/AP_Motors_Class.h>
 #endif
@@ -39,6 +41,7 @@
 #include "AP_InertialSensor_Invensensev3.h"
 #include "AP_InertialSensor_NONE.h"
 #include "AP_InertialSensor_SCHA63T.h"
+#include "AP_InertialSensor_RateBuffer.h"
 
 /* Define INS_TIMING_DEBUG to track down scheduling issues with the main loop.
  * Output is on the debug console. */
@@ -679,7 +682,7 @@ const AP_Param::GroupInfo AP_InertialSensor::var_info[] = {
     // @Param: _RAW_LOG_OPT
     // @DisplayName: Raw logging options
     // @Description: Raw logging options bitmask
-    // @Bitmask: 0:Log primary gyro only, 1:Log all gyros, 2:Post filter, 3: Pre and post filter
+    // @Bitmask: 0:Log primary gyro only, 1:Log all gyros, 2:Post filter, 3: Pre and post filter, 4: Delta encode raw samples (ACCD and GYRD messages)
     // @User: Advanced
     AP_GROUPINFO("_RAW_LOG_OPT", 56, AP_InertialSensor, raw_logging_options, 0),
 
@@ -915,6 +918,58 @@ bool AP_InertialSensor::set_gyro_window_size(uint16_t size) {
     return true;
 }
 
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+bool AP_InertialSensor::enable_rate_loop_buffer(uint8_t decimation)
+{
+    if (_rate_loop_buffer == nullptr) {
+        _rate_loop_buffer = NEW_NOTHROW AP_InertialSensor_RateBuffer();
+        if (_rate_loop_buffer == nullptr) {
+            return false;
+        }
+    }
+    _rate_loop_buffer->set_decimation(decimation);
+    _rate_loop_buffer->clear();
+    _rate_loop_buffer_enabled = true;
+    return true;
+}
+
+void AP_InertialSensor::disable_rate_loop_buffer()
+{
+    _rate_loop_buffer_enabled = false;
+}
+
+uint8_t AP_InertialSensor::rate_loop_buffer_decimation() const
+{
+    if (_rate_loop_buffer == nullptr) {
+        return 1;
+    }
+    return _rate_loop_buffer->get_decimation();
+}
+
+bool AP_InertialSensor::get_next_gyro_sample(Vector3f &gyro, GyroSampleTime &time, uint32_t timeout_us)
+{
+    if (!_rate_loop_buffer_enabled) {
+        return false;
+    }
+    AP_InertialSensor_RateBuffer::Sample sample;
+    if (!_rate_loop_buffer->wait_sample(sample, timeout_us)) {
+        return false;
+    }
+    gyro = sample.gyro;
+    time.sample_us = sample.sample_us;
+    time.filtered_us = sample.filtered_us;
+    return true;
+}
+
+uint32_t AP_InertialSensor::get_rate_loop_dropped_samples()
+{
+    if (_rate_loop_buffer == nullptr) {
+        return 0;
+    }
+    return _rate_loop_buffer->get_and_clear_dropped();
+}
+#endif // AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+
 #if HAL_WITH_DSP && AP_INERTIALSENSOR_HARMONICNOTCH_ENABLED
 bool AP_InertialSensor::has_fft_notch() const
 {
@@ -968,6 +1023,13 @@ AP_InertialSensor::init(uint16_t loop_rate)
     batchsampler.init();
 #endif
 
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger != nullptr) {
+        logger->set_pending_writes_flusher(FUNCTOR_BIND_MEMBER(&AP_InertialSensor::flush_delta_logs, void));
+    }
+#endif
+
 #if HAL_GYROFFT_ENABLED
     AP_GyroFFT* fft = AP::fft();
     bool fft_enabled = fft != nullptr && fft->enabled();
@@ -1891,6 +1953,9 @@ void AP_InertialSensor::update(void)
     // wait_for_sample(), and a wait is implied
     wait_for_sample();
 
+    // time the update, not the wait for the sample
+    AP_SCHEDULER_PROFILE_SECTION("ins_update");
+
         for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
             // mark sensors unhealthy and let update() in each backend
             // mark them healthy via _publish_gyro() and
@@ -1981,6 +2046,21 @@ void AP_InertialSensor::update(void)
         send_uart_data();
     }
 #endif
+
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+    update_delta_logs();
+#endif
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+    if (_rate_loop_buffer_enabled) {
+        // the rate loop uses the gyro the AHRS uses
+#if AP_AHRS_ENABLED
+        _rate_loop_buffer->set_instance(AP::ahrs().get_primary_gyro_index());
+#else
+        _rate_loop_buffer->set_instance(_first_usable_gyro);
+#endif
+    }
+#endif
 }
 
 /*
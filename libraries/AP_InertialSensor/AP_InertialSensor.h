@@ -40,6 +40,8 @@ class AP_AHRS;
   because of mutual dependencies
  */
 class AP_Logger;
+class AP_InertialSensor_DeltaLog;
+class AP_InertialSensor_RateBuffer;
 
 /* AP_InertialSensor is an abstraction for gyro and accel measurements
  * which are correctly aligned to the body axes and scaled to SI units.
@@ -110,6 +112,16 @@ public:
     const Vector3f     &get_gyro(uint8_t i) const { return _gyro[i]; }
     const Vector3f     &get_gyro(void) const { return get_gyro(_first_usable_gyro); }
 
+    // times of a gyro sample on its way through the filters, used
+    // to measure the latency from the sensor to the motors
+    struct GyroSampleTime {
+        uint32_t sample_us;     // sample arrived from the sensor
+        uint32_t filtered_us;   // filtered sample ready
+    };
+
+    // times of the sample behind get_gyro(i)
+    const GyroSampleTime &get_gyro_sample_time(uint8_t i) const { return _gyro_time[i]; }
+
     // set gyro offsets in radians/sec
     const Vector3f &get_gyro_offsets(uint8_t i) const { return _gyro_offset(i); }
     const Vector3f &get_gyro_offsets(void) const { return get_gyro_offsets(_first_usable_gyro); }
@@ -168,6 +180,22 @@ public:
 #endif
 #endif
     bool set_gyro_window_size(uint16_t size);
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+    // pass the primary gyro's filtered samples to a rate loop thread,
+    // one in every decimation samples
+    bool enable_rate_loop_buffer(uint8_t decimation);
+    void disable_rate_loop_buffer();
+    bool rate_loop_buffer_enabled() const { return _rate_loop_buffer_enabled; }
+    uint8_t rate_loop_buffer_decimation() const;
+
+    // wait up to timeout_us for the next sample for the rate loop
+    bool get_next_gyro_sample(Vector3f &gyro, GyroSampleTime &time, uint32_t timeout_us);
+
+    // rate loop samples lost since the last call
+    uint32_t get_rate_loop_dropped_samples();
+#endif
+
     // get accel offsets in m/s/s
     const Vector3f &get_accel_offsets(uint8_t i) const { return _accel_offset(i); }
     const Vector3f &get_accel_offsets(void) const { return get_accel_offsets(_first_usable_accel); }
@@ -242,6 +270,11 @@ public:
     // indicate which bit in LOG_BITMASK indicates raw logging enabled
     void set_log_raw_bit(uint32_t log_raw_bit) { _log_raw_bit = log_raw_bit; }
 
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+    // write out samples held by the delta encoders
+    void flush_delta_logs();
+#endif
+
     // Logging Functions
     void Write_IMU() const;
     void Write_Vibration() const;
@@ -525,6 +558,7 @@ private:
     LowPassFilter2pVector3f _gyro_filter[INS_MAX_INSTANCES];
     Vector3f _accel_filtered[INS_MAX_INSTANCES];
     Vector3f _gyro_filtered[INS_MAX_INSTANCES];
+    GyroSampleTime _gyro_filtered_time[INS_MAX_INSTANCES];
 #if HAL_GYROFFT_ENABLED
     // Thread-safe public version of _last_raw_gyro
     Vector3f _gyro_for_fft[INS_MAX_INSTANCES];
@@ -541,6 +575,7 @@ private:
 
     // Most recent gyro reading
     Vector3f _gyro[INS_MAX_INSTANCES];
+    GyroSampleTime _gyro_time[INS_MAX_INSTANCES];
     Vector3f _delta_angle[INS_MAX_INSTANCES];
     float _delta_angle_dt[INS_MAX_INSTANCES];
     bool _delta_angle_valid[INS_MAX_INSTANCES];
@@ -668,6 +703,26 @@ private:
     // bitmask bit which indicates if we should log raw accel and gyro data
     uint32_t _log_raw_bit;
 
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+    // encoders for delta encoded raw logging, allocated on first
+    // use. Gyros have twice the instances to allow for pre and post
+    // filter logging
+    AP_InertialSensor_DeltaLog *_delta_log_accel[INS_MAX_INSTANCES];
+    AP_InertialSensor_DeltaLog *_delta_log_gyro[INS_MAX_INSTANCES*2];
+    AP_InertialSensor_DeltaLog *get_delta_log(IMU_SENSOR_TYPE type, uint8_t instance);
+
+    // flush the encoders when delta encoded logging stops
+    void update_delta_logs();
+    bool _delta_log_active;
+#endif
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+    // allocated on first use and never freed, as a backend may be
+    // pushing to it
+    AP_InertialSensor_RateBuffer *_rate_loop_buffer;
+    bool _rate_loop_buffer_enabled;
+#endif
+
     // has wait_for_sample() found a sample?
     bool _have_sample:1;
 
@@ -793,6 +848,7 @@ private:
         ALL_GYROS           = (1U<<1),
         POST_FILTER         = (1U<<2),
         PRE_AND_POST_FILTER = (1U<<3),
+        DELTA_ENCODE        = (1U<<4),
     };
     AP_Int16 raw_logging_options;
     bool raw_logging_option_set(RAW_LOGGING_OPTION option) const {
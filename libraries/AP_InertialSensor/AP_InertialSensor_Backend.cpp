@@ -4,6 +4,7 @@
 #include <AP_AHRS/AP_AHRS.h>
 #include "AP_InertialSensor.h"
 #include "AP_InertialSensor_Backend.h"
+#include "AP_InertialSensor_RateBuffer.h"
 #include <AP_Logger/AP_Logger.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
 #if AP_MODULE_SUPPORTED
@@ -159,6 +160,95 @@ void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vecto
     gyro.rotate(_imu._board_orientation);
 }
 
+/*
+  rotate and correct a block of accel samples. This gives the same
+  result as _rotate_and_correct_accel() on each sample, but the
+  calibration state and temperature correction are only evaluated once
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_accel_samples(uint8_t instance, Vector3f *accel, uint8_t n_samples)
+{
+    const enum Rotation sensor_rotation = _imu._accel_orientation[instance];
+    const enum Rotation board_rotation = _imu._board_orientation;
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        accel[i].rotate(sensor_rotation);
+    }
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    const float temperature = _imu.get_temperature(instance);
+    if (_imu.tcal_learning) {
+        for (uint8_t i = 0; i < n_samples; i++) {
+            _imu.tcal(instance).update_accel_learning(accel[i], temperature);
+        }
+    }
+#endif
+
+    if (!_imu._calibrating_accel && (_imu._acal == nullptr
+#if HAL_INS_ACCELCAL_ENABLED
+        || !_imu._acal->running()
+#endif
+    )) {
+        // the temperature correction only depends on temperature, so
+        // evaluate it once and fold it into the offsets
+        Vector3f offset = _imu._accel_offset(instance);
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        Vector3f tcorr;
+        _imu.tcal(instance).correct_accel(temperature, _imu.caltemp_accel(instance), tcorr);
+        offset -= tcorr;
+#endif
+        const Vector3f accel_scale = _imu._accel_scale(instance).get();
+        for (uint8_t i = 0; i < n_samples; i++) {
+            Vector3f &a = accel[i];
+            a -= offset;
+            a.x *= accel_scale.x;
+            a.y *= accel_scale.y;
+            a.z *= accel_scale.z;
+        }
+    }
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        accel[i].rotate(board_rotation);
+    }
+}
+
+/*
+  rotate and correct a block of gyro samples, see _rotate_and_correct_accel_samples()
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_gyro_samples(uint8_t instance, Vector3f *gyro, uint8_t n_samples)
+{
+    const enum Rotation sensor_rotation = _imu._gyro_orientation[instance];
+    const enum Rotation board_rotation = _imu._board_orientation;
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        gyro[i].rotate(sensor_rotation);
+    }
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    const float temperature = _imu.get_temperature(instance);
+    if (_imu.tcal_learning) {
+        for (uint8_t i = 0; i < n_samples; i++) {
+            _imu.tcal(instance).update_gyro_learning(gyro[i], temperature);
+        }
+    }
+#endif
+
+    if (!_imu._calibrating_gyro) {
+        Vector3f offset = _imu._gyro_offset(instance);
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        Vector3f tcorr;
+        _imu.tcal(instance).correct_gyro(temperature, _imu.caltemp_gyro(instance), tcorr);
+        offset -= tcorr;
+#endif
+        for (uint8_t i = 0; i < n_samples; i++) {
+            gyro[i] -= offset;
+        }
+    }
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        gyro[i].rotate(board_rotation);
+    }
+}
+
 /*
   rotate gyro vector and add the gyro offset
  */
@@ -206,7 +296,7 @@ void AP_InertialSensor_Backend::save_gyro_window(const uint8_t instance, const V
 /*
   apply harmonic notch and low pass gyro filters
  */
-void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const Vector3f &gyro)
+void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const Vector3f &gyro, const uint64_t sample_us)
 {
     uint8_t filter_phase = 0;
     save_gyro_window(instance, gyro, filter_phase++);
@@ -256,6 +346,17 @@ void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const
 #endif
     } else {
         _imu._gyro_filtered[instance] = gyro_filtered;
+        // backends that don't give sample times are stamped on arrival
+        // by the _notify functions. Zero means no sample time to users,
+        // so keep it for gyros that have never sampled
+        const uint32_t gyro_sample_us = sample_us != 0 ? uint32_t(sample_us) : AP_HAL::micros();
+        _imu._gyro_filtered_time[instance].sample_us = MAX(gyro_sample_us, 1U);
+        _imu._gyro_filtered_time[instance].filtered_us = AP_HAL::micros();
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+        if (_imu._rate_loop_buffer_enabled) {
+            _imu._rate_loop_buffer->push(instance, gyro_filtered, _imu._gyro_filtered_time[instance]);
+        }
+#endif
     }
 }
 
@@ -342,7 +443,7 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
         _imu._last_raw_gyro[instance] = gyro;
 
         // apply gyro filters and sample for FFT
-        apply_gyro_filters(instance, gyro);
+        apply_gyro_filters(instance, gyro, sample_us);
 
         _imu._new_gyro_data[instance] = true;
     }
@@ -351,6 +452,95 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     log_gyro_raw(instance, sample_us, gyro, _imu._gyro_filtered[instance]);
 }
 
+/*
+  handle a block of gyro samples from a FIFO based sensor. The
+  per-sample integration, filtering and FFT sampling match
+  _notify_new_gyro_raw_sample(), but the semaphore is taken once for
+  each block of up to max_batch_samples
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance,
+                                                             const Vector3f *gyro,
+                                                             uint8_t n_samples)
+{
+    while (n_samples > 0) {
+        if (has_been_killed(instance)) {
+            return;
+        }
+        const uint8_t n = MIN(n_samples, uint8_t(max_batch_samples));
+
+        for (uint8_t i = 0; i < n; i++) {
+            _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
+                                _imu._gyro_raw_sample_rates[instance]);
+        }
+
+        // don't accept below 40Hz
+        if (_imu._gyro_raw_sample_rates[instance] < 40) {
+            return;
+        }
+        const float dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
+
+        const uint64_t last_sample_us = _imu._gyro_last_sample_us[instance];
+        const uint64_t now = AP_HAL::micros64();
+        _imu._gyro_last_sample_us[instance] = now;
+
+        for (uint8_t i = 0; i < n; i++) {
+#if AP_MODULE_SUPPORTED
+            // call gyro_sample hook if any
+            AP_Module::call_hook_gyro_sample(instance, dt, gyro[i]);
+#endif
+            // push gyros if optical flow present
+            if (hal.opticalflow) {
+                hal.opticalflow->push_gyro(gyro[i].x, gyro[i].y, dt);
+            }
+        }
+
+        // spread the sample times back from now at the sample rate
+        const uint32_t dt_us = dt * 1.0e6f;
+
+        Vector3f filtered[max_batch_samples];
+        {
+            WITH_SEMAPHORE(_sem);
+
+            // zero accumulator if sensor was unhealthy for 0.1s, and don't integrate the first sample
+            const bool reset = now - last_sample_us > 100000U;
+            if (reset) {
+                _imu._delta_angle_acc[instance].zero();
+                _imu._delta_angle_acc_dt[instance] = 0;
+            }
+
+            for (uint8_t i = 0; i < n; i++) {
+                const float sample_dt = (reset && i == 0) ? 0 : dt;
+
+                // compute delta angle and coning correction, see _notify_new_gyro_raw_sample()
+                const Vector3f delta_angle = (gyro[i] + _imu._last_raw_gyro[instance]) * 0.5f * sample_dt;
+                Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
+                                         _imu._last_delta_angle[instance] * (1.0f / 6.0f));
+                delta_coning = delta_coning % delta_angle;
+                delta_coning *= 0.5f;
+
+                _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
+                _imu._delta_angle_acc_dt[instance] += sample_dt;
+
+                _imu._last_delta_angle[instance] = delta_angle;
+                _imu._last_raw_gyro[instance] = gyro[i];
+
+                // apply gyro filters and sample for FFT
+                apply_gyro_filters(instance, gyro[i], now - (n-1-i) * dt_us);
+                filtered[i] = _imu._gyro_filtered[instance];
+            }
+
+            _imu._new_gyro_data[instance] = true;
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            log_gyro_raw(instance, now - (n-1-i) * dt_us, gyro[i], filtered[i]);
+        }
+
+        gyro += n;
+        n_samples -= n;
+    }
+}
+
 /*
   handle a delta-angle sample from the backend. This assumes FIFO
   style sampling and the sample should not be rotated or corrected for
@@ -430,7 +620,7 @@ void AP_InertialSensor_Backend::_notify_new_delta_angle(uint8_t instance, const
         _imu._last_raw_gyro[instance] = gyro;
 
         // apply gyro filters and sample for FFT
-        apply_gyro_filters(instance, gyro);
+        apply_gyro_filters(instance, gyro, sample_us);
 
         _imu._new_gyro_data[instance] = true;
     }
@@ -595,6 +785,94 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
 #endif
 }
 
+/*
+  handle a block of accel samples from a FIFO based sensor, see
+  _notify_new_gyro_raw_samples()
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance,
+                                                              const Vector3f *accel,
+                                                              uint8_t n_samples,
+                                                              uint32_t fsync_mask)
+{
+    while (n_samples > 0) {
+        if (has_been_killed(instance)) {
+            return;
+        }
+        const uint8_t n = MIN(n_samples, uint8_t(max_batch_samples));
+
+        for (uint8_t i = 0; i < n; i++) {
+            _update_sensor_rate(_imu._sample_accel_count[instance], _imu._sample_accel_start_us[instance],
+                                _imu._accel_raw_sample_rates[instance]);
+        }
+
+        // don't accept below 40Hz
+        if (_imu._accel_raw_sample_rates[instance] < 40) {
+            return;
+        }
+        const float dt = 1.0f / _imu._accel_raw_sample_rates[instance];
+
+        const uint64_t last_sample_us = _imu._accel_last_sample_us[instance];
+        const uint64_t now = AP_HAL::micros64();
+        _imu._accel_last_sample_us[instance] = now;
+
+        for (uint8_t i = 0; i < n; i++) {
+#if AP_MODULE_SUPPORTED
+            // call accel_sample hook if any
+            AP_Module::call_hook_accel_sample(instance, dt, accel[i], (fsync_mask & (1U<<i)) != 0);
+#endif
+            _imu.calc_vibration_and_clipping(instance, accel[i], dt);
+        }
+
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+        Vector3f filtered[max_batch_samples];
+#endif
+        {
+            WITH_SEMAPHORE(_sem);
+
+            // zero accumulator if sensor was unhealthy for 0.1s, and don't integrate the first sample
+            const bool reset = now - last_sample_us > 100000U;
+            if (reset) {
+                _imu._delta_velocity_acc[instance].zero();
+                _imu._delta_velocity_acc_dt[instance] = 0;
+            }
+
+            for (uint8_t i = 0; i < n; i++) {
+                const float sample_dt = (reset && i == 0) ? 0 : dt;
+
+                // delta velocity
+                _imu._delta_velocity_acc[instance] += accel[i] * sample_dt;
+                _imu._delta_velocity_acc_dt[instance] += sample_dt;
+
+                _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel[i]);
+                if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+                    _imu._accel_filter[instance].reset();
+                }
+                _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+                filtered[i] = _imu._accel_filtered[instance];
+#endif
+            }
+
+            _imu._new_accel_data[instance] = true;
+        }
+
+        // spread the sample times back from now at the sample rate
+        const uint32_t dt_us = dt * 1.0e6f;
+        for (uint8_t i = 0; i < n; i++) {
+            const uint64_t sample_us = now - (n-1-i) * dt_us;
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+            log_accel_raw(instance, sample_us, _imu.batchsampler.doing_post_filter_logging() ? filtered[i] : accel[i]);
+#else
+            log_accel_raw(instance, sample_us, accel[i]);
+#endif
+        }
+
+        accel += n;
+        n_samples -= n;
+        fsync_mask >>= n;
+    }
+}
+
 /*
   handle a delta-velocity sample from the backend. This assumes FIFO style sampling and
   the sample should not be rotated or corrected for offsets
@@ -774,6 +1052,7 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance) /* front end */
     }
     if (_imu._new_gyro_data[instance]) {
         _publish_gyro(instance, _imu._gyro_filtered[instance]);
+        _imu._gyro_time[instance] = _imu._gyro_filtered_time[instance];
 #if HAL_GYROFFT_ENABLED
         // copy the gyro samples from the backend to the frontend window for FFTs sampling at less than IMU rate
         _imu._gyro_for_fft[instance] = _imu._last_gyro_for_fft[instance];
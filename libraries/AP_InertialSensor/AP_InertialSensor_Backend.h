@@ -156,11 +156,17 @@ protected:
     void _rotate_and_correct_accel(uint8_t instance, Vector3f &accel) __RAMFUNC__;
     void _rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro) __RAMFUNC__;
 
+    // rotate and correct a block of FIFO samples, evaluating calibration state and
+    // temperature corrections once for the block
+    void _rotate_and_correct_accel_samples(uint8_t instance, Vector3f *accel, uint8_t n_samples) __RAMFUNC__;
+    void _rotate_and_correct_gyro_samples(uint8_t instance, Vector3f *gyro, uint8_t n_samples) __RAMFUNC__;
+
     // rotate gyro vector, offset and publish
     void _publish_gyro(uint8_t instance, const Vector3f &gyro) __RAMFUNC__; /* front end */
 
-    // apply notch and lowpass gyro filters and sample for FFT
-    void apply_gyro_filters(const uint8_t instance, const Vector3f &gyro);
+    // apply notch and lowpass gyro filters and sample for FFT.
+    // sample_us is the time the sample arrived from the sensor
+    void apply_gyro_filters(const uint8_t instance, const Vector3f &gyro, const uint64_t sample_us);
     void save_gyro_window(const uint8_t instance, const Vector3f &gyro, uint8_t phase);
 
     // this should be called every time a new gyro raw sample is
@@ -171,6 +177,12 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_gyro_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0) __RAMFUNC__;
 
+    // batch interface for FIFO based sensors. Equivalent to calling
+    // _notify_new_gyro_raw_sample() for each sample with sample_us=0,
+    // but the frontend semaphore is taken once per block. Samples
+    // must be rotated and corrected (_rotate_and_correct_gyro_samples)
+    void _notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyro, uint8_t n_samples) __RAMFUNC__;
+
     // alternative interface using delta-angles. Rotation and correction is handled inside this function
     void _notify_new_delta_angle(uint8_t instance, const Vector3f &dangle);
     
@@ -185,8 +197,18 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0, bool fsync_set=false) __RAMFUNC__;
 
+    // batch interface for FIFO based sensors. Equivalent to calling
+    // _notify_new_accel_raw_sample() for each sample with sample_us=0,
+    // but the frontend semaphore is taken once per block. Bit i of
+    // fsync_mask is the fsync flag for sample i. Samples must be
+    // rotated and corrected (_rotate_and_correct_accel_samples)
+    void _notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accel, uint8_t n_samples, uint32_t fsync_mask=0) __RAMFUNC__;
+
     // alternative interface using delta-velocities. Rotation and correction is handled inside this function
     void _notify_new_delta_velocity(uint8_t instance, const Vector3f &dvelocity);
+
+    // maximum number of samples handled under one take of the frontend semaphore by the batch interface
+    static const uint8_t max_batch_samples = 8;
     
     // set the amount of oversamping a accel is doing
     void _set_accel_oversampling(uint8_t instance, uint8_t n);
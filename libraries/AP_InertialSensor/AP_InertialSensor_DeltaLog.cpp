@@ -0,0 +1,150 @@
+#include "AP_InertialSensor_DeltaLog.h"
+
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Logger/AP_Logger.h>
+
+// largest gap between the first two samples of a message
+#define DELTA_LOG_MAX_INTERVAL_US 100000
+
+AP_InertialSensor_DeltaLog::AP_InertialSensor_DeltaLog(uint8_t msg_type, uint8_t instance, float _resolution) :
+    resolution(_resolution),
+    count(0),
+    last_sample_us(0),
+    use_sample_timestamp(false)
+{
+    pkt.head1 = HEAD_BYTE1;
+    pkt.head2 = HEAD_BYTE2;
+    pkt.msgid = msg_type;
+    pkt.instance = instance;
+}
+
+/*
+  add a sample to the pending message, returning false if it can't be
+  added without losing precision or timing
+ */
+bool AP_InertialSensor_DeltaLog::append(uint64_t sample_us, const Vector3f &sample)
+{
+    if (count == 0) {
+        // start a new message with this sample as the keyframe
+        pkt.sample_us = sample_us;
+        pkt.span_us = 0;
+        pkt.x = sample.x;
+        pkt.y = sample.y;
+        pkt.z = sample.z;
+        sum[0] = sum[1] = sum[2] = 0;
+        last_sample_us = sample_us;
+        count = 1;
+        return true;
+    }
+    if (count >= MAX_SAMPLES) {
+        return false;
+    }
+
+    // samples must be evenly spaced for the times to be interpolated
+    const uint64_t dt = sample_us - last_sample_us;
+    if (count == 1) {
+        if (sample_us < last_sample_us || dt > DELTA_LOG_MAX_INTERVAL_US) {
+            return false;
+        }
+    } else {
+        const uint32_t interval = pkt.span_us / (count - 1);
+        if (sample_us < last_sample_us || dt > interval + interval/4 || dt + interval/4 < interval) {
+            return false;
+        }
+    }
+
+    // the differences are taken against the reconstructed value so
+    // quantisation errors don't accumulate along the message
+    const float keyframe[3] { pkt.x, pkt.y, pkt.z };
+    int32_t delta[3];
+    for (uint8_t i=0; i<3; i++) {
+        const float total = (sample[i] - keyframe[i]) / resolution;
+        // also rejects NaN
+        if (!(fabsf(total) < 1.0e9f)) {
+            return false;
+        }
+        delta[i] = int32_t(lrintf(total)) - sum[i];
+        if (delta[i] < INT16_MIN || delta[i] > INT16_MAX) {
+            return false;
+        }
+    }
+
+    const uint8_t idx = count - 1;
+    pkt.dx[idx] = delta[0];
+    pkt.dy[idx] = delta[1];
+    pkt.dz[idx] = delta[2];
+    for (uint8_t i=0; i<3; i++) {
+        sum[i] += delta[i];
+    }
+    pkt.span_us = sample_us - pkt.sample_us;
+    last_sample_us = sample_us;
+    count++;
+    return true;
+}
+
+/*
+  return the pending message, ready to be written
+ */
+const log_IMUDelta &AP_InertialSensor_DeltaLog::packet()
+{
+    pkt.count = count;
+    // zero unused differences so they compress well
+    for (uint8_t i=(count>0?count-1:0); i<LOG_IMU_DELTA_COUNT; i++) {
+        pkt.dx[i] = pkt.dy[i] = pkt.dz[i] = 0;
+    }
+    return pkt;
+}
+
+void AP_InertialSensor_DeltaLog::add_sample(uint64_t sample_us, const Vector3f &sample, bool _use_sample_timestamp)
+{
+    WITH_SEMAPHORE(sem);
+    use_sample_timestamp = _use_sample_timestamp;
+    if (append(sample_us, sample)) {
+        return;
+    }
+    write_pending();
+    append(sample_us, sample);
+}
+
+void AP_InertialSensor_DeltaLog::flush()
+{
+    WITH_SEMAPHORE(sem);
+    write_pending();
+}
+
+void AP_InertialSensor_DeltaLog::write_pending()
+{
+    if (count == 0) {
+        return;
+    }
+    pkt.time_us = use_sample_timestamp ? last_sample_us : AP_HAL::micros64();
+    AP::logger().WriteBlock(&packet(), sizeof(pkt));
+    count = 0;
+}
+
+/*
+  expand a message into its samples and sample times
+ */
+uint8_t AP_InertialSensor_DeltaLog::decode(const log_IMUDelta &msg, float _resolution, uint64_t sample_us[], Vector3f samples[])
+{
+    const uint8_t n = MIN(msg.count, uint8_t(MAX_SAMPLES));
+    if (n == 0) {
+        return 0;
+    }
+    const Vector3f keyframe { msg.x, msg.y, msg.z };
+    int32_t total[3] {};
+    sample_us[0] = msg.sample_us;
+    samples[0] = keyframe;
+    for (uint8_t i=1; i<n; i++) {
+        total[0] += msg.dx[i-1];
+        total[1] += msg.dy[i-1];
+        total[2] += msg.dz[i-1];
+        sample_us[i] = msg.sample_us + (uint64_t(msg.span_us) * i) / (n - 1);
+        samples[i] = keyframe + Vector3f(total[0], total[1], total[2]) * _resolution;
+    }
+    return n;
+}
+
+#endif // AP_INERTIALSENSOR_DELTA_LOG_ENABLED
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "AP_InertialSensor_config.h"
+
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/Semaphores.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Logger/LogStructure.h>
+
+/*
+  delta encoder for raw IMU logging. Consecutive samples from one
+  sensor are packed into a single ACCD or GYRD message holding a full
+  precision keyframe followed by the differences between successive
+  samples as fixed point values. A message is written when it is full,
+  when a difference does not fit in 16 bits or when the sample
+  interval changes, so sample times can be recovered by interpolation.
+  Samples are added from the backend thread of the sensor and the
+  pending message may be flushed from any thread
+ */
+class AP_InertialSensor_DeltaLog {
+public:
+    // resolution is the value of one count in the differences, and
+    // must match the multiplier given for the message format
+    AP_InertialSensor_DeltaLog(uint8_t msg_type, uint8_t instance, float resolution);
+
+    CLASS_NO_COPY(AP_InertialSensor_DeltaLog);
+
+    // samples per message, including the keyframe
+    static const uint8_t MAX_SAMPLES = LOG_IMU_DELTA_COUNT + 1;
+
+    // add a sample, writing out the pending message if the sample
+    // can't be added to it
+    void add_sample(uint64_t sample_us, const Vector3f &sample, bool use_sample_timestamp) __RAMFUNC__;
+
+    // write out any pending samples
+    void flush();
+
+    // add a sample to the pending message, returning false if it
+    // can't be added without losing precision or timing
+    bool append(uint64_t sample_us, const Vector3f &sample);
+
+    // the pending message, ready to be written
+    const log_IMUDelta &packet();
+
+    // expand a message into its samples and sample times, returning
+    // the number of samples. The arrays must hold MAX_SAMPLES entries
+    static uint8_t decode(const log_IMUDelta &pkt, float resolution, uint64_t sample_us[], Vector3f samples[]);
+
+private:
+    // write out any pending samples, with sem held
+    void write_pending();
+
+    HAL_Semaphore sem;
+    log_IMUDelta pkt {};
+    const float resolution;
+    uint8_t count;
+    // running sum of the differences for each axis, in counts
+    int32_t sum[3] {};
+    uint64_t last_sample_us;
+    bool use_sample_timestamp;
+};
+
+#endif // AP_INERTIALSENSOR_DELTA_LOG_ENABLED
@@ -581,49 +581,62 @@ void AP_InertialSensor_Invensense::_check_register_change(void)
 
 bool AP_InertialSensor_Invensense::_accumulate(uint8_t *samples, uint8_t n_samples)
 {
+    // decode the whole FIFO block, then rotate, correct and publish it in one go
+    Vector3f accel[MPU_FIFO_BUFFER_LEN];
+    Vector3f gyro[MPU_FIFO_BUFFER_LEN];
+    uint32_t fsync_mask = 0;
+    uint8_t n_good = 0;
+    bool ret = true;
+
+    n_samples = MIN(n_samples, MPU_FIFO_BUFFER_LEN);
     for (uint8_t i = 0; i < n_samples; i++) {
         const uint8_t *data = samples + MPU_SAMPLE_SIZE * i;
-        Vector3f accel, gyro;
-        bool fsync_set = false;
 
 #if INVENSENSE_EXT_SYNC_ENABLE
-        fsync_set = (int16_val(data, 2) & 1U) != 0;
+        if ((int16_val(data, 2) & 1U) != 0) {
+            fsync_mask |= 1U << i;
+        }
 #endif
         
-        accel = Vector3f(int16_val(data, 1),
-                         int16_val(data, 0),
-                         -int16_val(data, 2));
-        accel *= _accel_scale;
+        accel[i] = Vector3f(int16_val(data, 1),
+                            int16_val(data, 0),
+                            -int16_val(data, 2));
+        accel[i] *= _accel_scale;
 
         int16_t t2 = int16_val(data, 3);
         if (!_check_raw_temp(t2)) {
-            if (_enable_fast_fifo_reset) {
-                _fast_fifo_reset();
-                return false;
-            } else {
-                if (!hal.scheduler->in_expected_delay()) {
-                    debug("temp reset IMU[%u] %d %d", accel_instance, _raw_temp, t2);
-                }
-                _fifo_reset(true);
-                return false;
-            }
+            // publish the good samples before the reset
+            ret = false;
+            break;
         }
         float temp = t2 * temp_sensitivity + temp_zero;
         
-        gyro = Vector3f(int16_val(data, 5),
-                        int16_val(data, 4),
-                        -int16_val(data, 6));
-        gyro *= _gyro_scale;
+        gyro[i] = Vector3f(int16_val(data, 5),
+                           int16_val(data, 4),
+                           -int16_val(data, 6));
+        gyro[i] *= _gyro_scale;
 
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
+        _temp_filtered = _temp_filter.apply(temp);
+        n_good++;
+    }
 
-        _notify_new_accel_raw_sample(accel_instance, accel, 0, fsync_set);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
+    _rotate_and_correct_accel_samples(accel_instance, accel, n_good);
+    _rotate_and_correct_gyro_samples(gyro_instance, gyro, n_good);
 
-        _temp_filtered = _temp_filter.apply(temp);
+    _notify_new_accel_raw_samples(accel_instance, accel, n_good, fsync_mask);
+    _notify_new_gyro_raw_samples(gyro_instance, gyro, n_good);
+
+    if (!ret) {
+        if (_enable_fast_fifo_reset) {
+            _fast_fifo_reset();
+        } else {
+            if (!hal.scheduler->in_expected_delay()) {
+                debug("temp reset IMU[%u] %d %d", accel_instance, _raw_temp, int16_val(samples + MPU_SAMPLE_SIZE * n_good, 3));
+            }
+            _fifo_reset(true);
+        }
     }
-    return true;
+    return ret;
 }
 
 /*
@@ -413,11 +413,31 @@ void AP_InertialSensor_Invensensev3::accumulate()
     // nothing to do
 }
 
+/*
+  rotate, correct and publish a block of decoded samples. Publishing the
+  block at once takes the frontend semaphore once rather than twice per sample
+ */
+void AP_InertialSensor_Invensensev3::publish_samples(Vector3f *accel, Vector3f *gyro, uint8_t n_samples)
+{
+    _rotate_and_correct_accel_samples(accel_instance, accel, n_samples);
+    _rotate_and_correct_gyro_samples(gyro_instance, gyro, n_samples);
+
+    _notify_new_accel_raw_samples(accel_instance, accel, n_samples);
+    _notify_new_gyro_raw_samples(gyro_instance, gyro, n_samples);
+}
+
 bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, uint8_t n_samples)
 {
 #if INV3_ENABLE_FIFO_LOGGING
     const uint64_t tstart = AP_HAL::micros64();
 #endif
+    // decode the whole FIFO block, then rotate, correct and publish it in one go
+    Vector3f accel[INV3_FIFO_BUFFER_LEN];
+    Vector3f gyro[INV3_FIFO_BUFFER_LEN];
+    uint8_t n_good = 0;
+    bool ret = true;
+
+    n_samples = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
     for (uint8_t i = 0; i < n_samples; i++) {
         const FIFOData &d = data[i];
 
@@ -427,31 +447,27 @@ bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, ui
         // ICM42688 - HEADER_TIMESTAMP_FSYNC bit 2-3 : 10
         if ((d.header & 0xFC) != 0x68) { // ACCEL_EN | GYRO_EN | TMST_FIELD_EN
             // no or bad data
-            return false;
+            ret = false;
+            break;
         }
 
-        Vector3f accel{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
-        Vector3f gyro{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
+        accel[i] = Vector3f{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
+        gyro[i] = Vector3f{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
 
-        accel *= accel_scale;
-        gyro *= gyro_scale;
+        accel[i] *= accel_scale;
+        gyro[i] *= gyro_scale;
 
 #if INV3_ENABLE_FIFO_LOGGING
-        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro, true);
+        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro[i], true);
 #endif
 
         const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
-
         temp_filtered = temp_filter.apply(temp);
+        n_good++;
     }
-    return true;
+
+    publish_samples(accel, gyro, n_good);
+    return ret;
 }
 
 #if HAL_INS_HIGHRES_SAMPLE
@@ -479,6 +495,13 @@ bool AP_InertialSensor_Invensensev3::accumulate_highres_samples(const FIFODataHi
 #if INV3_ENABLE_FIFO_LOGGING
     const uint64_t tstart = AP_HAL::micros64();
 #endif
+    // decode the whole FIFO block, then rotate, correct and publish it in one go
+    Vector3f accel[INV3_FIFO_BUFFER_LEN];
+    Vector3f gyro[INV3_FIFO_BUFFER_LEN];
+    uint8_t n_good = 0;
+    bool ret = true;
+
+    n_samples = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
     for (uint8_t i = 0; i < n_samples; i++) {
         const FIFODataHighRes &d = data[i];
 
@@ -486,34 +509,30 @@ bool AP_InertialSensor_Invensensev3::accumulate_highres_samples(const FIFODataHi
         // about with the temperature registers
         if ((d.header & 0xFC) != 0x78) { // ACCEL_EN | GYRO_EN | HIRES_EN | TMST_FIELD_EN
             // no or bad data
-            return false;
+            ret = false;
+            break;
         }
 
-        Vector3f accel{uint20_to_float(d.accel[1], d.accel[0], d.ax),
+        accel[i] = Vector3f{uint20_to_float(d.accel[1], d.accel[0], d.ax),
             uint20_to_float(d.accel[3], d.accel[2], d.ay),
             uint20_to_float(d.accel[5], d.accel[4], d.az)};
-        Vector3f gyro{uint20_to_float(d.gyro[1], d.gyro[0], d.gx),
+        gyro[i] = Vector3f{uint20_to_float(d.gyro[1], d.gyro[0], d.gx),
             uint20_to_float(d.gyro[3], d.gyro[2], d.gy),
             uint20_to_float(d.gyro[5], d.gyro[4], d.gz)};
 
-        accel *= accel_scale;
-        gyro *= gyro_scale;
+        accel[i] *= accel_scale;
+        gyro[i] *= gyro_scale;
 
 #if INV3_ENABLE_FIFO_LOGGING
-        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro, true);
+        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro[i], true);
 #endif
         const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
-
         temp_filtered = temp_filter.apply(temp);
+        n_good++;
     }
-    return true;
+
+    publish_samples(accel, gyro, n_good);
+    return ret;
 }
 #endif
 
@@ -72,6 +72,7 @@ private:
     uint8_t register_read_bank_icm456xy(uint16_t bank_addr, uint16_t reg);
     void register_write_bank_icm456xy(uint16_t bank_addr, uint16_t reg, uint8_t val);
 
+    void publish_samples(Vector3f *accel, Vector3f *gyro, uint8_t n_samples);
     bool accumulate_samples(const struct FIFOData *data, uint8_t n_samples);
     bool accumulate_highres_samples(const struct FIFODataHighRes *data, uint8_t n_samples);
 
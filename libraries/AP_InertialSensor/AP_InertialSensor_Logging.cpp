@@ -4,14 +4,77 @@
 
 #include "AP_InertialSensor.h"
 #include "AP_InertialSensor_Backend.h"
+#include "AP_InertialSensor_DeltaLog.h"
 
 #include <AP_AHRS/AP_AHRS.h>
 #include <AP_Logger/AP_Logger.h>
 
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+// get the delta encoder for a sensor, allocating it on first use
+AP_InertialSensor_DeltaLog *AP_InertialSensor::get_delta_log(IMU_SENSOR_TYPE type, uint8_t instance)
+{
+    if (type == IMU_SENSOR_TYPE_GYRO) {
+        if (instance >= ARRAY_SIZE(_delta_log_gyro)) {
+            return nullptr;
+        }
+        if (_delta_log_gyro[instance] == nullptr) {
+            _delta_log_gyro[instance] = NEW_NOTHROW AP_InertialSensor_DeltaLog(LOG_GYRD_MSG, instance, LOG_GYRD_RESOLUTION);
+        }
+        return _delta_log_gyro[instance];
+    }
+    if (instance >= ARRAY_SIZE(_delta_log_accel)) {
+        return nullptr;
+    }
+    if (_delta_log_accel[instance] == nullptr) {
+        _delta_log_accel[instance] = NEW_NOTHROW AP_InertialSensor_DeltaLog(LOG_ACCD_MSG, instance, LOG_ACCD_RESOLUTION);
+    }
+    return _delta_log_accel[instance];
+}
+
+// write out samples held by the delta encoders. Called by the logger
+// before it stops logging or rotates the log on disarm
+void AP_InertialSensor::flush_delta_logs()
+{
+    for (auto *delta_log : _delta_log_accel) {
+        if (delta_log != nullptr) {
+            delta_log->flush();
+        }
+    }
+    for (auto *delta_log : _delta_log_gyro) {
+        if (delta_log != nullptr) {
+            delta_log->flush();
+        }
+    }
+}
+
+// the backends only push samples out of the encoders when adding new
+// ones, so flush when the option is cleared or raw logging stops
+void AP_InertialSensor::update_delta_logs()
+{
+    const AP_Logger *logger = AP_Logger::get_singleton();
+    const bool active = raw_logging_option_set(RAW_LOGGING_OPTION::DELTA_ENCODE) &&
+        _log_raw_bit != (uint32_t)-1 &&
+        logger != nullptr && logger->should_log(_log_raw_bit);
+    if (_delta_log_active && !active) {
+        flush_delta_logs();
+    }
+    _delta_log_active = active;
+}
+#endif
+
 // Write ACC data packet: raw accel data
 void AP_InertialSensor_Backend::Write_ACC(const uint8_t instance, const uint64_t sample_us, const Vector3f &accel) const
 {
         const uint64_t now = AP_HAL::micros64();
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+        if (_imu.raw_logging_option_set(AP_InertialSensor::RAW_LOGGING_OPTION::DELTA_ENCODE)) {
+            AP_InertialSensor_DeltaLog *delta_log = _imu.get_delta_log(AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, instance);
+            if (delta_log != nullptr) {
+                delta_log->add_sample(sample_us?sample_us:now, accel, false);
+                return;
+            }
+        }
+#endif
         const struct log_ACC pkt {
             LOG_PACKET_HEADER_INIT(LOG_ACC_MSG),
             time_us   : now,
@@ -28,6 +91,15 @@ void AP_InertialSensor_Backend::Write_ACC(const uint8_t instance, const uint64_t
 void AP_InertialSensor_Backend::Write_GYR(const uint8_t instance, const uint64_t sample_us, const Vector3f &gyro, bool use_sample_timestamp) const
 {
         const uint64_t now = use_sample_timestamp?sample_us:AP_HAL::micros64();
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+        if (_imu.raw_logging_option_set(AP_InertialSensor::RAW_LOGGING_OPTION::DELTA_ENCODE)) {
+            AP_InertialSensor_DeltaLog *delta_log = _imu.get_delta_log(AP_InertialSensor::IMU_SENSOR_TYPE_GYRO, instance);
+            if (delta_log != nullptr) {
+                delta_log->add_sample(sample_us?sample_us:now, gyro, use_sample_timestamp);
+                return;
+            }
+        }
+#endif
         const struct log_GYR pkt{
             LOG_PACKET_HEADER_INIT(LOG_GYR_MSG),
             time_us   : now,
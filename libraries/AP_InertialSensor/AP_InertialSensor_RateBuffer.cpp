@@ -0,0 +1,80 @@
+#include "AP_InertialSensor_RateBuffer.h"
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+
+void AP_InertialSensor_RateBuffer::push(uint8_t instance, const Vector3f &gyro, const AP_InertialSensor::GyroSampleTime &time)
+{
+    // check without the lock first, as every gyro calls this
+    if (instance != _instance) {
+        return;
+    }
+    WITH_SEMAPHORE(_write_sem);
+    if (instance != _instance) {
+        // the gyro changed while we waited
+        return;
+    }
+    if (++_decimation_count < _decimation) {
+        return;
+    }
+    _decimation_count = 0;
+
+    const Sample sample {
+        gyro : gyro,
+        sample_us : time.sample_us,
+        filtered_us : time.filtered_us,
+    };
+    if (!_samples.push(sample)) {
+        // the reader has stopped or is far behind
+        _overruns++;
+        return;
+    }
+    _sem.signal();
+}
+
+bool AP_InertialSensor_RateBuffer::wait_sample(Sample &sample, uint32_t timeout_us)
+{
+    // the semaphore may have been left signalled by samples which
+    // have already been read
+    while (_samples.is_empty()) {
+        if (!_sem.wait(timeout_us)) {
+            return false;
+        }
+    }
+    const uint32_t available = _samples.available();
+    for (uint32_t i = 0; i < available-1; i++) {
+        _samples.pop();
+    }
+    _skipped += available-1;
+    return _samples.pop(sample);
+}
+
+void AP_InertialSensor_RateBuffer::set_instance(uint8_t instance)
+{
+    if (instance == _instance) {
+        return;
+    }
+    WITH_SEMAPHORE(_write_sem);
+    _instance = instance;
+    _decimation_count = 0;
+}
+
+void AP_InertialSensor_RateBuffer::set_decimation(uint8_t decimation)
+{
+    _decimation = MAX(decimation, uint8_t(1));
+}
+
+void AP_InertialSensor_RateBuffer::clear()
+{
+    while (_samples.pop()) {
+    }
+}
+
+uint32_t AP_InertialSensor_RateBuffer::get_and_clear_dropped()
+{
+    const uint32_t dropped = _overruns + _skipped;
+    const uint32_t ret = dropped - _dropped_reported;
+    _dropped_reported = dropped;
+    return ret;
+}
+
+#endif // AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "AP_InertialSensor_config.h"
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/Semaphores.h>
+#include <AP_HAL/utility/RingBuffer.h>
+#include <AP_Math/AP_Math.h>
+#include "AP_InertialSensor.h"
+
+/*
+  hands the filtered samples of one gyro from the backend threads to
+  a rate loop thread, which waits on each sample rather than on the
+  main loop. Only one in every decimation samples is passed on, the
+  gyro low pass filter having removed the frequencies which would
+  otherwise alias.
+
+  The buffer is written by the backend owning the gyro and read by a
+  single reader. The gyro is chosen by the main loop with
+  set_instance(), and pushes are made under a lock so that the
+  backends of the old and new gyros never write at the same time
+ */
+class AP_InertialSensor_RateBuffer {
+public:
+    AP_InertialSensor_RateBuffer() {}
+
+    CLASS_NO_COPY(AP_InertialSensor_RateBuffer);
+
+    struct Sample {
+        Vector3f gyro;
+        uint32_t sample_us;     // time the sample arrived from the sensor
+        uint32_t filtered_us;   // time the filtered sample was ready
+    };
+
+    // add a filtered sample, called by the backends for each gyro.
+    // Samples from gyros other than the selected one are ignored
+    void push(uint8_t instance, const Vector3f &gyro, const AP_InertialSensor::GyroSampleTime &time);
+
+    // select the gyro whose samples are passed on
+    void set_instance(uint8_t instance);
+
+    // wait up to timeout_us for the next sample. If the reader has
+    // fallen behind the older samples are skipped and the newest
+    // returned
+    bool wait_sample(Sample &sample, uint32_t timeout_us);
+
+    // pass on one in every decimation samples
+    void set_decimation(uint8_t decimation);
+    uint8_t get_decimation() const { return _decimation; }
+
+    // discard any samples held
+    void clear();
+
+    // samples lost since the last call, because the buffer was full
+    // or the reader skipped them
+    uint32_t get_and_clear_dropped();
+
+private:
+    ObjectBuffer<Sample> _samples{8};
+    HAL_BinarySemaphore _sem;
+
+    // held by the writer and while changing gyro
+    HAL_Semaphore _write_sem;
+    uint8_t _instance = 0;
+
+    uint8_t _decimation = 1;
+    uint8_t _decimation_count = 0;
+
+    // counted separately by the writer and the reader
+    uint32_t _overruns = 0;
+    uint32_t _skipped = 0;
+    uint32_t _dropped_reported = 0;
+};
+
+#endif // AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
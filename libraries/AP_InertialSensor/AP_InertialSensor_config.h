@@ -70,6 +70,15 @@
 #define AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_LOGGING_ENABLED)
 #endif
 
+#ifndef AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+#define AP_INERTIALSENSOR_DELTA_LOG_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_LOGGING_ENABLED && BOARD_FLASH_SIZE > 1024)
+#endif
+
 #ifndef AP_INERTIALSENSOR_KILL_IMU_ENABLED
 #define AP_INERTIALSENSOR_KILL_IMU_ENABLED 1
 #endif
+
+// pass filtered gyro samples to a rate loop thread
+#ifndef AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+#define AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED (AP_INERTIALSENSOR_ENABLED && BOARD_FLASH_SIZE > 1024)
+#endif
@@ -8,7 +8,9 @@
     LOG_IMU_MSG, \
     LOG_ISBH_MSG, \
     LOG_ISBD_MSG, \
-    LOG_VIBE_MSG
+    LOG_VIBE_MSG, \
+    LOG_ACCD_MSG, \
+    LOG_GYRD_MSG
 
 // @LoggerMessage: ACC
 // @Description: IMU accelerometer data
@@ -42,6 +44,42 @@ struct PACKED log_GYR {
     float GyrX, GyrY, GyrZ;
 };
 
+// number of differences carried by each ACCD/GYRD message; this is
+// fixed by the size of the 'a' format type
+#define LOG_IMU_DELTA_COUNT 32
+
+// value of one count in the ACCD and GYRD differences; these must
+// match the multipliers in the formats below
+#define LOG_ACCD_RESOLUTION 1.0e-3f // m/s/s
+#define LOG_GYRD_RESOLUTION 1.0e-4f // rad/s
+
+// @LoggerMessage: ACCD,GYRD
+// @Description: Delta encoded IMU accelerometer (ACCD) or gyroscope (GYRD) data. Each message holds up to 33 consecutive samples: a full precision keyframe followed by fixed point differences between successive samples. Sample times are evenly spaced between SampleUS and SampleUS+SpanUS
+// @Field: TimeUS: Time since system startup
+// @Field: I: sensor instance number
+// @Field: SampleUS: time since system startup the keyframe sample was taken
+// @Field: SpanUS: time between the keyframe sample and the last sample in this message
+// @Field: N: number of samples in this message, including the keyframe
+// @Field: X: keyframe sample X axis
+// @Field: Y: keyframe sample Y axis
+// @Field: Z: keyframe sample Z axis
+// @Field: DX: X axis differences between successive samples
+// @Field: DY: Y axis differences between successive samples
+// @Field: DZ: Z axis differences between successive samples
+struct PACKED log_IMUDelta {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t instance;
+    uint64_t sample_us;
+    uint32_t span_us;
+    uint8_t count;
+    float x, y, z;
+    int16_t dx[LOG_IMU_DELTA_COUNT];
+    int16_t dy[LOG_IMU_DELTA_COUNT];
+    int16_t dz[LOG_IMU_DELTA_COUNT];
+};
+static_assert(sizeof(log_IMUDelta) < 256, "log_IMUDelta is over-size");
+
 // @LoggerMessage: IMU
 // @Description: Inertial Measurement Unit data
 // @Field: TimeUS: Time since system startup
@@ -123,4 +161,8 @@ struct PACKED log_Vibe {
     { LOG_ISBH_MSG, sizeof(log_ISBH), \
       "ISBH", "QHBBHHQf", "TimeUS,N,type,instance,mul,smp_cnt,SampleUS,smp_rate", "s-----sz", "F-----F-" },  \
     { LOG_ISBD_MSG, sizeof(log_ISBD), \
-      "ISBD", "QHHaaa", "TimeUS,N,seqno,x,y,z", "s--ooo", "F--???" },
+      "ISBD", "QHHaaa", "TimeUS,N,seqno,x,y,z", "s--ooo", "F--???" }, \
+    { LOG_ACCD_MSG, sizeof(log_IMUDelta), \
+      "ACCD", "QBQIBfffaaa", "TimeUS,I,SampleUS,SpanUS,N,X,Y,Z,DX,DY,DZ", "s#ss-oooooo", "F-FF-000CCC" }, \
+    { LOG_GYRD_MSG, sizeof(log_IMUDelta), \
+      "GYRD", "QBQIBfffaaa", "TimeUS,I,SampleUS,SpanUS,N,X,Y,Z,DX,DY,DZ", "s#ss-EEEEEE", "F-FF-000DDD" },
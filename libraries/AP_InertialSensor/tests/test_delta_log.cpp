@@ -0,0 +1,89 @@
+#include <AP_gtest.h>
+#include <AP_HAL/AP_HAL.h>
+
+#include <AP_InertialSensor/AP_InertialSensor_DeltaLog.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+
+static const uint8_t MAX_SAMPLES = AP_InertialSensor_DeltaLog::MAX_SAMPLES;
+
+// decode the pending message and check it against the samples given
+static void check_decode(AP_InertialSensor_DeltaLog &encoder, const uint64_t *sample_us, const Vector3f *samples, uint8_t count)
+{
+    uint64_t decoded_us[MAX_SAMPLES];
+    Vector3f decoded[MAX_SAMPLES];
+    ASSERT_EQ(count, AP_InertialSensor_DeltaLog::decode(encoder.packet(), LOG_GYRD_RESOLUTION, decoded_us, decoded));
+    for (uint8_t i=0; i<count; i++) {
+        EXPECT_EQ(sample_us[i], decoded_us[i]);
+        for (uint8_t axis=0; axis<3; axis++) {
+            // the error is bounded by half a count plus float rounding
+            EXPECT_NEAR(samples[i][axis], decoded[i][axis], 0.5f*LOG_GYRD_RESOLUTION + 1.0e-6f);
+        }
+    }
+}
+
+TEST(DeltaLog, RoundTrip)
+{
+    AP_InertialSensor_DeltaLog encoder(LOG_GYRD_MSG, 0, LOG_GYRD_RESOLUTION);
+    uint64_t sample_us[MAX_SAMPLES];
+    Vector3f samples[MAX_SAMPLES];
+    for (uint8_t i=0; i<MAX_SAMPLES; i++) {
+        sample_us[i] = 1000000 + i * 125;
+        const float t = i * 0.000125f;
+        samples[i] = Vector3f(sinf(t*200), 0.3f*cosf(t*300), -1.2f + 0.01f*i);
+        EXPECT_TRUE(encoder.append(sample_us[i], samples[i]));
+    }
+    check_decode(encoder, sample_us, samples, MAX_SAMPLES);
+
+    // the message is full
+    EXPECT_FALSE(encoder.append(sample_us[MAX_SAMPLES-1] + 125, samples[0]));
+}
+
+TEST(DeltaLog, Partial)
+{
+    AP_InertialSensor_DeltaLog encoder(LOG_GYRD_MSG, 0, LOG_GYRD_RESOLUTION);
+    const uint64_t sample_us[2] { 5000, 5250 };
+    const Vector3f samples[2] { {0.1f, 0.2f, 0.3f}, {0.1f, 0.2f, 0.35f} };
+    EXPECT_TRUE(encoder.append(sample_us[0], samples[0]));
+    check_decode(encoder, sample_us, samples, 1);
+    EXPECT_TRUE(encoder.append(sample_us[1], samples[1]));
+    check_decode(encoder, sample_us, samples, 2);
+
+    // unused differences are cleared
+    EXPECT_EQ(0, encoder.packet().dz[1]);
+}
+
+TEST(DeltaLog, Overflow)
+{
+    AP_InertialSensor_DeltaLog encoder(LOG_GYRD_MSG, 0, LOG_GYRD_RESOLUTION);
+    EXPECT_TRUE(encoder.append(1000, Vector3f(0, 0, 0)));
+    // a step larger than 32767 counts needs a new keyframe
+    EXPECT_FALSE(encoder.append(1125, Vector3f(0, 32768 * LOG_GYRD_RESOLUTION, 0)));
+    EXPECT_FALSE(encoder.append(1125, Vector3f(NAN, 0, 0)));
+    EXPECT_TRUE(encoder.append(1125, Vector3f(0, 3.0f, 0)));
+    EXPECT_EQ(2, encoder.packet().count);
+}
+
+TEST(DeltaLog, Timing)
+{
+    AP_InertialSensor_DeltaLog encoder(LOG_GYRD_MSG, 0, LOG_GYRD_RESOLUTION);
+    const Vector3f v;
+    EXPECT_TRUE(encoder.append(1000, v));
+    // the first interval can't be too long or go backwards
+    EXPECT_FALSE(encoder.append(500, v));
+    EXPECT_FALSE(encoder.append(1000 + 200000, v));
+    EXPECT_TRUE(encoder.append(1100, v));
+    // small jitter is accepted, a change of rate is not
+    EXPECT_TRUE(encoder.append(1210, v));
+    EXPECT_FALSE(encoder.append(1410, v));
+    EXPECT_FALSE(encoder.append(1220, v));
+    EXPECT_TRUE(encoder.append(1300, v));
+    EXPECT_EQ(4, encoder.packet().count);
+    EXPECT_EQ(300U, encoder.packet().span_us);
+}
+
+#endif // AP_INERTIALSENSOR_DELTA_LOG_ENABLED
+
+AP_GTEST_MAIN()
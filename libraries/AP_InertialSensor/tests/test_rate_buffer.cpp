@@ -0,0 +1,78 @@
+#include <AP_gtest.h>
+#include <AP_HAL/AP_HAL.h>
+
+#include <AP_InertialSensor/AP_InertialSensor_RateBuffer.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+
+static AP_InertialSensor::GyroSampleTime sample_time(uint32_t us)
+{
+    AP_InertialSensor::GyroSampleTime time;
+    time.sample_us = us;
+    time.filtered_us = us + 10;
+    return time;
+}
+
+// only samples from the selected gyro are passed on
+TEST(RateBuffer, Instance)
+{
+    AP_InertialSensor_RateBuffer buffer;
+    AP_InertialSensor_RateBuffer::Sample sample;
+
+    buffer.set_instance(1);
+    buffer.push(0, Vector3f(1, 0, 0), sample_time(1000));
+    buffer.push(1, Vector3f(2, 0, 0), sample_time(1125));
+    ASSERT_TRUE(buffer.wait_sample(sample, 0));
+    EXPECT_FLOAT_EQ(2, sample.gyro.x);
+    EXPECT_EQ(1125U, sample.sample_us);
+    EXPECT_EQ(1135U, sample.filtered_us);
+
+    // after a switch the old gyro is ignored
+    buffer.set_instance(0);
+    buffer.push(1, Vector3f(3, 0, 0), sample_time(1250));
+    buffer.push(0, Vector3f(4, 0, 0), sample_time(1250));
+    ASSERT_TRUE(buffer.wait_sample(sample, 0));
+    EXPECT_FLOAT_EQ(4, sample.gyro.x);
+
+    // ignored samples are not counted as dropped
+    EXPECT_EQ(0U, buffer.get_and_clear_dropped());
+}
+
+// one in every decimation samples is passed on, counted from the
+// first sample of a newly selected gyro
+TEST(RateBuffer, Decimation)
+{
+    AP_InertialSensor_RateBuffer buffer;
+    AP_InertialSensor_RateBuffer::Sample sample;
+    buffer.set_decimation(2);
+
+    buffer.push(0, Vector3f(1, 0, 0), sample_time(1000));
+    buffer.set_instance(1);
+    buffer.push(1, Vector3f(2, 0, 0), sample_time(1000));
+    buffer.push(1, Vector3f(3, 0, 0), sample_time(1125));
+    buffer.push(1, Vector3f(4, 0, 0), sample_time(1250));
+    ASSERT_TRUE(buffer.wait_sample(sample, 0));
+    EXPECT_FLOAT_EQ(3, sample.gyro.x);
+    EXPECT_EQ(0U, buffer.get_and_clear_dropped());
+}
+
+// a reader that falls behind gets the newest sample
+TEST(RateBuffer, Skip)
+{
+    AP_InertialSensor_RateBuffer buffer;
+    AP_InertialSensor_RateBuffer::Sample sample;
+
+    for (uint8_t i=0; i<3; i++) {
+        buffer.push(0, Vector3f(i, 0, 0), sample_time(1000 + i*125));
+    }
+    ASSERT_TRUE(buffer.wait_sample(sample, 0));
+    EXPECT_FLOAT_EQ(2, sample.gyro.x);
+    EXPECT_EQ(2U, buffer.get_and_clear_dropped());
+    EXPECT_EQ(0U, buffer.get_and_clear_dropped());
+}
+
+#endif // AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+
+AP_GTEST_MAIN()
@@ -188,6 +188,15 @@ const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @RebootRequired: True
     AP_GROUPINFO("_MAX_FILES", 12, AP_Logger, _params.max_log_files, MAX_LOG_FILES),
 
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+    // @Param: _FILE_COMPRESS
+    // @DisplayName: Compress log files
+    // @Description: When enabled, log files are written as a series of LZ4 compressed chunks of up to 64k each, which reduces the amount of data written to the card. Compressed logs need a log reader which supports them. Takes effect when the next log file is opened.
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_COMPRESS", 13, AP_Logger, _params.file_compress, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -681,6 +690,10 @@ void AP_Logger::set_vehicle_armed(const bool armed_state)
         // no change in status
         return;
     }
+    if (!armed_state && _pending_writes_flusher) {
+        // write out held back messages while still logging as armed
+        _pending_writes_flusher();
+    }
     _armed = armed_state;
 
     if (_armed) {
@@ -790,6 +803,9 @@ bool AP_Logger::CardInserted(void) {
 
 void AP_Logger::StopLogging()
 {
+    if (_pending_writes_flusher) {
+        _pending_writes_flusher();
+    }
     FOR_EACH_BACKEND(stop_logging());
 }
 
@@ -193,6 +193,7 @@ class AP_Logger
 
 public:
     FUNCTOR_TYPEDEF(vehicle_startup_message_Writer, void);
+    FUNCTOR_TYPEDEF(pending_writes_flusher, void);
 
     AP_Logger();
 
@@ -239,6 +240,10 @@ public:
 
     void setVehicle_Startup_Writer(vehicle_startup_message_Writer writer);
 
+    // set a callback which writes out messages a library is holding
+    // back, called before logging stops or the log is closed on disarm
+    void set_pending_writes_flusher(pending_writes_flusher flusher) { _pending_writes_flusher = flusher; }
+
     void PrepForArming();
 
     void EnableWrites(bool enable) { _writes_enabled = enable; }
@@ -327,6 +332,7 @@ public:
     uint8_t log_replay(void) const { return _params.log_replay; }
 
     vehicle_startup_message_Writer _vehicle_messages;
+    pending_writes_flusher _pending_writes_flusher;
 
     enum class LogDisarmed : uint8_t {
         NONE = 0,
@@ -351,6 +357,9 @@ public:
         AP_Float blk_ratemax;
         AP_Float disarm_ratemax;
         AP_Int16 max_log_files;
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+        AP_Int8 file_compress;
+#endif
     } _params;
 
     const struct LogStructure *structure(uint16_t num) const;
@@ -0,0 +1,182 @@
+#include "AP_Logger_Compress.h"
+
+#include <string.h>
+#include <AP_Math/AP_Math.h>
+
+/*
+  LZ4 block format: each sequence is a token byte holding the literal
+  count in the top nibble and the match length minus 4 in the bottom
+  nibble, followed by extra literal count bytes, the literals, a 16
+  bit little-endian match offset and extra match length bytes. A
+  nibble of 15 means extra length bytes follow, each adding up to 255.
+  The last sequence is literals only, and the format requires the
+  last 5 bytes to be literals and the last match to start at least
+  12 bytes before the end
+ */
+#define LZ_MIN_MATCH    4
+#define LZ_LAST_LITERALS 5
+#define LZ_MF_LIMIT     12
+#define LZ_MAX_OFFSET   65535
+#define LZ_HASH_BITS    12
+
+static_assert((1U << LZ_HASH_BITS) == AP_Logger_Compress::HASH_TABLE_SIZE, "hash table size");
+
+static inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash32(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+// write an extended length, returning the new output position
+static inline uint8_t *write_length(uint8_t *op, uint32_t len)
+{
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = len;
+    return op;
+}
+
+// write a sequence of literals and, if match_len is non-zero, a match
+static uint8_t *write_sequence(uint8_t *op, const uint8_t *oend,
+                               const uint8_t *literals, uint32_t lit_len,
+                               uint16_t offset, uint32_t match_len)
+{
+    // worst case size of this sequence
+    const uint32_t needed = 1 + lit_len / 255 + 1 + lit_len + 2 + match_len / 255 + 1;
+    if (needed > uint32_t(oend - op)) {
+        return nullptr;
+    }
+    uint8_t *token = op++;
+    *token = MIN(lit_len, 15U) << 4;
+    if (lit_len >= 15) {
+        op = write_length(op, lit_len - 15);
+    }
+    memcpy(op, literals, lit_len);
+    op += lit_len;
+    if (match_len == 0) {
+        return op;
+    }
+    *op++ = offset & 0xFF;
+    *op++ = offset >> 8;
+    const uint32_t ml = match_len - LZ_MIN_MATCH;
+    *token |= MIN(ml, 15U);
+    if (ml >= 15) {
+        op = write_length(op, ml - 15);
+    }
+    return op;
+}
+
+uint32_t AP_Logger_Compress::compress(const uint8_t *src, uint32_t len, uint8_t *dest, uint32_t dest_len, uint16_t *hash_table)
+{
+    if (len > MAX_CHUNK_SIZE) {
+        return 0;
+    }
+    uint8_t *op = dest;
+    const uint8_t *oend = dest + dest_len;
+    uint32_t anchor = 0;
+
+    if (len > LZ_MF_LIMIT) {
+        memset(hash_table, 0, HASH_TABLE_SIZE * sizeof(hash_table[0]));
+        const uint32_t match_limit = len - LZ_MF_LIMIT;
+        uint32_t ip = 0;
+        while (ip < match_limit) {
+            const uint32_t seq = read32(&src[ip]);
+            const uint32_t h = hash32(seq);
+            const uint32_t ref = hash_table[h];
+            hash_table[h] = ip;
+            if (ref >= ip || ip - ref > LZ_MAX_OFFSET || read32(&src[ref]) != seq) {
+                ip++;
+                continue;
+            }
+            uint32_t match_len = LZ_MIN_MATCH;
+            const uint32_t max_len = len - LZ_LAST_LITERALS - ip;
+            while (match_len < max_len && src[ref + match_len] == src[ip + match_len]) {
+                match_len++;
+            }
+            op = write_sequence(op, oend, &src[anchor], ip - anchor, ip - ref, match_len);
+            if (op == nullptr) {
+                return 0;
+            }
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+
+    // the remainder is literals
+    op = write_sequence(op, oend, &src[anchor], len - anchor, 0, 0);
+    if (op == nullptr) {
+        return 0;
+    }
+    return op - dest;
+}
+
+int32_t AP_Logger_Compress::decompress(const uint8_t *src, uint32_t len, uint8_t *dest, uint32_t dest_len)
+{
+    uint32_t ip = 0;
+    uint32_t op = 0;
+
+    while (ip < len) {
+        const uint8_t token = src[ip++];
+
+        uint32_t lit_len = token >> 4;
+        if (lit_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= len) {
+                    return -1;
+                }
+                b = src[ip++];
+                lit_len += b;
+            } while (b == 255);
+        }
+        if (lit_len > len - ip || lit_len > dest_len - op) {
+            return -1;
+        }
+        memcpy(&dest[op], &src[ip], lit_len);
+        ip += lit_len;
+        op += lit_len;
+        if (ip == len) {
+            // last sequence has no match
+            break;
+        }
+
+        if (len - ip < 2) {
+            return -1;
+        }
+        const uint32_t offset = src[ip] | (src[ip+1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return -1;
+        }
+        uint32_t match_len = token & 0x0F;
+        if (match_len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= len) {
+                    return -1;
+                }
+                b = src[ip++];
+                match_len += b;
+            } while (b == 255);
+        }
+        match_len += LZ_MIN_MATCH;
+        if (match_len > dest_len - op) {
+            return -1;
+        }
+        // matches may overlap their own output, so copy bytewise
+        const uint8_t *ref = &dest[op - offset];
+        for (uint32_t i=0; i<match_len; i++) {
+            dest[op + i] = ref[i];
+        }
+        op += match_len;
+    }
+    return op;
+}
@@ -0,0 +1,95 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  block compression for log files written by AP_Logger_File
+
+  A compressed log starts with a file header, followed by chunks of
+  compressed log data, each with its own header so that a reader can
+  step from chunk to chunk without decompressing. When the log is
+  closed cleanly a chunk index and footer are appended, allowing a
+  reader to seek straight to the chunk holding a given raw offset.
+
+  Chunk data uses the LZ4 block format, so tools can decompress with
+  any LZ4 implementation given the raw length from the chunk header.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <AP_Common/AP_Common.h>
+
+class AP_Logger_Compress {
+public:
+    static const uint32_t FILE_MAGIC = 0x5a4c5041;   // "APLZ"
+    static const uint32_t CHUNK_MAGIC = 0x4b434c5a;  // "ZLCK"
+    static const uint32_t INDEX_MAGIC = 0x58444e49;  // "INDX"
+    static const uint8_t VERSION = 1;
+
+    // chunks are limited to 64k so that match positions fit in 16 bits
+    static const uint32_t MAX_CHUNK_SIZE = 65536;
+
+    // number of entries in the hash table passed to compress()
+    static const uint16_t HASH_TABLE_SIZE = 4096;
+
+    struct PACKED FileHeader {
+        uint32_t magic;
+        uint8_t version;
+        uint8_t reserved[3];
+        uint32_t chunk_size;
+    };
+
+    /*
+      a chunk with compressed_len == raw_len holds raw data, used
+      when the data did not compress
+     */
+    struct PACKED ChunkHeader {
+        uint32_t magic;
+        uint32_t raw_len;
+        uint32_t compressed_len;
+        uint32_t crc;           // crc32 of the chunk data as stored
+        uint64_t raw_offset;    // offset of the chunk in the uncompressed log
+    };
+
+    struct PACKED IndexEntry {
+        uint64_t file_offset;   // offset of the ChunkHeader in the file
+        uint64_t raw_offset;
+    };
+
+    // last bytes of a cleanly closed file, after the IndexEntry array
+    struct PACKED IndexFooter {
+        uint32_t magic;
+        uint32_t num_entries;
+        uint64_t index_offset;  // file offset of the first IndexEntry
+    };
+
+    // worst case compressed size for len bytes of input
+    static uint32_t compress_bound(uint32_t len) {
+        return len + len / 255 + 16;
+    }
+
+    /*
+      compress len bytes from src into dest, using hash_table of
+      HASH_TABLE_SIZE entries as scratch space. Returns the compressed
+      length, or zero if it does not fit in dest_len or len is larger
+      than MAX_CHUNK_SIZE
+     */
+    static uint32_t compress(const uint8_t *src, uint32_t len, uint8_t *dest, uint32_t dest_len, uint16_t *hash_table);
+
+    /*
+      decompress len bytes from src into dest. Returns the
+      decompressed length, or -1 if the data is corrupt or does not
+      fit in dest_len
+     */
+    static int32_t decompress(const uint8_t *src, uint32_t len, uint8_t *dest, uint32_t dest_len);
+};
@@ -157,6 +157,12 @@ void AP_Logger_File::periodic_1Hz()
         start_new_log_pending = true;
     }
 
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+    if (_compress.active) {
+        Write_Compress_Stats();
+    }
+#endif
+
     if (!io_thread_alive()) {
         if (io_thread_warning_decimation_counter == 0 && _initialised) {
             // we don't print this error unless we did initialise. When _initialised is set to true
@@ -713,6 +719,12 @@ void AP_Logger_File::stop_logging(void)
     if (_write_fd != -1) {
         int fd = _write_fd;
         _write_fd = -1;
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+        if (have_sem) {
+            compress_finish(fd);
+        }
+        _compress.active = false;
+#endif
         AP::FS().close(fd);
     }
     if (have_sem) {
@@ -843,6 +855,11 @@ void AP_Logger_File::start_new_log(void)
     _open_error_ms = 0;
     _write_offset = 0;
     _writebuf.clear();
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+    if (_front._params.file_compress && !compress_start()) {
+        DEV_PRINTF("Log compression unavailable\n");
+    }
+#endif
     write_fd_semaphore.give();
 
     // now update lastlog.txt with the new log number
@@ -880,7 +897,12 @@ void AP_Logger_File::flush(void)
 #if APM_BUILD_TYPE(APM_BUILD_Replay) || APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
 {
     uint32_t tnow = AP_HAL::millis();
-    while (_write_fd != -1 && _initialised && !recent_open_error() && _writebuf.available()) {
+    while (_write_fd != -1 && _initialised && !recent_open_error() &&
+           (_writebuf.available()
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+            || (_compress.active && _compress.out_written < _compress.out_len)
+#endif
+            )) {
         // convince the IO timer that it really is OK to write out
         // less than _writebuf_chunk bytes:
         if (tnow > 2001) { // avoid resetting _last_write_time to 0
@@ -931,6 +953,13 @@ void AP_Logger_File::io_timer(void)
         write_lastlog_file(log_num);
     }
 
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+    if (_compress.active) {
+        io_timer_compressed(tnow);
+        return;
+    }
+#endif
+
     uint32_t nbytes = _writebuf.available();
     if (nbytes == 0) {
         return;
@@ -941,17 +970,8 @@ void AP_Logger_File::io_timer(void)
         // least once per 2 seconds if data is available
         return;
     }
-    if (tnow - _free_space_last_check_time > _free_space_check_interval) {
-        _free_space_last_check_time = tnow;
-        last_io_operation = "disk_space_avail";
-        if (disk_space_avail() < _free_space_min_avail && disk_space() > 0) {
-            DEV_PRINTF("Out of space for logging\n");
-            stop_logging();
-            _open_error_ms = AP_HAL::millis(); // prevent logging starting again for 5s
-            last_io_operation = "";
-            return;
-        }
-        last_io_operation = "";
+    if (!check_free_space(tnow)) {
+        return;
     }
 
     _last_write_time = tnow;
@@ -972,15 +992,47 @@ void AP_Logger_File::io_timer(void)
         }
     }
 
+    const ssize_t nwritten = write_to_file(head, nbytes, tnow);
+    if (nwritten > 0) {
+        _writebuf.advance(nwritten);
+    }
+}
+
+/*
+  check there is space left for the log, stopping logging if not
+ */
+bool AP_Logger_File::check_free_space(uint32_t tnow)
+{
+    if (tnow - _free_space_last_check_time > _free_space_check_interval) {
+        _free_space_last_check_time = tnow;
+        last_io_operation = "disk_space_avail";
+        if (disk_space_avail() < _free_space_min_avail && disk_space() > 0) {
+            DEV_PRINTF("Out of space for logging\n");
+            stop_logging();
+            _open_error_ms = AP_HAL::millis(); // prevent logging starting again for 5s
+            last_io_operation = "";
+            return false;
+        }
+        last_io_operation = "";
+    }
+    return true;
+}
+
+/*
+  write to the log file from the IO thread, returning the number of
+  bytes written
+ */
+ssize_t AP_Logger_File::write_to_file(const uint8_t *data, uint32_t len, uint32_t tnow)
+{
     last_io_operation = "write";
     if (!write_fd_semaphore.take(1)) {
-        return;
+        return -1;
     }
     if (_write_fd == -1) {
         write_fd_semaphore.give();
-        return;
+        return -1;
     }
-    ssize_t nwritten = AP::FS().write(_write_fd, head, nbytes);
+    ssize_t nwritten = AP::FS().write(_write_fd, data, len);
     last_io_operation = "";
     if (nwritten <= 0) {
         if ((tnow - _last_write_ms)/1000U > unsigned(_front._params.file_timeout)) {
@@ -991,6 +1043,9 @@ void AP_Logger_File::io_timer(void)
             AP::FS().close(_write_fd);
             last_io_operation = "";
             _write_fd = -1;
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+            _compress.active = false;
+#endif
             printf("Failed to write to File: %s\n", strerror(errno));
         }
         _last_write_failed = true;
@@ -998,7 +1053,6 @@ void AP_Logger_File::io_timer(void)
         _last_write_failed = false;
         _last_write_ms = tnow;
         _write_offset += nwritten;
-        _writebuf.advance(nwritten);
         /*
           the best strategy for minimizing corruption on microSD cards
           seems to be to write in 4k chunks and fsync the file on each
@@ -1025,7 +1079,228 @@ void AP_Logger_File::io_timer(void)
     }
 
     write_fd_semaphore.give();
+    return nwritten;
+}
+
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+/*
+  setup compression for a newly opened log file and write the file
+  header. Called with write_fd_semaphore held
+ */
+bool AP_Logger_File::compress_start()
+{
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
+    // replay writes directly to the file, bypassing io_timer
+    return false;
+#endif
+    if (_compress.raw == nullptr) {
+        _compress.chunk_size = MIN(uint32_t(AP_Logger_Compress::MAX_CHUNK_SIZE), _writebuf.get_size() / 2);
+        _compress.raw = NEW_NOTHROW uint8_t[_compress.chunk_size];
+        _compress.out = NEW_NOTHROW uint8_t[sizeof(AP_Logger_Compress::ChunkHeader) + AP_Logger_Compress::compress_bound(_compress.chunk_size)];
+        _compress.hash_table = NEW_NOTHROW uint16_t[AP_Logger_Compress::HASH_TABLE_SIZE];
+        if (_compress.raw == nullptr || _compress.out == nullptr || _compress.hash_table == nullptr) {
+            delete[] _compress.raw;
+            _compress.raw = nullptr;
+            delete[] _compress.out;
+            _compress.out = nullptr;
+            delete[] _compress.hash_table;
+            _compress.hash_table = nullptr;
+            return false;
+        }
+    }
+
+    const AP_Logger_Compress::FileHeader hdr {
+        magic : AP_Logger_Compress::FILE_MAGIC,
+        version : AP_Logger_Compress::VERSION,
+        reserved : {},
+        chunk_size : _compress.chunk_size,
+    };
+    if (AP::FS().write(_write_fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+        return false;
+    }
+    _write_offset = sizeof(hdr);
+    _compress.file_offset = sizeof(hdr);
+    _compress.raw_offset = 0;
+    _compress.out_len = 0;
+    _compress.out_written = 0;
+    _compress.index_len = 0;
+    _compress.active = true;
+    return true;
+}
+
+/*
+  compress nbytes from the write buffer into the next chunk. Called
+  with write_fd_semaphore held
+ */
+void AP_Logger_File::compress_chunk(uint32_t nbytes)
+{
+    const uint32_t start_us = AP_HAL::micros();
+    last_io_operation = "compress";
+
+    _writebuf.peekbytes(_compress.raw, nbytes);
+    _writebuf.advance(nbytes);
+
+    AP_Logger_Compress::ChunkHeader hdr {};
+    uint8_t *data = &_compress.out[sizeof(hdr)];
+    uint32_t len = AP_Logger_Compress::compress(_compress.raw, nbytes, data,
+                                                AP_Logger_Compress::compress_bound(_compress.chunk_size),
+                                                _compress.hash_table);
+    if (len == 0 || len >= nbytes) {
+        // store incompressible data as is
+        memcpy(data, _compress.raw, nbytes);
+        len = nbytes;
+    }
+    hdr.magic = AP_Logger_Compress::CHUNK_MAGIC;
+    hdr.raw_len = nbytes;
+    hdr.compressed_len = len;
+    hdr.crc = crc_crc32(0, data, len);
+    hdr.raw_offset = _compress.raw_offset;
+    memcpy(_compress.out, &hdr, sizeof(hdr));
+
+    // record the chunk in the index, growing it as needed
+    if (_compress.index_len == _compress.index_size) {
+        const uint32_t new_size = MAX(_compress.index_size * 2, 256U);
+        auto *new_index = NEW_NOTHROW AP_Logger_Compress::IndexEntry[new_size];
+        if (new_index != nullptr) {
+            if (_compress.index != nullptr) {
+                memcpy(new_index, _compress.index, _compress.index_len * sizeof(new_index[0]));
+                delete[] _compress.index;
+            }
+            _compress.index = new_index;
+            _compress.index_size = new_size;
+        }
+    }
+    if (_compress.index_len < _compress.index_size) {
+        _compress.index[_compress.index_len++] = { _compress.file_offset, _compress.raw_offset };
+    }
+
+    _compress.raw_offset += nbytes;
+    _compress.file_offset += sizeof(hdr) + len;
+    _compress.out_len = sizeof(hdr) + len;
+    _compress.out_written = 0;
+
+    _compress.raw_bytes += nbytes;
+    _compress.chunks++;
+    _compress.compress_us += AP_HAL::micros() - start_us;
+    last_io_operation = "";
+}
+
+/*
+  write compressed data once a full chunk is available, or at least
+  every 2 seconds. The compression state is shared with
+  stop_logging(), so it is only touched with write_fd_semaphore held
+ */
+void AP_Logger_File::io_timer_compressed(uint32_t tnow)
+{
+    if (_compress.out_written == _compress.out_len) {
+        const uint32_t nbytes = MIN(_writebuf.available(), _compress.chunk_size);
+        if (nbytes == 0) {
+            return;
+        }
+        if (nbytes < _compress.chunk_size &&
+            tnow - _last_write_time < 2000UL) {
+            return;
+        }
+        if (!check_free_space(tnow)) {
+            return;
+        }
+        _last_write_time = tnow;
+    }
+
+    if (!write_fd_semaphore.take(1)) {
+        return;
+    }
+    // the log may have been closed since io_timer() checked
+    if (_compress.active && _write_fd != -1) {
+        const uint32_t nbytes = MIN(_writebuf.available(), _compress.chunk_size);
+        if (_compress.out_written == _compress.out_len && nbytes > 0) {
+            compress_chunk(nbytes);
+        }
+    }
+    if (_compress.active && _write_fd != -1 && _compress.out_written < _compress.out_len) {
+        const ssize_t nwritten = write_to_file(&_compress.out[_compress.out_written],
+                                               _compress.out_len - _compress.out_written, tnow);
+        if (nwritten > 0) {
+            _compress.out_written += nwritten;
+            _compress.file_bytes += nwritten;
+        }
+    }
+    write_fd_semaphore.give();
+}
+
+/*
+  complete the current chunk and append the chunk index to a
+  compressed log being closed. Called with write_fd_semaphore held
+ */
+void AP_Logger_File::compress_finish(int fd)
+{
+    if (!_compress.active) {
+        return;
+    }
+    _compress.active = false;
+
+    const uint32_t remaining = _compress.out_len - _compress.out_written;
+    if (remaining > 0 &&
+        AP::FS().write(fd, &_compress.out[_compress.out_written], remaining) != ssize_t(remaining)) {
+        return;
+    }
+    _compress.out_written = _compress.out_len;
+
+    const uint32_t index_bytes = _compress.index_len * sizeof(AP_Logger_Compress::IndexEntry);
+    if (index_bytes > 0 &&
+        AP::FS().write(fd, _compress.index, index_bytes) != ssize_t(index_bytes)) {
+        return;
+    }
+    const AP_Logger_Compress::IndexFooter footer {
+        magic : AP_Logger_Compress::INDEX_MAGIC,
+        num_entries : _compress.index_len,
+        index_offset : _compress.file_offset,
+    };
+    AP::FS().write(fd, &footer, sizeof(footer));
+}
+
+/*
+  write compression statistics for the last second
+ */
+void AP_Logger_File::Write_Compress_Stats()
+{
+    // the IO thread updates the statistics with write_fd_semaphore
+    // held, try again next second if it is busy
+    if (!write_fd_semaphore.take_nonblocking()) {
+        return;
+    }
+    const uint32_t raw_bytes = _compress.raw_bytes;
+    const uint32_t file_bytes = _compress.file_bytes;
+    const float ratio = _compress.file_offset > 0 ? float(_compress.raw_offset) / _compress.file_offset : 0.0f;
+    const uint32_t compress_us = _compress.compress_us;
+    const uint16_t chunks = _compress.chunks;
+    _compress.raw_bytes = 0;
+    _compress.file_bytes = 0;
+    _compress.compress_us = 0;
+    _compress.chunks = 0;
+    write_fd_semaphore.give();
+
+    // @LoggerMessage: DSFC
+    // @Description: Onboard log compression statistics
+    // @Field: TimeUS: Time since system startup
+    // @Field: Raw: Log data compressed in the last second
+    // @Field: File: Bytes written to the log file in the last second
+    // @Field: Ratio: Compression ratio over the log so far
+    // @Field: CPU: Time spent compressing in the last second
+    // @Field: Chk: Chunks compressed in the last second
+    AP::logger().WriteStreaming("DSFC",
+                                "TimeUS,Raw,File,Ratio,CPU,Chk",
+                                "sbb-s-",
+                                "F00-F-",
+                                "QIIfIH",
+                                AP_HAL::micros64(),
+                                raw_bytes,
+                                file_bytes,
+                                ratio,
+                                compress_us,
+                                chunks);
 }
+#endif // HAL_LOGGING_FILE_COMPRESSION_ENABLED
 
 bool AP_Logger_File::io_thread_alive() const
 {
@@ -10,6 +10,7 @@
 
 #include <AP_HAL/utility/RingBuffer.h>
 #include "AP_Logger_Backend.h"
+#include "AP_Logger_Compress.h"
 
 #if HAL_LOGGING_FILESYSTEM_ENABLED
 
@@ -144,6 +145,42 @@ private:
     const char *last_io_operation = "";
 
     bool start_new_log_pending;
+
+    // returns false if the disk is nearly full, stopping logging
+    bool check_free_space(uint32_t tnow);
+    // write to the current log file, handling write errors
+    ssize_t write_to_file(const uint8_t *data, uint32_t len, uint32_t tnow);
+
+#if HAL_LOGGING_FILE_COMPRESSION_ENABLED
+    // block compression of the current log file, see AP_Logger_Compress.h
+    struct {
+        bool active;
+        uint32_t chunk_size;
+        uint8_t *raw;
+        uint8_t *out;
+        uint16_t *hash_table;
+        // the chunk in out and how much of it has been written
+        uint32_t out_len;
+        uint32_t out_written;
+        uint64_t raw_offset;
+        uint64_t file_offset;
+        // index of chunks in the file, written when the log is closed
+        AP_Logger_Compress::IndexEntry *index;
+        uint32_t index_len;
+        uint32_t index_size;
+        // statistics for the DSFC message
+        uint32_t raw_bytes;
+        uint32_t file_bytes;
+        uint32_t compress_us;
+        uint16_t chunks;
+    } _compress;
+
+    bool compress_start();
+    void compress_chunk(uint32_t nbytes);
+    void compress_finish(int fd);
+    void io_timer_compressed(uint32_t tnow);
+    void Write_Compress_Stats();
+#endif
 };
 
 #endif // HAL_LOGGING_FILESYSTEM_ENABLED
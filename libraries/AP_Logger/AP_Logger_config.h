@@ -47,6 +47,10 @@
 
 #endif
 
+#ifndef HAL_LOGGING_FILE_COMPRESSION_ENABLED
+#define HAL_LOGGING_FILE_COMPRESSION_ENABLED (HAL_LOGGING_FILESYSTEM_ENABLED && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX))
+#endif
+
 #ifndef HAL_LOGGER_FILE_CONTENTS_ENABLED
 #define HAL_LOGGER_FILE_CONTENTS_ENABLED HAL_LOGGING_FILESYSTEM_ENABLED
 #endif
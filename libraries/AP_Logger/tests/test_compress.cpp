@@ -0,0 +1,112 @@
+#include <AP_gtest.h>
+#include <AP_HAL/AP_HAL.h>
+
+#include <AP_Logger/AP_Logger_Compress.h>
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static uint16_t hash_table[AP_Logger_Compress::HASH_TABLE_SIZE];
+static uint8_t compressed[AP_Logger_Compress::MAX_CHUNK_SIZE + AP_Logger_Compress::MAX_CHUNK_SIZE/255 + 16];
+static uint8_t output[AP_Logger_Compress::MAX_CHUNK_SIZE];
+
+// compress and decompress len bytes, returning the compressed length
+static uint32_t round_trip(const uint8_t *data, uint32_t len)
+{
+    const uint32_t clen = AP_Logger_Compress::compress(data, len, compressed, AP_Logger_Compress::compress_bound(len), hash_table);
+    EXPECT_GT(clen, 0U);
+    EXPECT_LE(clen, AP_Logger_Compress::compress_bound(len));
+    EXPECT_EQ(int32_t(len), AP_Logger_Compress::decompress(compressed, clen, output, sizeof(output)));
+    EXPECT_EQ(0, memcmp(data, output, len));
+    return clen;
+}
+
+TEST(LoggerCompress, Empty)
+{
+    round_trip(nullptr, 0);
+}
+
+TEST(LoggerCompress, Short)
+{
+    const uint8_t data[] = "abcabcabcabcabcabcabcabc";
+    for (uint32_t len = 1; len < sizeof(data); len++) {
+        round_trip(data, len);
+    }
+}
+
+TEST(LoggerCompress, Repetitive)
+{
+    static uint8_t data[AP_Logger_Compress::MAX_CHUNK_SIZE];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = i % 40;
+    }
+    EXPECT_LT(round_trip(data, sizeof(data)), sizeof(data) / 50);
+}
+
+TEST(LoggerCompress, Random)
+{
+    static uint8_t data[AP_Logger_Compress::MAX_CHUNK_SIZE];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = get_random16();
+    }
+    round_trip(data, sizeof(data));
+}
+
+TEST(LoggerCompress, LogLike)
+{
+    // a header, a time stamp, a few slowly changing values and
+    // some constant status fields
+    static uint8_t data[AP_Logger_Compress::MAX_CHUNK_SIZE];
+    const uint8_t record_len = 31;
+    uint64_t time_us = 0;
+    float values[3] {};
+    const uint32_t status[2] { 3, 0x1f };
+    for (uint32_t ofs = 0, n = 0; ofs + record_len <= sizeof(data); ofs += record_len, n++) {
+        data[ofs] = 0xA3;
+        data[ofs+1] = 0x95;
+        data[ofs+2] = 0x80;
+        time_us += 2500;
+        if (n % 8 == 0) {
+            values[n % 3] += 0.25;
+        }
+        memcpy(&data[ofs+3], &time_us, sizeof(time_us));
+        memcpy(&data[ofs+11], values, sizeof(values));
+        memcpy(&data[ofs+23], status, sizeof(status));
+    }
+    EXPECT_LT(round_trip(data, sizeof(data)), sizeof(data) / 2);
+}
+
+TEST(LoggerCompress, TooLarge)
+{
+    static uint8_t data[AP_Logger_Compress::MAX_CHUNK_SIZE + 1];
+    EXPECT_EQ(0U, AP_Logger_Compress::compress(data, sizeof(data), compressed, sizeof(compressed), hash_table));
+}
+
+TEST(LoggerCompress, DestTooSmall)
+{
+    static uint8_t data[1024];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = get_random16();
+    }
+    EXPECT_EQ(0U, AP_Logger_Compress::compress(data, sizeof(data), compressed, 512, hash_table));
+}
+
+TEST(LoggerCompress, Corrupt)
+{
+    static uint8_t data[4096];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = i % 100;
+    }
+    const uint32_t clen = AP_Logger_Compress::compress(data, sizeof(data), compressed, sizeof(compressed), hash_table);
+    ASSERT_GT(clen, 0U);
+
+    // truncated input and a too small output are rejected
+    EXPECT_EQ(-1, AP_Logger_Compress::decompress(compressed, clen - 1, output, sizeof(output)));
+    EXPECT_EQ(-1, AP_Logger_Compress::decompress(compressed, clen, output, sizeof(data) - 1));
+
+    // as is an offset pointing before the start of the output
+    const uint8_t bad_offset[] = { 0x14, 'a', 0x10, 0x00 };
+    EXPECT_EQ(-1, AP_Logger_Compress::decompress(bad_offset, sizeof(bad_offset), output, sizeof(output)));
+}
+
+AP_GTEST_MAIN()
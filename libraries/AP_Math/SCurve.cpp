@@ -56,6 +56,7 @@ void SCurve::init()
     track.zero();
     delta_unit.zero();
     position_sq = 0.0f;
+    update_segment_coefficients();
 }
 
 // generate a trigonometric track in 3D space that moves over a straight line
@@ -109,7 +110,10 @@ void SCurve::calculate_track(const Vector3f &origin, const Vector3f &destination
 #endif
         INTERNAL_ERROR(AP_InternalError::error_t::invalid_arg_or_result);
         init();
+        return;
     }
+
+    update_segment_coefficients();
 }
 
 // set maximum velocity and re-calculate the path using these limits
@@ -151,6 +155,7 @@ void SCurve::set_speed_max(float speed_xy, float speed_up, float speed_down)
         add_segments(Pend);
         set_origin_speed_max(Vstart);
         set_destination_speed_max(Vend);
+        update_segment_coefficients();
         return;
     }
 
@@ -185,6 +190,10 @@ void SCurve::set_speed_max(float speed_xy, float speed_up, float speed_down)
         // in the constant speed phase
         // overwrite the acceleration and speed change phases with the current position and velocity
 
+        // get current position and velocity before the segments are changed
+        float Jt_out, At_out, Vt_out, Pt_out;
+        get_jerk_accel_vel_pos_at_time(time, Jt_out, At_out, Vt_out, Pt_out);
+
         // set initial segment to last acceleration segment
         segment[SEG_INIT].seg_type = SegmentType::CONSTANT_JERK;
         segment[SEG_INIT].jerk_ref = 0.0f;
@@ -194,8 +203,6 @@ void SCurve::set_speed_max(float speed_xy, float speed_up, float speed_down)
         segment[SEG_INIT].end_pos = segment[SEG_SPEED_CHANGE_END].end_pos;
 
         // set acceleration and change segments to current constant speed
-        float Jt_out, At_out, Vt_out, Pt_out;
-        get_jerk_accel_vel_pos_at_time(time, Jt_out, At_out, Vt_out, Pt_out);
         for (uint8_t i = SEG_INIT+1; i <= SEG_SPEED_CHANGE_END; i++) {
             segment[i].seg_type = SegmentType::CONSTANT_JERK;
             segment[i].jerk_ref = 0.0f;
@@ -342,7 +349,10 @@ void SCurve::set_speed_max(float speed_xy, float speed_up, float speed_down)
 #endif
         INTERNAL_ERROR(AP_InternalError::error_t::invalid_arg_or_result);
         init();
+        return;
     }
+
+    update_segment_coefficients();
 }
 
 // set the maximum vehicle speed at the origin
@@ -425,6 +435,7 @@ float SCurve::set_origin_speed_max(float speed)
         return 0.0f;
     }
 
+    update_segment_coefficients();
     return speed;
 }
 
@@ -475,7 +486,10 @@ void SCurve::set_destination_speed_max(float speed)
 #endif
         INTERNAL_ERROR(AP_InternalError::error_t::invalid_arg_or_result);
         init();
+        return;
     }
+
+    update_segment_coefficients();
 }
 
 // move target location along path from origin to destination
@@ -635,102 +649,88 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
         return;
     }
 
-    SegmentType Jtype;
-    uint8_t pnt = num_segs;
-    float Jm, tj, T0, A0, V0, P0;
-
-    // find active segment at time_now
-    for (uint8_t i = 0; i < num_segs; i++) {
-        if (time_now < segment[num_segs - 1 - i].end_time) {
-            pnt = num_segs - 1 - i;
-        }
+    // find active segment at time_now, starting from the segment found
+    // last time as time normally moves forward a little on each call
+    uint8_t pnt = MIN(seg_last, num_segs);
+    while ((pnt > 0) && (time_now < segment[pnt - 1].end_time)) {
+        pnt--;
     }
-    if (pnt == 0) {
-        Jtype = SegmentType::CONSTANT_JERK;
-        Jm = 0.0f;
-        tj = 0.0f;
-        T0 = segment[pnt].end_time;
-        A0 = segment[pnt].end_accel;
-        V0 = segment[pnt].end_vel;
-        P0 = segment[pnt].end_pos;
-    } else if (pnt == num_segs) {
-        Jtype = SegmentType::CONSTANT_JERK;
-        Jm = 0.0f;
-        tj = 0.0f;
-        T0 = segment[pnt - 1].end_time;
-        A0 = segment[pnt - 1].end_accel;
-        V0 = segment[pnt - 1].end_vel;
-        P0 = segment[pnt - 1].end_pos;
-    } else {
-        Jtype = segment[pnt].seg_type;
-        Jm = segment[pnt].jerk_ref;
-        tj = segment[pnt].end_time - segment[pnt - 1].end_time;
-        T0 = segment[pnt - 1].end_time;
-        A0 = segment[pnt - 1].end_accel;
-        V0 = segment[pnt - 1].end_vel;
-        P0 = segment[pnt - 1].end_pos;
+    while ((pnt < num_segs) && (time_now >= segment[pnt].end_time)) {
+        pnt++;
     }
-
-    switch (Jtype) {
-    case SegmentType::CONSTANT_JERK:
-        calc_javp_for_segment_const_jerk(time_now - T0, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
-        break;
-    case SegmentType::POSITIVE_JERK:
-        calc_javp_for_segment_incr_jerk(time_now - T0, tj, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
-        break;
-    case SegmentType::NEGATIVE_JERK:
-        calc_javp_for_segment_decr_jerk(time_now - T0, tj, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
-        break;
+    seg_last = pnt;
+
+    // the segment starts from the end state of the previous segment
+    const SegmentCoefficients &c = seg_coef[pnt];
+    const auto &s0 = segment[MAX(pnt, 1) - 1];
+    const float t = time_now - s0.end_time;
+    const float p1 = s0.end_vel - c.ps * c.beta;
+    const float p2 = 0.5f * s0.end_accel;
+    Jt_out = 6.0f * c.p3;
+    At_out = 2.0f * p2 + 6.0f * c.p3 * t;
+    Vt_out = p1 + (2.0f * p2 + 3.0f * c.p3 * t) * t;
+    Pt_out = s0.end_pos + (p1 + (p2 + c.p3 * t) * t) * t;
+    if (is_positive(c.beta)) {
+        // raised cosine jerk segment
+        const float sin_bt = sinf(c.beta * t);
+        const float cos_bt = cosf(c.beta * t);
+        Jt_out -= c.ps * (c.beta * c.beta * c.beta) * cos_bt;
+        At_out -= c.ps * (c.beta * c.beta) * sin_bt;
+        Vt_out += c.ps * c.beta * cos_bt;
+        Pt_out += c.ps * sin_bt;
     }
     Pt_out = MAX(0.0f, Pt_out);
 }
 
-// calculate the jerk, acceleration, velocity and position at time time_now when running the constant jerk time segment
-void SCurve::calc_javp_for_segment_const_jerk(float time_now, float J0, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
+// calculate the coefficients used to evaluate each time segment
+// must be called whenever the segments are changed
+void SCurve::update_segment_coefficients()
 {
-    Jt = J0;
-    At = A0 + J0 * time_now;
-    Vt = V0 + A0 * time_now + 0.5f * J0 * (time_now * time_now);
-    Pt = P0 + V0 * time_now + 0.5f * A0 * (time_now * time_now) + (1.0f / 6.0f) * J0 * (time_now * time_now * time_now);
-}
-
-// Calculate the jerk, acceleration, velocity and position at time time_now when running the increasing jerk magnitude time segment based on a raised cosine profile
-void SCurve::calc_javp_for_segment_incr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
-{
-    if (!is_positive(tj)) {
-        Jt = 0.0;
-        At = A0;
-        Vt = V0;
-        Pt = P0;
+    seg_last = 0;
+    if (num_segs != segments_max) {
         return;
     }
-    const float Alpha = Jm * 0.5f;
-    const float Beta = M_PI / tj;
-    Jt = Alpha * (1.0f - cosf(Beta * time_now));
-    At = A0 + Alpha * time_now - (Alpha / Beta) * sinf(Beta * time_now);
-    Vt = V0 + A0 * time_now + (Alpha * 0.5f) * (time_now * time_now) + (Alpha / (Beta * Beta)) * cosf(Beta * time_now) - Alpha / (Beta * Beta);
-    Pt = P0 + V0 * time_now + 0.5f * A0 * (time_now * time_now) + (-Alpha / (Beta * Beta)) * time_now + Alpha * (time_now * time_now * time_now) / 6.0f + (Alpha / (Beta * Beta * Beta)) * sinf(Beta * time_now);
-}
 
-// Calculate the jerk, acceleration, velocity and position at time time_now when running the decreasing jerk magnitude time segment based on a raised cosine profile
-void SCurve::calc_javp_for_segment_decr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
-{
-    if (!is_positive(tj)) {
-        Jt = 0.0;
-        At = A0;
-        Vt = V0;
-        Pt = P0;
-        return;
+    for (uint8_t pnt = 0; pnt <= num_segs; pnt++) {
+        // the first and last entries hold the start and end states
+        SegmentType Jtype = SegmentType::CONSTANT_JERK;
+        float Jm = 0.0f;
+        float tj = 0.0f;
+        if (pnt > 0 && pnt < num_segs) {
+            Jtype = segment[pnt].seg_type;
+            Jm = segment[pnt].jerk_ref;
+            tj = segment[pnt].end_time - segment[pnt - 1].end_time;
+        }
+
+        SegmentCoefficients &c = seg_coef[pnt];
+        c.p3 = 0.0f;
+        c.ps = 0.0f;
+        c.beta = 0.0f;
+
+        switch (Jtype) {
+        case SegmentType::CONSTANT_JERK:
+            c.p3 = Jm / 6.0f;
+            break;
+        case SegmentType::POSITIVE_JERK:
+        case SegmentType::NEGATIVE_JERK: {
+            // a segment of zero duration is never active
+            if (!is_positive(tj)) {
+                break;
+            }
+            // raised cosine jerk, Jm/2 * (1 -/+ cos(beta * t)), integrated
+            // three times. The decreasing jerk form is the increasing
+            // form shifted by tj which only changes the sign of the
+            // sinusoidal terms
+            const float Alpha = Jm * 0.5f;
+            const float Beta = M_PI / tj;
+            const float sign = (Jtype == SegmentType::POSITIVE_JERK) ? 1.0f : -1.0f;
+            c.p3 = Alpha / 6.0f;
+            c.ps = sign * Alpha / (Beta * Beta * Beta);
+            c.beta = Beta;
+            break;
+        }
+        }
     }
-    const float Alpha = Jm * 0.5f;
-    const float Beta = M_PI / tj;
-    const float AT = Alpha * tj;
-    const float VT = Alpha * ((tj * tj) * 0.5f - 2.0f / (Beta * Beta));
-    const float PT = Alpha * ((-1.0f / (Beta * Beta)) * tj + (1.0f / 6.0f) * (tj * tj * tj));
-    Jt = Alpha * (1.0f - cosf(Beta * (time_now + tj)));
-    At = (A0 - AT) + Alpha * (time_now + tj) - (Alpha / Beta) * sinf(Beta * (time_now + tj));
-    Vt = (V0 - VT) + (A0 - AT) * time_now + 0.5f * Alpha * (time_now + tj) * (time_now + tj) + (Alpha / (Beta * Beta)) * cosf(Beta * (time_now + tj)) - Alpha / (Beta * Beta);
-    Pt = (P0 - PT) + (V0 - VT) * time_now + 0.5f * (A0 - AT) * (time_now * time_now) + (-Alpha / (Beta * Beta)) * (time_now + tj) + (Alpha / 6.0f) * (time_now + tj) * (time_now + tj) * (time_now + tj) + (Alpha / (Beta * Beta * Beta)) * sinf(Beta * (time_now + tj));
 }
 
 // generate the segments for a path of length L
@@ -141,14 +141,8 @@ private:
     // calculate the jerk, acceleration, velocity and position at time t
     void get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float &At_out, float &Vt_out, float &Pt_out) const;
 
-    // calculate the jerk, acceleration, velocity and position at time t when running the constant jerk time segment
-    void calc_javp_for_segment_const_jerk(float time_now, float J0, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
-
-    // Calculate the jerk, acceleration, velocity and position at time t when running the increasing jerk magnitude time segment based on a raised cosine profile
-    void calc_javp_for_segment_incr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
-
-    // Calculate the jerk, acceleration, velocity and position at time t when running the decreasing jerk magnitude time segment based on a raised cosine profile
-    void calc_javp_for_segment_decr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
+    // calculate the coefficients used by get_jerk_accel_vel_pos_at_time, must be called after the segments are changed
+    void update_segment_coefficients();
 
     // generate time segments for straight segment
     void add_segments(float L);
@@ -215,6 +209,17 @@ private:
         float end_pos;      // final position value for segment
     } segment[segments_max];
 
+    // coefficients for evaluating each time segment, with entries before the first and after the last segment.
+    // with T0, A0, V0 and P0 the time, acceleration, velocity and position at the end of the previous segment
+    // and t the time since T0, position is P0 + (V0 - ps*beta)*t + A0/2*t^2 + p3*t^3 + ps*sin(beta*t)
+    // and velocity, acceleration and jerk are its derivatives
+    struct SegmentCoefficients {
+        float p3;           // cubic coefficient
+        float ps;           // sinusoid amplitude, zero for constant jerk segments
+        float beta;         // sinusoid frequency in rad/s, zero for constant jerk segments
+    } seg_coef[segments_max + 1];
+    mutable uint8_t seg_last;   // segment found by the last call to get_jerk_accel_vel_pos_at_time
+
     Vector3f track;       // total change in position from origin to destination
     Vector3f delta_unit;  // reference direction vector for path
 };
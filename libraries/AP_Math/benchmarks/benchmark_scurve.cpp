@@ -0,0 +1,51 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/SCurve.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// kinematic limits in cm, as used by AC_WPNav
+static const float speed_xy = 1000.0f;
+static const float speed_up = 250.0f;
+static const float speed_down = 150.0f;
+static const float accel_xy = 250.0f;
+static const float accel_z = 100.0f;
+static const float snap_max = 1000.0f;
+static const float jerk_max = 100.0f;
+
+static Vector3f mission_waypoint(uint16_t index)
+{
+    // zig-zag survey pattern with a climb on every other leg
+    return Vector3f((index / 2) * 2000.0f, (((index + 1) / 2) % 2) * 10000.0f, -1000.0f - (index % 4) * 500.0f);
+}
+
+// run a long mission at 400Hz through fast waypoints, measuring the
+// cost of each loop including the leg changes
+static void BM_SCurveAdvanceMission(benchmark::State& state)
+{
+    const float dt = 0.0025f;
+    SCurve prev_leg, this_leg, next_leg;
+    uint16_t wp = 1;
+    this_leg.calculate_track(mission_waypoint(0), mission_waypoint(1), speed_xy, speed_up, speed_down, accel_xy, accel_z, snap_max, jerk_max);
+    next_leg.calculate_track(mission_waypoint(1), mission_waypoint(2), speed_xy, speed_up, speed_down, accel_xy, accel_z, snap_max, jerk_max);
+
+    while (state.KeepRunning()) {
+        Vector3f target_pos = mission_waypoint(wp - 1);
+        Vector3f target_vel, target_accel;
+        const bool finished = this_leg.advance_target_along_track(prev_leg, next_leg, 200.0f, 500.0f, true, dt, target_pos, target_vel, target_accel);
+        gbenchmark_escape(&target_pos);
+        gbenchmark_escape(&target_vel);
+        gbenchmark_escape(&target_accel);
+        if (finished) {
+            prev_leg = this_leg;
+            this_leg = next_leg;
+            wp++;
+            next_leg.calculate_track(mission_waypoint(wp), mission_waypoint(wp + 1), speed_xy, speed_up, speed_down, accel_xy, accel_z, snap_max, jerk_max);
+        }
+    }
+}
+
+BENCHMARK(BM_SCurveAdvanceMission);
+
+BENCHMARK_MAIN();
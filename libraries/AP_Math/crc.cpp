@@ -505,22 +505,23 @@ void hash_fnv_1a(uint32_t len, const uint8_t* buf, uint64_t* hash)
     }
 }
 
-// calculate 24 bit crc. We take an approach that saves memory and flash at the cost of higher CPU load.
+/*
+  CRC24Q as used by RTCMv3, using a 16 entry table to process a nibble
+  at a time. This is much faster than the bitwise loop while costing
+  only 64 bytes of flash, compared to 1kB for a full 256 entry table
+ */
+static const uint32_t crc24_nibble_tab[16] = {
+    0x000000, 0x864CFB, 0x8AD50D, 0x0C99F6, 0x93E6E1, 0x15AA1A, 0x1933EC, 0x9F7F17,
+    0xA18139, 0x27CDC2, 0x2B5434, 0xAD18CF, 0x3267D8, 0xB42B23, 0xB8B2D5, 0x3EFE2E,
+};
+
 uint32_t crc_crc24(const uint8_t *bytes, uint16_t len)
 {
-    static constexpr uint32_t POLYCRC24 = 0x1864CFB;
     uint32_t crc = 0;
     while (len--) {
-        uint8_t b = *bytes++;
-        const uint8_t idx = (crc>>16) ^ b;
-        uint32_t crct = idx<<16;
-        for (uint8_t j=0; j<8; j++) {
-            crct <<= 1;
-            if (crct & 0x1000000) {
-                crct ^= POLYCRC24;
-            }
-        }
-        crc = ((crc<<8)&0xFFFFFF) ^ crct;
+        crc ^= uint32_t(*bytes++) << 16;
+        crc = ((crc << 4) & 0xFFFFFF) ^ crc24_nibble_tab[(crc >> 20) & 0xF];
+        crc = ((crc << 4) & 0xFFFFFF) ^ crc24_nibble_tab[(crc >> 20) & 0xF];
     }
     return crc;
 }
@@ -17,6 +17,36 @@ TEST(LinesScurve, test_calculate_path)
     EXPECT_FLOAT_EQ(t6_out, 0.25000018);
 }
 
+TEST(LinesScurve, test_advance_target_along_track)
+{
+    // fly a straight leg, stopping at the destination
+    const Vector3f origin{0, 0, 0};
+    const Vector3f destination{2000, 1000, -500};
+    SCurve prev_leg, this_leg, next_leg;
+    this_leg.calculate_track(origin, destination, 1000, 250, 150, 250, 100, 1000, 100);
+
+    const float dt = 0.0025;
+    Vector3f last_pos = origin, last_vel;
+    bool finished = false;
+    for (uint32_t i = 0; i < 100000 && !finished; i++) {
+        Vector3f pos = origin, vel, accel;
+        finished = this_leg.advance_target_along_track(prev_leg, next_leg, 200, 500, false, dt, pos, vel, accel);
+
+        // the path is continuous and within the kinematic limits
+        EXPECT_LT((pos - last_pos).length(), 1000 * dt * 1.01);
+        EXPECT_LT((vel - last_vel).length(), 250 * dt * 1.01);
+        EXPECT_LT(vel.length(), 1000 * 1.01);
+        EXPECT_LT(accel.length(), 250 * 1.01);
+
+        // velocity and position agree
+        EXPECT_NEAR((pos - last_pos).length(), (vel + last_vel).length() * 0.5 * dt, 1e-3);
+        last_pos = pos;
+        last_vel = vel;
+    }
+    EXPECT_TRUE(finished);
+    EXPECT_LT((last_pos - destination).length(), 0.01);
+    EXPECT_LT(last_vel.length(), 0.1);
+}
 
 AP_GTEST_MAIN()
 int hal = 0; //weirdly the build will fail without this
@@ -46,6 +46,15 @@ const AP_Param::GroupInfo AP_Mission::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Mission, _options, AP_MISSION_OPTIONS_DEFAULT),
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    // @Param: CACHE
+    // @DisplayName: Mission command cache
+    // @Description: Keep a decoded copy of the mission in RAM, with indexes for finding the next navigation and landing commands. This speeds up mission access, particularly for large missions, and costs about 31 bytes of RAM per mission item. Missions of more than 1000 items (4000 on boards with more memory) are always read from storage
+    // @Values: 0:Disabled, 1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("CACHE",  3, AP_Mission, _cmd_cache_enable, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -300,6 +309,13 @@ bool AP_Mission::clear()
 void AP_Mission::truncate(uint16_t index)
 {
     if ((unsigned)_cmd_total > index) {
+#if AP_MISSION_CMD_CACHE_ENABLED
+        WITH_SEMAPHORE(_rsem);
+        if (_cache.count > index) {
+            _cache.count = index;
+            _cache.indexes_valid = false;
+        }
+#endif
         _cmd_total.set_and_save(index);
         _last_change_time_ms = AP_HAL::millis();
     }
@@ -542,6 +558,19 @@ bool AP_Mission::get_next_nav_cmd(uint16_t start_index, Mission_Command& cmd)
 {
     // search until the end of the mission command list
     for (uint16_t cmd_index = start_index; cmd_index < (unsigned)_cmd_total; cmd_index++) {
+#if AP_MISSION_CMD_CACHE_ENABLED
+        {
+            // skip straight over "do" and "conditional" commands, which
+            // get_next_cmd() would otherwise return one at a time
+            WITH_SEMAPHORE(_rsem);
+            if (cmd_cache_update_indexes() && cmd_index < _cache.count) {
+                cmd_index = _cache.next_nav_or_jump[cmd_index];
+                if (cmd_index >= (unsigned)_cmd_total) {
+                    break;
+                }
+            }
+        }
+#endif
         // get next command
         if (!get_next_cmd(cmd_index, cmd, false)) {
             // no more commands so return failure
@@ -824,6 +853,26 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    if (cmd_cache_update()) {
+        const Mission_Command *cached = cmd_cache_get(index);
+        if (cached == nullptr) {
+            // as decode_cmd_from_storage() leaves it
+            cmd = {};
+            return false;
+        }
+        cmd = *cached;
+        return true;
+    }
+#endif
+
+    return decode_cmd_from_storage(index, cmd);
+}
+
+/// decode_cmd_from_storage - decode a packed command from storage
+///     true is return if successful
+bool AP_Mission::decode_cmd_from_storage(uint16_t index, Mission_Command& cmd) const
+{
     // ensure all bytes of cmd are zeroed
     cmd = {};
 
@@ -969,6 +1018,15 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         _storage.write_block(pos_in_storage+5, packed.bytes, 10);
     }
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    // decode the cached copy again on next use, so it is what a read
+    // from storage would return, including any packing losses
+    if (index < _cache.count && index != 0) {
+        _cache.state[index] = CmdCacheState::NOT_DECODED;
+        _cache.indexes_valid = false;
+    }
+#endif
+
     // remember when the mission last changed
     _last_change_time_ms = AP_HAL::millis();
 
@@ -2257,11 +2315,7 @@ bool AP_Mission::jump_to_tag(const uint16_t tag)
 // Returns 0 if no appropriate JUMP_TAG match can be found.
 uint16_t AP_Mission::get_index_of_jump_tag(const uint16_t tag) const
 {
-    const auto count = num_commands();
-    for (uint16_t i = 1; i < count; i++) {
-        if (get_command_id(i) != uint16_t(MAV_CMD_JUMP_TAG)) {
-            continue;
-        }
+    for (uint16_t i = find_next_cmd_with_id(0, MAV_CMD_JUMP_TAG); i != 0; i = find_next_cmd_with_id(i, MAV_CMD_JUMP_TAG)) {
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
             continue;
@@ -2377,11 +2431,7 @@ uint16_t AP_Mission::get_landing_sequence_start(const Location &current_loc)
     float min_distance = -1;
 
     // Go through mission looking for nearest landing start command
-    const auto count = num_commands();
-    for (uint16_t i = 1; i < count; i++) {
-        if (get_command_id(i) != uint16_t(MAV_CMD_DO_LAND_START)) {
-            continue;
-        }
+    for (uint16_t i = find_next_cmd_with_id(0, MAV_CMD_DO_LAND_START); i != 0; i = find_next_cmd_with_id(i, MAV_CMD_DO_LAND_START)) {
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
             continue;
@@ -2450,18 +2500,16 @@ bool AP_Mission::jump_to_closest_mission_leg(const Location &current_loc)
     uint16_t search_remaining = 1000;
 
     // Go through mission and check each DO_RETURN_PATH_START
-    for (uint16_t i = 1; i < num_commands(); i++) {
-        if (get_command_id(i) == uint16_t(MAV_CMD_DO_RETURN_PATH_START)) {
-            uint16_t tmp_index;
-            float tmp_distance;
-            if (distance_to_mission_leg(i, search_remaining, tmp_distance, tmp_index, current_loc) && (min_distance < 0 || tmp_distance <= min_distance)){
-                min_distance = tmp_distance;
-                landing_start_index = tmp_index;
-            }
-            if (search_remaining == 0) {
-                // Run out of time to search, stop and return the best so far
-                break;
-            }
+    for (uint16_t i = find_next_cmd_with_id(0, MAV_CMD_DO_RETURN_PATH_START); i != 0; i = find_next_cmd_with_id(i, MAV_CMD_DO_RETURN_PATH_START)) {
+        uint16_t tmp_index;
+        float tmp_distance;
+        if (distance_to_mission_leg(i, search_remaining, tmp_distance, tmp_index, current_loc) && (min_distance < 0 || tmp_distance <= min_distance)){
+            min_distance = tmp_distance;
+            landing_start_index = tmp_index;
+        }
+        if (search_remaining == 0) {
+            // Run out of time to search, stop and return the best so far
+            break;
         }
     }
 
@@ -2487,11 +2535,7 @@ bool AP_Mission::jump_to_abort_landing_sequence(const Location &current_loc)
     uint16_t abort_index = 0;
     float min_distance = FLT_MAX;
 
-    const auto count = num_commands();
-    for (uint16_t i = 1; i < count; i++) {
-        if (get_command_id(i) != uint16_t(MAV_CMD_DO_GO_AROUND)) {
-            continue;
-        }
+    for (uint16_t i = find_next_cmd_with_id(0, MAV_CMD_DO_GO_AROUND); i != 0; i = find_next_cmd_with_id(i, MAV_CMD_DO_GO_AROUND)) {
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
             continue;
@@ -2885,6 +2929,17 @@ const char *AP_Mission::Mission_Command::type() const
  */
 uint16_t AP_Mission::get_command_id(uint16_t index) const
 {
+#if AP_MISSION_CMD_CACHE_ENABLED
+    {
+        WITH_SEMAPHORE(_rsem);
+        if (index != 0 && index < (unsigned)_cmd_total && cmd_cache_update() && index < _cache.count) {
+            const Mission_Command *cached = cmd_cache_get(index);
+            if (cached != nullptr) {
+                return cached->id;
+            }
+        }
+    }
+#endif
     const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
     uint8_t b[3] {};
     if (!_storage.read_block(b, pos_in_storage, sizeof(b))) {
@@ -2899,16 +2954,50 @@ uint16_t AP_Mission::get_command_id(uint16_t index) const
     return id;
 }
 
+/*
+  return the index of the first command after after_index with the
+  given id, or 0 if there is none
+ */
+uint16_t AP_Mission::find_next_cmd_with_id(uint16_t after_index, uint16_t id) const
+{
+#if AP_MISSION_CMD_CACHE_ENABLED
+    {
+        WITH_SEMAPHORE(_rsem);
+        if (cmd_cache_update_indexes()) {
+            if (cmd_cache_is_marker(id) && !_cache.markers_overflow) {
+                for (uint8_t m=0; m<_cache.num_markers; m++) {
+                    const uint16_t i = _cache.markers[m];
+                    if (i > after_index && _cache.cmds[i].id == id) {
+                        return i;
+                    }
+                }
+                return 0;
+            }
+            // the indexes decoded every command
+            for (uint16_t i = after_index+1; i < _cache.count; i++) {
+                if (_cache.state[i] == CmdCacheState::DECODED && _cache.cmds[i].id == id) {
+                    return i;
+                }
+            }
+            return 0;
+        }
+    }
+#endif
+    const auto count = num_commands();
+    for (uint16_t i = after_index+1; i < count; i++) {
+        if (get_command_id(i) == id) {
+            return i;
+        }
+    }
+    return 0;
+}
+
 /*
   see if the mission contains a particular item
  */
 bool AP_Mission::contains_item(MAV_CMD command) const
 {
-    const auto count = num_commands();
-    for (uint16_t i = 1; i < count; i++) {
-        if (get_command_id(i) != uint16_t(command)) {
-            continue;
-        }
+    for (uint16_t i = find_next_cmd_with_id(0, command); i != 0; i = find_next_cmd_with_id(i, command)) {
         // confirm with full read
         Mission_Command tmp;
         if (!read_cmd_from_storage(i, tmp)) {
@@ -3116,6 +3205,203 @@ bool AP_Mission::jump_to_abort_landing_sequence(void)
 }
 #endif // AP_SCRIPTING_ENABLED
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+/*
+  bring the command cache up to date with the number of commands in
+  the mission. Returns false if the cache can't be used, in which case
+  callers fall back to reading from storage. Caller must hold _rsem
+ */
+bool AP_Mission::cmd_cache_update(void) const
+{
+    if (_cmd_cache_enable == 0) {
+        if (_cache.capacity > 0) {
+            cmd_cache_free();
+        }
+        _cache.alloc_failed = false;
+        return false;
+    }
+    if (_cache.alloc_failed) {
+        return false;
+    }
+    const uint16_t total = MIN(uint16_t(_cmd_total.get()), _commands_max);
+    if (total > AP_MISSION_CMD_CACHE_MAX_CMDS) {
+        return false;
+    }
+    if (_cache.count > total) {
+        // mission has been truncated
+        _cache.count = total;
+        _cache.indexes_valid = false;
+    }
+    if (_cache.count < total) {
+        if (total > _cache.capacity && !cmd_cache_grow(total)) {
+            return false;
+        }
+        // the new commands are decoded when they are first used
+        for (uint16_t i=_cache.count; i<total; i++) {
+            _cache.state[i] = CmdCacheState::NOT_DECODED;
+        }
+        _cache.count = total;
+        _cache.indexes_valid = false;
+    }
+    return true;
+}
+
+/*
+  bring the command cache and its indexes up to date. Building the
+  indexes decodes every command. Caller must hold _rsem
+ */
+bool AP_Mission::cmd_cache_update_indexes(void) const
+{
+    if (!cmd_cache_update()) {
+        return false;
+    }
+    if (!_cache.indexes_valid) {
+        cmd_cache_build_indexes();
+    }
+    return true;
+}
+
+/*
+  return a cached command, decoding it from storage on first use. A
+  command which fails to decode is remembered, so it isn't retried on
+  every read, and nullptr returned
+ */
+const AP_Mission::Mission_Command *AP_Mission::cmd_cache_get(uint16_t index) const
+{
+    switch (_cache.state[index]) {
+    case CmdCacheState::NOT_DECODED:
+        if (!decode_cmd_from_storage(index, _cache.cmds[index])) {
+            _cache.state[index] = CmdCacheState::DECODE_FAILED;
+            return nullptr;
+        }
+        _cache.state[index] = CmdCacheState::DECODED;
+        break;
+    case CmdCacheState::DECODED:
+        break;
+    case CmdCacheState::DECODE_FAILED:
+        return nullptr;
+    }
+    return &_cache.cmds[index];
+}
+
+/*
+  grow the cache to hold at least total commands
+ */
+bool AP_Mission::cmd_cache_grow(uint16_t total) const
+{
+    // grow in chunks to avoid re-allocating on every mission item
+    // added during an upload
+    const uint16_t capacity = MIN(uint32_t((total + 31U) & ~31U), uint32_t(AP_MISSION_CMD_CACHE_MAX_CMDS));
+    Mission_Command *cmds = NEW_NOTHROW Mission_Command[capacity];
+    CmdCacheState *state = NEW_NOTHROW CmdCacheState[capacity];
+    // one extra entry so the end of the mission can be indexed
+    uint16_t *next_nav_or_jump = NEW_NOTHROW uint16_t[capacity+1];
+    if (cmds == nullptr || state == nullptr || next_nav_or_jump == nullptr) {
+        delete[] cmds;
+        delete[] state;
+        delete[] next_nav_or_jump;
+        // don't keep trying to allocate, we fall back to storage
+        _cache.alloc_failed = true;
+        return false;
+    }
+    for (uint16_t i=0; i<_cache.count; i++) {
+        cmds[i] = _cache.cmds[i];
+        state[i] = _cache.state[i];
+    }
+    delete[] _cache.cmds;
+    delete[] _cache.state;
+    delete[] _cache.next_nav_or_jump;
+    _cache.cmds = cmds;
+    _cache.state = state;
+    _cache.next_nav_or_jump = next_nav_or_jump;
+    _cache.capacity = capacity;
+    _cache.indexes_valid = false;
+    return true;
+}
+
+/*
+  return true if a command id is tracked in the cache marker list
+ */
+bool AP_Mission::cmd_cache_is_marker(uint16_t id)
+{
+    switch (id) {
+    case MAV_CMD_DO_LAND_START:
+    case MAV_CMD_DO_RETURN_PATH_START:
+    case MAV_CMD_DO_GO_AROUND:
+    case MAV_CMD_JUMP_TAG:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+  rebuild the nav/jump skip table and marker list from the cached
+  commands, decoding any not yet used
+ */
+void AP_Mission::cmd_cache_build_indexes(void) const
+{
+    const uint16_t count = _cache.count;
+    _cache.next_nav_or_jump[count] = count;
+    for (int32_t i=int32_t(count)-1; i>=0; i--) {
+        // index 0 is home, which is read as a nav waypoint. Commands
+        // which fail to decode stop the skip so that reading them
+        // fails as it would without the cache
+        const Mission_Command *cmd = (i == 0) ? nullptr : cmd_cache_get(i);
+        const bool stop = (cmd == nullptr ||
+                           is_nav_cmd(*cmd) ||
+                           cmd->id == MAV_CMD_DO_JUMP ||
+                           cmd->id == MAV_CMD_DO_JUMP_TAG);
+        _cache.next_nav_or_jump[i] = stop ? i : _cache.next_nav_or_jump[i+1];
+    }
+
+    _cache.num_markers = 0;
+    _cache.markers_overflow = false;
+    for (uint16_t i=1; i<count; i++) {
+        if (_cache.state[i] != CmdCacheState::DECODED ||
+            !cmd_cache_is_marker(_cache.cmds[i].id)) {
+            continue;
+        }
+        if (_cache.num_markers >= ARRAY_SIZE(_cache.markers)) {
+            _cache.markers_overflow = true;
+            break;
+        }
+        _cache.markers[_cache.num_markers++] = i;
+    }
+
+    _cache.indexes_valid = true;
+}
+
+/*
+  free all cache memory
+ */
+void AP_Mission::cmd_cache_free(void) const
+{
+    delete[] _cache.cmds;
+    delete[] _cache.state;
+    delete[] _cache.next_nav_or_jump;
+    _cache.cmds = nullptr;
+    _cache.state = nullptr;
+    _cache.next_nav_or_jump = nullptr;
+    _cache.count = 0;
+    _cache.capacity = 0;
+    _cache.indexes_valid = false;
+}
+
+/*
+  enable or disable the command cache
+ */
+void AP_Mission::set_cmd_cache_enabled(bool enable)
+{
+    WITH_SEMAPHORE(_rsem);
+    _cmd_cache_enable.set(enable);
+    _cache.alloc_failed = false;
+    if (!enable) {
+        cmd_cache_free();
+    }
+}
+#endif // AP_MISSION_CMD_CACHE_ENABLED
+
 
 // singleton instance
 AP_Mission *AP_Mission::_singleton;
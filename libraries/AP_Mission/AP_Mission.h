@@ -782,6 +782,13 @@ public:
     void set_log_start_mission_item_bit(uint32_t bit) { log_start_mission_item_bit = bit; }
 #endif
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    // enable or disable the in-RAM command cache, as MIS_CACHE does.
+    // Disabling frees the cache and reverts to reading every command
+    // from storage
+    void set_cmd_cache_enabled(bool enable);
+#endif
+
 private:
     static AP_Mission *_singleton;
 
@@ -894,6 +901,9 @@ private:
     AP_Int16                _cmd_total;  // total number of commands in the mission
     AP_Int16                _options;    // bitmask options for missions, currently for mission clearing on reboot but can be expanded as required
     AP_Int8                 _restart;   // controls mission starting point when entering Auto mode (either restart from beginning of mission or resume from last command run)
+#if AP_MISSION_CMD_CACHE_ENABLED
+    AP_Int8                 _cmd_cache_enable;  // keep a decoded copy of the mission in RAM
+#endif
 
     // internal variables
     bool                    _force_resume;  // when set true it forces mission to resume irrespective of MIS_RESTART param.
@@ -926,6 +936,64 @@ private:
     // fast call to get command ID of a mission index
     uint16_t get_command_id(uint16_t index) const;
 
+    // return the index of the first command after after_index with
+    // the given id, or 0 if there is none
+    uint16_t find_next_cmd_with_id(uint16_t after_index, uint16_t id) const;
+
+    // decode a command from storage, bypassing the command cache
+    bool decode_cmd_from_storage(uint16_t index, Mission_Command& cmd) const;
+
+#if AP_MISSION_CMD_CACHE_ENABLED
+    /*
+      in-RAM copy of the decoded mission, used when MIS_CACHE is
+      set. It costs about 31 bytes of RAM per mission
+      command, allocated as the mission is used. Entries are decoded from
+      storage on first use, and marked for decoding again by
+      write_cmd_to_storage(). A command that fails to decode is
+      remembered and reads of it fail, as they would from storage. The
+      indexes are rebuilt lazily after any change. Slot 0 (home) is
+      never used as home comes from AHRS
+     */
+    static const uint8_t cmd_cache_max_markers = 32;
+    enum class CmdCacheState : uint8_t {
+        NOT_DECODED = 0,
+        DECODED,
+        DECODE_FAILED,
+    };
+    struct CmdCache {
+        Mission_Command *cmds;
+        CmdCacheState *state;
+        // first index at or after i holding a nav or jump command
+        // (count if none); indexes between i and this are all "do"
+        // or "conditional" commands
+        uint16_t *next_nav_or_jump;
+        uint16_t count;
+        uint16_t capacity;
+        // sorted indexes of DO_LAND_START, DO_RETURN_PATH_START,
+        // DO_GO_AROUND and JUMP_TAG commands
+        uint16_t markers[cmd_cache_max_markers];
+        uint8_t num_markers;
+        bool markers_overflow;
+        bool indexes_valid;
+        bool alloc_failed;
+    };
+    mutable CmdCache _cache;
+
+    // bring the cache up to date with _cmd_total, returns false if the
+    // cache can't be used. Caller must hold _rsem
+    bool cmd_cache_update(void) const;
+    // as cmd_cache_update(), also building the indexes
+    bool cmd_cache_update_indexes(void) const;
+    // return a cached command, decoding it if needed, or nullptr if it
+    // can't be decoded. index must be between 1 and _cache.count-1 and
+    // the caller must hold _rsem
+    const Mission_Command *cmd_cache_get(uint16_t index) const;
+    bool cmd_cache_grow(uint16_t total) const;
+    void cmd_cache_build_indexes(void) const;
+    void cmd_cache_free(void) const;
+    static bool cmd_cache_is_marker(uint16_t id);
+#endif
+
     // memoisation of contains-relative:
     bool _contains_terrain_alt_items;  // true if the mission has terrain-relative items
     uint32_t _last_contains_relative_calculated_ms;  // will be equal to _last_change_time_ms if _contains_terrain_alt_items is up-to-date
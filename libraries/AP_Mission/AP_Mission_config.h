@@ -7,3 +7,20 @@
 #ifndef AP_MISSION_NAV_PAYLOAD_PLACE_ENABLED
 #define AP_MISSION_NAV_PAYLOAD_PLACE_ENABLED 1
 #endif
+
+// support keeping an in-RAM decoded copy of the mission with
+// precomputed indexes. It is only used when enabled with MIS_OPTIONS
+// and costs about 31 bytes of RAM per cached mission command
+#ifndef AP_MISSION_CMD_CACHE_ENABLED
+#define AP_MISSION_CMD_CACHE_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// largest mission that will be held in the command cache. Larger
+// missions (e.g. on microSD) are read directly from storage
+#ifndef AP_MISSION_CMD_CACHE_MAX_CMDS
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_1000
+#define AP_MISSION_CMD_CACHE_MAX_CMDS 4000
+#else
+#define AP_MISSION_CMD_CACHE_MAX_CMDS 1000
+#endif
+#endif
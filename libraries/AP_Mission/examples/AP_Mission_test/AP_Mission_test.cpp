@@ -55,6 +55,9 @@ private:
     void run_set_current_cmd_while_stopped_test();
     void run_replace_cmd_test();
     void run_max_cmd_test();
+    void init_mission_survey(uint16_t num_commands);
+    uint32_t time_mission_access(uint16_t iterations);
+    void run_cache_benchmark();
 
     AP_Mission mission{
             FUNCTOR_BIND_MEMBER(&MissionTest::start_cmd, bool, const AP_Mission::Mission_Command &),
@@ -1327,6 +1330,105 @@ void MissionTest::run_max_cmd_test()
     }
 }
 
+// init_mission_survey - initialise a large survey style mission with a
+// camera trigger after every waypoint and a landing sequence at the end
+void MissionTest::init_mission_survey(uint16_t num_commands)
+{
+    AP_Mission::Mission_Command cmd {};
+
+    mission.clear();
+
+    // Command #0 : home
+    cmd.id = MAV_CMD_NAV_WAYPOINT;
+    cmd.content.location = Location{
+        -353632620,
+        1491652370,
+        58400,
+        Location::AltFrame::ABSOLUTE
+    };
+    mission.add_cmd(cmd);
+
+    uint16_t i = 1;
+    while (i < num_commands - 3) {
+        cmd = {};
+        cmd.id = MAV_CMD_NAV_WAYPOINT;
+        cmd.content.location = Location{
+            int32_t(-353632620 + (i % 40) * 2000),
+            int32_t(1491652370 + (i / 40) * 500),
+            3000,
+            Location::AltFrame::ABOVE_HOME
+        };
+        if (!mission.add_cmd(cmd)) {
+            break;
+        }
+        cmd = {};
+        cmd.id = MAV_CMD_DO_DIGICAM_CONTROL;
+        if (!mission.add_cmd(cmd)) {
+            break;
+        }
+        i += 2;
+    }
+
+    cmd = {};
+    cmd.id = MAV_CMD_DO_LAND_START;
+    cmd.content.location = Location{
+        -353632620,
+        1491652370,
+        3000,
+        Location::AltFrame::ABOVE_HOME
+    };
+    mission.add_cmd(cmd);
+
+    cmd.id = MAV_CMD_NAV_LAND;
+    mission.add_cmd(cmd);
+}
+
+// time_mission_access - time typical mission lookups, returns microseconds
+uint32_t MissionTest::time_mission_access(uint16_t iterations)
+{
+    const Location loc{-353632620, 1491652370, 3000, Location::AltFrame::ABOVE_HOME};
+    AP_Mission::Mission_Command cmd;
+    const uint16_t num_commands = mission.num_commands();
+
+    const uint32_t start_us = AP_HAL::micros();
+    for (uint16_t n=0; n<iterations; n++) {
+        for (uint16_t i=1; i<num_commands; i++) {
+            mission.read_cmd_from_storage(i, cmd);
+        }
+        for (uint16_t i=1; i<num_commands; i+=10) {
+            mission.get_next_nav_cmd(i, cmd);
+        }
+        mission.get_landing_sequence_start(loc);
+    }
+    return AP_HAL::micros() - start_us;
+}
+
+// run_cache_benchmark - compare mission access with and without the command cache
+void MissionTest::run_cache_benchmark()
+{
+    const uint16_t iterations = 20;
+
+    init_mission_survey(mission.num_commands_max());
+    hal.console->printf("Survey mission with %u commands\n", (unsigned)mission.num_commands());
+
+#if AP_MISSION_CMD_CACHE_ENABLED
+    mission.set_cmd_cache_enabled(false);
+#endif
+    const uint32_t uncached_us = time_mission_access(iterations);
+    hal.console->printf("storage: %u usec per iteration\n", (unsigned)(uncached_us / iterations));
+
+#if AP_MISSION_CMD_CACHE_ENABLED
+    mission.set_cmd_cache_enabled(true);
+    // first access populates the cache
+    const uint32_t fill_us = time_mission_access(1);
+    const uint32_t cached_us = time_mission_access(iterations);
+    hal.console->printf("cache fill: %u usec\n", (unsigned)fill_us);
+    hal.console->printf("cached: %u usec per iteration\n", (unsigned)(cached_us / iterations));
+#else
+    hal.console->printf("command cache not enabled in this build\n");
+#endif
+}
+
 // setup
 void MissionTest::setup(void)
 {
@@ -1346,6 +1448,9 @@ void MissionTest::loop(void)
     // uncomment line below to run the mission pause/resume test
     //run_resume_test();
 
+    // uncomment line below to run the command cache benchmark
+    //run_cache_benchmark();
+
     // wait forever
     while(true) {
         hal.scheduler->delay(1000);
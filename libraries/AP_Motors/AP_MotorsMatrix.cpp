@@ -16,6 +16,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AP_MotorsMatrix.h"
 #include <AP_Vehicle/AP_Vehicle_Type.h>
+#include <AP_Scheduler/PerfInfo.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -106,6 +107,7 @@ bool AP_MotorsMatrix::set_throttle_factor(int8_t motor_num, float throttle_facto
     }
 
     _throttle_factor[motor_num] = throttle_factor;
+    mixer_changed();
     return true;
 }
 
@@ -180,6 +182,8 @@ void AP_MotorsMatrix::output_to_motors()
             rc_write(i, output_to_pwm(_actuator[i]));
         }
     }
+
+    AP_SCHEDULER_GYRO_LATENCY_MARK(MIX);
 }
 
 // get_motor_mask - returns a bitmask of which outputs are being used for motors (1 means being used)
@@ -208,6 +212,34 @@ float AP_MotorsMatrix::boost_ratio(float boost_value, float normal_value) const
     return _thrust_boost_ratio * boost_value + (1.0 - _thrust_boost_ratio) * normal_value;
 }
 
+// pack the factors of the enabled motors into dense arrays
+void AP_MotorsMatrix::compile_mixer()
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        _mixer.mixer_index[i] = AP_MOTORS_MAX_NUM_MOTORS;
+        if (!motor_enabled[i]) {
+            continue;
+        }
+        _mixer.roll[n] = _roll_factor[i];
+        _mixer.pitch[n] = _pitch_factor[i];
+        _mixer.yaw[n] = _yaw_factor[i];
+        if (is_zero(_yaw_factor[i])) {
+            _mixer.yaw_inv[n] = 0.0f;
+            _mixer.yaw_unused[n] = 1.0f;
+        } else {
+            _mixer.yaw_inv[n] = 1.0f / fabsf(_yaw_factor[i]);
+            _mixer.yaw_unused[n] = 0.0f;
+        }
+        _mixer.throttle[n] = _throttle_factor[i];
+        _mixer.motor_index[n] = i;
+        _mixer.mixer_index[i] = n;
+        n++;
+    }
+    _mixer.num_motors = n;
+    _mixer.valid = true;
+}
+
 // output_armed - sends commands to the motors
 // includes new scaling stability patch
 void AP_MotorsMatrix::output_armed_stabilizing()
@@ -271,30 +303,34 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // Octo-Quad (x8) + : MOT_YAW_HEADROOM = 300, ATC_RAT_RLL_IMAX = 0.5,   ATC_RAT_PIT_IMAX = 0.5,   ATC_RAT_YAW_IMAX = 0.25
     // Quads cannot make use of motor loss handling because it doesn't have enough degrees of freedom.
 
+    if (!_mixer.valid) {
+        compile_mixer();
+    }
+    const uint8_t num_motors = _mixer.num_motors;
+
+    // position of the lost motor in the mixer, if thrust boost is enabled
+    const uint8_t lost = _thrust_boost ? _mixer.mixer_index[_motor_lost_index] : AP_MOTORS_MAX_NUM_MOTORS;
+
+    // combined thrust outputs for each entry in the mixer
+    float thrust[AP_MOTORS_MAX_NUM_MOTORS];
+
     // calculate amount of yaw we can fit into the throttle range
     // this is always equal to or less than the requested yaw from the pilot or rate controller
     float yaw_allowed = 1.0f; // amount of yaw we can fit in
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            // calculate the thrust outputs for roll and pitch
-            _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
-
-            // Check the maximum yaw control that can be used on this channel
-            // Exclude any lost motors if thrust boost is enabled
-            if (!is_zero(_yaw_factor[i]) && (!_thrust_boost || i != _motor_lost_index)) {
-                const float thrust_rp_best_throttle = throttle_thrust_best_rpy + _thrust_rpyt_out[i];
-                float motor_room;
-                if (is_positive(yaw_thrust * _yaw_factor[i])) {
-                    // room to upper limit
-                    motor_room = 1.0 - thrust_rp_best_throttle;
-                } else {
-                    // room to lower limit
-                    motor_room = thrust_rp_best_throttle;
-                }
-                const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(_yaw_factor[i]);
-                yaw_allowed = MIN(yaw_allowed, motor_yaw_allowed);
-            }
-        }
+    for (uint8_t i = 0; i < num_motors; i++) {
+        // calculate the thrust outputs for roll and pitch
+        thrust[i] = roll_thrust * _mixer.roll[i] + pitch_thrust * _mixer.pitch[i];
+
+        // Check the maximum yaw control that can be used on this channel,
+        // room to upper limit if yaw increases its output, otherwise room to lower limit
+        const float thrust_rp_best_throttle = throttle_thrust_best_rpy + thrust[i];
+        const float motor_room = is_positive(yaw_thrust * _mixer.yaw[i]) ? 1.0f - thrust_rp_best_throttle : thrust_rp_best_throttle;
+
+        // motors with no yaw factor never limit yaw
+        const float motor_yaw_allowed = MAX(motor_room, 0.0f) * _mixer.yaw_inv[i] + _mixer.yaw_unused[i];
+
+        // Exclude any lost motors if thrust boost is enabled
+        yaw_allowed = MIN(yaw_allowed, i == lost ? 1.0f : motor_yaw_allowed);
     }
 
     // calculate the maximum yaw control that can be used
@@ -308,18 +344,17 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     yaw_allowed = MAX(yaw_allowed, yaw_allowed_min);
 
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost && motor_enabled[_motor_lost_index]) {
+    if (lost < num_motors) {
         // Check the maximum yaw control that can be used on this channel
-        // Exclude any lost motors if thrust boost is enabled
-        if (!is_zero(_yaw_factor[_motor_lost_index])){
-            const float thrust_rp_best_throttle = throttle_thrust_best_rpy + _thrust_rpyt_out[_motor_lost_index];
+        if (!is_zero(_mixer.yaw_inv[lost])) {
+            const float thrust_rp_best_throttle = throttle_thrust_best_rpy + thrust[lost];
             float motor_room;
-            if (is_positive(yaw_thrust * _yaw_factor[_motor_lost_index])) {
+            if (is_positive(yaw_thrust * _mixer.yaw[lost])) {
                 motor_room = 1.0 - thrust_rp_best_throttle;
             } else {
                 motor_room = thrust_rp_best_throttle;
             }
-            const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(_yaw_factor[_motor_lost_index]);
+            const float motor_yaw_allowed = MAX(motor_room, 0.0) * _mixer.yaw_inv[lost];
             yaw_allowed = boost_ratio(yaw_allowed, MIN(yaw_allowed, motor_yaw_allowed));
         }
     }
@@ -333,26 +368,21 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // add yaw control to thrust outputs
     float rpy_low = 1.0f;   // lowest thrust value
     float rpy_high = -1.0f; // highest thrust value
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
+    for (uint8_t i = 0; i < num_motors; i++) {
+        thrust[i] += yaw_thrust * _mixer.yaw[i];
 
-            // record lowest roll + pitch + yaw command
-            if (_thrust_rpyt_out[i] < rpy_low) {
-                rpy_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch + yaw command
-            // Exclude any lost motors if thrust boost is enabled
-            if (_thrust_rpyt_out[i] > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rpy_high = _thrust_rpyt_out[i];
-            }
-        }
+        // record lowest roll + pitch + yaw command
+        rpy_low = MIN(rpy_low, thrust[i]);
+
+        // record highest roll + pitch + yaw command
+        // Exclude any lost motors if thrust boost is enabled
+        rpy_high = MAX(rpy_high, i == lost ? -1.0f : thrust[i]);
     }
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost) {
+    if (lost < num_motors) {
         // record highest roll + pitch + yaw command
-        if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_enabled[_motor_lost_index]) {
-            rpy_high = boost_ratio(rpy_high, _thrust_rpyt_out[_motor_lost_index]);
+        if (thrust[lost] > rpy_high) {
+            rpy_high = boost_ratio(rpy_high, thrust[lost]);
         }
     }
 
@@ -391,10 +421,8 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 
     // add scaled roll, pitch, constrained yaw and throttle for each motor
     const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = (throttle_thrust_best_plus_adj * _throttle_factor[i]) + (rpy_scale * _thrust_rpyt_out[i]);
-        }
+    for (uint8_t i = 0; i < num_motors; i++) {
+        _thrust_rpyt_out[_mixer.motor_index[i]] = (throttle_thrust_best_plus_adj * _mixer.throttle[i]) + (rpy_scale * thrust[i]);
     }
 
     // determine throttle thrust for harmonic notch
@@ -416,27 +444,21 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 void AP_MotorsMatrix::check_for_failed_motor(float throttle_thrust_best_plus_adj)
 {
     // record filtered and scaled thrust output for motor loss monitoring purposes
+    // this is only called from output_armed_stabilizing so the mixer is up to date
     float alpha = _dt / (_dt + 0.5f);
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out_filt[i] += alpha * (_thrust_rpyt_out[i] - _thrust_rpyt_out_filt[i]);
-        }
-    }
-
     float rpyt_high = 0.0f;
     float rpyt_sum = 0.0f;
-    uint8_t number_motors = 0.0f;
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            number_motors += 1;
-            rpyt_sum += _thrust_rpyt_out_filt[i];
-            // record highest filtered thrust command
-            if (_thrust_rpyt_out_filt[i] > rpyt_high) {
-                rpyt_high = _thrust_rpyt_out_filt[i];
-                // hold motor lost index constant while thrust boost is active
-                if (!_thrust_boost) {
-                    _motor_lost_index = i;
-                }
+    const uint8_t number_motors = _mixer.num_motors;
+    for (uint8_t m = 0; m < number_motors; m++) {
+        const uint8_t i = _mixer.motor_index[m];
+        _thrust_rpyt_out_filt[i] += alpha * (_thrust_rpyt_out[i] - _thrust_rpyt_out_filt[i]);
+        rpyt_sum += _thrust_rpyt_out_filt[i];
+        // record highest filtered thrust command
+        if (_thrust_rpyt_out_filt[i] > rpyt_high) {
+            rpyt_high = _thrust_rpyt_out_filt[i];
+            // hold motor lost index constant while thrust boost is active
+            if (!_thrust_boost) {
+                _motor_lost_index = i;
             }
         }
     }
@@ -511,6 +533,7 @@ void AP_MotorsMatrix::add_motor_raw(int8_t motor_num, float roll_fac, float pitc
 
         // enable motor
         motor_enabled[motor_num] = true;
+        mixer_changed();
 
         // set roll, pitch, yaw and throttle factors
         _roll_factor[motor_num] = roll_fac;
@@ -550,6 +573,7 @@ void AP_MotorsMatrix::remove_motor(int8_t motor_num)
     if (motor_num >= 0 && motor_num < AP_MOTORS_MAX_NUM_MOTORS) {
         // disable the motor, set all factors to zero
         motor_enabled[motor_num] = false;
+        mixer_changed();
         _roll_factor[motor_num] = 0.0f;
         _pitch_factor[motor_num] = 0.0f;
         _yaw_factor[motor_num] = 0.0f;
@@ -1338,6 +1362,7 @@ void AP_MotorsMatrix::normalise_rpy_factors()
             }
         }
     }
+    mixer_changed();
 }
 
 
@@ -1362,6 +1387,7 @@ void AP_MotorsMatrix::disable_yaw_torque(void)
     for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
         _yaw_factor[i] = 0;
     }
+    mixer_changed();
 }
 
 #if APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
@@ -127,6 +127,10 @@ protected:
     // normalizes the roll, pitch and yaw factors so maximum magnitude is 0.5
     void                normalise_rpy_factors();
 
+    // mark the compiled mixer as out of date. Must be called whenever
+    // motors are enabled or disabled or their factors are changed
+    void                mixer_changed() { _mixer.valid = false; }
+
     // call vehicle supplied thrust compensation if set
     void                thrust_compensation(void) override;
 
@@ -160,6 +164,25 @@ private:
     // helper to return value scaled between boost and normal based on the value of _thrust_boost_ratio
     float boost_ratio(float boost_value, float normal_value) const;
 
+    // pack the factors of the enabled motors into _mixer
+    void compile_mixer();
+
+    // factors of the enabled motors packed into dense arrays so that
+    // output_armed_stabilizing can run over them without per-motor
+    // branches. Rebuilt on first use after mixer_changed()
+    struct {
+        float roll[AP_MOTORS_MAX_NUM_MOTORS];
+        float pitch[AP_MOTORS_MAX_NUM_MOTORS];
+        float yaw[AP_MOTORS_MAX_NUM_MOTORS];
+        float yaw_inv[AP_MOTORS_MAX_NUM_MOTORS];    // 1/|yaw factor|, zero for motors with no yaw factor
+        float yaw_unused[AP_MOTORS_MAX_NUM_MOTORS]; // 1 for motors with no yaw factor, else zero
+        float throttle[AP_MOTORS_MAX_NUM_MOTORS];
+        uint8_t motor_index[AP_MOTORS_MAX_NUM_MOTORS];  // motor number for each entry
+        uint8_t mixer_index[AP_MOTORS_MAX_NUM_MOTORS];  // entry for each motor number, AP_MOTORS_MAX_NUM_MOTORS if not enabled
+        uint8_t num_motors;
+        bool valid;
+    } _mixer;
+
     // setup motors matrix
     bool setup_quad_matrix(motor_frame_type frame_type);
     bool setup_hexa_matrix(motor_frame_type frame_type);
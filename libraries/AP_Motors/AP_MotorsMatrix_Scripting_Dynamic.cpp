@@ -37,6 +37,7 @@ bool AP_MotorsMatrix_Scripting_Dynamic::add_motor(uint8_t motor_num, uint8_t tes
     if (motor_num < AP_MOTORS_MAX_NUM_MOTORS) {
         _test_order[motor_num] = testing_order;
         motor_enabled[motor_num] = true;
+        mixer_changed();
         return true;
     }
     return false;
@@ -51,6 +52,7 @@ void AP_MotorsMatrix_Scripting_Dynamic::load_factors(const factor_table &new_tab
     memcpy(_pitch_factor,new_table.pitch,sizeof(_pitch_factor));
     memcpy(_yaw_factor,new_table.yaw,sizeof(_yaw_factor));
     memcpy(_throttle_factor,new_table.throttle,sizeof(_throttle_factor));
+    mixer_changed();
 
 #if debug_print
     hal.console->printf("Got new factors:\n");
@@ -0,0 +1,75 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_BattMonitor/AP_BattMonitor.h>
+#include <SRV_Channel/SRV_Channel.h>
+#include <AP_Motors/tests/reference_matrix_mixer.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// singletons needed by the motors library
+static SRV_Channels srvs;
+static AP_BattMonitor battmonitor{0, nullptr, nullptr};
+
+static ReferenceMotorsMatrix motors;
+
+static const struct {
+    AP_Motors::motor_frame_class frame_class;
+    AP_Motors::motor_frame_type frame_type;
+} frames[] = {
+    { AP_Motors::MOTOR_FRAME_QUAD, AP_Motors::MOTOR_FRAME_TYPE_X },
+    { AP_Motors::MOTOR_FRAME_HEXA, AP_Motors::MOTOR_FRAME_TYPE_X },
+    { AP_Motors::MOTOR_FRAME_Y6, AP_Motors::MOTOR_FRAME_TYPE_Y6B },
+    { AP_Motors::MOTOR_FRAME_OCTA, AP_Motors::MOTOR_FRAME_TYPE_X },
+    { AP_Motors::MOTOR_FRAME_OCTAQUAD, AP_Motors::MOTOR_FRAME_TYPE_X },
+    { AP_Motors::MOTOR_FRAME_DECA, AP_Motors::MOTOR_FRAME_TYPE_X },
+    { AP_Motors::MOTOR_FRAME_DODECAHEXA, AP_Motors::MOTOR_FRAME_TYPE_X },
+};
+
+static void setup_frame(uint8_t frame)
+{
+    motors.setup_motors(frames[frame].frame_class, frames[frame].frame_type);
+    motors.set_inputs(0.2f, -0.1f, 0.3f, 0.5f, 0.5f);
+}
+
+// both mixers run through the full output_armed_stabilizing() call,
+// including the throttle limits and the motor loss check
+static void BM_MixerReference(benchmark::State& state)
+{
+    setup_frame(state.range(0));
+
+    float roll = 0.2f;
+    while (state.KeepRunning()) {
+        motors.set_roll(roll);
+        motors.output_armed_stabilizing_reference();
+        float out = motors.get_thrust_rpyt_out(0);
+        gbenchmark_escape(&out);
+        roll = -roll;
+    }
+}
+
+static void BM_MixerCompiled(benchmark::State& state)
+{
+    setup_frame(state.range(0));
+
+    float roll = 0.2f;
+    while (state.KeepRunning()) {
+        motors.set_roll(roll);
+        motors.output_armed_stabilizing();
+        float out = motors.get_thrust_rpyt_out(0);
+        gbenchmark_escape(&out);
+        roll = -roll;
+    }
+}
+
+// run each benchmark over every frame
+static void frame_args(benchmark::internal::Benchmark* b)
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(frames); i++) {
+        b->Arg(i);
+    }
+}
+
+BENCHMARK(BM_MixerReference)->Apply(frame_args);
+BENCHMARK(BM_MixerCompiled)->Apply(frame_args);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,232 @@
+#pragma once
+
+/*
+  AP_MotorsMatrix with a copy of the mixer from before the motor factors
+  were compiled into dense arrays, looping over every motor slot. The
+  equivalence test and the mixer benchmark use it to run both mixers
+  through the same full output_armed_stabilizing() call
+ */
+
+#include <AP_Motors/AP_Motors.h>
+
+class ReferenceMotorsMatrix : public AP_MotorsMatrix {
+public:
+    using AP_MotorsMatrix::setup_motors;
+    using AP_MotorsMatrix::remove_motor;
+    using AP_MotorsMatrix::output_armed_stabilizing;
+
+    // everything the mixer reads from the previous call or writes
+    struct State {
+        AP_Motors_limit limit;
+        float thrust_rpyt_out[AP_MOTORS_MAX_NUM_MOTORS];
+        float thrust_rpyt_out_filt[AP_MOTORS_MAX_NUM_MOTORS];
+        float throttle_out;
+        float thrust_boost_ratio;
+        uint8_t motor_lost_index;
+        bool thrust_boost;
+        bool thrust_balanced;
+    };
+
+    void save(State &s) const {
+        s.limit = limit;
+        memcpy(s.thrust_rpyt_out, _thrust_rpyt_out, sizeof(s.thrust_rpyt_out));
+        memcpy(s.thrust_rpyt_out_filt, _thrust_rpyt_out_filt, sizeof(s.thrust_rpyt_out_filt));
+        s.throttle_out = _throttle_out;
+        s.thrust_boost_ratio = _thrust_boost_ratio;
+        s.motor_lost_index = _motor_lost_index;
+        s.thrust_boost = _thrust_boost;
+        s.thrust_balanced = _thrust_balanced;
+    }
+
+    void restore(const State &s) {
+        limit = s.limit;
+        memcpy(_thrust_rpyt_out, s.thrust_rpyt_out, sizeof(_thrust_rpyt_out));
+        memcpy(_thrust_rpyt_out_filt, s.thrust_rpyt_out_filt, sizeof(_thrust_rpyt_out_filt));
+        _throttle_out = s.throttle_out;
+        _thrust_boost_ratio = s.thrust_boost_ratio;
+        _motor_lost_index = s.motor_lost_index;
+        _thrust_boost = s.thrust_boost;
+        _thrust_balanced = s.thrust_balanced;
+    }
+
+    void set_inputs(float roll, float pitch, float yaw, float throttle, float throttle_avg_max) {
+        set_roll(roll);
+        set_pitch(pitch);
+        set_yaw(yaw);
+        set_throttle_avg_max(throttle_avg_max);
+        _throttle_filter.reset(throttle);
+        _throttle_thrust_max = 1.0f;
+    }
+
+    // start thrust boost with the given motor lost
+    void set_lost_motor(uint8_t motor_lost_index, float thrust_boost_ratio) {
+        _thrust_boost = true;
+        _thrust_balanced = false;
+        _motor_lost_index = motor_lost_index;
+        _thrust_boost_ratio = thrust_boost_ratio;
+    }
+
+    void output_armed_stabilizing_reference() {
+        const float compensation_gain = thr_lin.get_compensation_gain();
+        const float roll_thrust = (_roll_in + _roll_in_ff) * compensation_gain;
+        const float pitch_thrust = (_pitch_in + _pitch_in_ff) * compensation_gain;
+        float yaw_thrust = (_yaw_in + _yaw_in_ff) * compensation_gain;
+        float throttle_thrust = get_throttle() * compensation_gain;
+        float throttle_avg_max = _throttle_avg_max * compensation_gain;
+        const float throttle_thrust_max = boost_ratio_reference(1.0, _throttle_thrust_max * compensation_gain);
+
+        if (throttle_thrust <= 0.0f) {
+            throttle_thrust = 0.0f;
+            limit.throttle_lower = true;
+        }
+        if (throttle_thrust >= throttle_thrust_max) {
+            throttle_thrust = throttle_thrust_max;
+            limit.throttle_upper = true;
+        }
+        throttle_avg_max = constrain_float(throttle_avg_max, throttle_thrust, throttle_thrust_max);
+        float throttle_thrust_best_rpy = MIN(0.5f, throttle_avg_max);
+
+        float yaw_allowed = 1.0f;
+        for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+            if (motor_enabled[i]) {
+                _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
+                if (!is_zero(_yaw_factor[i]) && (!_thrust_boost || i != _motor_lost_index)) {
+                    const float thrust_rp_best_throttle = throttle_thrust_best_rpy + _thrust_rpyt_out[i];
+                    float motor_room;
+                    if (is_positive(yaw_thrust * _yaw_factor[i])) {
+                        motor_room = 1.0 - thrust_rp_best_throttle;
+                    } else {
+                        motor_room = thrust_rp_best_throttle;
+                    }
+                    const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(_yaw_factor[i]);
+                    yaw_allowed = MIN(yaw_allowed, motor_yaw_allowed);
+                }
+            }
+        }
+
+        float yaw_allowed_min = (float)_yaw_headroom * 0.001f;
+        yaw_allowed_min = boost_ratio_reference(0.5, yaw_allowed_min);
+        yaw_allowed = MAX(yaw_allowed, yaw_allowed_min);
+
+        if (_thrust_boost && motor_enabled[_motor_lost_index]) {
+            if (!is_zero(_yaw_factor[_motor_lost_index])) {
+                const float thrust_rp_best_throttle = throttle_thrust_best_rpy + _thrust_rpyt_out[_motor_lost_index];
+                float motor_room;
+                if (is_positive(yaw_thrust * _yaw_factor[_motor_lost_index])) {
+                    motor_room = 1.0 - thrust_rp_best_throttle;
+                } else {
+                    motor_room = thrust_rp_best_throttle;
+                }
+                const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(_yaw_factor[_motor_lost_index]);
+                yaw_allowed = boost_ratio_reference(yaw_allowed, MIN(yaw_allowed, motor_yaw_allowed));
+            }
+        }
+
+        if (fabsf(yaw_thrust) > yaw_allowed) {
+            yaw_thrust = constrain_float(yaw_thrust, -yaw_allowed, yaw_allowed);
+            limit.yaw = true;
+        }
+
+        float rpy_low = 1.0f;
+        float rpy_high = -1.0f;
+        for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+            if (motor_enabled[i]) {
+                _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
+                if (_thrust_rpyt_out[i] < rpy_low) {
+                    rpy_low = _thrust_rpyt_out[i];
+                }
+                if (_thrust_rpyt_out[i] > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
+                    rpy_high = _thrust_rpyt_out[i];
+                }
+            }
+        }
+        if (_thrust_boost) {
+            if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_enabled[_motor_lost_index]) {
+                rpy_high = boost_ratio_reference(rpy_high, _thrust_rpyt_out[_motor_lost_index]);
+            }
+        }
+
+        float rpy_scale = 1.0f;
+        if (rpy_high - rpy_low > 1.0f) {
+            rpy_scale = 1.0f / (rpy_high - rpy_low);
+        }
+        if (throttle_avg_max + rpy_low < 0) {
+            rpy_scale = MIN(rpy_scale, -throttle_avg_max / rpy_low);
+        }
+
+        rpy_high *= rpy_scale;
+        rpy_low *= rpy_scale;
+        throttle_thrust_best_rpy = -rpy_low;
+        float thr_adj = throttle_thrust - throttle_thrust_best_rpy;
+        if (rpy_scale < 1.0f) {
+            limit.roll = true;
+            limit.pitch = true;
+            limit.yaw = true;
+            if (thr_adj > 0.0f) {
+                limit.throttle_upper = true;
+            }
+            thr_adj = 0.0f;
+        } else if (thr_adj < 0.0f) {
+            thr_adj = 0.0f;
+        } else if (thr_adj > 1.0f - (throttle_thrust_best_rpy + rpy_high)) {
+            thr_adj = 1.0f - (throttle_thrust_best_rpy + rpy_high);
+            limit.throttle_upper = true;
+        }
+
+        const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
+        for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+            if (motor_enabled[i]) {
+                _thrust_rpyt_out[i] = (throttle_thrust_best_plus_adj * _throttle_factor[i]) + (rpy_scale * _thrust_rpyt_out[i]);
+            }
+        }
+
+        _throttle_out = throttle_thrust_best_plus_adj / compensation_gain;
+
+        check_for_failed_motor_reference(throttle_thrust_best_plus_adj);
+    }
+
+private:
+    float boost_ratio_reference(float boost_value, float normal_value) const {
+        return _thrust_boost_ratio * boost_value + (1.0 - _thrust_boost_ratio) * normal_value;
+    }
+
+    void check_for_failed_motor_reference(float throttle_thrust_best_plus_adj) {
+        float alpha = _dt / (_dt + 0.5f);
+        for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+            if (motor_enabled[i]) {
+                _thrust_rpyt_out_filt[i] += alpha * (_thrust_rpyt_out[i] - _thrust_rpyt_out_filt[i]);
+            }
+        }
+
+        float rpyt_high = 0.0f;
+        float rpyt_sum = 0.0f;
+        uint8_t number_motors = 0.0f;
+        for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+            if (motor_enabled[i]) {
+                number_motors += 1;
+                rpyt_sum += _thrust_rpyt_out_filt[i];
+                if (_thrust_rpyt_out_filt[i] > rpyt_high) {
+                    rpyt_high = _thrust_rpyt_out_filt[i];
+                    if (!_thrust_boost) {
+                        _motor_lost_index = i;
+                    }
+                }
+            }
+        }
+
+        float thrust_balance = 1.0f;
+        if (rpyt_sum > 0.1f) {
+            thrust_balance = rpyt_high * number_motors / rpyt_sum;
+        }
+        if (number_motors >= 6 && thrust_balance >= 1.5f && _thrust_balanced) {
+            _thrust_balanced = false;
+        }
+        if (thrust_balance <= 1.25f && !_thrust_balanced) {
+            _thrust_balanced = true;
+        }
+
+        if ((_throttle_thrust_max * thr_lin.get_compensation_gain() > throttle_thrust_best_plus_adj) && (rpyt_high < 0.9f) && _thrust_balanced) {
+            _thrust_boost = false;
+        }
+    }
+};
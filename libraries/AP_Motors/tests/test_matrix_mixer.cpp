@@ -0,0 +1,154 @@
+#include <AP_gtest.h>
+
+#include <AP_BattMonitor/AP_BattMonitor.h>
+#include <SRV_Channel/SRV_Channel.h>
+#include "reference_matrix_mixer.h"
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// singletons needed by the motors library
+static SRV_Channels srvs;
+static AP_BattMonitor battmonitor{0, nullptr, nullptr};
+
+static ReferenceMotorsMatrix motors;
+
+static const struct {
+    float roll, pitch, yaw, throttle, throttle_avg_max;
+} inputs[] = {
+    { 0.1f, -0.05f, 0.05f, 0.5f, 0.5f },
+    // roll and pitch saturation
+    { 1.0f, 1.0f, 0.0f, 0.5f, 0.5f },
+    { -0.8f, 0.6f, 0.4f, 0.9f, 0.9f },
+    // yaw limited by the motor headroom, both directions
+    { 0.2f, -0.1f, 1.0f, 0.5f, 0.5f },
+    { 0.3f, 0.3f, -1.0f, 0.7f, 0.8f },
+    // throttle at and beyond its limits
+    { 0.3f, -0.3f, 0.3f, 0.0f, 0.0f },
+    { 0.3f, 0.3f, -0.3f, 1.0f, 1.0f },
+    { 0.05f, 0.05f, 0.05f, 1.2f, 1.0f },
+    { 0.2f, 0.0f, 0.1f, -0.1f, 0.2f },
+};
+
+static const int16_t yaw_headrooms[] { 0, 200, 500 };
+
+#define MIXER_TOLERANCE 1.0e-5f
+
+static void expect_state_eq(const ReferenceMotorsMatrix::State &ref, const ReferenceMotorsMatrix::State &out, const char *what)
+{
+    SCOPED_TRACE(what);
+    EXPECT_EQ(ref.limit.roll, out.limit.roll);
+    EXPECT_EQ(ref.limit.pitch, out.limit.pitch);
+    EXPECT_EQ(ref.limit.yaw, out.limit.yaw);
+    EXPECT_EQ(ref.limit.throttle_lower, out.limit.throttle_lower);
+    EXPECT_EQ(ref.limit.throttle_upper, out.limit.throttle_upper);
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        EXPECT_NEAR(ref.thrust_rpyt_out[i], out.thrust_rpyt_out[i], MIXER_TOLERANCE);
+        EXPECT_NEAR(ref.thrust_rpyt_out_filt[i], out.thrust_rpyt_out_filt[i], MIXER_TOLERANCE);
+    }
+    EXPECT_NEAR(ref.throttle_out, out.throttle_out, MIXER_TOLERANCE);
+    EXPECT_EQ(ref.motor_lost_index, out.motor_lost_index);
+    EXPECT_EQ(ref.thrust_boost, out.thrust_boost);
+    EXPECT_EQ(ref.thrust_balanced, out.thrust_balanced);
+}
+
+/*
+  run the reference and compiled mixers from the same state for a few
+  loops and check they give the same outputs, limits and motor loss
+  detection
+ */
+static void check_mixers(const char *what)
+{
+    const uint8_t num_loops = 5;
+    ReferenceMotorsMatrix::State start, ref[num_loops], out;
+
+    motors.save(start);
+    for (uint8_t n = 0; n < num_loops; n++) {
+        motors.limit = {};
+        motors.output_armed_stabilizing_reference();
+        motors.save(ref[n]);
+    }
+
+    motors.restore(start);
+    for (uint8_t n = 0; n < num_loops; n++) {
+        motors.limit = {};
+        motors.output_armed_stabilizing();
+        motors.save(out);
+        expect_state_eq(ref[n], out, what);
+    }
+}
+
+TEST(AP_MotorsMatrix, MixerMatchesReference)
+{
+    motors.set_dt(0.0025f);
+    uint16_t num_frames = 0;
+
+    for (uint8_t frame_class = AP_Motors::MOTOR_FRAME_QUAD; frame_class <= AP_Motors::MOTOR_FRAME_DYNAMIC_SCRIPTING_MATRIX; frame_class++) {
+        for (uint8_t frame_type = AP_Motors::MOTOR_FRAME_TYPE_PLUS; frame_type <= AP_Motors::MOTOR_FRAME_TYPE_Y4; frame_type++) {
+            motors.setup_motors(AP_Motors::motor_frame_class(frame_class), AP_Motors::motor_frame_type(frame_type));
+            if (!motors.initialised_ok()) {
+                continue;
+            }
+            num_frames++;
+
+            char frame[32];
+            motors.get_frame_and_type_string(frame, sizeof(frame));
+
+            for (const auto &in : inputs) {
+                motors.set_inputs(in.roll, in.pitch, in.yaw, in.throttle, in.throttle_avg_max);
+                for (const int16_t yaw_headroom : yaw_headrooms) {
+                    motors.set_yaw_headroom(yaw_headroom);
+
+                    // normal operation, starting from no motor loss
+                    ReferenceMotorsMatrix::State clear {};
+                    clear.thrust_balanced = true;
+                    motors.restore(clear);
+                    check_mixers(frame);
+
+                    // thrust boost with an enabled and a disabled motor
+                    // lost, part way into and fully into the boost
+                    for (const uint8_t lost : { uint8_t(0), uint8_t(3), uint8_t(AP_MOTORS_MAX_NUM_MOTORS-1) }) {
+                        for (const float ratio : { 0.5f, 1.0f }) {
+                            motors.restore(clear);
+                            motors.set_lost_motor(lost, ratio);
+                            check_mixers(frame);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // quad, hexa, octa, octaquad, y6, dodecahexa and deca frames
+    EXPECT_GT(num_frames, 20);
+}
+
+// the mixer must follow changes to the motor factors
+TEST(AP_MotorsMatrix, MixerFollowsFactorChanges)
+{
+    motors.set_dt(0.0025f);
+    motors.setup_motors(AP_Motors::MOTOR_FRAME_HEXA, AP_Motors::MOTOR_FRAME_TYPE_X);
+    ASSERT_TRUE(motors.initialised_ok());
+    motors.set_inputs(0.2f, -0.1f, 0.3f, 0.5f, 0.5f);
+    motors.set_yaw_headroom(200);
+
+    ReferenceMotorsMatrix::State clear {};
+    clear.thrust_balanced = true;
+
+    // prime the compiled mixer, then change the factors under it
+    motors.restore(clear);
+    motors.output_armed_stabilizing();
+
+    motors.set_throttle_factor(2, 0.5f);
+    motors.restore(clear);
+    check_mixers("throttle factor");
+
+    motors.remove_motor(4);
+    motors.restore(clear);
+    check_mixers("motor removed");
+
+    motors.disable_yaw_torque();
+    motors.restore(clear);
+    check_mixers("yaw torque disabled");
+}
+
+AP_GTEST_MAIN()
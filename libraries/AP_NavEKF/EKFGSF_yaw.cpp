@@ -92,8 +92,11 @@ void EKFGSF_yaw::update(const Vector3F &delAng,
     }
 
     // Always run the AHRS prediction cycle for each model
+    preparePrediction();
+    ftype sin_yaw[N_MODELS_EKFGSF];
+    ftype cos_yaw[N_MODELS_EKFGSF];
     for (uint8_t mdl_idx = 0; mdl_idx < N_MODELS_EKFGSF; mdl_idx++) {
-        predict(mdl_idx);
+        predict(mdl_idx, sin_yaw[mdl_idx], cos_yaw[mdl_idx]);
     }
 
     if (vel_fuse_running && !run_ekf_gsf) {
@@ -105,8 +108,8 @@ void EKFGSF_yaw::update(const Vector3F &delAng,
     // equal to the weighting value before it is summed.
     Vector2F yaw_vector;
     for (uint8_t mdl_idx = 0; mdl_idx < N_MODELS_EKFGSF; mdl_idx++) {
-        yaw_vector[0] += GSF.weights[mdl_idx] * cosF(EKF[mdl_idx].X[2]);
-        yaw_vector[1] += GSF.weights[mdl_idx] * sinF(EKF[mdl_idx].X[2]);
+        yaw_vector[0] += GSF.weights[mdl_idx] * cos_yaw[mdl_idx];
+        yaw_vector[1] += GSF.weights[mdl_idx] * sin_yaw[mdl_idx];
     }
     GSF.yaw = atan2F(yaw_vector[1],yaw_vector[0]);
 
@@ -191,24 +194,15 @@ void EKFGSF_yaw::fuseVelData(const Vector2F &vel, const ftype velAcc)
     }
 }
 
-void EKFGSF_yaw::predictAHRS(const uint8_t mdl_idx)
+void EKFGSF_yaw::preparePrediction()
 {
-    // Generate attitude solution using simple complementary filter for the selected model
-
-    // Calculate 'k' unit vector of earth frame rotated into body frame
-    const Vector3F k{AHRS[mdl_idx].R[2][0], AHRS[mdl_idx].R[2][1], AHRS[mdl_idx].R[2][2]};
-
     // Calculate angular rate vector in rad/sec averaged across last sample interval
     const Vector3F ang_rate_delayed_raw { delta_angle / angle_dt };
 
-    // Perform angular rate correction using accel data and reduce correction as accel magnitude moves away from 1 g (reduces drift when vehicle picked up and moved).
+    // Reduce the accel correction as accel magnitude moves away from 1 g (reduces drift when vehicle picked up and moved).
     // During fixed wing flight, compensate for centripetal acceleration assuming coordinated turns and X axis forward
-
-    Vector3F tilt_error_gyro_correction; // (rad/sec)
-
     if (accel_gain > 0.0f) {
-
-        Vector3F accel = ahrs_accel;
+        pred.accel = ahrs_accel;
 
         if (is_positive(true_airspeed)) {
             // Calculate centripetal acceleration in body frame from cross product of body rate and body frame airspeed vector
@@ -219,18 +213,39 @@ void EKFGSF_yaw::predictAHRS(const uint8_t mdl_idx)
                 - ang_rate_delayed_raw[1] * true_airspeed
             };
             // Correct measured accel for centripetal acceleration
-            accel -= centripetal_accel_vec_bf;
+            pred.accel -= centripetal_accel_vec_bf;
         }
 
-        tilt_error_gyro_correction = (k % accel) * (accel_gain / ahrs_accel_norm);
+        pred.tilt_gain = accel_gain / ahrs_accel_norm;
+    }
 
+    // Only learn gyro bias when turning slowly
+    const ftype spinRate_squared = ang_rate_delayed_raw.length_squared();
+    pred.learn_gyro_bias = spinRate_squared < sq(0.175f);
+    pred.bias_gain = EKFGSF_gyroBiasGain * angle_dt;
+
+    // Use fixed values for delta velocity and delta angle process noise variances
+    pred.dvxVar = sq(EKFGSF_accelNoise * velocity_dt);
+    pred.dazVar = sq(EKFGSF_gyroNoise * angle_dt);
+}
+
+void EKFGSF_yaw::predictAHRS(const uint8_t mdl_idx)
+{
+    // Generate attitude solution using simple complementary filter for the selected model
+
+    // Calculate 'k' unit vector of earth frame rotated into body frame
+    const Vector3F k{AHRS[mdl_idx].R[2][0], AHRS[mdl_idx].R[2][1], AHRS[mdl_idx].R[2][2]};
+
+    // Perform angular rate correction using accel data
+    Vector3F tilt_error_gyro_correction; // (rad/sec)
+    if (accel_gain > 0.0f) {
+        tilt_error_gyro_correction = (k % pred.accel) * pred.tilt_gain;
     }
 
     // Gyro bias estimation
     const ftype gyro_bias_limit = radians(5.0f);
-    const ftype spinRate_squared = ang_rate_delayed_raw.length_squared();
-    if (spinRate_squared < sq(0.175f)) {
-        AHRS[mdl_idx].gyro_bias -= tilt_error_gyro_correction * (EKFGSF_gyroBiasGain * angle_dt);
+    if (pred.learn_gyro_bias) {
+        AHRS[mdl_idx].gyro_bias -= tilt_error_gyro_correction * pred.bias_gain;
 
         // sanity check
         if (AHRS[mdl_idx].gyro_bias.is_nan()) {
@@ -315,13 +330,15 @@ void EKFGSF_yaw::alignYaw()
 }
 
 // predict states and covariance for specified model index
-void EKFGSF_yaw::predict(const uint8_t mdl_idx)
+void EKFGSF_yaw::predict(const uint8_t mdl_idx, ftype &sin_yaw, ftype &cos_yaw)
 {
     // generate an attitude reference using IMU data
     predictAHRS(mdl_idx);
 
     // we don't start running the EKF part of the algorithm until there are regular velocity observations
     if (!vel_fuse_running) {
+        sin_yaw = sinF(EKF[mdl_idx].X[2]);
+        cos_yaw = cosF(EKF[mdl_idx].X[2]);
         return;
     }
 
@@ -334,10 +351,14 @@ void EKFGSF_yaw::predict(const uint8_t mdl_idx)
         EKF[mdl_idx].X[2] = atan2F(-AHRS[mdl_idx].R[0][1], AHRS[mdl_idx].R[1][1]); // first rotation (yaw)
     }
 
+    // the sine and cosine of yaw are used by the velocity rotation, the covariance prediction and the caller
+    sin_yaw = sinF(EKF[mdl_idx].X[2]);
+    cos_yaw = cosF(EKF[mdl_idx].X[2]);
+
     // calculate delta velocity in a horizontal front-right frame
     const Vector3F del_vel_NED = AHRS[mdl_idx].R * delta_velocity;
-    const ftype dvx =   del_vel_NED[0] * cosF(EKF[mdl_idx].X[2]) + del_vel_NED[1] * sinF(EKF[mdl_idx].X[2]);
-    const ftype dvy = - del_vel_NED[0] * sinF(EKF[mdl_idx].X[2]) + del_vel_NED[1] * cosF(EKF[mdl_idx].X[2]);
+    const ftype dvx =   del_vel_NED[0] * cos_yaw + del_vel_NED[1] * sin_yaw;
+    const ftype dvy = - del_vel_NED[0] * sin_yaw + del_vel_NED[1] * cos_yaw;
 
     // sum delta velocities in earth frame:
     EKF[mdl_idx].X[0] += del_vel_NED[0];
@@ -358,12 +379,12 @@ void EKFGSF_yaw::predict(const uint8_t mdl_idx)
     const ftype P22 = EKF[mdl_idx].P[2][2];
 
     // Use fixed values for delta velocity and delta angle process noise variances
-    const ftype dvxVar = sq(EKFGSF_accelNoise * velocity_dt); // variance of forward delta velocity - (m/s)^2
+    const ftype dvxVar = pred.dvxVar; // variance of forward delta velocity - (m/s)^2
     const ftype dvyVar = dvxVar; // variance of right delta velocity - (m/s)^2
-    const ftype dazVar = sq(EKFGSF_gyroNoise * angle_dt); // variance of yaw delta angle - rad^2
+    const ftype dazVar = pred.dazVar; // variance of yaw delta angle - rad^2
 
-    const ftype t2 = sinF(EKF[mdl_idx].X[2]);
-    const ftype t3 = cosF(EKF[mdl_idx].X[2]);
+    const ftype t2 = sin_yaw;
+    const ftype t3 = cos_yaw;
     const ftype t4 = dvy*t3;
     const ftype t5 = dvx*t2;
     const ftype t6 = t4+t5;
@@ -88,6 +88,20 @@ private:
     ftype ahrs_accel_norm;          // length of body frame specific force vector used by AHRS calculation (m/s/s)
     ftype true_airspeed;            // true airspeed used to correct for centripetal acceleratoin in coordinated turns (m/s)
 
+    // Quantities derived from the latest IMU data that are the same for every model, calculated
+    // once per update so the models only do the work that depends on their own states.
+    struct {
+        Vector3F accel;             // filtered specific force corrected for centripetal acceleration (m/s/s)
+        ftype tilt_gain;            // gain from the cross product of the earth 'k' vector and accel to gyro correction
+        ftype bias_gain;            // gain from gyro correction to the change in gyro bias
+        bool learn_gyro_bias;       // true when the turn rate is low enough for the gyro bias to be learned
+        ftype dvxVar;               // variance of forward and right delta velocity - (m/s)^2
+        ftype dazVar;               // variance of yaw delta angle - rad^2
+    } pred;
+
+    // Calculates the quantities shared by the prediction of every model
+    void preparePrediction();
+
     // Runs quaternion prediction for the selected AHRS using IMU (and optionally true airspeed) data
     void predictAHRS(const uint8_t mdl_idx);
 
@@ -115,8 +129,9 @@ private:
     // Resets states and covariances for the EKF's and GSF including GSF weights, but not the AHRS complementary filters
     void resetEKFGSF();
 
-    // Runs the state and covariance prediction for the selected EKF
-    void predict(const uint8_t mdl_idx);
+    // Runs the state and covariance prediction for the selected EKF, returning the sine and cosine
+    // of its yaw state
+    void predict(const uint8_t mdl_idx, ftype &sin_yaw, ftype &cos_yaw);
 
     // Runs the state and covariance update for the selected EKF using the GPS NE velocity measurement
     // Returns false if the sttae and covariance correction failed
@@ -45,12 +45,64 @@ uint32_t ekf_ring_buffer::time_ms(uint8_t idx) const
     return el->time_ms;
 }
 
+/*
+  get the buffer index of the element n places after the oldest
+ */
+uint8_t ekf_ring_buffer::index(uint8_t n) const
+{
+    const uint16_t idx = uint16_t(oldest) + n;
+    return idx >= size ? idx - size : idx;
+}
+
 /*
   Search through a ring buffer and return the newest data that is
   older than the time specified by sample_time_ms
   Returns false if no data can be found that is less than 100msec old
 */
 bool ekf_ring_buffer::recall(void *element, const uint32_t sample_time_ms)
+{
+    if (!ordered) {
+        return recall_unordered(element, sample_time_ms);
+    }
+
+    // with the timestamps in order the elements no younger than
+    // sample_time_ms are all at the start of the buffer, so binary
+    // search for the number of them
+    uint8_t low = 0;
+    uint8_t high = count;
+    while (low < high) {
+        const uint8_t mid = (low + high) / 2;
+        const int32_t dt = sample_time_ms - time_ms(index(mid));
+        if (dt >= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        // the oldest element is younger than we want
+        return false;
+    }
+
+    // the newest of them is the best match, provided it is recent
+    // enough. They are all discarded either way
+    const uint8_t best_index = index(low - 1);
+    const int32_t dt = sample_time_ms - time_ms(best_index);
+    const bool ret = dt < 100;
+    if (ret) {
+        memcpy(element, get_offset(best_index), elsize);
+    }
+    oldest = index(low);
+    count -= low;
+
+    return ret;
+}
+
+/*
+  linear search through the ring buffer, returning the same element as
+  recall() but without relying on the timestamps being in order
+*/
+bool ekf_ring_buffer::recall_unordered(void *element, const uint32_t sample_time_ms)
 {
     bool ret = false;
     uint8_t best_index = 0;  // only valid when ret becomes true
@@ -71,6 +123,10 @@ bool ekf_ring_buffer::recall(void *element, const uint32_t sample_time_ms)
         count--;
         oldest = (oldest+1) % size;
     }
+    if (count == 0) {
+        // an empty buffer is in order again
+        ordered = true;
+    }
 
     if (ret) {
         memcpy(element, get_offset(best_index), elsize);
@@ -90,7 +146,14 @@ void ekf_ring_buffer::push(const void *element)
     }
 
     // Advance head to next available index
-    const uint8_t head = (oldest+count) % size;
+    const uint8_t head = index(count);
+
+    // note if this element is older than the newest one, so recall()
+    // can't rely on the order of the timestamps
+    if (count > 0 &&
+        int32_t(((const EKF_obs_element_t *)element)->time_ms - time_ms(index(count-1))) < 0) {
+        ordered = false;
+    }
 
     // New data is written at the head
     memcpy(get_offset(head), element, elsize);
@@ -108,6 +171,7 @@ void ekf_ring_buffer::reset()
 {
     count = 0;
     oldest = 0;
+    ordered = true;
 }
 
 ////////////////////////////////////////////////////
@@ -27,6 +27,7 @@ public:
      * time specified by sample_time_ms
      * Zeros old data so it cannot not be used again
      * Returns false if no data can be found that is less than 100msec old
+     * This is a binary search while the buffered timestamps are in order
     */
     bool recall(void *element, const uint32_t sample_time_ms);
 
@@ -52,8 +53,17 @@ private:
     // total number of elements in the buffer
     uint8_t count;
 
+    // true when the buffered timestamps are known to be in order
+    bool ordered;
+
     uint32_t time_ms(uint8_t idx) const;
     void *get_offset(uint8_t idx) const;
+
+    // buffer index of the element n places after the oldest
+    uint8_t index(uint8_t n) const;
+
+    // linear search used when the timestamps are out of order
+    bool recall_unordered(void *element, const uint32_t sample_time_ms);
 };
 
 /*
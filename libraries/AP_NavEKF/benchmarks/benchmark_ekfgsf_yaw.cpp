@@ -0,0 +1,55 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_NavEKF/EKFGSF_yaw.h>
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  cost per EKF core of the yaw estimator, for an IMU update with and
+  without a GPS velocity update, once velocity fusion is running
+ */
+static EKFGSF_yaw *running_estimator()
+{
+    EKFGSF_yaw *gsf = NEW_NOTHROW EKFGSF_yaw();
+    const ftype dt = 0.0025;
+    const Vector3F delAng { 0, 0.05 * dt, 0.2 * dt };
+    const Vector3F delVel { 0.1 * dt, 0.2 * dt, -GRAVITY_MSS * dt };
+    for (uint16_t i=0; i<400; i++) {
+        gsf->update(delAng, delVel, dt, dt, true, 0);
+        gsf->fuseVelData(Vector2F(5, 2), 0.5);
+    }
+    return gsf;
+}
+
+static void BM_EKFGSF_update(benchmark::State& state)
+{
+    EKFGSF_yaw *gsf = running_estimator();
+    const ftype dt = 0.0025;
+    const Vector3F delAng { 0, 0.05 * dt, 0.2 * dt };
+    const Vector3F delVel { 0.1 * dt, 0.2 * dt, -GRAVITY_MSS * dt };
+    while (state.KeepRunning()) {
+        gsf->update(delAng, delVel, dt, dt, true, 0);
+        gbenchmark_escape(gsf);
+    }
+    delete gsf;
+}
+
+static void BM_EKFGSF_updateAndFuse(benchmark::State& state)
+{
+    EKFGSF_yaw *gsf = running_estimator();
+    const ftype dt = 0.0025;
+    const Vector3F delAng { 0, 0.05 * dt, 0.2 * dt };
+    const Vector3F delVel { 0.1 * dt, 0.2 * dt, -GRAVITY_MSS * dt };
+    while (state.KeepRunning()) {
+        gsf->update(delAng, delVel, dt, dt, true, 0);
+        gsf->fuseVelData(Vector2F(5, 2), 0.5);
+        gbenchmark_escape(gsf);
+    }
+    delete gsf;
+}
+
+BENCHMARK(BM_EKFGSF_update);
+BENCHMARK(BM_EKFGSF_updateAndFuse);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,59 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_NavEKF/EKF_Buffer.h>
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+struct test_data : EKF_obs_element_t {
+    uint32_t data[8];
+};
+
+/*
+  steady state use: one sample pushed and one recalled per update, with
+  the fusion time horizon lagging the newest sample by state.range(0)
+  samples
+ */
+static void BM_RingBufferRecallSteady(benchmark::State& state)
+{
+    EKF_obs_buffer_t<test_data> buf;
+    buf.init(state.range(0) + 2);
+    test_data d {};
+    uint32_t now_ms = 1000;
+    while (state.KeepRunning()) {
+        d.time_ms = now_ms;
+        buf.push(d);
+        test_data d2;
+        gbenchmark_escape(&d2);
+        benchmark::DoNotOptimize(buf.recall(d2, now_ms - 10*state.range(0)));
+        now_ms += 10;
+    }
+}
+
+/*
+  a buffer filled and then recalled in one go, as after a sensor
+  catches up or the time horizon jumps forward. The time includes
+  the pushes
+ */
+static void BM_RingBufferRecallFull(benchmark::State& state)
+{
+    EKF_obs_buffer_t<test_data> buf;
+    buf.init(state.range(0));
+    test_data d {};
+    uint32_t now_ms = 1000;
+    while (state.KeepRunning()) {
+        for (uint8_t i=0; i<state.range(0); i++) {
+            d.time_ms = now_ms;
+            buf.push(d);
+            now_ms += 10;
+        }
+        test_data d2;
+        gbenchmark_escape(&d2);
+        benchmark::DoNotOptimize(buf.recall(d2, now_ms));
+    }
+}
+
+BENCHMARK(BM_RingBufferRecallSteady)->Arg(4)->Arg(16)->Arg(48);
+BENCHMARK(BM_RingBufferRecallFull)->Arg(4)->Arg(16)->Arg(48);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,67 @@
+#include <AP_gtest.h>
+
+/*
+  tests for AP_NavEKF/EKFGSF_yaw.cpp
+ */
+
+#include <AP_NavEKF/EKFGSF_yaw.h>
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+/*
+  fly a coordinated turn at constant speed, starting from level flight
+  with an unknown heading, and check the yaw estimate converges on the
+  true heading
+ */
+TEST(EKFGSF_yaw, CoordinatedTurn)
+{
+    EKFGSF_yaw *gsf = NEW_NOTHROW EKFGSF_yaw();
+    ASSERT_NE(gsf, nullptr);
+
+    const ftype dt = 0.0025;
+    const ftype airspeed = 12;
+    const ftype bank = radians(20);
+    ftype yaw = 1.0;
+    ftype roll = 0;
+    for (uint32_t i=0; i<400*40; i++) {
+        const ftype t = i * dt;
+
+        // roll into the turn after 5 seconds
+        const ftype roll_rate = (t > 5 && t <= 6) ? bank : 0;
+        roll += roll_rate * dt;
+        const ftype yaw_rate = GRAVITY_MSS * tanF(roll) / airspeed;
+        yaw = wrap_PI(yaw + yaw_rate * dt);
+
+        const Vector3F delAng { roll_rate * dt, yaw_rate * sinF(roll) * dt, yaw_rate * cosF(roll) * dt };
+        const Vector3F delVel { 0, 0, -GRAVITY_MSS / cosF(roll) * dt };
+        gsf->update(delAng, delVel, dt, dt, t > 2, airspeed);
+
+        // GPS velocity at 5Hz
+        if (i % 80 == 0) {
+            gsf->fuseVelData(Vector2F(airspeed * cosF(yaw), airspeed * sinF(yaw)), 0.3);
+        }
+
+        ftype yaw_est, yaw_variance;
+        if (t < 2) {
+            // no estimate until velocity fusion has started
+            EXPECT_FALSE(gsf->getYawData(yaw_est, yaw_variance));
+        }
+    }
+
+    ftype yaw_est, yaw_variance;
+    ASSERT_TRUE(gsf->getYawData(yaw_est, yaw_variance));
+    EXPECT_LT(fabsF(wrap_PI(yaw_est - yaw)), radians(2));
+    EXPECT_LT(yaw_variance, sq(radians(5)));
+    ftype vel_innov_length;
+    ASSERT_TRUE(gsf->getVelInnovLength(vel_innov_length));
+    EXPECT_LT(vel_innov_length, 0.1);
+
+    delete gsf;
+}
+
+AP_GTEST_MAIN()
+
+#endif // HAL_SITL or HAL_LINUX
@@ -122,6 +122,111 @@ TEST(EKF_Buffer, EKF_Buffer)
     EXPECT_FALSE(buf.recall(d2, 103));
 }
 
+/*
+  the linear search recall() used before it took advantage of ordered
+  timestamps, used to check the results are unchanged
+ */
+class reference_ring_buffer {
+public:
+    void push(uint32_t time_ms, uint32_t data) {
+        const uint8_t head = (oldest+count) % SIZE;
+        times[head] = time_ms;
+        datas[head] = data;
+        if (count < SIZE) {
+            count++;
+        } else {
+            oldest = (oldest+1) % SIZE;
+        }
+    }
+
+    bool recall(uint32_t &data, uint32_t sample_time_ms) {
+        bool ret = false;
+        while (count > 0) {
+            const int32_t dt = sample_time_ms - times[oldest];
+            if (dt >= 0 && dt < 100) {
+                data = datas[oldest];
+                ret = true;
+            }
+            if (dt < 0) {
+                break;
+            }
+            count--;
+            oldest = (oldest+1) % SIZE;
+        }
+        return ret;
+    }
+
+    static const uint8_t SIZE = 12;
+
+private:
+    uint32_t times[SIZE];
+    uint32_t datas[SIZE];
+    uint8_t oldest;
+    uint8_t count;
+};
+
+// push and recall a random sequence of elements, checking every
+// recall against the reference implementation
+static void check_against_reference(uint32_t start_ms, uint8_t out_of_order_percent)
+{
+    struct test_data : EKF_obs_element_t {
+        uint32_t data;
+    };
+    EKF_obs_buffer_t<test_data> buf;
+    buf.init(reference_ring_buffer::SIZE);
+    reference_ring_buffer ref {};
+
+    uint32_t now_ms = start_ms;
+    uint32_t last_push_ms = start_ms;
+    uint32_t data = 0;
+    for (uint16_t i=0; i<5000; i++) {
+        now_ms += 1 + random() % 40;
+        // push with a varying lag, sometimes out of order
+        const uint8_t pushes = random() % 4;
+        for (uint8_t j=0; j<pushes; j++) {
+            test_data d;
+            d.time_ms = now_ms - random() % 20;
+            if (uint8_t(random() % 100) < out_of_order_percent) {
+                d.time_ms -= random() % 150;
+            } else if (out_of_order_percent == 0 && int32_t(d.time_ms - last_push_ms) < 0) {
+                d.time_ms = last_push_ms;
+            }
+            last_push_ms = d.time_ms;
+            d.data = data++;
+            buf.push(d);
+            ref.push(d.time_ms, d.data);
+        }
+
+        // recall on a delayed time horizon which occasionally jumps
+        uint32_t sample_time_ms = now_ms - 50 - random() % 30;
+        if (random() % 50 == 0) {
+            sample_time_ms -= 200;
+        }
+        test_data d2 {};
+        uint32_t expected_data = 0;
+        const bool expected = ref.recall(expected_data, sample_time_ms);
+        ASSERT_EQ(expected, buf.recall(d2, sample_time_ms));
+        if (expected) {
+            ASSERT_EQ(expected_data, d2.data);
+        }
+    }
+}
+
+TEST(EKF_Buffer, MatchesReference)
+{
+    srandom(42);
+    check_against_reference(100, 0);
+    // across the 32 bit time wrap
+    check_against_reference(0xFFFFFFFFU - 50000U, 0);
+}
+
+TEST(EKF_Buffer, MatchesReferenceOutOfOrder)
+{
+    srandom(43);
+    check_against_reference(100, 5);
+    check_against_reference(0xFFFFFFFFU - 50000U, 30);
+}
+
 TEST(ekf_imu_buffer, one_element_case)
 {
     // test degenerate 1-element case:
@@ -3,6 +3,7 @@
 #include <AP_HAL/AP_HAL.h>
 
 #include "AP_NavEKF3_core.h"
+#include "AP_NavEKF3_CoreWorkers.h"
 #include <GCS_MAVLink/GCS.h>
 #include <AP_Logger/AP_Logger.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
@@ -738,8 +739,8 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
 
     // @Param: OPTIONS
     // @DisplayName: Optional EKF behaviour
-    // @Description: This controls optional EKF behaviour. Setting JammingExpected will change the EKF nehaviour such that if dead reckoning navigation is possible it will require the preflight alignment GPS quality checks controlled by EK3_GPS_CHECK and EK3_CHECK_SCALE to pass before resuming GPS use if GPS lock is lost for more than 2 seconds to prevent bad
-    // @Bitmask: 0:JammingExpected
+    // @Description: This controls optional EKF behaviour. Setting JammingExpected will change the EKF nehaviour such that if dead reckoning navigation is possible it will require the preflight alignment GPS quality checks controlled by EK3_GPS_CHECK and EK3_CHECK_SCALE to pass before resuming GPS use if GPS lock is lost for more than 2 seconds to prevent bad. Setting ParallelCores updates each EKF lane on its own thread on Linux boards, which reduces the main loop time taken by the EKF when there are spare CPU cores
+    // @Bitmask: 0:JammingExpected, 1:ParallelCores
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  11, NavEKF3, _options, 0),
 
@@ -902,6 +903,57 @@ bool NavEKF3::coreBetterScore(uint8_t new_core, uint8_t current_core) const
     return coreRelativeErrors[new_core] < coreRelativeErrors[current_core];
 }
 
+// true if a core may run its state prediction step this frame
+bool NavEKF3::allowStatePrediction(uint8_t core_index)
+{
+    // if we have not overrun by more than 3 IMU frames, and we
+    // have already used more than 1/3 of the CPU budget for this
+    // loop then suppress the prediction step. This allows
+    // multiple EKF instances to cooperate on scheduling
+    if (core[core_index].getFramesSincePredict() < (_framesPerPrediction+3) &&
+        dal.ekf_low_time_remaining(AP_DAL::EKFType::EKF3, core_index)) {
+        return false;
+    }
+    return true;
+}
+
+#if EK3_FEATURE_PARALLEL_CORES
+/*
+  update the cores on worker threads when EK3_OPTIONS ParallelCores is
+  set. Cores only share state through the frontend while the common
+  origin is being set, so until then they are updated one after
+  another to keep the result independent of thread timing
+ */
+bool NavEKF3::updateCoresParallel(void)
+{
+    if (!option_is_enabled(Option::ParallelCores) || num_cores < 2 || !common_origin_valid) {
+        return false;
+    }
+    if (core_workers == nullptr) {
+        if (core_workers_failed) {
+            return false;
+        }
+        core_workers = NEW_NOTHROW NavEKF3_CoreWorkers();
+        if (core_workers == nullptr || !core_workers->init(core, num_cores)) {
+            // no threads were started so it is safe to free
+            delete core_workers;
+            core_workers = nullptr;
+            core_workers_failed = true;
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "EKF3 parallel cores unavailable");
+            return false;
+        }
+    }
+
+    // decide on prediction for all cores before any of them start
+    bool allow_state_prediction[MAX_EKF_CORES];
+    for (uint8_t i=0; i<num_cores; i++) {
+        allow_state_prediction[i] = allowStatePrediction(i);
+    }
+    core_workers->update(allow_state_prediction);
+    return true;
+}
+#endif
+
 /* 
   Update Filter States - this should be called whenever new IMU data is available
   Execution speed governed by SCHED_LOOP_RATE
@@ -916,17 +968,14 @@ void NavEKF3::UpdateFilter(void)
 
     imuSampleTime_us = dal.micros64();
 
-    for (uint8_t i=0; i<num_cores; i++) {
-        // if we have not overrun by more than 3 IMU frames, and we
-        // have already used more than 1/3 of the CPU budget for this
-        // loop then suppress the prediction step. This allows
-        // multiple EKF instances to cooperate on scheduling
-        bool allow_state_prediction = true;
-        if (core[i].getFramesSincePredict() < (_framesPerPrediction+3) &&
-            dal.ekf_low_time_remaining(AP_DAL::EKFType::EKF3, i)) {
-            allow_state_prediction = false;
+    bool cores_updated = false;
+#if EK3_FEATURE_PARALLEL_CORES
+    cores_updated = updateCoresParallel();
+#endif
+    if (!cores_updated) {
+        for (uint8_t i=0; i<num_cores; i++) {
+            core[i].UpdateFilter(allowStatePrediction(i));
         }
-        core[i].UpdateFilter(allow_state_prediction);
     }
 
     // If the current core selected has a bad error score or is unhealthy, switch to a healthy core with the lowest fault score
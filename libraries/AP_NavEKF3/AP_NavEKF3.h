@@ -24,8 +24,10 @@
 #include <AP_Param/AP_Param.h>
 #include <AP_NavEKF/AP_Nav_Common.h>
 #include <AP_NavEKF/AP_NavEKF_Source.h>
+#include "AP_NavEKF3_feature.h"
 
 class NavEKF3_core;
+class NavEKF3_CoreWorkers;
 class EKFGSF_yaw;
 
 class NavEKF3 {
@@ -455,6 +457,7 @@ private:
     // enum for processing options
     enum class Option {
         JammingExpected     = (1<<0),
+        ParallelCores       = (1<<1),
     };
     bool option_is_enabled(Option option) const {
         return (_options & (uint32_t)option) != 0;
@@ -509,6 +512,20 @@ private:
     // last time of Log_Write
     uint64_t lastLogWrite_us;
 
+#if EK3_FEATURE_PARALLEL_CORES
+    // worker threads for EK3_OPTIONS ParallelCores, started on first use
+    NavEKF3_CoreWorkers *core_workers;
+    bool core_workers_failed;
+    uint32_t lastCoreWorkersLog_ms;
+
+    // update the cores on the worker threads, returning false if
+    // they need to be updated one after another
+    bool updateCoresParallel(void);
+#endif
+
+    // true if a core may run its state prediction step this frame
+    bool allowStatePrediction(uint8_t core_index);
+
     struct {
         uint32_t last_function_call;  // last time getLastYawResetAngle was called
         bool core_changed;            // true when a core change happened and hasn't been consumed, false otherwise
@@ -0,0 +1,111 @@
+#include "AP_NavEKF3_CoreWorkers.h"
+
+#if EK3_FEATURE_PARALLEL_CORES
+
+#include "AP_NavEKF3_core.h"
+
+#include <AP_Logger/AP_Logger.h>
+#include <AP_Scheduler/AP_Scheduler_config.h>
+
+extern const AP_HAL::HAL& hal;
+
+bool NavEKF3_CoreWorkers::init(NavEKF3_core *cores, uint8_t num_cores)
+{
+    _cores = cores;
+    _num_cores = num_cores;
+
+    const uint8_t num_workers = MIN(num_cores-1, int(ARRAY_SIZE(_workers)));
+    for (uint8_t i=0; i<num_workers; i++) {
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&NavEKF3_CoreWorkers::worker_thread, void),
+                                          "ekf3-core",
+                                          16384, AP_HAL::Scheduler::PRIORITY_MAIN, 0)) {
+            break;
+        }
+        _num_workers++;
+    }
+    return _num_workers > 0;
+}
+
+void NavEKF3_CoreWorkers::worker_thread()
+{
+    uint8_t worker_index;
+    {
+        WITH_SEMAPHORE(_sem);
+        worker_index = _next_worker_index++;
+    }
+    // keep off the CPUs of the main loop where the HAL supports it,
+    // placing the cores after the scheduler task workers so they
+    // don't share a CPU while there are enough CPUs to go round
+    hal.scheduler->set_worker_thread_affinity(AP_SCHEDULER_MAX_WORKERS + worker_index);
+
+    Worker &worker = _workers[worker_index];
+    NavEKF3_core &core = _cores[worker_index+1];
+    while (true) {
+        if (!worker.start.wait_blocking()) {
+            continue;
+        }
+        const uint32_t start_us = AP_HAL::micros();
+        core.UpdateFilter(worker.allow_state_prediction);
+        worker.time_us = AP_HAL::micros() - start_us;
+        worker.done.signal();
+    }
+}
+
+void NavEKF3_CoreWorkers::update(const bool allow_state_prediction[])
+{
+    const uint32_t start_us = AP_HAL::micros();
+    for (uint8_t i=0; i<_num_workers; i++) {
+        _workers[i].allow_state_prediction = allow_state_prediction[i+1];
+        _workers[i].start.signal();
+    }
+
+    // the first core, and any without a worker, run here
+    _cores[0].UpdateFilter(allow_state_prediction[0]);
+    for (uint8_t i=_num_workers+1; i<_num_cores; i++) {
+        _cores[i].UpdateFilter(allow_state_prediction[i]);
+    }
+    uint32_t serial_us = AP_HAL::micros() - start_us;
+
+    // wait for all workers before lane selection looks at the cores
+    for (uint8_t i=0; i<_num_workers; i++) {
+        _workers[i].done.wait_blocking();
+        serial_us += _workers[i].time_us;
+    }
+
+    const uint32_t wall_us = AP_HAL::micros() - start_us;
+    _stats.count++;
+    _stats.serial_us += serial_us;
+    _stats.wall_us += wall_us;
+    _stats.max_wall_us = MAX(_stats.max_wall_us, wall_us);
+}
+
+void NavEKF3_CoreWorkers::Log_Write_Stats()
+{
+#if HAL_LOGGING_ENABLED
+    if (_stats.count == 0) {
+        return;
+    }
+    const uint32_t serial_us = _stats.serial_us / _stats.count;
+    const uint32_t wall_us = _stats.wall_us / _stats.count;
+
+// @LoggerMessage: XKPC
+// @Description: EKF3 parallel core update timing
+// @Field: TimeUS: Time since system startup
+// @Field: N: number of updates since the last message
+// @Field: Ser: average time the cores would have taken updated one after another
+// @Field: Par: average time taken to update the cores in parallel
+// @Field: Max: longest time taken to update the cores in parallel
+// @Field: Saved: average time saved per update
+    AP::logger().WriteStreaming("XKPC", "TimeUS,N,Ser,Par,Max,Saved",
+                                "s-ssss", "F-FFFF", "QIIIIi",
+                                AP_HAL::micros64(),
+                                _stats.count,
+                                serial_us,
+                                wall_us,
+                                _stats.max_wall_us,
+                                int32_t(serial_us - wall_us));
+#endif
+    _stats = {};
+}
+
+#endif // EK3_FEATURE_PARALLEL_CORES
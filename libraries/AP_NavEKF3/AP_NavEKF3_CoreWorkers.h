@@ -0,0 +1,65 @@
+#pragma once
+
+#include "AP_NavEKF3_feature.h"
+
+#if EK3_FEATURE_PARALLEL_CORES
+
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/Semaphores.h>
+
+#include "AP_NavEKF3.h"
+
+/*
+  worker threads that update EKF3 cores in parallel. The first core
+  is updated on the calling thread and each other core on its own
+  worker. update() returns once every core has finished, so lane
+  selection sees the same core states as it would after a sequential
+  update
+ */
+class NavEKF3_CoreWorkers {
+public:
+    NavEKF3_CoreWorkers() {}
+
+    /* Do not allow copies */
+    CLASS_NO_COPY(NavEKF3_CoreWorkers);
+
+    // start a worker for each core after the first, returns false if
+    // none could be started
+    bool init(NavEKF3_core *cores, uint8_t num_cores);
+
+    // update all cores, returning once they have all been updated
+    void update(const bool allow_state_prediction[]);
+
+    // log the time saved against updating the cores one after another
+    void Log_Write_Stats();
+
+private:
+    struct Worker {
+        HAL_BinarySemaphore start;
+        HAL_BinarySemaphore done;
+        bool allow_state_prediction;
+        uint32_t time_us;
+    };
+
+    void worker_thread();
+
+    NavEKF3_core *_cores;
+    uint8_t _num_cores;
+
+    Worker _workers[MAX_EKF_CORES-1];
+    uint8_t _num_workers;
+
+    HAL_Semaphore _sem;
+    uint8_t _next_worker_index;
+
+    // update times since the stats were last logged
+    struct {
+        uint32_t count;
+        uint64_t serial_us;     // sum of the core update times
+        uint64_t wall_us;       // time the caller spent in update()
+        uint32_t max_wall_us;
+    } _stats;
+};
+
+#endif // EK3_FEATURE_PARALLEL_CORES
@@ -0,0 +1,123 @@
+// Generated by derivation/generate_kernels.py with sympy 1.14.0, do not edit
+#pragma once
+
+// only the magnetometer fusion is generated, the other fusion and the
+// covariance prediction are maintained by hand
+
+#include <AP_Math/AP_Math.h>
+
+namespace EK3_Generated {
+
+/*
+  innovation variances of the X, Y and Z magnetometer axes
+  with measurement noise variance R_MAG
+ */
+template <typename T, typename MatrixT>
+inline void mag_innovation_variance(const MatrixT &P, T q0, T q1, T q2, T q3, T magN, T magE, T magD, T R_MAG, T innovVar[3])
+{
+    const T IV0 = q0*q3;
+    const T IV1 = q1*q2;
+    const T IV2 = 2*IV0 + 2*IV1;
+    const T IV3 = q0*q2;
+    const T IV4 = q1*q3;
+    const T IV5 = 2*IV3 - 2*IV4;
+    const T IV6 = 2*magD*q3 + 2*magE*q2 + 2*magN*q1;
+    const T IV7 = -2*magD*q2 + 2*magE*q3 + 2*magN*q0;
+    const T IV8 = 2*magD*q0 - 2*magE*q1 + 2*magN*q2;
+    const T IV9 = 2*magD*q1 + 2*magE*q0 - 2*magN*q3;
+    const T IV10 = sq(q1);
+    const T IV11 = sq(q2);
+    const T IV12 = -IV11;
+    const T IV13 = sq(q0);
+    const T IV14 = sq(q3);
+    const T IV15 = IV13 - IV14;
+    const T IV16 = IV10 + IV12 + IV15;
+    const T IV17 = IV8*P[1][2];
+    const T IV18 = IV9*P[1][3];
+    const T IV19 = IV6*P[1][2];
+    const T IV20 = IV7*P[0][2];
+    const T IV21 = IV6*P[1][3];
+    const T IV22 = IV7*P[0][3];
+    const T IV23 = IV8*P[0][2];
+    const T IV24 = IV9*P[0][3];
+    const T IV25 = q0*q1;
+    const T IV26 = q2*q3;
+    const T IV27 = 2*IV25 + 2*IV26;
+    const T IV28 = 2*IV0 - 2*IV1;
+    const T IV29 = -IV10;
+    const T IV30 = IV11 + IV15 + IV29;
+    const T IV31 = IV7*P[2][3];
+    const T IV32 = IV9*P[0][1];
+    const T IV33 = IV8*P[0][1];
+    const T IV34 = IV6*P[2][3];
+    const T IV35 = 2*IV3 + 2*IV4;
+    const T IV36 = 2*IV25 - 2*IV26;
+    const T IV37 = IV12 + IV13 + IV14 + IV29;
+
+    innovVar[0] = IV16*P[16][19] + IV16*(IV16*P[16][16] + IV2*P[16][17] - IV5*P[16][18] + IV6*P[1][16] + IV7*P[0][16] - IV8*P[2][16] + IV9*P[3][16] + P[16][19]) + IV2*P[17][19] + IV2*(IV16*P[16][17] + IV2*P[17][17] - IV5*P[17][18] + IV6*P[1][17] + IV7*P[0][17] - IV8*P[2][17] + IV9*P[3][17] + P[17][19]) - IV5*P[18][19] - IV5*(IV16*P[16][18] + IV2*P[17][18] - IV5*P[18][18] + IV6*P[1][18] + IV7*P[0][18] - IV8*P[2][18] + IV9*P[3][18] + P[18][19]) + IV6*P[1][19] + IV6*(IV16*P[1][16] - IV17 + IV18 + IV2*P[1][17] - IV5*P[1][18] + IV6*P[1][1] + IV7*P[0][1] + P[1][19]) + IV7*P[0][19] + IV7*(IV16*P[0][16] + IV2*P[0][17] - IV23 + IV24 - IV5*P[0][18] + IV6*P[0][1] + IV7*P[0][0] + P[0][19]) - IV8*P[2][19] - IV8*(IV16*P[2][16] + IV19 + IV2*P[2][17] + IV20 - IV5*P[2][18] - IV8*P[2][2] + IV9*P[2][3] + P[2][19]) + IV9*P[3][19] + IV9*(IV16*P[3][16] + IV2*P[3][17] + IV21 + IV22 - IV5*P[3][18] - IV8*P[2][3] + IV9*P[3][3] + P[3][19]) + P[19][19] + R_MAG;
+    innovVar[1] = IV27*P[18][20] + IV27*(IV27*P[18][18] - IV28*P[16][18] + IV30*P[17][18] + IV6*P[2][18] - IV7*P[3][18] + IV8*P[1][18] + IV9*P[0][18] + P[18][20]) - IV28*P[16][20] - IV28*(IV27*P[16][18] - IV28*P[16][16] + IV30*P[16][17] + IV6*P[2][16] - IV7*P[3][16] + IV8*P[1][16] + IV9*P[0][16] + P[16][20]) + IV30*P[17][20] + IV30*(IV27*P[17][18] - IV28*P[16][17] + IV30*P[17][17] + IV6*P[2][17] - IV7*P[3][17] + IV8*P[1][17] + IV9*P[0][17] + P[17][20]) + IV6*P[2][20] + IV6*(IV17 + IV27*P[2][18] - IV28*P[2][16] + IV30*P[2][17] - IV31 + IV6*P[2][2] + IV9*P[0][2] + P[2][20]) - IV7*P[3][20] - IV7*(IV24 + IV27*P[3][18] - IV28*P[3][16] + IV30*P[3][17] + IV34 - IV7*P[3][3] + IV8*P[1][3] + P[3][20]) + IV8*P[1][20] + IV8*(IV19 + IV27*P[1][18] - IV28*P[1][16] + IV30*P[1][17] + IV32 - IV7*P[1][3] + IV8*P[1][1] + P[1][20]) + IV9*P[0][20] + IV9*(-IV22 + IV27*P[0][18] - IV28*P[0][16] + IV30*P[0][17] + IV33 + IV6*P[0][2] + IV9*P[0][0] + P[0][20]) + P[20][20] + R_MAG;
+    innovVar[2] = IV35*P[16][21] + IV35*(IV35*P[16][16] - IV36*P[16][17] + IV37*P[16][18] + IV6*P[3][16] + IV7*P[2][16] + IV8*P[0][16] - IV9*P[1][16] + P[16][21]) - IV36*P[17][21] - IV36*(IV35*P[16][17] - IV36*P[17][17] + IV37*P[17][18] + IV6*P[3][17] + IV7*P[2][17] + IV8*P[0][17] - IV9*P[1][17] + P[17][21]) + IV37*P[18][21] + IV37*(IV35*P[16][18] - IV36*P[17][18] + IV37*P[18][18] + IV6*P[3][18] + IV7*P[2][18] + IV8*P[0][18] - IV9*P[1][18] + P[18][21]) + IV6*P[3][21] + IV6*(-IV18 + IV31 + IV35*P[3][16] - IV36*P[3][17] + IV37*P[3][18] + IV6*P[3][3] + IV8*P[0][3] + P[3][21]) + IV7*P[2][21] + IV7*(IV23 + IV34 + IV35*P[2][16] - IV36*P[2][17] + IV37*P[2][18] + IV7*P[2][2] - IV9*P[1][2] + P[2][21]) + IV8*P[0][21] + IV8*(IV20 - IV32 + IV35*P[0][16] - IV36*P[0][17] + IV37*P[0][18] + IV6*P[0][3] + IV8*P[0][0] + P[0][21]) - IV9*P[1][21] - IV9*(IV21 + IV33 + IV35*P[1][16] - IV36*P[1][17] + IV37*P[1][18] + IV7*P[1][2] - IV9*P[1][1] + P[1][21]) + P[21][21] + R_MAG;
+}
+
+/*
+  observation jacobians of the X, Y and Z magnetometer axes.
+  Column j of H_MAG is state j for j < 4 and state j + 12 above
+  that, the jacobian for the bias of the axis is 1 and the
+  others are 0
+ */
+template <typename T>
+inline void mag_observation_jacobian(T q0, T q1, T q2, T q3, T magN, T magE, T magD, T H_MAG[3][7])
+{
+    const T HK0 = -magD*q2 + magE*q3 + magN*q0;
+    const T HK1 = 2*HK0;
+    const T HK2 = 2*(magD*q3 + magE*q2 + magN*q1);
+    const T HK3 = magD*q0 - magE*q1 + magN*q2;
+    const T HK4 = magD*q1 + magE*q0 - magN*q3;
+    const T HK5 = 2*HK4;
+    const T HK6 = sq(q1);
+    const T HK7 = sq(q2);
+    const T HK8 = -HK7;
+    const T HK9 = sq(q0);
+    const T HK10 = sq(q3);
+    const T HK11 = -HK10 + HK9;
+    const T HK12 = q0*q3;
+    const T HK13 = q0*q2;
+    const T HK14 = 2*HK3;
+    const T HK15 = -HK6;
+    const T HK16 = q0*q1;
+
+    H_MAG[0][0] = HK1;
+    H_MAG[0][1] = HK2;
+    H_MAG[0][2] = -2*HK3;
+    H_MAG[0][3] = HK5;
+    H_MAG[0][4] = HK11 + HK6 + HK8;
+    H_MAG[0][5] = 2*HK12 + 2*q1*q2;
+    H_MAG[0][6] = -2*HK13 + 2*q1*q3;
+    H_MAG[1][0] = HK5;
+    H_MAG[1][1] = HK14;
+    H_MAG[1][2] = HK2;
+    H_MAG[1][3] = -2*HK0;
+    H_MAG[1][4] = -2*HK12 + 2*q1*q2;
+    H_MAG[1][5] = HK11 + HK15 + HK7;
+    H_MAG[1][6] = 2*HK16 + 2*q2*q3;
+    H_MAG[2][0] = HK14;
+    H_MAG[2][1] = -2*HK4;
+    H_MAG[2][2] = HK1;
+    H_MAG[2][3] = HK2;
+    H_MAG[2][4] = 2*HK13 + 2*q1*q3;
+    H_MAG[2][5] = -2*HK16 + 2*q2*q3;
+    H_MAG[2][6] = HK10 + HK15 + HK8 + HK9;
+}
+
+/*
+  Kalman gain of state row for magnetometer axis
+  with jacobian H from mag_observation_jacobian() and
+  SK the inverse of the innovation variance
+ */
+template <typename T, typename MatrixT>
+inline void mag_kalman_gain(const MatrixT &P, uint8_t row, uint8_t axis, const T H[7], T SK, T &K)
+{
+    K = SK*(H[0]*P[row][0] + H[1]*P[row][1] + H[2]*P[row][2] + H[3]*P[row][3] + H[4]*P[row][16] + H[5]*P[row][17] + H[6]*P[row][18] + P[row][19 + axis]);
+}
+
+} // namespace EK3_Generated
@@ -4,6 +4,7 @@
 
 #include "AP_NavEKF3.h"
 #include "AP_NavEKF3_core.h"
+#include "AP_NavEKF3_CoreWorkers.h"
 
 #include <AP_HAL/HAL.h>
 #include <AP_Logger/AP_Logger.h>
@@ -374,6 +375,13 @@ void NavEKF3::Log_Write()
         core[i].Log_Write(time_us);
     }
 
+#if EK3_FEATURE_PARALLEL_CORES
+    if (core_workers != nullptr && dal.millis() - lastCoreWorkersLog_ms >= 1000) {
+        lastCoreWorkersLog_ms = dal.millis();
+        core_workers->Log_Write_Stats();
+    }
+#endif
+
     AP::dal().start_frame(AP_DAL::FrameType::LogWriteEKF3);
 }
 
@@ -46,3 +46,8 @@
 #ifndef EK3_FEATURE_OPTFLOW_FUSION
 #define EK3_FEATURE_OPTFLOW_FUSION HAL_NAVEKF3_AVAILABLE && AP_OPTICALFLOW_ENABLED
 #endif
+
+// update cores on worker threads on Linux boards, enabled with EK3_OPTIONS
+#ifndef EK3_FEATURE_PARALLEL_CORES
+#define EK3_FEATURE_PARALLEL_CORES (CONFIG_HAL_BOARD == HAL_BOARD_LINUX) && !APM_BUILD_TYPE(APM_BUILD_Replay) && !APM_BUILD_TYPE(APM_BUILD_AP_DAL_Standalone)
+#endif
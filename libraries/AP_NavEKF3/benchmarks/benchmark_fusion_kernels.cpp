@@ -0,0 +1,104 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_NavEKF3/AP_NavEKF3_GeneratedKernels.h>
+#include <AP_NavEKF3/tests/reference_kernels.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  cost of evaluating the magnetometer innovation variances and Kalman
+  gains, with the generated kernels and the hand written equations
+  they replaced
+ */
+template <typename T>
+struct MagFusionInputs {
+    MagFusionInputs() {
+        for (uint8_t i=0; i<24; i++) {
+            for (uint8_t j=0; j<24; j++) {
+                P[i][j] = (i == j) ? 0.1 : 1.0e-3 * (i + j);
+            }
+        }
+    }
+    T P[24][24];
+    T q[4] { 0.9, 0.1, -0.2, 0.3 };
+    T mag[3] { 0.25, 0.05, 0.4 };
+    T R_MAG = 2.5e-3;
+    T innovVar[3] { 0.3, 0.4, 0.5 };
+};
+
+template <typename T>
+static void BM_MagInnovVarGenerated(benchmark::State& state)
+{
+    MagFusionInputs<T> in;
+    T innovVar[3];
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&in);
+        EK3_Generated::mag_innovation_variance(in.P, in.q[0], in.q[1], in.q[2], in.q[3],
+                                               in.mag[0], in.mag[1], in.mag[2], in.R_MAG, innovVar);
+        gbenchmark_escape(innovVar);
+    }
+}
+
+template <typename T>
+static void BM_MagInnovVarReference(benchmark::State& state)
+{
+    MagFusionInputs<T> in;
+    T innovVar[3];
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&in);
+        reference_mag_innovation_variance(in.P, in.q[0], in.q[1], in.q[2], in.q[3],
+                                          in.mag[0], in.mag[1], in.mag[2], in.R_MAG, innovVar);
+        gbenchmark_escape(innovVar);
+    }
+}
+
+// the gains of all states for all three axes, as in one magnetometer fusion
+template <typename T>
+static void BM_MagGainGenerated(benchmark::State& state)
+{
+    MagFusionInputs<T> in;
+    T K[3][24];
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&in);
+        T H[3][7];
+        EK3_Generated::mag_observation_jacobian(in.q[0], in.q[1], in.q[2], in.q[3],
+                                                in.mag[0], in.mag[1], in.mag[2], H);
+        for (uint8_t axis=0; axis<3; axis++) {
+            const T SK = 1.0 / in.innovVar[axis];
+            for (uint8_t row=0; row<24; row++) {
+                EK3_Generated::mag_kalman_gain(in.P, row, axis, H[axis], SK, K[axis][row]);
+            }
+        }
+        gbenchmark_escape(K);
+    }
+}
+
+// the reference recomputes the shared terms for every row, which the
+// hand written code did once per axis, so this overstates its cost
+template <typename T>
+static void BM_MagGainReference(benchmark::State& state)
+{
+    MagFusionInputs<T> in;
+    T K[3][24];
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&in);
+        for (uint8_t axis=0; axis<3; axis++) {
+            for (uint8_t row=0; row<24; row++) {
+                K[axis][row] = reference_mag_kalman_gain(in.P, row, axis, in.q[0], in.q[1], in.q[2], in.q[3],
+                                                         in.mag[0], in.mag[1], in.mag[2], in.innovVar[axis]);
+            }
+        }
+        gbenchmark_escape(K);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MagInnovVarGenerated, float);
+BENCHMARK_TEMPLATE(BM_MagInnovVarReference, float);
+BENCHMARK_TEMPLATE(BM_MagInnovVarGenerated, double);
+BENCHMARK_TEMPLATE(BM_MagInnovVarReference, double);
+BENCHMARK_TEMPLATE(BM_MagGainGenerated, float);
+BENCHMARK_TEMPLATE(BM_MagGainReference, float);
+BENCHMARK_TEMPLATE(BM_MagGainGenerated, double);
+BENCHMARK_TEMPLATE(BM_MagGainReference, double);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+# Generates the fixed size fusion kernels in AP_NavEKF3_GeneratedKernels.h
+#
+# Unlike the scratch output of generate_1.py and generate_2.py the
+# kernels are written straight into the library as self contained
+# inline functions, so the generated file is committed and used as is.
+#
+# The magnetometer fusion equations (innovation variances, observation
+# jacobians and Kalman gains) are generated here. The position and
+# velocity fusion observes states directly, so there is no algebra to
+# generate, and the covariance prediction is still the CSE output of
+# generate_2.py, which is pinned to an older sympy. CI runs --check so
+# the generated header can't drift from this script.
+#
+# usage:
+#   ./generate_kernels.py          regenerate the header
+#   ./generate_kernels.py --check  fail if the committed header is stale
+import argparse
+import filecmp
+import os
+import sys
+import tempfile
+
+from sympy import __version__ as __sympy__version__
+from sympy import *
+from code_gen import *
+
+# version required to generate the exact kernels currently present in
+# ArduPilot. Any sympy upgrade must regenerate and retest the kernels
+assert __sympy__version__ == "1.14.0", "expected sympy version 1.14.0, not "+__sympy__version__
+
+HEADER_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "AP_NavEKF3_GeneratedKernels.h")
+
+# q: quaternion describing rotation from frame 1 to frame 2
+# returns a rotation matrix derived form q which describes the same
+# rotation. This is the form used by the hand written fusion code
+def quat2Rot(q):
+    q0 = q[0]
+    q1 = q[1]
+    q2 = q[2]
+    q3 = q[3]
+
+    Rot = Matrix([[q0**2 + q1**2 - q2**2 - q3**2, 2*(q1*q2 - q0*q3), 2*(q1*q3 + q0*q2)],
+                  [2*(q1*q2 + q0*q3), q0**2 - q1**2 + q2**2 - q3**2, 2*(q2*q3 - q0*q1)],
+                   [2*(q1*q3-q0*q2), 2*(q2*q3 + q0*q1), q0**2 - q1**2 - q2**2 + q3**2]])
+
+    return Rot
+
+# symmetric covariance matrix which only references the upper triangle
+def create_symmetric_cov_matrix(n):
+    return Matrix(n, n, lambda i, j: Symbol("P[" + str(min(i,j)) + "][" + str(max(i,j)) + "]", real=True))
+
+class KernelWriter(CodeGenerator):
+    def write_line(self, line=""):
+        self.file.write(line + "\n")
+
+    # write an inline function template evaluating the given common
+    # subexpressions and outputs. Kernels reading the covariance matrix
+    # take it as their first argument
+    def write_kernel(self, name, description, args, subexpressions, outputs, uses_P=True):
+        self.write_line("/*")
+        for line in description:
+            self.write_line("  " + line)
+        self.write_line(" */")
+        if uses_P:
+            self.write_line("template <typename T, typename MatrixT>")
+            args = ["const MatrixT &P"] + args
+        else:
+            self.write_line("template <typename T>")
+        self.write_line("inline void " + name + "(" + ", ".join(args) + ")")
+        self.write_line("{")
+        for (symbol, expression) in subexpressions:
+            self.write_line("    const T " + str(symbol) + " = " + self.get_ccode(expression) + ";")
+        if len(subexpressions) > 0:
+            self.write_line()
+        for (variable, expression) in outputs:
+            self.write_line("    " + variable + " = " + self.get_ccode(expression) + ";")
+        self.write_line("}")
+        self.write_line()
+
+# innovation variances for all three magnetometer axes. The axes share
+# most of their terms so they are simplified together
+def mag_innovation_variance(writer, P, state, R_to_body, i, ib):
+    obs_var = symbols("R_MAG", real=True)  # magnetometer measurement noise variance
+
+    m_mag = R_to_body * i + ib
+
+    innov_var = zeros(3,1)
+    for index in range(3):
+        H = Matrix([m_mag[index]]).jacobian(state)
+        innov_var[index] = (H * P * H.T)[0,0] + obs_var
+
+    subexpressions, simplified = cse(innov_var, symbols("IV0:1000"), optimizations='basic')
+
+    writer.write_kernel("mag_innovation_variance",
+                        ["innovation variances of the X, Y and Z magnetometer axes",
+                         "with measurement noise variance R_MAG"],
+                        ["T q0", "T q1", "T q2", "T q3", "T magN", "T magE", "T magD", "T R_MAG", "T innovVar[3]"],
+                        subexpressions,
+                        [("innovVar[%u]" % index, simplified[0][index]) for index in range(3)])
+
+# states observed by each magnetometer axis besides its own bias: the
+# quaternion and the earth field
+MAG_JACOBIAN_STATES = [0, 1, 2, 3, 16, 17, 18]
+
+# observation jacobians of the X, Y and Z magnetometer axes. Each axis
+# observes its own bias state with a jacobian of 1, so only the
+# quaternion and earth field columns are output
+def mag_observation_jacobian(writer, state, R_to_body, i, ib):
+    m_mag = R_to_body * i + ib
+
+    H_MAG = zeros(3, len(MAG_JACOBIAN_STATES))
+    for axis in range(3):
+        H = Matrix([m_mag[axis]]).jacobian(state)
+        for index in range(state.shape[0]):
+            if index == 19 + axis:
+                assert(H[index] == 1)
+            elif index not in MAG_JACOBIAN_STATES:
+                assert(H[index] == 0)
+        for column in range(len(MAG_JACOBIAN_STATES)):
+            H_MAG[axis, column] = H[MAG_JACOBIAN_STATES[column]]
+
+    subexpressions, simplified = cse(H_MAG, symbols("HK0:1000"), optimizations='basic')
+
+    writer.write_kernel("mag_observation_jacobian",
+                        ["observation jacobians of the X, Y and Z magnetometer axes.",
+                         "Column j of H_MAG is state j for j < 4 and state j + 12 above",
+                         "that, the jacobian for the bias of the axis is 1 and the",
+                         "others are 0"],
+                        ["T q0", "T q1", "T q2", "T q3", "T magN", "T magE", "T magD", "T H_MAG[3][7]"],
+                        subexpressions,
+                        [("H_MAG[%u][%u]" % (axis, column), simplified[0][axis, column])
+                         for axis in range(3) for column in range(len(MAG_JACOBIAN_STATES))],
+                        uses_P=False)
+
+# Kalman gain for one state and one magnetometer axis, K = P*H'/innovVar,
+# using the jacobian from mag_observation_jacobian()
+def mag_kalman_gain(writer):
+    H = Matrix(1, len(MAG_JACOBIAN_STATES), lambda i, j: Symbol("H[" + str(j) + "]", real=True))
+    P_row = Matrix(len(MAG_JACOBIAN_STATES), 1, lambda i, j: Symbol("P[row][" + str(MAG_JACOBIAN_STATES[i]) + "]", real=True))
+    P_bias = Symbol("P[row][19 + axis]", real=True)
+    SK = symbols("SK", real=True)  # 1 / innovation variance
+
+    K = SK * ((H * P_row)[0,0] + P_bias)
+
+    writer.write_kernel("mag_kalman_gain",
+                        ["Kalman gain of state row for magnetometer axis",
+                         "with jacobian H from mag_observation_jacobian() and",
+                         "SK the inverse of the innovation variance"],
+                        ["uint8_t row", "uint8_t axis", "const T H[7]", "T SK", "T &K"],
+                        [],
+                        [("K", K)])
+
+def generate_kernels(file_name):
+    writer = KernelWriter(file_name)
+    writer.write_line("// Generated by derivation/generate_kernels.py with sympy " + __sympy__version__ + ", do not edit")
+    writer.write_line("#pragma once")
+    writer.write_line()
+    writer.write_line("// only the magnetometer fusion is generated, the other fusion and the")
+    writer.write_line("// covariance prediction are maintained by hand")
+    writer.write_line()
+    writer.write_line("#include <AP_Math/AP_Math.h>")
+    writer.write_line()
+    writer.write_line("namespace EK3_Generated {")
+    writer.write_line()
+
+    # the states used by the kernels, the others are placeholders
+    q = Matrix(symbols("q0 q1 q2 q3", real=True))
+    i = Matrix(symbols("magN magE magD", real=True))
+    ib = Matrix(symbols("magXbias magYbias magZbias", real=True))
+    state = Matrix([q, Matrix(symbols("s4:16", real=True)), i, ib, Matrix(symbols("s22:24", real=True))])
+    assert(state.shape[0] == 24)
+    R_to_body = quat2Rot(q).T
+    P = create_symmetric_cov_matrix(24)
+
+    print('Generating magnetometer innovation variance kernel ...')
+    mag_innovation_variance(writer, P, state, R_to_body, i, ib)
+
+    print('Generating magnetometer observation jacobian kernel ...')
+    mag_observation_jacobian(writer, state, R_to_body, i, ib)
+
+    print('Generating magnetometer Kalman gain kernel ...')
+    mag_kalman_gain(writer)
+
+    writer.write_line("} // namespace EK3_Generated")
+    writer.close()
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="generate EKF3 fusion kernels")
+    parser.add_argument("--check", action="store_true", help="check the committed kernels are up to date")
+    args = parser.parse_args()
+
+    if not args.check:
+        generate_kernels(HEADER_PATH)
+        sys.exit(0)
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        file_name = os.path.join(tmpdir, "kernels.h")
+        generate_kernels(file_name)
+        if not filecmp.cmp(file_name, HEADER_PATH, shallow=False):
+            print("AP_NavEKF3_GeneratedKernels.h is out of date, run generate_kernels.py")
+            sys.exit(1)
+    print("AP_NavEKF3_GeneratedKernels.h is up to date")
@@ -0,0 +1,134 @@
+#include <AP_gtest.h>
+
+/*
+  tests for the generated kernels in AP_NavEKF3_GeneratedKernels.h,
+  checked against the hand written equations they replaced
+ */
+
+#include <AP_NavEKF3/AP_NavEKF3_GeneratedKernels.h>
+#include "reference_kernels.h"
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// repeatable pseudo random numbers between -1 and 1
+static double rand_double(uint32_t &seed)
+{
+    seed = seed * 1664525U + 1013904223U;
+    return (seed >> 8) / double(1U<<23) - 1.0;
+}
+
+// fill in a symmetric positive definite covariance matrix
+template <typename T>
+static void random_covariance(uint32_t &seed, T P[24][24])
+{
+    double A[24][24];
+    for (uint8_t i=0; i<24; i++) {
+        for (uint8_t j=0; j<24; j++) {
+            A[i][j] = 0.1 * rand_double(seed);
+        }
+    }
+    for (uint8_t i=0; i<24; i++) {
+        for (uint8_t j=0; j<24; j++) {
+            double sum = (i == j) ? 1.0e-3 : 0.0;
+            for (uint8_t k=0; k<24; k++) {
+                sum += A[i][k] * A[j][k];
+            }
+            P[i][j] = sum;
+        }
+    }
+}
+
+template <typename T>
+static void check_mag_innovation_variance(double tolerance, bool normalise_quat)
+{
+    uint32_t seed = 17;
+    for (uint16_t n=0; n<1000; n++) {
+        T P[24][24];
+        random_covariance(seed, P);
+        T q[4];
+        double length_sq = 0;
+        for (uint8_t i=0; i<4; i++) {
+            q[i] = rand_double(seed);
+            length_sq += sq(double(q[i]));
+        }
+        if (normalise_quat) {
+            for (uint8_t i=0; i<4; i++) {
+                q[i] /= sqrt(length_sq);
+            }
+        }
+        const T magN = 0.3 + 0.2 * rand_double(seed);
+        const T magE = 0.1 * rand_double(seed);
+        const T magD = 0.4 * rand_double(seed);
+        const T R_MAG = 2.5e-3;
+
+        T expected[3], result[3];
+        reference_mag_innovation_variance(P, q[0], q[1], q[2], q[3], magN, magE, magD, R_MAG, expected);
+        EK3_Generated::mag_innovation_variance(P, q[0], q[1], q[2], q[3], magN, magE, magD, R_MAG, result);
+        for (uint8_t i=0; i<3; i++) {
+            EXPECT_NEAR(expected[i], result[i], tolerance * expected[i]);
+        }
+    }
+}
+
+template <typename T>
+static void check_mag_jacobian_and_gain(double tolerance)
+{
+    uint32_t seed = 23;
+    for (uint16_t n=0; n<200; n++) {
+        T P[24][24];
+        random_covariance(seed, P);
+        T q[4];
+        for (uint8_t i=0; i<4; i++) {
+            q[i] = rand_double(seed);
+        }
+        const T magN = 0.3 + 0.2 * rand_double(seed);
+        const T magE = 0.1 * rand_double(seed);
+        const T magD = 0.4 * rand_double(seed);
+        const T R_MAG = 2.5e-3;
+
+        T expected_H[3][7], H[3][7];
+        reference_mag_observation_jacobian(q[0], q[1], q[2], q[3], magN, magE, magD, expected_H);
+        EK3_Generated::mag_observation_jacobian(q[0], q[1], q[2], q[3], magN, magE, magD, H);
+        for (uint8_t axis=0; axis<3; axis++) {
+            for (uint8_t i=0; i<7; i++) {
+                EXPECT_NEAR(expected_H[axis][i], H[axis][i], tolerance);
+            }
+        }
+
+        T innovVar[3];
+        EK3_Generated::mag_innovation_variance(P, q[0], q[1], q[2], q[3], magN, magE, magD, R_MAG, innovVar);
+        for (uint8_t axis=0; axis<3; axis++) {
+            for (uint8_t row=0; row<24; row++) {
+                const T expected = reference_mag_kalman_gain(P, row, axis, q[0], q[1], q[2], q[3], magN, magE, magD, innovVar[axis]);
+                T K;
+                EK3_Generated::mag_kalman_gain(P, row, axis, H[axis], T(1.0 / innovVar[axis]), K);
+                EXPECT_NEAR(expected, K, tolerance * MAX(fabs(expected), 1.0));
+            }
+        }
+    }
+}
+
+TEST(EK3_GeneratedKernels, MagInnovationVarianceFloat)
+{
+    check_mag_innovation_variance<float>(1.0e-5, true);
+}
+
+TEST(EK3_GeneratedKernels, MagInnovationVarianceDouble)
+{
+    check_mag_innovation_variance<double>(1.0e-12, true);
+    // the equations don't assume a unit quaternion
+    check_mag_innovation_variance<double>(1.0e-12, false);
+}
+
+TEST(EK3_GeneratedKernels, MagJacobianAndGainFloat)
+{
+    check_mag_jacobian_and_gain<float>(1.0e-5);
+}
+
+TEST(EK3_GeneratedKernels, MagJacobianAndGainDouble)
+{
+    check_mag_jacobian_and_gain<double>(1.0e-12);
+}
+
+AP_GTEST_MAIN()
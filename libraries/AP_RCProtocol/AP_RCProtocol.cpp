@@ -234,6 +234,21 @@ void AP_RCProtocol::process_pulse_list(const uint32_t *widths, uint16_t n, bool
 
 bool AP_RCProtocol::process_byte(uint8_t byte, uint32_t baudrate)
 {
+    return process_bytes(&byte, 1, baudrate);
+}
+
+/*
+  process a block of bytes. When a protocol has been detected the whole
+  block goes to its backend in one call. While searching each enabled
+  backend sees the whole block and the first protocol in backend order
+  to complete a frame is selected
+ */
+bool AP_RCProtocol::process_bytes(const uint8_t *bytes, uint16_t len, uint32_t baudrate)
+{
+    if (len == 0) {
+        return false;
+    }
+
     uint32_t now = AP_HAL::millis();
     bool searching = should_search(now);
 
@@ -253,7 +268,7 @@ bool AP_RCProtocol::process_byte(uint8_t byte, uint32_t baudrate)
 
     // first try current protocol
     if (_detected_protocol != AP_RCProtocol::NONE && !searching) {
-        backend[_detected_protocol]->process_byte(byte, baudrate);
+        backend[_detected_protocol]->process_bytes(bytes, len, baudrate);
         if (backend[_detected_protocol]->new_input()) {
             _new_input = true;
             _last_input_ms = now;
@@ -269,7 +284,7 @@ bool AP_RCProtocol::process_byte(uint8_t byte, uint32_t baudrate)
             }
             const uint32_t frame_count = backend[i]->get_rc_frame_count();
             const uint32_t input_count = backend[i]->get_rc_input_count();
-            backend[i]->process_byte(byte, baudrate);
+            backend[i]->process_bytes(bytes, len, baudrate);
             const uint32_t frame_count2 = backend[i]->get_rc_frame_count();
             if (frame_count2 > frame_count) {
                 if (requires_3_frames((rcprotocol_t)i) && frame_count2 < 3) {
@@ -368,13 +383,16 @@ void AP_RCProtocol::check_added_uart(void)
     const uint32_t current_baud = serial_configs[added.config_num].baud;
     process_handshake(current_baud);
 
+    uint8_t b[64];
     uint32_t n = added.uart->available();
     n = MIN(n, 255U);
-    for (uint8_t i=0; i<n; i++) {
-        int16_t b = added.uart->read();
-        if (b >= 0) {
-            process_byte(uint8_t(b), current_baud);
+    while (n > 0) {
+        const ssize_t nread = added.uart->read(b, MIN(n, sizeof(b)));
+        if (nread <= 0) {
+            break;
         }
+        process_bytes(b, nread, current_baud);
+        n -= nread;
     }
     if (searching) {
         if (now - added.last_config_change_ms > 1000) {
@@ -222,11 +222,23 @@ void AP_RCProtocol_CRSF::process_byte(uint8_t byte, uint32_t baudrate)
     _process_byte(byte);
 }
 
+// process a block of bytes provided by a uart from rc stack
+void AP_RCProtocol_CRSF::process_bytes(const uint8_t *bytes, uint16_t len, uint32_t baudrate)
+{
+    // reject RC data if we have been configured for standalone mode
+    if ((baudrate != CRSF_BAUDRATE && baudrate != CRSF_BAUDRATE_1MBIT && baudrate != CRSF_BAUDRATE_2MBIT) || _uart) {
+        return;
+    }
+    const uint32_t now = AP_HAL::micros();
+    for (uint16_t i = 0; i < len; i++) {
+        _process_byte(now, bytes[i]);
+    }
+}
+
 // process a byte provided by a uart
-void AP_RCProtocol_CRSF::_process_byte(uint8_t byte)
+void AP_RCProtocol_CRSF::_process_byte(uint32_t now, uint8_t byte)
 {
     //debug("process_byte(0x%x)", byte);
-    const uint32_t now = AP_HAL::micros();
 
     // extra check for overflow, should never happen since it will have been handled in check_frame()
     if (_frame_ofs >= sizeof(_frame)) {
@@ -355,13 +367,19 @@ void AP_RCProtocol_CRSF::update(void)
             start_uart();
             _last_uart_start_time_ms = now;
         }
+        uint8_t b[64];
         uint32_t n = _uart->available();
         n = MIN(n, 255U);
-        for (uint8_t i = 0; i < n; i++) {
-            int16_t b = _uart->read();
-            if (b >= 0) {
-                _process_byte(uint8_t(b));
+        while (n > 0) {
+            const ssize_t nread = _uart->read(b, MIN(n, sizeof(b)));
+            if (nread <= 0) {
+                break;
+            }
+            const uint32_t now_us = AP_HAL::micros();
+            for (uint8_t i = 0; i < nread; i++) {
+                _process_byte(now_us, b[i]);
             }
+            n -= nread;
         }
     }
 
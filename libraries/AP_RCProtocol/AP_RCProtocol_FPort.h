@@ -34,6 +34,7 @@ public:
     AP_RCProtocol_FPort(AP_RCProtocol &_frontend, bool inverted);
     void process_pulse(uint32_t width_s0, uint32_t width_s1) override;
     void process_byte(uint8_t byte, uint32_t baudrate) override;
+    void process_bytes(const uint8_t *bytes, uint16_t len, uint32_t baudrate) override;
 
 private:
     void decode_control(const FPort_Frame &frame);
@@ -434,6 +434,18 @@ void AP_RCProtocol_GHST::process_byte(uint8_t byte, uint32_t baudrate)
     _process_byte(AP_HAL::micros(), byte);
 }
 
+// process a block of bytes provided by a uart
+void AP_RCProtocol_GHST::process_bytes(const uint8_t *bytes, uint16_t len, uint32_t baudrate)
+{
+    if (baudrate != CRSF_BAUDRATE && baudrate != GHST_BAUDRATE) {
+        return;
+    }
+    const uint32_t now = AP_HAL::micros();
+    for (uint16_t i = 0; i < len; i++) {
+        _process_byte(now, bytes[i]);
+    }
+}
+
 // change the bootstrap baud rate to Ghost standard if configured
 void AP_RCProtocol_GHST::process_handshake(uint32_t baudrate)
 {
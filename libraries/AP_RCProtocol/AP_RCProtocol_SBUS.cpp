@@ -213,4 +213,16 @@ void AP_RCProtocol_SBUS::process_byte(uint8_t b, uint32_t baudrate)
     _process_byte(AP_HAL::micros(), b);
 }
 
+// support block byte input, all bytes in a block share a timestamp
+void AP_RCProtocol_SBUS::process_bytes(const uint8_t *bytes, uint16_t len, uint32_t baudrate)
+{
+    if (baudrate != ss.baud()) {
+        return;
+    }
+    const uint32_t now = AP_HAL::micros();
+    for (uint16_t i = 0; i < len; i++) {
+        _process_byte(now, bytes[i]);
+    }
+}
+
 #endif  // AP_RCPROTOCOL_SBUS_ENABLED
@@ -84,10 +84,10 @@ void setup()
     delay_ms(100);
 }
 
-static bool check_result(const char *name, bool bytes, const uint16_t *values, uint8_t nvalues)
+static bool check_result(const char *name, const char *mode, const uint16_t *values, uint8_t nvalues)
 {
     char label[20];
-    snprintf(label, 20, "%s(%s)", name, bytes?"bytes":"pulses");
+    snprintf(label, 20, "%s(%s)", name, mode);
     const bool have_input = rcprot->new_input();
     if (values == nullptr) {
         if (have_input) {
@@ -146,7 +146,34 @@ static bool test_byte_protocol(const char *name, uint32_t baudrate,
         }
         delay_ms(10);
         if (repeat > repeats) {
-            ret &= check_result(name, true, values, nvalues);
+            ret &= check_result(name, "bytes", values, nvalues);
+        }
+    }
+    return ret;
+}
+
+/*
+  test a byte protocol handler using block input, with each block
+  running up to the next pause
+ */
+static bool test_block_protocol(const char *name, uint32_t baudrate,
+                                const uint8_t *bytes, uint8_t nbytes,
+                                const uint16_t *values, uint8_t nvalues,
+                                uint8_t repeats,
+                                uint8_t pause_at)
+{
+    bool ret = true;
+    const uint8_t block_len = pause_at > 0 ? pause_at : nbytes;
+    for (uint8_t repeat=0; repeat<repeats+4; repeat++) {
+        for (uint8_t i=0; i<nbytes; i += block_len) {
+            if (i > 0) {
+                delay_ms(10);
+            }
+            rcprot->process_bytes(&bytes[i], MIN(block_len, uint8_t(nbytes-i)), baudrate);
+        }
+        delay_ms(10);
+        if (repeat > repeats) {
+            ret &= check_result(name, "blocks", values, nvalues);
         }
     }
     return ret;
@@ -230,7 +257,7 @@ static bool test_pulse_protocol(const char *name, uint32_t baudrate,
         }
         send_pause(1, baudrate, 6000, inverted);
         if (repeat > repeats) {
-            ret &= check_result(name, false, values, nvalues);
+            ret &= check_result(name, "pulses", values, nvalues);
         }
     }
     return ret;
@@ -253,6 +280,11 @@ static bool test_protocol(const char *name, uint32_t baudrate,
     ret &= test_byte_protocol(name, baudrate, bytes, nbytes, values, nvalues, repeats, pause_at);
     delete rcprot;
 
+    rcprot = new AP_RCProtocol();
+    rcprot->init();
+    ret &= test_block_protocol(name, baudrate, bytes, nbytes, values, nvalues, repeats, pause_at);
+    delete rcprot;
+
     rcprot = new AP_RCProtocol();
     rcprot->init();
     ret &= test_pulse_protocol(name, baudrate, bytes, nbytes, values, nvalues, repeats, pause_at, inverted);
@@ -278,6 +310,11 @@ static bool test_protocol_bytesonly(const char *name, uint32_t baudrate,
     ret &= test_byte_protocol(name, baudrate, bytes, nbytes, values, nvalues, repeats, pause_at);
     delete rcprot;
 
+    rcprot = new AP_RCProtocol();
+    rcprot->init();
+    ret &= test_block_protocol(name, baudrate, bytes, nbytes, values, nvalues, repeats, pause_at);
+    delete rcprot;
+
     rcprot = new AP_RCProtocol();
     rcprot->init();
     ret &= test_pulse_protocol(name, baudrate, bytes, nbytes, nullptr, 0, repeats, pause_at, inverted);
@@ -308,11 +345,25 @@ static void test_random(void)
             printf("Failed to read from /dev/urandom\n");
             break;
         }
+        uint32_t t0 = AP_HAL::micros();
         for (uint32_t i=0; i<test_bytes; i++) {
             rcprot->process_byte(buf[i], b);
         }
+        const uint32_t byte_us = AP_HAL::micros() - t0;
+        delete rcprot;
+
+        // same data again using 64 byte blocks, as read from a uart
+        rcprot = new AP_RCProtocol();
+        rcprot->init();
+        t0 = AP_HAL::micros();
+        for (uint32_t i=0; i<test_bytes; i += 64) {
+            rcprot->process_bytes(&buf[i], MIN(64U, test_bytes-i), b);
+        }
+        const uint32_t block_us = AP_HAL::micros() - t0;
         delete rcprot;
         rcprot = nullptr;
+        printf("  bytes: %.1fns/byte blocks: %.1fns/byte\n",
+               byte_us*1000.0/test_bytes, block_us*1000.0/test_bytes);
     }
     free(buf);
     close(fd);
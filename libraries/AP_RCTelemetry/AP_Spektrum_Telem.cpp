@@ -579,7 +579,7 @@ void AP_Spektrum_Telem::calc_esc()
 {
 #if HAL_WITH_ESC_TELEM
     uint8_t esc = AP::esc_telem().get_max_rpm_esc();
-    const volatile AP_ESC_Telem_Backend::TelemetryData& td = AP::esc_telem().get_telem_data(esc); // ideally should rotate between ESCs
+    const AP_ESC_Telem_Backend::TelemetryData td = AP::esc_telem().get_telem_data(esc); // ideally should rotate between ESCs
     float rpm = 0.0f;
     uint16_t rpmdata = 0xFFFFU;
     if (AP::esc_telem().get_rpm(esc, rpm)) {
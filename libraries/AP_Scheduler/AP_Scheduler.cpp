@@ -70,10 +70,20 @@ const AP_Param::GroupInfo AP_Scheduler::var_info[] = {
     // @Param: OPTIONS
     // @DisplayName: Scheduling options
     // @Description: This controls optional aspects of the scheduler.
-    // @Bitmask: 0:Enable per-task perf info
+    // @Bitmask: 0:Enable per-task perf info, 1:Enable profiler histograms
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Scheduler, _options, 0),
 
+#if AP_SCHEDULER_WORKERS_ENABLED
+    // @Param: WORKERS
+    // @DisplayName: Scheduler worker threads
+    // @Description: Number of threads used to run scheduler tasks which are safe to run concurrently with the main loop. When the main process is pinned to a subset of CPUs the workers are pinned to the remaining CPUs. Set to zero to run all tasks on the main thread.
+    // @Range: 0 3
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("WORKERS",  3, AP_Scheduler, _num_workers, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -136,6 +146,17 @@ void AP_Scheduler::init(const AP_Scheduler::Task *tasks, uint8_t num_tasks, uint
     if (_options & uint8_t(Options::RECORD_TASK_INFO)) {
         perf_info.allocate_task_info(_num_tasks);
     }
+#if AP_SCHEDULER_PROFILER_ENABLED
+    if (_options & uint8_t(Options::ENABLE_PROFILER)) {
+        perf_info.allocate_profile(_num_tasks);
+    }
+#endif
+
+#if AP_SCHEDULER_WORKERS_ENABLED
+    if (_num_workers > 0) {
+        _workers.init(_num_workers, _num_tasks);
+    }
+#endif
 
     _log_performance_bit = log_performance_bit;
 
@@ -190,6 +211,12 @@ void AP_Scheduler::run(uint32_t time_available)
     uint8_t vehicle_tasks_offset = 0;
     uint8_t common_tasks_offset = 0;
 
+#if AP_SCHEDULER_WORKERS_ENABLED
+    if (_workers.running()) {
+        _workers.collect(perf_info);
+    }
+#endif
+
     for (uint8_t i=0; i<_num_tasks; i++) {
         // determine which of the common task / vehicle task to run
         bool run_vehicle_task = false;
@@ -240,6 +267,17 @@ void AP_Scheduler::run(uint32_t time_available)
                 perf_info.task_slipped(i);
             }
 
+#if AP_SCHEDULER_WORKERS_ENABLED
+            if (task.worker_safe && _workers.running()) {
+                // hand it to a worker. If the task is still busy from
+                // an earlier tick it is retried on the next tick
+                if (_workers.submit(i, task.function, task.max_time_micros)) {
+                    _last_run[i] = _tick_counter;
+                }
+                continue;
+            }
+#endif
+
             if (dt >= interval_ticks*max_task_slowdown) {
                 // we are going beyond the maximum slowdown factor for a
                 // task. This will trigger increasing the time budget
@@ -283,6 +321,9 @@ void AP_Scheduler::run(uint32_t time_available)
         }
 
         perf_info.update_task_info(i, time_taken, overrun);
+#if AP_SCHEDULER_PROFILER_ENABLED
+        perf_info.update_task_profile(i, time_taken);
+#endif
 
         if (time_taken >= time_available) {
             /*
@@ -356,6 +397,11 @@ void AP_Scheduler::loop()
         _last_loop_time_s = get_loop_period_s();
     } else {
         _last_loop_time_s = (sample_time_us - _loop_timer_start_us) * 1.0e-6;
+#if AP_SCHEDULER_PROFILER_ENABLED
+        // jitter of the fast loop start time against the loop period
+        const int32_t loop_error_us = int32_t(sample_time_us - _loop_timer_start_us) - int32_t(get_loop_period_us());
+        perf_info.update_loop_jitter(abs(loop_error_us));
+#endif
     }
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -433,6 +479,9 @@ void AP_Scheduler::update_logging()
     if (_log_performance_bit != (uint32_t)-1 &&
         AP::logger().should_log(_log_performance_bit)) {
         Log_Write_Performance();
+#if AP_SCHEDULER_PROFILER_ENABLED
+        Log_Write_Profile();
+#endif
     }
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
@@ -442,6 +491,14 @@ void AP_Scheduler::update_logging()
     } else if ((_options & uint8_t(Options::RECORD_TASK_INFO)) && !perf_info.has_task_info()) {
         perf_info.allocate_task_info(_num_tasks);
     }
+#if AP_SCHEDULER_PROFILER_ENABLED
+    // and the profiler histograms
+    if (!(_options & uint8_t(Options::ENABLE_PROFILER)) && perf_info.profiling_enabled()) {
+        perf_info.disable_profile();
+    } else if ((_options & uint8_t(Options::ENABLE_PROFILER)) && !perf_info.profiling_enabled()) {
+        perf_info.allocate_profile(_num_tasks);
+    }
+#endif
 }
 
 // Write a performance monitoring packet
@@ -473,8 +530,135 @@ void AP_Scheduler::Log_Write_Performance()
     };
     AP::logger().WriteCriticalBlock(&pkt, sizeof(pkt));
 }
+
+#if AP_SCHEDULER_PROFILER_ENABLED
+// write a PROF message for the loop jitter and each task and section
+// that ran since the last call
+void AP_Scheduler::Log_Write_Profile()
+{
+    const uint64_t now_us = AP_HAL::micros64();
+    const auto write = [now_us](uint8_t type, uint8_t id, const AP::PerfInfo::Histogram &hist) {
+        const uint32_t n = hist.total();
+        if (n == 0) {
+            return;
+        }
+        // @LoggerMessage: PROF
+        // @Description: Scheduler profiler latency summary
+        // @Field: TimeUS: Time since system startup
+        // @Field: Type: 0:loop start jitter, 1:task, 2:named section, 3:gyro to motor latency stage
+        // @Field: Id: task index, section number or latency stage, see @SYS/profile.txt for names
+        // @Field: N: number of samples
+        // @Field: P50: median
+        // @Field: P90: 90th percentile
+        // @Field: P99: 99th percentile
+        // @Field: Max: maximum
+        AP::logger().WriteStreaming("PROF",
+                                    "TimeUS,Type,Id,N,P50,P90,P99,Max",
+                                    "s-#-ssss",
+                                    "F---FFFF",
+                                    "QBBIIIII",
+                                    now_us,
+                                    type,
+                                    id,
+                                    n,
+                                    hist.percentile(50),
+                                    hist.percentile(90),
+                                    hist.percentile(99),
+                                    hist.max_us);
+    };
+
+    const AP::PerfInfo::Histogram *jitter = perf_info.get_loop_jitter_histogram();
+    if (jitter == nullptr) {
+        return;
+    }
+    write(0, 0, *jitter);
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        const AP::PerfInfo::Histogram *hist = perf_info.get_task_histogram(i);
+        if (hist != nullptr) {
+            write(1, i, *hist);
+        }
+    }
+    for (uint8_t i = 0; i < AP_SCHEDULER_PROFILER_MAX_SECTIONS; i++) {
+        const AP::PerfInfo::Section *section = perf_info.get_section(i);
+        if (section == nullptr) {
+            break;
+        }
+        write(2, i, section->hist);
+    }
+    for (uint8_t i = 0; i < uint8_t(AP::PerfInfo::GyroLatencyStage::NUM_STAGES); i++) {
+        const AP::PerfInfo::Histogram *hist = perf_info.get_gyro_latency_histogram(AP::PerfInfo::GyroLatencyStage(i));
+        if (hist != nullptr) {
+            write(3, i, *hist);
+        }
+    }
+}
+#endif  // AP_SCHEDULER_PROFILER_ENABLED
 #endif  // HAL_LOGGING_ENABLED
 
+// return the name of a task by its index in the merged task list, in
+// the same order as run() walks the vehicle and common task lists
+const char *AP_Scheduler::task_name(uint8_t task_index) const
+{
+    uint8_t vehicle_tasks_offset = 0;
+    uint8_t common_tasks_offset = 0;
+
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        bool run_vehicle_task = false;
+        if (vehicle_tasks_offset < _num_vehicle_tasks &&
+            common_tasks_offset < _num_common_tasks) {
+            run_vehicle_task = _vehicle_tasks[vehicle_tasks_offset].priority <= _common_tasks[common_tasks_offset].priority;
+        } else if (vehicle_tasks_offset < _num_vehicle_tasks) {
+            run_vehicle_task = true;
+        }
+        const char *name = run_vehicle_task ? _vehicle_tasks[vehicle_tasks_offset++].name : _common_tasks[common_tasks_offset++].name;
+        if (i == task_index) {
+            return name;
+        }
+    }
+    return "";
+}
+
+#if AP_SCHEDULER_PROFILER_ENABLED
+// display profiler histograms as text buffer for @SYS/profile.txt
+void AP_Scheduler::profile_info(ExpandingString &str)
+{
+    // a header to allow for machine parsers to determine format
+    str.printf("ProfileV1\n");
+
+    // dynamically enable the profiler
+    if (!(_options & uint8_t(Options::ENABLE_PROFILER))) {
+        _options.set(_options | uint8_t(Options::ENABLE_PROFILER));
+        return;
+    }
+
+    const AP::PerfInfo::Histogram *jitter = perf_info.get_loop_jitter_histogram();
+    if (jitter == nullptr) {
+        return;
+    }
+    jitter->print("LoopJitter", str);
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        const AP::PerfInfo::Histogram *hist = perf_info.get_task_histogram(i);
+        if (hist != nullptr && hist->total() > 0) {
+            hist->print(task_name(i), str);
+        }
+    }
+    for (uint8_t i = 0; i < AP_SCHEDULER_PROFILER_MAX_SECTIONS; i++) {
+        const AP::PerfInfo::Section *section = perf_info.get_section(i);
+        if (section == nullptr) {
+            break;
+        }
+        section->hist.print(section->name, str);
+    }
+    for (uint8_t i = 0; i < uint8_t(AP::PerfInfo::GyroLatencyStage::NUM_STAGES); i++) {
+        const auto stage = AP::PerfInfo::GyroLatencyStage(i);
+        const AP::PerfInfo::Histogram *hist = perf_info.get_gyro_latency_histogram(stage);
+        if (hist != nullptr && hist->total() > 0) {
+            hist->print(AP::PerfInfo::gyro_latency_stage_name(stage), str);
+        }
+    }
+}
+#endif  // AP_SCHEDULER_PROFILER_ENABLED
+
 // display task statistics as text buffer for @SYS/tasks.txt
 void AP_Scheduler::task_info(ExpandingString &str)
 {
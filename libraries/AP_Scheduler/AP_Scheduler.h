@@ -29,6 +29,7 @@
 #include <AP_HAL/Util.h>
 #include <AP_Math/AP_Math.h>
 #include "PerfInfo.h"       // loop perf monitoring
+#include "TaskWorkers.h"
 
 #if AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED
 #define AP_SCHEDULER_NAME_INITIALIZER(_clazz,_name) .name = #_clazz "::" #_name,
@@ -47,7 +48,23 @@
     AP_SCHEDULER_NAME_INITIALIZER(classname, func)\
     .rate_hz = _rate_hz,\
     .max_time_micros = _max_time_micros,        \
-    .priority = _priority \
+    .priority = _priority, \
+    .worker_safe = false \
+}
+
+/*
+  as SCHED_TASK_CLASS, for tasks that are safe to run concurrently
+  with the main loop. On boards with scheduler worker threads these
+  are run from a worker (see SCHED_WORKERS), otherwise they run in the
+  main thread like any other task
+ */
+#define SCHED_WORKER_TASK_CLASS(classname, classptr, func, _rate_hz, _max_time_micros, _priority) { \
+    .function = FUNCTOR_BIND(classptr, &classname::func, void),\
+    AP_SCHEDULER_NAME_INITIALIZER(classname, func)\
+    .rate_hz = _rate_hz,\
+    .max_time_micros = _max_time_micros,        \
+    .priority = _priority, \
+    .worker_safe = true \
 }
 
 /*
@@ -58,7 +75,8 @@
     AP_FAST_NAME_INITIALIZER(classname, func)\
     .rate_hz = 0,\
     .max_time_micros = 0,\
-    .priority = AP_Scheduler::FAST_TASK_PRI0 \
+    .priority = AP_Scheduler::FAST_TASK_PRI0, \
+    .worker_safe = false \
 }
 
 /*
@@ -90,10 +108,12 @@ public:
         float rate_hz;
         uint16_t max_time_micros;
         uint8_t priority; // task priority
+        bool worker_safe; // may be run from a worker thread
     };
 
     enum class Options : uint8_t {
-        RECORD_TASK_INFO = 1 << 0
+        RECORD_TASK_INFO = 1 << 0,
+        ENABLE_PROFILER = 1 << 1,
     };
 
     enum FastTaskPriorities {
@@ -190,6 +210,11 @@ public:
 
     void task_info(ExpandingString &str);
 
+#if AP_SCHEDULER_PROFILER_ENABLED
+    // display profiler histograms for @SYS/profile.txt
+    void profile_info(ExpandingString &str);
+#endif
+
     static const struct AP_Param::GroupInfo var_info[];
 
     // loop performance monitoring:
@@ -207,6 +232,13 @@ private:
 
     // scheduler options
     AP_Int8 _options;
+
+#if AP_SCHEDULER_WORKERS_ENABLED
+    // number of worker threads for worker safe tasks
+    AP_Int8 _num_workers;
+
+    AP::TaskWorkers _workers;
+#endif
     
     // calculated loop period in usec
     uint16_t _loop_period_us;
@@ -273,6 +305,14 @@ private:
 
     // semaphore that is held while not waiting for ins samples
     HAL_Semaphore _rsem;
+
+    // return the name of a task by its index in the merged task list
+    const char *task_name(uint8_t task_index) const;
+
+#if AP_SCHEDULER_PROFILER_ENABLED
+    // write PROF messages with the profiler histogram summaries
+    void Log_Write_Profile();
+#endif
 };
 
 namespace AP {
@@ -9,3 +9,19 @@
 #ifndef AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED
 #define AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED 1
 #endif
+
+#ifndef AP_SCHEDULER_PROFILER_ENABLED
+#define AP_SCHEDULER_PROFILER_ENABLED (AP_SCHEDULER_ENABLED && BOARD_FLASH_SIZE > 1024)
+#endif
+
+#ifndef AP_SCHEDULER_PROFILER_MAX_SECTIONS
+#define AP_SCHEDULER_PROFILER_MAX_SECTIONS 16
+#endif
+
+#ifndef AP_SCHEDULER_WORKERS_ENABLED
+#define AP_SCHEDULER_WORKERS_ENABLED (AP_SCHEDULER_ENABLED && CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+#ifndef AP_SCHEDULER_MAX_WORKERS
+#define AP_SCHEDULER_MAX_WORKERS 3
+#endif
@@ -34,6 +34,16 @@ void AP::PerfInfo::reset()
     if (_task_info != nullptr) {
         memset(_task_info, 0, (_num_tasks) * sizeof(TaskInfo));
     }
+#if AP_SCHEDULER_PROFILER_ENABLED
+    if (_profile != nullptr) {
+        memset(_task_hist, 0, _num_task_hist * sizeof(Histogram));
+        memset(&_profile->loop_jitter, 0, sizeof(_profile->loop_jitter));
+        for (auto &section : _profile->sections) {
+            memset(&section.hist, 0, sizeof(section.hist));
+        }
+        _gyro_latency_reset = true;
+    }
+#endif
 }
 
 // ignore_loop - ignore this loop from performance measurements (used to reduce false positive when arming)
@@ -109,6 +119,298 @@ void AP::PerfInfo::TaskInfo::print(const char* task_name, uint32_t total_time, E
                 unsigned(MIN(overrun_count, 999)), unsigned(MIN(slip_count, 999)), pct);
 }
 
+#if AP_SCHEDULER_PROFILER_ENABLED
+// allocate the profiler histograms for use by @SYS/profile.txt and PROF logging
+void AP::PerfInfo::allocate_profile(uint8_t num_tasks)
+{
+    if (_profile == nullptr) {
+        _task_hist = NEW_NOTHROW Histogram[num_tasks];
+        _profile = NEW_NOTHROW Profile;
+        if (_task_hist == nullptr || _profile == nullptr) {
+            DEV_PRINTF("Unable to allocate scheduler profile\n");
+            delete _profile;
+            _profile = nullptr;
+            delete[] _task_hist;
+            _task_hist = nullptr;
+            return;
+        }
+        _num_task_hist = num_tasks;
+    }
+    _profile_enabled = true;
+}
+
+void AP::PerfInfo::update_task_profile(uint8_t task_index, uint32_t task_time_us)
+{
+    if (!profiling_enabled() || task_index >= _num_task_hist) {
+        return;
+    }
+    _task_hist[task_index].add(task_time_us);
+}
+
+void AP::PerfInfo::update_loop_jitter(uint32_t jitter_us)
+{
+    if (!profiling_enabled()) {
+        return;
+    }
+    _profile->loop_jitter.add(jitter_us);
+}
+
+// record the run time of a named section. Sections are registered on
+// first use, so this must only be called from the main thread
+void AP::PerfInfo::update_section(const char *name, uint32_t time_us)
+{
+    if (!profiling_enabled()) {
+        return;
+    }
+    for (uint8_t i=0; i<_profile->num_sections; i++) {
+        Section &section = _profile->sections[i];
+        if (section.name == name) {
+            section.hist.add(time_us);
+            return;
+        }
+    }
+    if (_profile->num_sections >= ARRAY_SIZE(_profile->sections)) {
+        return;
+    }
+    Section &section = _profile->sections[_profile->num_sections++];
+    section.name = name;
+    section.hist.add(time_us);
+}
+
+// the trace for the calling thread, the rate controller runs in either
+// the main thread or its own thread, but outputs are pushed from both
+AP::PerfInfo::GyroLatencyTrace &AP::PerfInfo::gyro_latency_trace()
+{
+    return _gyro_latency[hal.scheduler->in_main_thread() ? 0 : 1];
+}
+
+// start a gyro latency trace, called as the rate controller is given
+// a gyro sample. A trace which didn't reach the output push is dropped
+void AP::PerfInfo::gyro_latency_start(uint32_t sample_us, uint32_t filtered_us)
+{
+    if (!profiling_enabled()) {
+        return;
+    }
+    GyroLatencyTrace &trace = gyro_latency_trace();
+    if (sample_us == 0) {
+        // no sample time for this gyro
+        trace.active = false;
+        return;
+    }
+    trace.sample_us = sample_us;
+    trace.filtered_us = filtered_us;
+    trace.start_us = AP_HAL::micros();
+    trace.rate_us = 0;
+    trace.mix_us = 0;
+    trace.active = true;
+}
+
+void AP::PerfInfo::gyro_latency_mark(GyroLatencyMark mark)
+{
+    if (!profiling_enabled()) {
+        return;
+    }
+    GyroLatencyTrace &trace = gyro_latency_trace();
+    if (!trace.active) {
+        return;
+    }
+    const uint32_t now_us = AP_HAL::micros();
+    switch (mark) {
+    case GyroLatencyMark::RATE:
+        trace.rate_us = now_us;
+        return;
+    case GyroLatencyMark::MIX:
+        trace.mix_us = now_us;
+        return;
+    case GyroLatencyMark::PUSH:
+        break;
+    }
+
+    trace.active = false;
+    if (trace.rate_us == 0 || trace.mix_us == 0) {
+        // outputs pushed without running the rate controller and mixer
+        return;
+    }
+    Histogram *hist = _profile->gyro_latency;
+    if (_gyro_latency_reset) {
+        _gyro_latency_reset = false;
+        memset(hist, 0, sizeof(_profile->gyro_latency));
+    }
+    hist[uint8_t(GyroLatencyStage::FILTER)].add(trace.filtered_us - trace.sample_us);
+    hist[uint8_t(GyroLatencyStage::WAIT)].add(trace.start_us - trace.filtered_us);
+    hist[uint8_t(GyroLatencyStage::RATE)].add(trace.rate_us - trace.start_us);
+    hist[uint8_t(GyroLatencyStage::MIX)].add(trace.mix_us - trace.rate_us);
+    hist[uint8_t(GyroLatencyStage::OUTPUT)].add(now_us - trace.mix_us);
+    hist[uint8_t(GyroLatencyStage::TOTAL)].add(now_us - trace.sample_us);
+}
+
+const AP::PerfInfo::Histogram *AP::PerfInfo::get_task_histogram(uint8_t task_index) const
+{
+    if (!profiling_enabled() || task_index >= _num_task_hist) {
+        return nullptr;
+    }
+    return &_task_hist[task_index];
+}
+
+const AP::PerfInfo::Histogram *AP::PerfInfo::get_loop_jitter_histogram() const
+{
+    if (!profiling_enabled()) {
+        return nullptr;
+    }
+    return &_profile->loop_jitter;
+}
+
+const AP::PerfInfo::Section *AP::PerfInfo::get_section(uint8_t index) const
+{
+    if (!profiling_enabled() || index >= _profile->num_sections) {
+        return nullptr;
+    }
+    return &_profile->sections[index];
+}
+
+const AP::PerfInfo::Histogram *AP::PerfInfo::get_gyro_latency_histogram(GyroLatencyStage stage) const
+{
+    if (!profiling_enabled() || stage >= GyroLatencyStage::NUM_STAGES) {
+        return nullptr;
+    }
+    return &_profile->gyro_latency[uint8_t(stage)];
+}
+
+const char *AP::PerfInfo::gyro_latency_stage_name(GyroLatencyStage stage)
+{
+    switch (stage) {
+    case GyroLatencyStage::FILTER:
+        return "GyroLat.Filter";
+    case GyroLatencyStage::WAIT:
+        return "GyroLat.Wait";
+    case GyroLatencyStage::RATE:
+        return "GyroLat.Rate";
+    case GyroLatencyStage::MIX:
+        return "GyroLat.Mix";
+    case GyroLatencyStage::OUTPUT:
+        return "GyroLat.Output";
+    case GyroLatencyStage::TOTAL:
+        return "GyroLat.Total";
+    case GyroLatencyStage::NUM_STAGES:
+        break;
+    }
+    return "";
+}
+
+// bucket index for a value, see the Histogram description in PerfInfo.h
+uint8_t AP::PerfInfo::Histogram::bucket(uint32_t value_us)
+{
+    if (value_us < 4) {
+        return value_us;
+    }
+    const uint8_t msb = 31 - __builtin_clz(value_us);
+    const uint8_t sub = (value_us >> (msb - 1)) & 1U;
+    return MIN(4 + (msb - 2) * 2 + sub, int(NUM_BUCKETS) - 1);
+}
+
+// lowest value that falls in bucket b
+uint32_t AP::PerfInfo::Histogram::bucket_lower_us(uint8_t b)
+{
+    if (b < 4) {
+        return b;
+    }
+    const uint8_t msb = 2 + (b - 4) / 2;
+    const uint8_t sub = (b - 4) % 2;
+    return uint32_t(2 + sub) << (msb - 1);
+}
+
+void AP::PerfInfo::Histogram::add(uint32_t value_us)
+{
+    uint16_t &count = counts[bucket(value_us)];
+    if (count < UINT16_MAX) {
+        count++;
+    }
+    max_us = MAX(max_us, value_us);
+}
+
+uint32_t AP::PerfInfo::Histogram::total() const
+{
+    uint32_t ret = 0;
+    for (const auto count : counts) {
+        ret += count;
+    }
+    return ret;
+}
+
+uint32_t AP::PerfInfo::Histogram::percentile(uint8_t pct) const
+{
+    const uint32_t target = (total() * pct + 99) / 100;
+    uint32_t sum = 0;
+    for (uint8_t b=0; b<NUM_BUCKETS-1; b++) {
+        sum += counts[b];
+        if (sum >= target && sum > 0) {
+            return MIN(bucket_lower_us(b+1) - 1, max_us);
+        }
+    }
+    return max_us;
+}
+
+// one line per histogram for @SYS/profile.txt, non-empty buckets are
+// listed as lower_bound:count
+void AP::PerfInfo::Histogram::print(const char *name, ExpandingString &str) const
+{
+#if AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED
+    const char* fmt = "%-32.32s N=%5u P50=%5u P90=%5u P99=%5u MAX=%5u H=";
+#else
+    const char* fmt = "%-16.16s N=%5u P50=%5u P90=%5u P99=%5u MAX=%5u H=";
+#endif
+    str.printf(fmt, name,
+               unsigned(total()),
+               unsigned(percentile(50)),
+               unsigned(percentile(90)),
+               unsigned(percentile(99)),
+               unsigned(max_us));
+    for (uint8_t b=0; b<NUM_BUCKETS; b++) {
+        if (counts[b] != 0) {
+            str.printf("%u:%u ", unsigned(bucket_lower_us(b)), unsigned(counts[b]));
+        }
+    }
+    str.printf("\n");
+}
+
+AP::PerfSectionTimer::PerfSectionTimer(const char *_name) :
+    name(_name)
+{
+    AP_Scheduler *sched = AP_Scheduler::get_singleton();
+    if (sched == nullptr ||
+        !sched->perf_info.profiling_enabled() ||
+        !hal.scheduler->in_main_thread()) {
+        perf = nullptr;
+        return;
+    }
+    perf = &sched->perf_info;
+    start_us = AP_HAL::micros();
+}
+
+AP::PerfSectionTimer::~PerfSectionTimer()
+{
+    if (perf != nullptr) {
+        perf->update_section(name, AP_HAL::micros() - start_us);
+    }
+}
+
+void AP::gyro_latency_start(uint32_t sample_us, uint32_t filtered_us)
+{
+    AP_Scheduler *sched = AP_Scheduler::get_singleton();
+    if (sched != nullptr) {
+        sched->perf_info.gyro_latency_start(sample_us, filtered_us);
+    }
+}
+
+void AP::gyro_latency_mark(PerfInfo::GyroLatencyMark mark)
+{
+    AP_Scheduler *sched = AP_Scheduler::get_singleton();
+    if (sched != nullptr) {
+        sched->perf_info.gyro_latency_mark(mark);
+    }
+}
+#endif // AP_SCHEDULER_PROFILER_ENABLED
+
 // check_loop_time - check latest loop time vs min, max and overtime threshold
 void AP::PerfInfo::check_loop_time(uint32_t time_in_micros)
 {
@@ -26,6 +26,56 @@ public:
         void print(const char* task_name, uint32_t total_time, ExpandingString& str) const;
     };
 
+#if AP_SCHEDULER_PROFILER_ENABLED
+    /*
+      log-linear latency histogram. Values below 4us have a bucket
+      each, above that each power of two is split into two buckets.
+      The last bucket collects everything from 49152us up
+     */
+    struct Histogram {
+        static const uint8_t NUM_BUCKETS = 32;
+        uint16_t counts[NUM_BUCKETS];
+        uint32_t max_us;
+
+        void add(uint32_t value_us);
+        uint32_t total() const;
+        // return the upper bound of the bucket holding the given percentile
+        uint32_t percentile(uint8_t pct) const;
+        void print(const char *name, ExpandingString &str) const;
+
+        static uint8_t bucket(uint32_t value_us);
+        static uint32_t bucket_lower_us(uint8_t b);
+    };
+
+    // a named section of main thread code timed with AP_SCHEDULER_PROFILE_SECTION()
+    struct Section {
+        const char *name;
+        Histogram hist;
+    };
+
+    /*
+      gyro to motor output latency. The vehicle starts a trace with
+      the times of the gyro sample given to the rate controller, the
+      rate controller, mixer and output push mark when they are done
+      and the push records the time spent in each stage. All of the
+      marks for a trace must come from the one thread
+     */
+    enum class GyroLatencyMark : uint8_t {
+        RATE,       // rate controller done
+        MIX,        // mixer outputs written
+        PUSH,       // outputs pushed to the hardware, ends the trace
+    };
+    enum class GyroLatencyStage : uint8_t {
+        FILTER,     // sensor sample to filtered sample
+        WAIT,       // filtered sample to rate controller start
+        RATE,       // rate controller
+        MIX,        // mixer
+        OUTPUT,     // mixer outputs to the output push done
+        TOTAL,      // sensor sample to the output push done
+        NUM_STAGES
+    };
+#endif
+
     /* Do not allow copies */
     CLASS_NO_COPY(PerfInfo);
 
@@ -62,6 +112,33 @@ public:
         }
     }
 
+#if AP_SCHEDULER_PROFILER_ENABLED
+    // allocate the profiler histograms for use by @SYS/profile.txt and
+    // PROF logging. Once allocated they are never freed, as the gyro
+    // latency trace may be recording from another thread, disabling the
+    // profiler only stops recording
+    void allocate_profile(uint8_t num_tasks);
+    void disable_profile() { _profile_enabled = false; }
+    bool profiling_enabled() const { return _profile_enabled; }
+
+    // record the run time of a task and the jitter of the fast loop start time
+    void update_task_profile(uint8_t task_index, uint32_t task_time_us);
+    void update_loop_jitter(uint32_t jitter_us);
+    // record the run time of a named section, main thread only
+    void update_section(const char *name, uint32_t time_us);
+
+    // gyro to motor output latency trace, see GyroLatencyMark
+    void gyro_latency_start(uint32_t sample_us, uint32_t filtered_us);
+    void gyro_latency_mark(GyroLatencyMark mark);
+
+    // histogram accessors, return nullptr if not available
+    const Histogram *get_task_histogram(uint8_t task_index) const;
+    const Histogram *get_loop_jitter_histogram() const;
+    const Section *get_section(uint8_t index) const;
+    const Histogram *get_gyro_latency_histogram(GyroLatencyStage stage) const;
+    static const char *gyro_latency_stage_name(GyroLatencyStage stage);
+#endif
+
 private:
     uint16_t loop_rate_hz;
     uint16_t overtime_threshold_micros;
@@ -77,8 +154,81 @@ private:
     // performance monitoring
     uint8_t _num_tasks;
     TaskInfo* _task_info;
+
+#if AP_SCHEDULER_PROFILER_ENABLED
+    struct Profile {
+        Histogram loop_jitter;
+        Section sections[AP_SCHEDULER_PROFILER_MAX_SECTIONS];
+        uint8_t num_sections;
+        Histogram gyro_latency[uint8_t(GyroLatencyStage::NUM_STAGES)];
+    } *_profile;
+
+    bool _profile_enabled;
+
+    // the gyro latency traces in progress, zero times for marks not
+    // yet reached. The main thread and the thread running the rate
+    // controller, if it has its own, each have a trace
+    struct GyroLatencyTrace {
+        uint32_t sample_us;
+        uint32_t filtered_us;
+        uint32_t start_us;
+        uint32_t rate_us;
+        uint32_t mix_us;
+        bool active;
+    } _gyro_latency[2];
+    GyroLatencyTrace &gyro_latency_trace();
+    // set by reset() so that the thread recording the gyro latency
+    // clears its histograms, rather than clearing them under it
+    bool _gyro_latency_reset;
+    Histogram *_task_hist;
+    uint8_t _num_task_hist;
+#endif
 };
 
+#if AP_SCHEDULER_PROFILER_ENABLED
+/*
+  time the enclosing scope into the named profiler section when the
+  profiler is enabled. name must be a string literal, sections are
+  told apart by pointer
+ */
+class PerfSectionTimer {
+public:
+    PerfSectionTimer(const char *_name);
+    ~PerfSectionTimer();
+
+    CLASS_NO_COPY(PerfSectionTimer);
+
+private:
+    const char *name;
+    PerfInfo *perf;
+    uint32_t start_us;
+};
+#endif
+
 };
 
 #endif  // AP_SCHEDULER_ENABLED
+
+#if AP_SCHEDULER_PROFILER_ENABLED
+#define AP_SCHEDULER_PROFILE_SECTION(name) AP::PerfSectionTimer _perf_section_timer(name)
+#else
+#define AP_SCHEDULER_PROFILE_SECTION(name)
+#endif
+
+/*
+  gyro to motor output latency trace, recorded when the profiler is
+  enabled. sample_us and filtered_us are the times the gyro sample
+  given to the rate controller arrived and was filtered. mark is one
+  of RATE, MIX or PUSH
+ */
+#if AP_SCHEDULER_PROFILER_ENABLED
+namespace AP {
+void gyro_latency_start(uint32_t sample_us, uint32_t filtered_us);
+void gyro_latency_mark(PerfInfo::GyroLatencyMark mark);
+};
+#define AP_SCHEDULER_GYRO_LATENCY_START(sample_us, filtered_us) AP::gyro_latency_start(sample_us, filtered_us)
+#define AP_SCHEDULER_GYRO_LATENCY_MARK(mark) AP::gyro_latency_mark(AP::PerfInfo::GyroLatencyMark::mark)
+#else
+#define AP_SCHEDULER_GYRO_LATENCY_START(sample_us, filtered_us)
+#define AP_SCHEDULER_GYRO_LATENCY_MARK(mark)
+#endif
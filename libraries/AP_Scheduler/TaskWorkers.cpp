@@ -0,0 +1,113 @@
+#include "AP_Scheduler_config.h"
+
+#if AP_SCHEDULER_WORKERS_ENABLED
+
+#include "TaskWorkers.h"
+#include "PerfInfo.h"
+
+#include <AP_Math/AP_Math.h>
+#include <GCS_MAVLink/GCS.h>
+
+extern const AP_HAL::HAL& hal;
+
+bool AP::TaskWorkers::init(uint8_t num_workers, uint8_t num_tasks)
+{
+    _state = NEW_NOTHROW TaskState[num_tasks];
+    _done = NEW_NOTHROW uint8_t[num_tasks];
+    if (_state == nullptr || _done == nullptr) {
+        delete[] _state;
+        _state = nullptr;
+        delete[] _done;
+        _done = nullptr;
+        return false;
+    }
+
+    num_workers = MIN(num_workers, AP_SCHEDULER_MAX_WORKERS);
+    for (uint8_t i=0; i<num_workers; i++) {
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP::TaskWorkers::worker_thread, void),
+                                          "ap-sched-worker",
+                                          8192, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
+            DEV_PRINTF("Failed to create scheduler worker\n");
+            break;
+        }
+        _num_workers++;
+    }
+    return _num_workers > 0;
+}
+
+bool AP::TaskWorkers::submit(uint8_t task_index, Functor<void> function, uint16_t max_time_micros)
+{
+    WITH_SEMAPHORE(_sem);
+    TaskState &state = _state[task_index];
+    if (state.busy || _count >= ARRAY_SIZE(_queue)) {
+        return false;
+    }
+    Item &item = _queue[(_head + _count) % ARRAY_SIZE(_queue)];
+    item.function = function;
+    item.task_index = task_index;
+    _count++;
+    state.busy = true;
+    state.max_time_micros = max_time_micros;
+    _work_sem.signal();
+    return true;
+}
+
+void AP::TaskWorkers::collect(PerfInfo &perf_info)
+{
+    WITH_SEMAPHORE(_sem);
+    for (uint8_t i=0; i<_num_done; i++) {
+        TaskState &state = _state[_done[i]];
+        const uint32_t time_taken = state.time_taken_us;
+        perf_info.update_task_info(_done[i], time_taken, time_taken > state.max_time_micros);
+#if AP_SCHEDULER_PROFILER_ENABLED
+        perf_info.update_task_profile(_done[i], time_taken);
+#endif
+        state.busy = false;
+    }
+    _num_done = 0;
+}
+
+bool AP::TaskWorkers::pop(Item &item)
+{
+    WITH_SEMAPHORE(_sem);
+    if (_count == 0) {
+        return false;
+    }
+    item = _queue[_head];
+    _head = (_head + 1) % ARRAY_SIZE(_queue);
+    _count--;
+    if (_count > 0) {
+        // wake another worker for the rest of the queue
+        _work_sem.signal();
+    }
+    return true;
+}
+
+void AP::TaskWorkers::worker_thread()
+{
+    uint8_t worker_index;
+    {
+        WITH_SEMAPHORE(_sem);
+        worker_index = _next_worker_index++;
+    }
+    // keep off the CPUs of the main loop where the HAL supports it
+    hal.scheduler->set_worker_thread_affinity(worker_index);
+
+    while (true) {
+        if (!_work_sem.wait_blocking()) {
+            continue;
+        }
+        Item item;
+        while (pop(item)) {
+            const uint32_t start_us = AP_HAL::micros();
+            item.function();
+            const uint32_t time_taken = AP_HAL::micros() - start_us;
+
+            WITH_SEMAPHORE(_sem);
+            _state[item.task_index].time_taken_us = time_taken;
+            _done[_num_done++] = item.task_index;
+        }
+    }
+}
+
+#endif  // AP_SCHEDULER_WORKERS_ENABLED
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AP_Scheduler_config.h"
+
+#if AP_SCHEDULER_WORKERS_ENABLED
+
+#include <AP_Common/AP_Common.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/Semaphores.h>
+
+namespace AP {
+
+class PerfInfo;
+
+/*
+  a pool of threads that run scheduler tasks marked as worker safe
+  with SCHED_WORKER_TASK_CLASS, off the main thread. The main thread
+  queues a task when it is due and collects the time it took once it
+  has finished, so PerfInfo is only ever updated from the main thread
+ */
+class TaskWorkers {
+public:
+    TaskWorkers() {}
+
+    /* Do not allow copies */
+    CLASS_NO_COPY(TaskWorkers);
+
+    // start the worker threads, returns false if none could be started
+    bool init(uint8_t num_workers, uint8_t num_tasks);
+
+    bool running() const { return _num_workers > 0; }
+
+    // queue a task. Returns false if the task is still queued or
+    // running from an earlier tick, or if the queue is full
+    bool submit(uint8_t task_index, Functor<void> function, uint16_t max_time_micros);
+
+    // record the run time of tasks completed since the last call
+    void collect(PerfInfo &perf_info);
+
+private:
+    struct Item {
+        Functor<void> function;
+        uint8_t task_index;
+    };
+
+    struct TaskState {
+        uint32_t time_taken_us;
+        uint16_t max_time_micros;
+        bool busy;
+    };
+
+    void worker_thread();
+    bool pop(Item &item);
+
+    HAL_Semaphore _sem;
+    HAL_BinarySemaphore _work_sem;
+
+    // tasks waiting for a worker
+    Item _queue[16];
+    uint8_t _head;
+    uint8_t _count;
+
+    // one entry per task, busy while the task is queued, running or
+    // waiting to be collected
+    TaskState *_state;
+
+    // tasks finished but not yet collected, each task can appear once
+    uint8_t *_done;
+    uint8_t _num_done;
+
+    uint8_t _num_workers;
+    uint8_t _next_worker_index;
+};
+
+};
+
+#endif  // AP_SCHEDULER_WORKERS_ENABLED
@@ -30,8 +30,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
-    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 4k of memory. Boards with less than 500k of RAM are limited to 500 points.
+    // @Range: 0 2000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -115,13 +115,29 @@ void AP_SmartRTL::init()
     _simplify.stack_max = _points_max * SMARTRTL_SIMPLIFY_STACK_LEN_MULT;
     _simplify.stack = (simplify_start_finish_t*)calloc(_simplify.stack_max, sizeof(simplify_start_finish_t));
 
+    // segment index hash table is the smallest power of two that holds one cell per point
+    _seg_index.num_cells = 1;
+    while (_seg_index.num_cells < _points_max) {
+        _seg_index.num_cells <<= 1;
+    }
+    _seg_index.cell_start = (uint16_t*)calloc(_seg_index.num_cells + 2, sizeof(uint16_t));
+    // each segment is held in at most SMARTRTL_PRUNING_INDEX_SEG_CELLS_MAX cells, longer ones once in the long bucket
+    _seg_index.entries_max = _points_max * SMARTRTL_PRUNING_INDEX_SEG_CELLS_MAX;
+    _seg_index.entries = (uint16_t*)calloc(_seg_index.entries_max, sizeof(uint16_t));
+
     // check if memory allocation failed
-    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr) {
+    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr ||
+        _seg_index.cell_start == nullptr || _seg_index.entries == nullptr) {
         log_action(Action::DEACTIVATED_INIT_FAILED);
         GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "SmartRTL deactivated: init failed");
         free(_path);
         free(_prune.loops);
         free(_simplify.stack);
+        free(_seg_index.cell_start);
+        free(_seg_index.entries);
+        _path = nullptr;
+        _seg_index.cell_start = nullptr;
+        _seg_index.entries = nullptr;
         return;
     }
 
@@ -563,6 +579,10 @@ void AP_SmartRTL::detect_simplifications()
 *   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
 *   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
 *
+*   Each segment is only compared against segments which share a cell of the segment index so the cost scales
+*   close to linearly with the number of points.  The index is built over the first calls, within the same time
+*   budget.  If the index cannot be built all segments are compared.
+*
 *   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
 */
 void AP_SmartRTL::detect_loops()
@@ -573,9 +593,26 @@ void AP_SmartRTL::detect_loops()
         return;
     }
 
-    // capture start time
+    // capture start time, building the index and searching share the time budget
     const uint32_t start_time_us = AP_HAL::micros();
 
+    if (!_prune.use_index) {
+        _seg_index.state = SegIndexState::FAILED;
+    } else if (!build_segment_index(_prune.path_points_count, start_time_us)) {
+        // continue building on the next call
+        return;
+    }
+
+    if (_seg_index.state == SegIndexState::READY) {
+        detect_loops_indexed(start_time_us);
+    } else {
+        detect_loops_all_segments(start_time_us);
+    }
+}
+
+// loop detection by comparing each segment against all earlier segments
+void AP_SmartRTL::detect_loops_all_segments(uint32_t start_time_us)
+{
     // run for defined amount of time
     while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
 
@@ -608,6 +645,207 @@ void AP_SmartRTL::detect_loops()
     }
 }
 
+// loop detection using the segment index. This finds the same loops as detect_loops_all_segments
+// because for each segment it finds the earliest close segment, which is the first the full search would hit
+void AP_SmartRTL::detect_loops_indexed(uint32_t start_time_us)
+{
+    // run for defined amount of time
+    while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
+
+        // check segment i against all earlier segments
+        if (_prune.i >= 3) {
+            uint16_t j;
+            Vector3f midpoint;
+            if (find_earliest_close_segment(_prune.i, j, midpoint)) {
+                // if there is a loop here, add to loop array
+                if (!add_loop(j, _prune.i-1, midpoint)) {
+                    // if the buffer is full, stop trying to prune
+                    _prune.complete = true;
+                    return;
+                }
+            }
+        }
+
+        // reduce outer loop
+        _prune.i--;
+        // complete when outer loop has run out of new points to check
+        if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+            _prune.complete = true;
+            _prune.path_points_completed = _prune.path_points_count;
+            return;
+        }
+    }
+}
+
+// hash of a grid cell into the index's cell table
+uint16_t AP_SmartRTL::segment_index_cell(int32_t x, int32_t y) const
+{
+    return (uint32_t(x) * 73856093U ^ uint32_t(y) * 19349663U) & (_seg_index.num_cells - 1);
+}
+
+// grid cell range covered by segment (index is the segment's end point) grown by the pruning distance
+// returns false if the segment covers too many cells to be indexed by cell
+bool AP_SmartRTL::segment_cell_range(uint16_t index, int32_t &x_min, int32_t &x_max, int32_t &y_min, int32_t &y_max) const
+{
+    const Vector3f &p1 = _path[index-1];
+    const Vector3f &p2 = _path[index];
+    const float margin = SMARTRTL_PRUNING_DELTA;
+    x_min = floorf((MIN(p1.x, p2.x) - margin) * _seg_index.cell_size_inv);
+    x_max = floorf((MAX(p1.x, p2.x) + margin) * _seg_index.cell_size_inv);
+    y_min = floorf((MIN(p1.y, p2.y) - margin) * _seg_index.cell_size_inv);
+    y_max = floorf((MAX(p1.y, p2.y) + margin) * _seg_index.cell_size_inv);
+    return (x_max - x_min + 1) * (y_max - y_min + 1) <= SMARTRTL_PRUNING_INDEX_SEG_CELLS_MAX;
+}
+
+// continue building the spatial index of the first path_points_count points' segments until
+// SMARTRTL_PRUNING_LOOP_TIME_US has passed since start_time_us.  returns true once the build is complete or has failed
+bool AP_SmartRTL::build_segment_index(uint16_t path_points_count, uint32_t start_time_us)
+{
+    // the final bucket holds long segments
+    const uint16_t long_bucket = _seg_index.num_cells;
+    uint16_t *cell_start = _seg_index.cell_start;
+
+    while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
+        switch (_seg_index.state) {
+        case SegIndexState::START:
+            if (cell_start == nullptr || path_points_count < 2) {
+                _seg_index.state = SegIndexState::FAILED;
+                _seg_index.fallback_count++;
+                break;
+            }
+            _seg_index.total_length = 0.0f;
+            _seg_index.build_i = 1;
+            _seg_index.state = SegIndexState::MEASURE;
+            break;
+
+        case SegIndexState::MEASURE: {
+            if (_seg_index.build_i < path_points_count) {
+                const uint16_t i = _seg_index.build_i++;
+                _seg_index.total_length += (_path[i].xy() - _path[i-1].xy()).length();
+                break;
+            }
+            // cells twice the average segment length plus the pruning margin mean most segments,
+            // grown by the margin, cover at most 2x2 cells. Longer segments go in the long bucket
+            const float cell_size = 2.0f * (_seg_index.total_length / (path_points_count - 1) + SMARTRTL_PRUNING_DELTA);
+            if (!is_positive(cell_size)) {
+                _seg_index.state = SegIndexState::FAILED;
+                _seg_index.fallback_count++;
+                break;
+            }
+            _seg_index.cell_size_inv = 1.0f / cell_size;
+            memset(cell_start, 0, (_seg_index.num_cells + 2) * sizeof(uint16_t));
+            _seg_index.build_i = 1;
+            _seg_index.state = SegIndexState::COUNT;
+            break;
+        }
+
+        case SegIndexState::COUNT: {
+            if (_seg_index.build_i < path_points_count) {
+                // count the entries in each bucket
+                const uint16_t i = _seg_index.build_i++;
+                int32_t x_min, x_max, y_min, y_max;
+                if (!segment_cell_range(i, x_min, x_max, y_min, y_max)) {
+                    cell_start[long_bucket]++;
+                    break;
+                }
+                for (int32_t x = x_min; x <= x_max; x++) {
+                    for (int32_t y = y_min; y <= y_max; y++) {
+                        cell_start[segment_index_cell(x, y)]++;
+                    }
+                }
+                break;
+            }
+            // convert counts to the end of each bucket. Segments are held in at most
+            // SMARTRTL_PRUNING_INDEX_SEG_CELLS_MAX cells so this fits in entries
+            uint16_t sum = 0;
+            for (uint16_t b = 0; b <= long_bucket; b++) {
+                sum += cell_start[b];
+                cell_start[b] = sum;
+            }
+            cell_start[long_bucket+1] = sum;
+            _seg_index.build_i = path_points_count - 1;
+            _seg_index.state = SegIndexState::FILL;
+            break;
+        }
+
+        case SegIndexState::FILL: {
+            if (_seg_index.build_i < 1) {
+                _seg_index.state = SegIndexState::READY;
+                break;
+            }
+            // fill buckets from the back so each bucket's segments end up in ascending order and cell_start holds the start of each bucket
+            const uint16_t i = _seg_index.build_i--;
+            int32_t x_min, x_max, y_min, y_max;
+            if (!segment_cell_range(i, x_min, x_max, y_min, y_max)) {
+                _seg_index.entries[--cell_start[long_bucket]] = i;
+                break;
+            }
+            for (int32_t x = x_max; x >= x_min; x--) {
+                for (int32_t y = y_max; y >= y_min; y--) {
+                    _seg_index.entries[--cell_start[segment_index_cell(x, y)]] = i;
+                }
+            }
+            break;
+        }
+
+        case SegIndexState::READY:
+        case SegIndexState::FAILED:
+            return true;
+        }
+    }
+    return false;
+}
+
+// find the earliest segment which comes within SMARTRTL_PRUNING_DELTA of segment i (i.e. from point i-1 to i)
+// only segments ending at or before point i-2 are considered. returns true if found
+bool AP_SmartRTL::find_earliest_close_segment(uint16_t i, uint16_t &j, Vector3f &midpoint) const
+{
+    uint16_t best = i;
+
+    // check the segments in the bucket against segment i, keeping the earliest close segment
+    auto check_bucket = [&](uint16_t bucket) {
+        for (uint16_t e = _seg_index.cell_start[bucket]; e < _seg_index.cell_start[bucket+1]; e++) {
+            const uint16_t k = _seg_index.entries[e];
+            // entries are ascending so nothing later in this bucket can be better
+            if (k > i - 2 || k >= best) {
+                return;
+            }
+            const dist_point dp = segment_segment_dist(_path[i], _path[i-1], _path[k-1], _path[k]);
+            if (dp.distance < SMARTRTL_PRUNING_DELTA) {
+                best = k;
+                midpoint = dp.midpoint;
+                return;
+            }
+        }
+    };
+
+    int32_t x_min, x_max, y_min, y_max;
+    if (segment_cell_range(i, x_min, x_max, y_min, y_max)) {
+        for (int32_t x = x_min; x <= x_max; x++) {
+            for (int32_t y = y_min; y <= y_max; y++) {
+                check_bucket(segment_index_cell(x, y));
+            }
+        }
+        check_bucket(_seg_index.num_cells);
+    } else {
+        // long segment, check against all earlier segments
+        for (uint16_t k = 1; k <= i - 2; k++) {
+            const dist_point dp = segment_segment_dist(_path[i], _path[i-1], _path[k-1], _path[k]);
+            if (dp.distance < SMARTRTL_PRUNING_DELTA) {
+                best = k;
+                midpoint = dp.midpoint;
+                break;
+            }
+        }
+    }
+
+    if (best >= i) {
+        return false;
+    }
+    j = best;
+    return true;
+}
+
 // restart simplify if new points have been added to path
 // path_points_count is _path_points_count but passed in to avoid having to take the semaphore
 void AP_SmartRTL::restart_simplify_if_new_points(uint16_t path_points_count)
@@ -651,6 +889,7 @@ void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
     _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
     _prune.j = 0;
     _prune.path_points_count = path_points_count;
+    _seg_index.state = SegIndexState::START;
 }
 
 // reset pruning algorithm so that it will re-check all points in the path
@@ -692,6 +931,9 @@ void AP_SmartRTL::remove_points_by_simplify_bitmask()
 
     _path_sem.give();
 
+    // segment index no longer matches the path
+    _seg_index.state = SegIndexState::START;
+
     // flag point removal is complete
     _simplify.bitmask.setall();
     _simplify.removal_required = false;
@@ -754,6 +996,9 @@ bool AP_SmartRTL::remove_points_by_loops(uint16_t num_points_to_remove)
         _prune.loops_count--;
     }
 
+    // segment index no longer matches the path
+    _seg_index.state = SegIndexState::START;
+
     _path_sem.give();
     return true;
 }
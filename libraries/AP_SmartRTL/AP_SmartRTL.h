@@ -8,7 +8,13 @@
 // definitions and macros
 #define SMARTRTL_ACCURACY_DEFAULT        2.0f   // default _ACCURACY parameter value.  Points will be no closer than this distance (in meters) together.
 #define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 20bytes * this number.
+#ifndef SMARTRTL_POINTS_MAX
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define SMARTRTL_POINTS_MAX              2000   // the absolute maximum number of points this library can support.
+#else
 #define SMARTRTL_POINTS_MAX              500    // the absolute maximum number of points this library can support.
+#endif
+#endif
 #define SMARTRTL_TIMEOUT                 15000  // the time in milliseconds with no points saved to the path (for whatever reason), before SmartRTL is disabled for the flight
 #define SMARTRTL_CLEANUP_POINT_TRIGGER   50     // simplification will trigger when this many points are added to the path
 #define SMARTRTL_CLEANUP_START_MARGIN    10     // routine cleanup algorithms begin when the path array has only this many empty slots remaining
@@ -21,6 +27,7 @@
 #define SMARTRTL_PRUNING_DELTA (_accuracy * 0.99)   // How many meters apart must two points be, such that we can assume that there is no obstacle between them.  must be smaller than _ACCURACY parameter
 #define SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT 0.25f // pruning loop buffer size as compared to maximum number of points
 #define SMARTRTL_PRUNING_LOOP_TIME_US    200    // maximum time (in microseconds) that the loop finding algorithm will run before returning
+#define SMARTRTL_PRUNING_INDEX_SEG_CELLS_MAX 4  // segments covering more grid cells than this are kept in the index's "long segment" list, also sets the index size
 
 class AP_SmartRTL {
 
@@ -85,6 +92,13 @@ public:
     // returns true if pilot's yaw input should be used to adjust vehicle's heading
     bool use_pilot_yaw(void) const;
 
+    // enable or disable the spatial segment index used by loop detection.  When disabled
+    // every segment is compared against every other segment (used by example sketch)
+    void set_use_segment_index(bool enable) { _prune.use_index = enable; }
+
+    // number of pruning runs that could not use the segment index and compared all segments (used by example sketch)
+    uint16_t get_segment_index_fallback_count() const { return _seg_index.fallback_count; }
+
     // parameter var table
     static const struct AP_Param::GroupInfo var_info[];
 
@@ -170,6 +184,27 @@ private:
     // get the closest distance between 2 line segments and the point midway between the closest points
     static dist_point segment_segment_dist(const Vector3f& p1, const Vector3f& p2, const Vector3f& p3, const Vector3f& p4);
 
+    // loop detection by comparing each segment against all earlier segments
+    void detect_loops_all_segments(uint32_t start_time_us);
+
+    // loop detection using the segment index
+    void detect_loops_indexed(uint32_t start_time_us);
+
+    // continue building the spatial index of the first path_points_count points' segments until
+    // SMARTRTL_PRUNING_LOOP_TIME_US has passed since start_time_us.  returns true once the build is complete or has failed
+    bool build_segment_index(uint16_t path_points_count, uint32_t start_time_us);
+
+    // grid cell range covered by segment (index is the segment's end point) grown by the pruning distance
+    // returns false if the segment covers too many cells to be indexed by cell
+    bool segment_cell_range(uint16_t index, int32_t &x_min, int32_t &x_max, int32_t &y_min, int32_t &y_max) const;
+
+    // hash of a grid cell into the index's cell table
+    uint16_t segment_index_cell(int32_t x, int32_t y) const;
+
+    // find the earliest segment which comes within SMARTRTL_PRUNING_DELTA of segment i (i.e. from point i-1 to i)
+    // only segments ending at or before point i-2 are considered. returns true if found
+    bool find_earliest_close_segment(uint16_t i, uint16_t &j, Vector3f &midpoint) const;
+
     // de-activate SmartRTL, send warning to GCS and logger
     void deactivate(Action action, const char *reason);
 
@@ -236,8 +271,34 @@ private:
         prune_loop_t* loops;// the result of the pruning algorithm
         uint16_t loops_max; // maximum number of elements in the _prunable_loops array
         uint16_t loops_count;   // number of elements in the _prunable_loops array
+        bool use_index = true;  // true if detect_loops should use the segment index
     } _prune;
 
+    // Segment index used by loop detection. Segments are bucketed into a hashed 2D grid of cells so that each
+    // segment is only compared against segments that are nearby. Buckets are stored contiguously with
+    // bucket b's segments held in entries[cell_start[b]] to entries[cell_start[b+1]-1] in ascending order.
+    // The final bucket holds long segments which are checked against every segment.
+    // The index is built a step at a time within the pruning time budget
+    enum class SegIndexState : uint8_t {
+        START,              // index does not match the path, build from the start
+        MEASURE,            // summing segment lengths to choose the cell size
+        COUNT,              // counting the entries in each bucket
+        FILL,               // filling the buckets
+        READY,              // index is usable for this pruning run
+        FAILED,             // index could not be built, compare all segments
+    };
+    struct {
+        uint16_t* cell_start;   // start of each bucket's entries, num_cells+2 elements
+        uint16_t* entries;      // segment indices (index of the segment's end point)
+        uint16_t entries_max;   // maximum number of elements in the entries array
+        uint16_t num_cells;     // number of cells in hash table (power of 2)
+        float cell_size_inv;    // inverse of the grid's cell size in meters
+        SegIndexState state;
+        uint16_t build_i;       // next segment for the build step
+        float total_length;     // sum of horizontal segment lengths in meters, while measuring
+        uint16_t fallback_count;// number of pruning runs which compared all segments
+    } _seg_index;
+
     // returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
     bool loops_overlap(const prune_loop_t& loop1, const prune_loop_t& loop2) const;
 };
@@ -32,12 +32,16 @@ AP_BoardConfig board_config;
 void setup();
 void loop();
 void reset();
+void reset_long_path();
 void check_path(const std::vector<Vector3f> &correct_path, const char* test_name, uint32_t time_us);
+void check_long_path_pruning();
 
 void setup()
 {
     hal.console->printf("SmartRTL test\n");
     board_config.init();
+    // allow the long path test to use the full path buffer
+    AP_Param::set_object_value(&smart_rtl, smart_rtl.var_info, "POINTS", SMARTRTL_POINTS_MAX);
     smart_rtl.init();
 }
 
@@ -76,6 +80,9 @@ void loop()
     run_time = AP_HAL::micros() - reference_time;
     check_path(test_path_complete, "simplify and pruning", run_time);
 
+    // compare indexed loop detection with checking all segments on a long path
+    check_long_path_pruning();
+
     // delay before next display
     hal.scheduler->delay(5e3); // 5 seconds
 }
@@ -89,6 +96,54 @@ void reset()
     }
 }
 
+// reset path and upload a long path of overlapping circles, each circle crossing all previous circles
+void reset_long_path()
+{
+    smart_rtl.set_home(true, Vector3f{0.0f, 0.0f, 0.0f});
+    const float radius = 60.0f;
+    const uint8_t circles = 8;
+    const uint16_t steps_per_circle = 360;
+    for (uint8_t c = 0; c < circles; c++) {
+        const float offset = c * 3.0f;
+        for (uint16_t s = 0; s < steps_per_circle; s++) {
+            const float angle = M_2PI * s / steps_per_circle;
+            smart_rtl.update(true, Vector3f{offset + radius * (cosf(angle) - 1.0f), radius * sinf(angle), -10.0f});
+        }
+    }
+}
+
+// prune the long path with and without the segment index and check both produce the same path
+void check_long_path_pruning()
+{
+    uint32_t run_time_us[2];
+    std::vector<Vector3f> pruned_path;
+    uint16_t fallback_count = 0;
+    for (uint8_t use_index = 0; use_index < 2; use_index++) {
+        hal.scheduler->delay(5);    // delay 5 milliseconds because request_through_cleanup uses millisecond timestamps
+        smart_rtl.set_use_segment_index(use_index);
+        reset_long_path();
+        const uint16_t points_before = smart_rtl.get_num_points();
+        fallback_count = smart_rtl.get_segment_index_fallback_count();
+        const uint32_t reference_time = AP_HAL::micros();
+        while (!smart_rtl.request_thorough_cleanup(AP_SmartRTL::THOROUGH_CLEAN_PRUNE_ONLY)) {
+            smart_rtl.run_background_cleanup();
+        }
+        run_time_us[use_index] = AP_HAL::micros() - reference_time;
+        if (use_index == 0) {
+            for (uint16_t i = 0; i < smart_rtl.get_num_points(); i++) {
+                pruned_path.push_back(smart_rtl.get_point(i));
+            }
+            hal.console->printf("long path: pruned %u points to %u\n", (unsigned)points_before, (unsigned)pruned_path.size());
+        }
+    }
+    hal.console->printf("long path all segments: time:%u us\n", (unsigned)run_time_us[0]);
+    if (smart_rtl.get_segment_index_fallback_count() != fallback_count) {
+        hal.console->printf("long path indexed: fail, segment index was not used\n");
+    }
+    check_path(pruned_path, "long path indexed", run_time_us[1]);
+    smart_rtl.set_use_segment_index(true);
+}
+
 // compare the vector array passed in with the path held in the smart_rtl object
 void check_path(const std::vector<Vector3f>& correct_path, const char* test_name, uint32_t time_us)
 {
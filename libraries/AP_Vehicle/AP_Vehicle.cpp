@@ -599,6 +599,10 @@ SCHED_TASK_CLASS arguments:
  - expected time (in MicroSeconds) that the method should take to run
  - priority (0 through 255, lower number meaning higher priority)
 
+SCHED_WORKER_TASK_CLASS takes the same arguments as SCHED_TASK_CLASS
+and marks the task as safe to run on a scheduler worker thread,
+concurrently with the main loop.
+
  */
 const AP_Scheduler::Task AP_Vehicle::scheduler_tasks[] = {
 #if HAL_GYROFFT_ENABLED
@@ -672,7 +676,7 @@ const AP_Scheduler::Task AP_Vehicle::scheduler_tasks[] = {
     SCHED_TASK_CLASS(AP_Filters,   &vehicle.filters,        update,                   1, 100, 252),
 #endif
 #if AP_STATS_ENABLED
-    SCHED_TASK_CLASS(AP_Stats,             &vehicle.stats,            update,           1, 100, 252),
+    SCHED_WORKER_TASK_CLASS(AP_Stats,      &vehicle.stats,            update,           1, 100, 252),
 #endif
 #if AP_ARMING_ENABLED
     SCHED_TASK(update_arming,          1,     50, 253),
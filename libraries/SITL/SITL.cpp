@@ -680,6 +680,21 @@ const AP_Param::GroupInfo SIM::var_info3[] = {
     // @User: Advanced
     AP_GROUPINFO("UART_LOSS", 42, SIM,  uart_byte_loss_pct, 0),
 
+    // @Param: BUS_TIMING
+    // @DisplayName: Simulated bus timing
+    // @Description: Controls use of the modelled I2C/SPI transfer times. Transfer times are always accounted for in @SYS/buses.txt. When enabled, periodic callbacks on an I2C bus are held off until the modelled transfers of earlier callbacks on that bus have completed, so a saturated bus shows up as callbacks running late
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("BUS_TIMING", 43, SIM,  bus_timing, 0),
+
+    // @Param: BUS_LAT
+    // @DisplayName: Simulated bus transfer latency
+    // @Description: Fixed time added to each modelled I2C/SPI transfer on top of the time taken to clock the bytes, for driver and controller overheads
+    // @Units: us
+    // @Range: 0 10000
+    // @User: Advanced
+    AP_GROUPINFO("BUS_LAT", 44, SIM,  bus_latency_us, 0),
+
     // @Group: ARSPD_
     // @Path: ./SITL_Airspeed.cpp
     AP_SUBGROUPINFO(airspeed[0], "ARSPD_", 50, SIM, AirspeedParm),
@@ -244,6 +244,10 @@ public:
 
     AP_Float uart_byte_loss_pct;
 
+    // simulated I2C/SPI bus timing
+    AP_Int8 bus_timing;
+    AP_Int16 bus_latency_us;
+
 #ifdef SFML_JOYSTICK
     AP_Int8 sfml_joystick_id;
     AP_Int8 sfml_joystick_axis[8];
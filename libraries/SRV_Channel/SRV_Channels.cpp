@@ -487,6 +487,8 @@ void SRV_Channels::push()
 {
     hal.rcout->push();
 
+    AP_SCHEDULER_GYRO_LATENCY_MARK(PUSH);
+
 #if AP_VOLZ_ENABLED
     // give volz library a chance to update
     volz.update();